@@ -85,6 +85,17 @@ namespace argos {
        * @see CreateLuaState()
        */
       virtual void ReadingsToLuaState(lua_State* pt_lua_state) = 0;
+
+      /**
+       * Returns <tt>true</tt> if the readings changed since the last call to ReadingsToLuaState().
+       * Lua controllers do not call ReadingsToLuaState() when this method returns <tt>false</tt>.
+       * Sensors that can cheaply tell whether their readings changed should override it;
+       * the default implementation always returns <tt>true</tt>.
+       * @see ReadingsToLuaState()
+       */
+      virtual bool LuaReadingsChanged() const {
+         return true;
+      }
 #endif
 
    };
@@ -12,6 +12,7 @@ namespace argos {
 }
 
 #include <argos3/core/utility/plugins/factory.h>
+#include <argos3/core/utility/configuration/argos_configuration.h>
 
 namespace argos {
 
@@ -42,6 +43,45 @@ namespace argos {
        */
       virtual void SetRobot(CComposableEntity& c_entity) = 0;
 
+      /**
+       * The base class of the parsed XML configuration of an actuator.
+       * @see ParseConfiguration()
+       */
+      struct SConfiguration {
+         virtual ~SConfiguration() {}
+      };
+
+      /**
+       * Parses the XML configuration of the actuator.
+       * When this method returns a configuration, it is called once per
+       * controller, on an actuator that is then discarded, and the actuators of
+       * all the robots using that controller are initialized with
+       * InitFromConfiguration() instead of CCI_Actuator::Init(). The XML is then
+       * parsed once rather than once per robot. This method must not use
+       * the robot, since SetRobot() is not called.
+       * The default implementation returns <tt>NULL</tt>, in which case each
+       * actuator parses its XML configuration in CCI_Actuator::Init().
+       * @param t_tree The XML configuration of the actuator.
+       * @return The parsed configuration, owned by the caller, or <tt>NULL</tt>.
+       * @see InitFromConfiguration()
+       * @see CControllableEntity::SetController()
+       */
+      virtual SConfiguration* ParseConfiguration(TConfigurationNode& t_tree) {
+         return NULL;
+      }
+
+      /**
+       * Initializes the actuator from a configuration returned by ParseConfiguration().
+       * This method is called right after SetRobot(), in place of CCI_Actuator::Init().
+       * The default implementation throws, as it must be overridden by the
+       * actuators that implement ParseConfiguration().
+       * @param s_config The parsed configuration.
+       * @see ParseConfiguration()
+       */
+      virtual void InitFromConfiguration(const SConfiguration& s_config) {
+         THROW_ARGOSEXCEPTION("BUG: InitFromConfiguration() called on an actuator that does not implement it");
+      }
+
       /**
        * Updates the state of the entity associated to this actuator.
        */
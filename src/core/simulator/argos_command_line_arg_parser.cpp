@@ -14,6 +14,7 @@ namespace argos {
 
    CARGoSCommandLineArgParser::CARGoSCommandLineArgParser() :
       m_eAction(ACTION_UNKNOWN),
+      m_unBatchWorkers(0),
       m_pcInitLogStream(NULL),
       m_pcInitLogErrStream(NULL) {
       AddFlag(
@@ -40,12 +41,36 @@ namespace argos {
          "the experiment XML configuration file",
          m_strExperimentConfigFile
          );
+      AddArgument<std::string>(
+         'b',
+         "batch",
+         "run the trials listed in the file on the experiment [OPTIONAL]",
+         m_strBatchFile
+         );
+      AddArgument<std::string>(
+         'o',
+         "batch-output",
+         "write the batch results to file [OPTIONAL]",
+         m_strBatchOutputFile
+         );
+      AddArgument<UInt32>(
+         'j',
+         "batch-workers",
+         "run the batch trials in N forked worker processes [OPTIONAL]",
+         m_unBatchWorkers
+         );
       AddArgument<std::string>(
          'q',
          "query",
          "query the available plugins",
          m_strQuery
          );
+      AddArgument<std::string>(
+         'm',
+         "plugin-manifest",
+         "write the manifest of the available plugins to file",
+         m_strPluginManifestFile
+         );
       AddArgument<std::string>(
          'l',
          "log-file",
@@ -106,27 +131,45 @@ namespace argos {
          LOGERR.GetStream().rdbuf(m_cLogErrFile.rdbuf());
       }
 
-      /* Check that either -h, -v, -c or -q was passed (strictly one of them) */
+      /* Check that either -h, -v, -c, -q or -m was passed (strictly one of them) */
       UInt32 nOptionsOn = 0;
       if(m_strExperimentConfigFile != "") ++nOptionsOn;
       if(m_strQuery != "") ++nOptionsOn;
+      if(m_strPluginManifestFile != "") ++nOptionsOn;
       if(m_bHelpWanted) ++nOptionsOn;
       if(m_bVersionWanted) ++nOptionsOn;
       if(nOptionsOn == 0) {
-         THROW_ARGOSEXCEPTION("No --help, --version, --config-file or --query options specified.");
+         THROW_ARGOSEXCEPTION("No --help, --version, --config-file, --query or --plugin-manifest options specified.");
       }
       if(nOptionsOn > 1) {
-         THROW_ARGOSEXCEPTION("Options --help, --version, --config-file and --query are mutually exclusive.");
+         THROW_ARGOSEXCEPTION("Options --help, --version, --config-file, --query and --plugin-manifest are mutually exclusive.");
       }
 
       if(m_strExperimentConfigFile != "") {
          m_eAction = ACTION_RUN_EXPERIMENT;
       }
 
+      if(m_strBatchFile != "") {
+         if(m_eAction != ACTION_RUN_EXPERIMENT) {
+            THROW_ARGOSEXCEPTION("Option --batch requires --config-file.");
+         }
+         m_eAction = ACTION_RUN_BATCH;
+         if(m_strBatchOutputFile == "") {
+            m_strBatchOutputFile = m_strBatchFile + ".results";
+         }
+      }
+      else if(m_strBatchOutputFile != "" || m_unBatchWorkers > 0) {
+         THROW_ARGOSEXCEPTION("Options --batch-output and --batch-workers require --batch.");
+      }
+
       if(m_strQuery != "") {
          m_eAction = ACTION_QUERY;
       }
 
+      if(m_strPluginManifestFile != "") {
+         m_eAction = ACTION_WRITE_PLUGIN_MANIFEST;
+      }
+
       if(m_bHelpWanted) {
          m_eAction = ACTION_SHOW_HELP;
       }
@@ -150,15 +193,34 @@ namespace argos {
       c_log << "   -v       | --version               display ARGoS version and release" << std::endl;
       c_log << "   -c FILE  | --config-file FILE      the experiment XML configuration file" << std::endl;
       c_log << "   -q QUERY | --query QUERY           query the available plugins." << std::endl;
+      c_log << "   -m FILE  | --plugin-manifest FILE  write the plugin manifest to FILE" << std::endl;
+      c_log << "   -b FILE  | --batch FILE            run the trials in FILE on the experiment [OPTIONAL]" << std::endl;
+      c_log << "   -o FILE  | --batch-output FILE     write the batch results to FILE [OPTIONAL]" << std::endl;
+      c_log << "   -j N     | --batch-workers N       run the batch trials in N processes [OPTIONAL]" << std::endl;
       c_log << "   -n       | --no-color              do not use colored output [OPTIONAL]" << std::endl;
       c_log << "   -l       | --log-file FILE         redirect LOG to FILE [OPTIONAL]" << std::endl;
       c_log << "   -e       | --logerr-file FILE      redirect LOGERR to FILE [OPTIONAL]" << std::endl << std::endl;
       c_log << "The options --config-file and --query are mutually exclusive. Either you use" << std::endl;
       c_log << "the first, and thus you run an experiment, or you use the second to query the" << std::endl;
       c_log << "plugins." << std::endl << std::endl;
+      c_log << "When running an experiment, the plugins are loaded on demand using the" << std::endl;
+      c_log << "manifests found in the plugin directories. --plugin-manifest loads all the" << std::endl;
+      c_log << "plugins and writes a manifest that lists which library provides each of them." << std::endl << std::endl;
       c_log << "EXAMPLES" << std::endl << std::endl;
       c_log << "To run an experiment, type:" << std::endl << std::endl;
       c_log << "   argos3 -c /path/to/myconfig.argos" << std::endl << std::endl;
+      c_log << "To run many trials of an experiment in a single process, type:" << std::endl << std::endl;
+      c_log << "   argos3 -c /path/to/myconfig.argos -b /path/to/trials.txt" << std::endl << std::endl;
+      c_log << "Each line of the trials file sets up a trial, e.g.:" << std::endl << std::endl;
+      c_log << "   seed=42 length=30 loop_functions/params@food_items=20" << std::endl << std::endl;
+      c_log << "The experiment is loaded once and reset before each trial. Only the" << std::endl;
+      c_log << "<loop_functions> section and the <params> section of the controllers can be" << std::endl;
+      c_log << "overridden: the former is passed to the ReadTrialConfiguration() method of" << std::endl;
+      c_log << "the loop functions, the latter reinitializes the controllers. The results are" << std::endl;
+      c_log << "written to trials.txt.results, unless --batch-output is given. With" << std::endl;
+      c_log << "--batch-workers N, the loaded experiment is forked into N worker processes" << std::endl;
+      c_log << "that run the trials in parallel; this requires threads=\"0\" in <system>." << std::endl;
+      c_log << "If a worker dies, its trial is run once more in a new worker." << std::endl << std::endl;
       c_log << "To query the plugins, type:" << std::endl << std::endl;
       c_log << "   argos3 -q QUERY" << std::endl << std::endl;
       c_log << "where QUERY can have the following values:" << std::endl << std::endl;
@@ -34,7 +34,9 @@ namespace argos {
          ACTION_SHOW_HELP,
          ACTION_SHOW_VERSION,
          ACTION_RUN_EXPERIMENT,
-         ACTION_QUERY
+         ACTION_RUN_BATCH,
+         ACTION_QUERY,
+         ACTION_WRITE_PLUGIN_MANIFEST
       };
 
    public:
@@ -98,6 +100,38 @@ namespace argos {
          return m_strExperimentConfigFile;
       }
 
+      /**
+       * Returns the batch trials file as parsed by Parse().
+       * The returned value is meaningful only if GetAction() returns ACTION_RUN_BATCH.
+       * @return The batch trials file as parsed by Parse().
+       * @see Parse()
+       * @see CBatchRunner
+       */
+      inline const std::string& GetBatchFile() {
+         return m_strBatchFile;
+      }
+
+      /**
+       * Returns the batch results file as parsed by Parse().
+       * If no file was specified, the trials file name followed by <tt>.results</tt> is returned.
+       * The returned value is meaningful only if GetAction() returns ACTION_RUN_BATCH.
+       * @return The batch results file as parsed by Parse().
+       * @see Parse()
+       */
+      inline const std::string& GetBatchOutputFile() {
+         return m_strBatchOutputFile;
+      }
+
+      /**
+       * Returns the number of batch worker processes as parsed by Parse().
+       * The returned value is meaningful only if GetAction() returns ACTION_RUN_BATCH.
+       * @return The number of batch worker processes; 0 means the trials run in this process.
+       * @see Parse()
+       */
+      inline UInt32 GetBatchWorkers() {
+         return m_unBatchWorkers;
+      }
+
       /**
        * Returns the query on the plugins as parsed by Parse().
        * The returned value is meaningful only if GetAction() returns ACTION_QUERY.
@@ -108,6 +142,16 @@ namespace argos {
          return m_strQuery;
       }
 
+      /**
+       * Returns the plugin manifest file as parsed by Parse().
+       * The returned value is meaningful only if GetAction() returns ACTION_WRITE_PLUGIN_MANIFEST.
+       * @return The plugin manifest file as parsed by Parse().
+       * @see Parse()
+       */
+      inline const std::string& GetPluginManifestFile() {
+         return m_strPluginManifestFile;
+      }
+
       /**
        * Returns <tt>true</tt> if color is enabled for LOG and LOGERR.
        * @see Parse()
@@ -134,6 +178,10 @@ namespace argos {
       EAction m_eAction;
       std::string m_strExperimentConfigFile;
       std::string m_strQuery;
+      std::string m_strPluginManifestFile;
+      std::string m_strBatchFile;
+      std::string m_strBatchOutputFile;
+      UInt32 m_unBatchWorkers;
       std::string m_strLogFileName;
       std::ofstream m_cLogFile;
       std::streambuf* m_pcInitLogStream;
@@ -0,0 +1,652 @@
+/**
+ * @file <argos3/core/simulator/batch_runner.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "batch_runner.h"
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/loop_functions.h>
+#include <argos3/core/simulator/entity/controllable_entity.h>
+#include <argos3/core/utility/string_utilities.h>
+#include <argos3/core/utility/logging/argos_log.h>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <sys/time.h>
+#include <sys/select.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <signal.h>
+#include <cerrno>
+#include <cstring>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   CBatchRunner::CBatchRunner(CSimulator& c_simulator) :
+      m_cSimulator(c_simulator),
+      m_unDefaultMaxSimulationClock(c_simulator.GetMaxSimulationClock()),
+      m_bLoopFunctionsOverridden(false) {}
+
+   /****************************************/
+   /****************************************/
+
+   /**
+    * Returns the name of an element of an override path, without the id.
+    */
+   static std::string GetElementName(const std::string& str_element) {
+      return str_element.substr(0, str_element.find('['));
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CBatchRunner::STrial CBatchRunner::ParseTrial(const std::string& str_line) {
+      STrial sTrial;
+      std::vector<std::string> vecSettings;
+      Tokenize(str_line, vecSettings, " \t\r");
+      for(size_t i = 0; i < vecSettings.size(); ++i) {
+         size_t unEqual = vecSettings[i].find('=');
+         if(unEqual == std::string::npos || unEqual == 0) {
+            THROW_ARGOSEXCEPTION("Invalid trial setting \"" << vecSettings[i] << "\": expected KEY=VALUE.");
+         }
+         std::string strKey = vecSettings[i].substr(0, unEqual);
+         std::string strValue = vecSettings[i].substr(unEqual + 1);
+         if(strKey == "seed") {
+            sTrial.HasRandomSeed = true;
+            sTrial.RandomSeed = FromString<UInt32>(strValue);
+         }
+         else if(strKey == "length") {
+            sTrial.HasLength = true;
+            sTrial.Length = FromString<Real>(strValue);
+         }
+         else {
+            size_t unAt = strKey.rfind('@');
+            if(unAt == std::string::npos || unAt == 0 || unAt == strKey.size() - 1) {
+               THROW_ARGOSEXCEPTION("Invalid trial setting \"" << vecSettings[i] << "\": expected seed=N, length=S or PATH@ATTRIBUTE=VALUE.");
+            }
+            SOverride sOverride;
+            sOverride.Path = strKey.substr(0, unAt);
+            /* Only the components that can read their configuration again can be overridden */
+            std::vector<std::string> vecElements;
+            Tokenize(sOverride.Path, vecElements, "/");
+            if(vecElements.empty() ||
+               (GetElementName(vecElements[0]) != "loop_functions" &&
+                (GetElementName(vecElements[0]) != "controllers" ||
+                 vecElements.size() < 3 ||
+                 GetElementName(vecElements[2]) != "params"))) {
+               THROW_ARGOSEXCEPTION("Invalid trial setting \"" << vecSettings[i] << "\": the experiment is not reloaded between trials, so only the <loop_functions> section and the <params> section of a controller can be overridden.");
+            }
+            sOverride.Attribute = strKey.substr(unAt + 1);
+            sOverride.Value = strValue;
+            sTrial.Overrides.push_back(sOverride);
+         }
+      }
+      return sTrial;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CBatchRunner::LoadTrials(const std::string& str_file_name) {
+      std::ifstream cInput(str_file_name.c_str());
+      if(cInput.fail()) {
+         THROW_ARGOSEXCEPTION("Error opening file \"" << str_file_name << "\"");
+      }
+      std::string strLine;
+      UInt32 unLine = 0;
+      while(std::getline(cInput, strLine)) {
+         ++unLine;
+         size_t unStart = strLine.find_first_not_of(" \t\r");
+         if(unStart == std::string::npos || strLine[unStart] == '#') continue;
+         try {
+            m_vecTrials.push_back(ParseTrial(strLine));
+         }
+         catch(CARGoSException& ex) {
+            THROW_ARGOSEXCEPTION_NESTED("Error parsing line " << unLine << " of \"" << str_file_name << "\"", ex);
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CBatchRunner::Run(std::ostream& c_output,
+                          UInt32 un_workers) {
+      if(un_workers > 1 && m_vecTrials.size() > 1) {
+         RunForked(c_output, un_workers);
+         return;
+      }
+      LOG << "[INFO] Running " << m_vecTrials.size() << " trials" << std::endl;
+      c_output << "# trial seed clock wall_time results" << std::endl;
+      for(size_t i = 0; i < m_vecTrials.size(); ++i) {
+         try {
+            RunTrial(m_vecTrials[i], i, c_output);
+         }
+         catch(CARGoSException& ex) {
+            RestoreOverrides();
+            THROW_ARGOSEXCEPTION_NESTED("Error running trial " << i, ex);
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   /**
+    * Writes the whole buffer to the given file descriptor.
+    * @return <tt>false</tt> in case of error.
+    */
+   static bool WriteAll(int n_fd,
+                        const std::string& str_data) {
+      size_t unWritten = 0;
+      while(unWritten < str_data.size()) {
+         ssize_t nRes = ::write(n_fd, str_data.c_str() + unWritten, str_data.size() - unWritten);
+         if(nRes < 0) {
+            if(errno == EINTR) continue;
+            return false;
+         }
+         unWritten += nRes;
+      }
+      return true;
+   }
+
+   /**
+    * Reads a newline-terminated line from the given file descriptor.
+    * @return <tt>false</tt> at end of file or in case of error.
+    */
+   static bool ReadLine(int n_fd,
+                        std::string& str_line) {
+      str_line.clear();
+      char chRead;
+      while(true) {
+         ssize_t nRes = ::read(n_fd, &chRead, 1);
+         if(nRes < 0 && errno == EINTR) continue;
+         if(nRes <= 0) return false;
+         if(chRead == '\n') return true;
+         str_line += chRead;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   /**
+    * A worker process of the fork-server pool.
+    */
+   struct SBatchWorker {
+      /** The process id */
+      pid_t Pid;
+      /** The parent end of the pipe the trial numbers are sent through */
+      int TaskFD;
+      /** The parent end of the pipe the results are received from */
+      int ResultFD;
+      /** The trial being run, or -1 if the worker is idle */
+      SInt32 Trial;
+      /** The results received so far */
+      std::string Buffer;
+   };
+
+   /****************************************/
+   /****************************************/
+
+   /**
+    * The worker processes of a forked batch run.
+    * <p>
+    * SIGPIPE is ignored while the pool exists, since a worker could die
+    * right before a trial is sent to it. When the pool is destroyed, the
+    * workers still in it are killed and reaped, and the SIGPIPE handler
+    * is restored, so an error that interrupts the run leaves no process
+    * behind.
+    * </p>
+    */
+   class CBatchWorkerPool {
+
+   public:
+
+      CBatchWorkerPool() :
+         m_ptOldSigPipe(::signal(SIGPIPE, SIG_IGN)) {}
+
+      ~CBatchWorkerPool() {
+         for(size_t i = 0; i < m_vecWorkers.size(); ++i) {
+            ::kill(m_vecWorkers[i].Pid, SIGKILL);
+         }
+         Close();
+         ::signal(SIGPIPE, m_ptOldSigPipe);
+      }
+
+      inline std::vector<SBatchWorker>& GetWorkers() {
+         return m_vecWorkers;
+      }
+
+      inline void Add(const SBatchWorker& s_worker) {
+         m_vecWorkers.push_back(s_worker);
+      }
+
+      /**
+       * Closes the pipes of a worker and waits for it to exit.
+       * The worker quits when its task pipe is closed.
+       */
+      void Remove(size_t un_worker) {
+         ::close(m_vecWorkers[un_worker].TaskFD);
+         ::close(m_vecWorkers[un_worker].ResultFD);
+         while(::waitpid(m_vecWorkers[un_worker].Pid, NULL, 0) < 0 && errno == EINTR);
+         m_vecWorkers.erase(m_vecWorkers.begin() + un_worker);
+      }
+
+      /**
+       * Closes the pipes of all the workers and waits for them to exit.
+       */
+      void Close() {
+         for(size_t i = 0; i < m_vecWorkers.size(); ++i) {
+            ::close(m_vecWorkers[i].TaskFD);
+            ::close(m_vecWorkers[i].ResultFD);
+         }
+         for(size_t i = 0; i < m_vecWorkers.size(); ++i) {
+            while(::waitpid(m_vecWorkers[i].Pid, NULL, 0) < 0 && errno == EINTR);
+         }
+         m_vecWorkers.clear();
+      }
+
+   private:
+
+      std::vector<SBatchWorker> m_vecWorkers;
+      void (*m_ptOldSigPipe)(int);
+
+   };
+
+   /****************************************/
+   /****************************************/
+
+   /* How many times a trial is sent to a worker before giving up */
+   static const UInt32 BATCH_MAX_ATTEMPTS = 2;
+
+   void CBatchRunner::RunForked(std::ostream& c_output,
+                                UInt32 un_workers) {
+      if(m_cSimulator.GetNumThreads() > 0) {
+         THROW_ARGOSEXCEPTION("Running batch trials in worker processes requires threads=\"0\" in the <system> section.");
+      }
+      un_workers = Min<UInt32>(un_workers, m_vecTrials.size());
+      LOG << "[INFO] Running " << m_vecTrials.size() << " trials in " << un_workers << " worker processes" << std::endl;
+      c_output << "# trial seed clock wall_time results" << std::endl;
+      CBatchWorkerPool cPool;
+      std::vector<SBatchWorker>& vecWorkers = cPool.GetWorkers();
+      /* The trials of the workers that died, to be sent again */
+      std::vector<UInt32> vecRetries;
+      std::vector<UInt32> vecAttempts(m_vecTrials.size(), 0);
+      std::vector<std::string> vecFailures;
+      size_t unNextTrial = 0;
+      size_t unBusy = 0;
+      char pchBuffer[4096];
+      while(unNextTrial < m_vecTrials.size() || !vecRetries.empty() || unBusy > 0) {
+         size_t unPending = m_vecTrials.size() - unNextTrial + vecRetries.size();
+         /* Fork workers, also to replace those that quit, while there are trials for them */
+         while(vecWorkers.size() < un_workers &&
+               vecWorkers.size() - unBusy < unPending) {
+            /* Flush the buffered output, or the worker would write it again */
+            c_output.flush();
+            LOG.Flush();
+            LOGERR.Flush();
+            LOG.GetStream().flush();
+            LOGERR.GetStream().flush();
+            int pnTaskPipe[2], pnResultPipe[2];
+            if(::pipe(pnTaskPipe) != 0) {
+               THROW_ARGOSEXCEPTION("Error creating worker pipe: " << ::strerror(errno));
+            }
+            if(::pipe(pnResultPipe) != 0) {
+               ::close(pnTaskPipe[0]);
+               ::close(pnTaskPipe[1]);
+               THROW_ARGOSEXCEPTION("Error creating worker pipe: " << ::strerror(errno));
+            }
+            pid_t tPid = ::fork();
+            if(tPid < 0) {
+               ::close(pnTaskPipe[0]);
+               ::close(pnTaskPipe[1]);
+               ::close(pnResultPipe[0]);
+               ::close(pnResultPipe[1]);
+               THROW_ARGOSEXCEPTION("Error forking worker process: " << ::strerror(errno));
+            }
+            if(tPid == 0) {
+               /* Worker: close the ends of the parent, including those of the other workers */
+               for(size_t j = 0; j < vecWorkers.size(); ++j) {
+                  ::close(vecWorkers[j].TaskFD);
+                  ::close(vecWorkers[j].ResultFD);
+               }
+               ::close(pnTaskPipe[1]);
+               ::close(pnResultPipe[0]);
+               int nStatus = 1;
+               try {
+                  nStatus = RunWorker(pnTaskPipe[0], pnResultPipe[1]);
+               }
+               catch(...) {
+                  /* The exception must not reach the stack of the parent */
+               }
+               LOG.Flush();
+               LOGERR.Flush();
+               LOG.GetStream().flush();
+               LOGERR.GetStream().flush();
+               /* Skip the destructors, they belong to the parent */
+               ::_exit(nStatus);
+            }
+            /* Parent */
+            ::close(pnTaskPipe[0]);
+            ::close(pnResultPipe[1]);
+            SBatchWorker sWorker;
+            sWorker.Pid = tPid;
+            sWorker.TaskFD = pnTaskPipe[1];
+            sWorker.ResultFD = pnResultPipe[0];
+            sWorker.Trial = -1;
+            cPool.Add(sWorker);
+         }
+         /* Send the pending trials to the idle workers, the retries first */
+         std::vector<size_t> vecQuit;
+         for(size_t i = 0; i < vecWorkers.size(); ++i) {
+            if(vecWorkers[i].Trial >= 0) continue;
+            UInt32 unTrial;
+            if(!vecRetries.empty()) {
+               unTrial = vecRetries.back();
+               vecRetries.pop_back();
+            }
+            else if(unNextTrial < m_vecTrials.size()) {
+               unTrial = unNextTrial;
+               ++unNextTrial;
+            }
+            else {
+               break;
+            }
+            ++vecAttempts[unTrial];
+            if(WriteAll(vecWorkers[i].TaskFD, ToString(unTrial) + "\n")) {
+               vecWorkers[i].Trial = unTrial;
+               ++unBusy;
+            }
+            else {
+               /* The worker died while idle */
+               vecQuit.push_back(i);
+               if(vecAttempts[unTrial] < BATCH_MAX_ATTEMPTS) {
+                  vecRetries.push_back(unTrial);
+               }
+               else {
+                  vecFailures.push_back("Trial " + ToString(unTrial) + ": the worker processes died " + ToString(vecAttempts[unTrial]) + " times");
+               }
+            }
+         }
+         if(unBusy > 0) {
+            /* Wait for results */
+            fd_set tReadFDs;
+            FD_ZERO(&tReadFDs);
+            int nMaxFD = -1;
+            for(size_t i = 0; i < vecWorkers.size(); ++i) {
+               if(vecWorkers[i].Trial >= 0) {
+                  FD_SET(vecWorkers[i].ResultFD, &tReadFDs);
+                  nMaxFD = Max(nMaxFD, vecWorkers[i].ResultFD);
+               }
+            }
+            int nReady = ::select(nMaxFD + 1, &tReadFDs, NULL, NULL, NULL);
+            if(nReady < 0 && errno != EINTR) {
+               THROW_ARGOSEXCEPTION("Error waiting for the worker processes: " << ::strerror(errno));
+            }
+            for(size_t i = 0; nReady > 0 && i < vecWorkers.size(); ++i) {
+               SBatchWorker& sWorker = vecWorkers[i];
+               if(sWorker.Trial < 0 || !FD_ISSET(sWorker.ResultFD, &tReadFDs)) continue;
+               ssize_t nRead = ::read(sWorker.ResultFD, pchBuffer, sizeof(pchBuffer));
+               if(nRead < 0 && errno == EINTR) continue;
+               if(nRead <= 0) {
+                  /* The worker died: send its trial again, unless it keeps killing the workers */
+                  UInt32 unTrial = sWorker.Trial;
+                  if(vecAttempts[unTrial] < BATCH_MAX_ATTEMPTS) {
+                     LOGERR << "[WARNING] Worker " << sWorker.Pid << " died while running trial " << unTrial << ", running it again" << std::endl;
+                     vecRetries.push_back(unTrial);
+                  }
+                  else {
+                     vecFailures.push_back("Trial " + ToString(unTrial) + ": the worker processes died " + ToString(vecAttempts[unTrial]) + " times");
+                  }
+                  sWorker.Trial = -1;
+                  --unBusy;
+                  vecQuit.push_back(i);
+                  continue;
+               }
+               sWorker.Buffer.append(pchBuffer, nRead);
+               size_t unNewLine = sWorker.Buffer.find('\n');
+               if(unNewLine == std::string::npos) continue;
+               std::string strLine = sWorker.Buffer.substr(0, unNewLine);
+               sWorker.Buffer.erase(0, unNewLine + 1);
+               sWorker.Trial = -1;
+               --unBusy;
+               if(!strLine.empty() && strLine[0] == '!') {
+                  /* The trial failed and the worker quit */
+                  vecFailures.push_back(strLine.substr(1));
+                  vecQuit.push_back(i);
+                  continue;
+               }
+               c_output << strLine << std::endl;
+            }
+         }
+         /* Reap the workers that quit; they are replaced at the next iteration */
+         std::sort(vecQuit.begin(), vecQuit.end());
+         for(size_t i = vecQuit.size(); i > 0; --i) {
+            cPool.Remove(vecQuit[i - 1]);
+         }
+      }
+      /* Tell the workers to quit and wait for them */
+      cPool.Close();
+      /* Report errors */
+      if(!vecFailures.empty()) {
+         std::ostringstream ossMsg;
+         ossMsg << "Error running batch trials in worker processes:";
+         for(size_t i = 0; i < vecFailures.size(); ++i) {
+            ossMsg << std::endl << "   " << vecFailures[i];
+         }
+         THROW_ARGOSEXCEPTION(ossMsg.str());
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   int CBatchRunner::RunWorker(int n_task_fd,
+                               int n_result_fd) {
+      std::string strTask;
+      while(ReadLine(n_task_fd, strTask)) {
+         UInt32 unTrial = FromString<UInt32>(strTask);
+         std::ostringstream ossResults;
+         try {
+            RunTrial(m_vecTrials[unTrial], unTrial, ossResults);
+         }
+         catch(std::exception& ex) {
+            RestoreOverrides();
+            /* The simulator state is unknown, quit after reporting the error */
+            std::string strError = ex.what();
+            std::replace(strError.begin(), strError.end(), '\n', ' ');
+            WriteAll(n_result_fd, "!Trial " + ToString(unTrial) + ": " + strError + "\n");
+            return 1;
+         }
+         if(!WriteAll(n_result_fd, ossResults.str())) return 1;
+      }
+      return 0;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CBatchRunner::RunTrial(const STrial& s_trial,
+                               UInt32 un_trial,
+                               std::ostream& c_output) {
+      /* Set up the trial */
+      ApplyOverrides(s_trial);
+      if(s_trial.HasLength) {
+         m_cSimulator.SetMaxSimulationClock(
+            s_trial.Length * CPhysicsEngine::GetInverseSimulationClockTick());
+      }
+      else {
+         m_cSimulator.SetMaxSimulationClock(m_unDefaultMaxSimulationClock);
+      }
+      if(s_trial.HasRandomSeed) {
+         m_cSimulator.Reset(s_trial.RandomSeed);
+      }
+      else {
+         m_cSimulator.Reset();
+      }
+      /* Run the trial */
+      ::timeval tStart, tEnd, tElapsed;
+      ::gettimeofday(&tStart, NULL);
+      while(!m_cSimulator.IsExperimentFinished()) {
+         m_cSimulator.UpdateSpace();
+      }
+      m_cSimulator.GetLoopFunctions().PostExperiment();
+      ::gettimeofday(&tEnd, NULL);
+      timersub(&tEnd, &tStart, &tElapsed);
+      /* Write the results */
+      c_output << un_trial << " "
+               << m_cSimulator.GetRandomSeed() << " "
+               << m_cSimulator.GetSpace().GetSimulationClock() << " "
+               << tElapsed.tv_sec << "." << std::setw(6) << std::setfill('0') << tElapsed.tv_usec
+               << std::setfill(' ');
+      std::ostringstream cResults;
+      m_cSimulator.GetLoopFunctions().WriteTrialResults(cResults);
+      if(!cResults.str().empty()) {
+         c_output << " " << cResults.str();
+      }
+      c_output << std::endl;
+      /* Undo the configuration overrides */
+      RestoreOverrides();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   TConfigurationNode& CBatchRunner::GetOverrideNode(const std::string& str_path) {
+      TConfigurationNode* ptNode = &m_cSimulator.GetConfigurationRoot();
+      std::vector<std::string> vecElements;
+      Tokenize(str_path, vecElements, "/");
+      for(size_t i = 0; i < vecElements.size(); ++i) {
+         /* Split "name[id]" */
+         std::string strName = vecElements[i];
+         std::string strId;
+         size_t unBracket = strName.find('[');
+         if(unBracket != std::string::npos) {
+            if(strName[strName.size() - 1] != ']') {
+               THROW_ARGOSEXCEPTION("Invalid element \"" << vecElements[i] << "\" in path \"" << str_path << "\".");
+            }
+            strId = strName.substr(unBracket + 1, strName.size() - unBracket - 2);
+            strName = strName.substr(0, unBracket);
+         }
+         /* Look for the matching child */
+         TConfigurationNode* ptChild = NULL;
+         TConfigurationNodeIterator itChild;
+         for(itChild = itChild.begin(ptNode);
+             itChild != itChild.end() && ptChild == NULL;
+             ++itChild) {
+            if(itChild->Value() == strName) {
+               if(strId.empty()) {
+                  ptChild = &*itChild;
+               }
+               else if(NodeAttributeExists(*itChild, "id")) {
+                  std::string strChildId;
+                  GetNodeAttribute(*itChild, "id", strChildId);
+                  if(strChildId == strId) ptChild = &*itChild;
+               }
+            }
+         }
+         if(ptChild == NULL) {
+            THROW_ARGOSEXCEPTION("Element \"" << vecElements[i] << "\" in path \"" << str_path << "\" not found.");
+         }
+         ptNode = ptChild;
+      }
+      return *ptNode;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CBatchRunner::ApplyOverrides(const STrial& s_trial) {
+      for(size_t i = 0; i < s_trial.Overrides.size(); ++i) {
+         const SOverride& sOverride = s_trial.Overrides[i];
+         /* Remember which component must read its configuration again */
+         std::vector<std::string> vecElements;
+         Tokenize(sOverride.Path, vecElements, "/");
+         if(GetElementName(vecElements[0]) == "loop_functions") {
+            m_bLoopFunctionsOverridden = true;
+         }
+         else {
+            TConfigurationNode* ptParams =
+               &GetOverrideNode(vecElements[0] + "/" + vecElements[1] + "/" + vecElements[2]);
+            if(std::find(m_vecOverriddenControllers.begin(),
+                         m_vecOverriddenControllers.end(),
+                         ptParams) == m_vecOverriddenControllers.end()) {
+               m_vecOverriddenControllers.push_back(ptParams);
+            }
+         }
+         SSavedAttribute sSaved;
+         sSaved.Node = &GetOverrideNode(sOverride.Path);
+         sSaved.Attribute = sOverride.Attribute;
+         sSaved.Existed = NodeAttributeExists(*sSaved.Node, sOverride.Attribute);
+         if(sSaved.Existed) {
+            GetNodeAttribute(*sSaved.Node, sOverride.Attribute, sSaved.Value);
+         }
+         m_vecSavedAttributes.push_back(sSaved);
+         SetNodeAttribute(*sSaved.Node, sOverride.Attribute, sOverride.Value);
+      }
+      ReadComponentConfigurations();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CBatchRunner::RestoreOverrides() {
+      /* Restore in reverse order, in case an attribute was overridden twice */
+      while(!m_vecSavedAttributes.empty()) {
+         const SSavedAttribute& sSaved = m_vecSavedAttributes.back();
+         if(sSaved.Existed) {
+            SetNodeAttribute(*sSaved.Node, sSaved.Attribute, sSaved.Value);
+         }
+         else {
+            sSaved.Node->RemoveAttribute(sSaved.Attribute);
+         }
+         m_vecSavedAttributes.pop_back();
+      }
+      /* Let the overridden components go back to the original configuration */
+      try {
+         ReadComponentConfigurations();
+      }
+      catch(CARGoSException&) {
+         m_bLoopFunctionsOverridden = false;
+         m_vecOverriddenControllers.clear();
+         throw;
+      }
+      m_bLoopFunctionsOverridden = false;
+      m_vecOverriddenControllers.clear();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CBatchRunner::ReadComponentConfigurations() {
+      if(m_bLoopFunctionsOverridden) {
+         m_cSimulator.GetLoopFunctions().ReadTrialConfiguration(
+            GetNode(m_cSimulator.GetConfigurationRoot(), "loop_functions"));
+      }
+      if(m_vecOverriddenControllers.empty()) return;
+      CSpace::TMapPerTypePerId& tEntities = m_cSimulator.GetSpace().GetEntityMapPerTypePerId();
+      CSpace::TMapPerTypePerId::iterator itControllables = tEntities.find("controller");
+      if(itControllables == tEntities.end()) return;
+      for(CSpace::TMapPerType::iterator it = itControllables->second.begin();
+          it != itControllables->second.end();
+          ++it) {
+         CControllableEntity* pcControllable = any_cast<CControllableEntity*>(it->second);
+         for(size_t i = 0; i < m_vecOverriddenControllers.size(); ++i) {
+            /* Compare the XML nodes, not their wrappers */
+            if(pcControllable->GetControllerConfig() == *m_vecOverriddenControllers[i]) {
+               pcControllable->ReinitController();
+               break;
+            }
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
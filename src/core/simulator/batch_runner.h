@@ -0,0 +1,238 @@
+/**
+ * @file <argos3/core/simulator/batch_runner.h>
+ *
+ * @brief This file provides the definition of the batch runner.
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+namespace argos {
+   class CBatchRunner;
+   class CSimulator;
+}
+
+#include <argos3/core/utility/configuration/argos_configuration.h>
+#include <string>
+#include <vector>
+#include <ostream>
+
+namespace argos {
+
+   /**
+    * Runs many trials of an experiment in a single process.
+    * <p>
+    * The experiment is loaded once with CSimulator::LoadExperiment(). Each
+    * trial resets the simulator with CSimulator::Reset() instead of
+    * rebuilding it, so plugins stay loaded, entities are not recreated and
+    * the thread pool of the space stays alive.
+    * </p>
+    * <p>
+    * A trial is described by a line of space-separated settings:
+    * </p>
+    * <ul>
+    * <li><tt>seed=N</tt> resets the simulator with the random seed <tt>N</tt>;
+    * <li><tt>length=S</tt> sets the experiment length to <tt>S</tt> seconds (0 means unlimited);
+    * <li><tt>PATH\@ATTRIBUTE=VALUE</tt> sets an attribute of the XML configuration.
+    * </ul>
+    * <p>
+    * <tt>PATH</tt> is a list of element names separated by <tt>/</tt>,
+    * starting below <tt>&lt;argos-configuration&gt;</tt>; an element name
+    * can be followed by <tt>[ID]</tt> to select the element whose
+    * <tt>id</tt> attribute is <tt>ID</tt>. For example:
+    * </p>
+    * <code>
+    *    seed=42 length=30 loop_functions/params@food_items=20 controllers/lua_controller[fb]/params@alpha=0.5
+    * </code>
+    * <p>
+    * Since the experiment is not reloaded, only the components that can
+    * read their configuration again can be overridden, and a trial that
+    * overrides anything else is rejected:
+    * </p>
+    * <ul>
+    * <li>the <tt>&lt;loop_functions&gt;</tt> section is passed to
+    *     CLoopFunctions::ReadTrialConfiguration() before Reset();
+    * <li>the <tt>&lt;params&gt;</tt> section of a controller is passed to
+    *     the controllers of the robots that use it, which are destroyed and
+    *     initialized again with CControllableEntity::ReinitController().
+    *     Robots with their own <tt>&lt;params&gt;</tt> section are not affected.
+    * </ul>
+    * <p>
+    * The overrides are undone at the end of each trial, and the same
+    * components read their configuration again. Empty lines and lines
+    * starting with <tt>#</tt> are ignored.
+    * </p>
+    * <p>
+    * For each trial, a line is written to the results stream with the
+    * trial number, the random seed, the final simulation clock, the wall
+    * clock time in seconds and whatever CLoopFunctions::WriteTrialResults()
+    * writes.
+    * </p>
+    * <p>
+    * The trials can also be distributed over a pool of worker processes,
+    * forked after the experiment is loaded. The workers share the memory of
+    * the loaded experiment copy-on-write; each receives the number of the
+    * trial to run over a pipe and sends back its results line. The results
+    * are written in order of completion. Since threads do not survive
+    * fork(), the pool requires <tt>threads="0"</tt> in the
+    * <tt>&lt;system&gt;</tt> section.
+    * </p>
+    * @see CSimulator
+    * @see CLoopFunctions::WriteTrialResults()
+    */
+   class CBatchRunner {
+
+   public:
+
+      /**
+       * An override of an attribute of the XML configuration.
+       */
+      struct SOverride {
+         /** The path of the element */
+         std::string Path;
+         /** The attribute name */
+         std::string Attribute;
+         /** The new value */
+         std::string Value;
+      };
+
+      /**
+       * The settings of a trial.
+       */
+      struct STrial {
+         /** True if the trial sets the random seed */
+         bool HasRandomSeed;
+         /** The random seed */
+         UInt32 RandomSeed;
+         /** True if the trial sets the experiment length */
+         bool HasLength;
+         /** The experiment length in seconds */
+         Real Length;
+         /** The configuration overrides */
+         std::vector<SOverride> Overrides;
+
+         STrial() :
+            HasRandomSeed(false),
+            RandomSeed(0),
+            HasLength(false),
+            Length(0.0) {}
+      };
+
+   public:
+
+      /**
+       * Class constructor.
+       * The experiment must have already been loaded in the simulator.
+       * @param c_simulator The simulator.
+       */
+      CBatchRunner(CSimulator& c_simulator);
+
+      /**
+       * Parses a trial description.
+       * @param str_line The trial description.
+       * @return The trial settings.
+       * @throws CARGoSException if the description is not valid, or if an override cannot take effect.
+       */
+      static STrial ParseTrial(const std::string& str_line);
+
+      /**
+       * Loads the trials from the given file.
+       * The trials are appended to those already loaded.
+       * @param str_file_name The file name.
+       * @throws CARGoSException if the file cannot be read or a trial is not valid.
+       */
+      void LoadTrials(const std::string& str_file_name);
+
+      /**
+       * Adds a trial.
+       * @param s_trial The trial settings.
+       */
+      inline void AddTrial(const STrial& s_trial) {
+         m_vecTrials.push_back(s_trial);
+      }
+
+      /**
+       * Returns the loaded trials.
+       */
+      inline const std::vector<STrial>& GetTrials() const {
+         return m_vecTrials;
+      }
+
+      /**
+       * Runs all the loaded trials.
+       * With less than two workers, the trials are run in order in this
+       * process; otherwise, they are distributed over a pool of forked
+       * worker processes. A worker that quits is replaced, and the trial
+       * of a worker that dies is run once more by another worker.
+       * @param c_output The stream to write the results to.
+       * @param un_workers The number of worker processes.
+       * @throws CARGoSException if a trial fails, or if its workers die twice.
+       */
+      void Run(std::ostream& c_output,
+               UInt32 un_workers = 0);
+
+      /**
+       * Runs a trial.
+       * @param s_trial The trial settings.
+       * @param un_trial The trial number, written in the results.
+       * @param c_output The stream to write the results to.
+       */
+      void RunTrial(const STrial& s_trial,
+                    UInt32 un_trial,
+                    std::ostream& c_output);
+
+   private:
+
+      void RunForked(std::ostream& c_output,
+                     UInt32 un_workers);
+
+      int RunWorker(int n_task_fd,
+                    int n_result_fd);
+
+      TConfigurationNode& GetOverrideNode(const std::string& str_path);
+
+      void ApplyOverrides(const STrial& s_trial);
+
+      void RestoreOverrides();
+
+      void ReadComponentConfigurations();
+
+   private:
+
+      /**
+       * The value of an attribute before it was overridden.
+       */
+      struct SSavedAttribute {
+         TConfigurationNode* Node;
+         std::string Attribute;
+         bool Existed;
+         std::string Value;
+      };
+
+   private:
+
+      /** The simulator */
+      CSimulator& m_cSimulator;
+
+      /** The trials to run */
+      std::vector<STrial> m_vecTrials;
+
+      /** The attribute values to restore at the end of a trial */
+      std::vector<SSavedAttribute> m_vecSavedAttributes;
+
+      /** The maximum simulation clock set in the XML configuration */
+      UInt32 m_unDefaultMaxSimulationClock;
+
+      /** True if the current trial overrides the loop functions configuration */
+      bool m_bLoopFunctionsOverridden;
+
+      /** The controller <tt>&lt;params&gt;</tt> sections overridden by the current trial */
+      std::vector<TConfigurationNode*> m_vecOverriddenControllers;
+
+   };
+
+}
+
+#endif
@@ -10,6 +10,7 @@
 #include <argos3/core/simulator/simulator.h>
 #include <argos3/core/simulator/entity/composable_entity.h>
 #include <argos3/core/simulator/space/space.h>
+#include <argos3/core/utility/math/rng.h>
 
 namespace argos {
 
@@ -18,7 +19,10 @@ namespace argos {
 
    CControllableEntity::CControllableEntity(CComposableEntity* pc_parent) :
       CEntity(pc_parent),
-      m_pcController(NULL) {}
+      m_pcController(NULL),
+      m_ptControllerConfig(NULL),
+      m_pcProfiler(NULL),
+      m_unControllerTimer(0) {}
 
    /****************************************/
    /****************************************/
@@ -26,7 +30,10 @@ namespace argos {
    CControllableEntity::CControllableEntity(CComposableEntity* pc_parent,
                                             const std::string& str_id) :
       CEntity(pc_parent, str_id),
-      m_pcController(NULL) {
+      m_pcController(NULL),
+      m_ptControllerConfig(NULL),
+      m_pcProfiler(NULL),
+      m_unControllerTimer(0) {
    }
 
    /****************************************/
@@ -68,6 +75,48 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CControllableEntity::SaveState(CByteArray& c_buffer) {
+      CEntity::SaveState(c_buffer);
+      SaveMementoMap(m_pcController->GetAllSensors(), c_buffer);
+      SaveMementoMap(m_pcController->GetAllActuators(), c_buffer);
+      CMemento* pcController = dynamic_cast<CMemento*>(m_pcController);
+      if(pcController != NULL) {
+         c_buffer << static_cast<UInt32>(1);
+         SaveStateBlock(*pcController, c_buffer);
+      }
+      else {
+         c_buffer << static_cast<UInt32>(0);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CControllableEntity::LoadState(CByteArray& c_buffer) {
+      try {
+         CEntity::LoadState(c_buffer);
+         m_vecCheckedRays.clear();
+         m_vecIntersectionPoints.clear();
+         CMementoBlockReader cReader(c_buffer);
+         LoadMementoMap(m_pcController->GetAllSensors(), cReader);
+         LoadMementoMap(m_pcController->GetAllActuators(), cReader);
+         if(cReader.ReadUInt32() != 0) {
+            CMemento* pcController = dynamic_cast<CMemento*>(m_pcController);
+            if(pcController == NULL) {
+               THROW_ARGOSEXCEPTION("The controller does not implement CMemento.");
+            }
+            cReader.LoadBlock(*pcController);
+         }
+         c_buffer.Clear();
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("Failed to restore the state of controllable entity \"" << GetId() << "\".", ex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CControllableEntity::Reset() {
       /* Clear rays */
       m_vecCheckedRays.clear();
@@ -145,53 +194,209 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   typedef std::map<std::string, CControllableEntity::SControllerTemplate*> TControllerTemplateMap;
+
+   static TControllerTemplateMap& GetControllerTemplateMap() {
+      static TControllerTemplateMap tMap;
+      return tMap;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template<class DEVICE>
+   static void ParseDeviceTemplates(TConfigurationNode& t_tree,
+                                    const std::string& str_kind,
+                                    std::vector<CControllableEntity::SControllerTemplate::SDevice<DEVICE> >& vec_devices,
+                                    std::vector<std::string>& vec_components) {
+      std::map<std::string, std::string> mapComponents;
+      std::string strImpl;
+      TConfigurationNodeIterator itDev;
+      for(itDev = itDev.begin(&t_tree);
+          itDev != itDev.end();
+          ++itDev) {
+         /* itDev->Value() is the name of the current device */
+         GetNodeAttribute(*itDev, "implementation", strImpl);
+         CControllableEntity::SControllerTemplate::SDevice<DEVICE> sDevice;
+         sDevice.Name = itDev->Value();
+         sDevice.Config = &(*itDev);
+         sDevice.Creator = CFactory<DEVICE>::GetCreator(sDevice.Name + " (" + strImpl + ")");
+         sDevice.Configuration = NULL;
+         vec_devices.push_back(sDevice);
+         /* Parse the configuration once, if the device supports it */
+         DEVICE* pcDevice = sDevice.Creator();
+         try {
+            vec_devices.back().Configuration = pcDevice->ParseConfiguration(*itDev);
+         }
+         catch(CARGoSException& ex) {
+            delete pcDevice;
+            THROW_ARGOSEXCEPTION_NESTED("Error parsing the configuration of " << str_kind << " \"" << sDevice.Name << "\"", ex);
+         }
+         delete pcDevice;
+         mapComponents[sDevice.Name] = str_kind + ":" + sDevice.Name;
+      }
+      /* The timers are stored in the order of the device map */
+      vec_components.clear();
+      for(std::map<std::string, std::string>::iterator it = mapComponents.begin();
+          it != mapComponents.end(); ++it) {
+         vec_components.push_back(it->second);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CControllableEntity::SControllerTemplate::~SControllerTemplate() {
+      for(size_t i = 0; i < Actuators.size(); ++i) {
+         delete Actuators[i].Configuration;
+      }
+      for(size_t i = 0; i < Sensors.size(); ++i) {
+         delete Sensors[i].Configuration;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   const CControllableEntity::SControllerTemplate& CControllableEntity::GetControllerTemplate(const std::string& str_controller_id) {
+      TControllerTemplateMap& tMap = GetControllerTemplateMap();
+      TControllerTemplateMap::iterator it = tMap.find(str_controller_id);
+      if(it != tMap.end()) {
+         return *(it->second);
+      }
+      /* Look in the map for the parsed XML configuration of the wanted controller */
+      TConfigurationNode& tConfig = CSimulator::GetInstance().GetConfigForController(str_controller_id);
+      SControllerTemplate* psTemplate = new SControllerTemplate;
+      try {
+         psTemplate->Config = &tConfig;
+         psTemplate->ControllerCreator = CFactory<CCI_Controller>::GetCreator(tConfig.Value());
+         psTemplate->ControllerComponent = "controller:" + tConfig.Value();
+         ParseDeviceTemplates(GetNode(tConfig, "actuators"),
+                              "actuator",
+                              psTemplate->Actuators,
+                              psTemplate->ActuatorComponents);
+         ParseDeviceTemplates(GetNode(tConfig, "sensors"),
+                              "sensor",
+                              psTemplate->Sensors,
+                              psTemplate->SensorComponents);
+      }
+      catch(CARGoSException& ex) {
+         delete psTemplate;
+         THROW_ARGOSEXCEPTION_NESTED("Error parsing the configuration of controller \"" << str_controller_id << "\"", ex);
+      }
+      tMap[str_controller_id] = psTemplate;
+      return *psTemplate;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CControllableEntity::ClearControllerTemplates() {
+      TControllerTemplateMap& tMap = GetControllerTemplateMap();
+      for(TControllerTemplateMap::iterator it = tMap.begin();
+          it != tMap.end(); ++it) {
+         delete it->second;
+      }
+      tMap.clear();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * Sets the stream of the RNGs that a device of a robot creates, and
+    * disables it again when going out of scope, also on errors. The stream
+    * is the FNV-1a hash of the robot id and of the slot of the device.
+    */
+   class CRNGStreamScope {
+
+   public:
+
+      CRNGStreamScope(const std::string& str_robot_id,
+                      size_t un_slot) {
+         UInt32 unHash = 2166136261UL;
+         for(size_t i = 0; i < str_robot_id.size(); ++i) {
+            unHash = (unHash ^ static_cast<UInt8>(str_robot_id[i])) * 16777619UL;
+         }
+         for(size_t i = 0; i < 4; ++i) {
+            unHash = (unHash ^ ((un_slot >> (8 * i)) & 0xFF)) * 16777619UL;
+         }
+         /* 0 means no stream */
+         CRandom::SetCreationStream(unHash != 0 ? unHash : 1);
+      }
+
+      ~CRNGStreamScope() {
+         CRandom::SetCreationStream(0);
+      }
+
+   };
+
+   /****************************************/
+   /****************************************/
+
    void CControllableEntity::SetController(const std::string& str_controller_id,
                                            TConfigurationNode& t_controller_config) {
       try {
-         /* Look in the map for the parsed XML configuration of the wanted controller */
-         TConfigurationNode& tConfig = CSimulator::GetInstance().GetConfigForController(str_controller_id);
-         /* tConfig is the base of the XML section of the wanted controller */
-         std::string strImpl;
+         /* Get the robot-independent part of the controller configuration */
+         const SControllerTemplate& sTemplate = GetControllerTemplate(str_controller_id);
          /* Create the controller */
-         m_pcController = CFactory<CCI_Controller>::New(tConfig.Value());
+         m_pcController = sTemplate.ControllerCreator();
          m_pcController->SetId(GetParent().GetId());
          /* Go through actuators */
-         TConfigurationNode& tActuators = GetNode(tConfig, "actuators");
-         TConfigurationNodeIterator itAct;
-         for(itAct = itAct.begin(&tActuators);
-             itAct != itAct.end();
-             ++itAct) {
-            /* itAct->Value() is the name of the current actuator */
-            GetNodeAttribute(*itAct, "implementation", strImpl);
-            CSimulatedActuator* pcAct = CFactory<CSimulatedActuator>::New(itAct->Value() + " (" + strImpl + ")");
+         for(size_t i = 0; i < sTemplate.Actuators.size(); ++i) {
+            const SControllerTemplate::SDevice<CSimulatedActuator>& sAct = sTemplate.Actuators[i];
+            CSimulatedActuator* pcAct = sAct.Creator();
             CCI_Actuator* pcCIAct = dynamic_cast<CCI_Actuator*>(pcAct);
             if(pcCIAct == NULL) {
-               THROW_ARGOSEXCEPTION("BUG: actuator \"" << itAct->Value() << "\" does not inherit from CCI_Actuator");
+               THROW_ARGOSEXCEPTION("BUG: actuator \"" << sAct.Name << "\" does not inherit from CCI_Actuator");
             }
             pcAct->SetRobot(GetParent());
-            pcCIAct->Init(*itAct);
-            m_mapActuators[itAct->Value()] = pcAct;
-            m_pcController->AddActuator(itAct->Value(), pcCIAct);
+            CRNGStreamScope cStream(GetParent().GetId(), i);
+            if(sAct.Configuration != NULL) {
+               pcAct->InitFromConfiguration(*sAct.Configuration);
+            }
+            else {
+               pcCIAct->Init(*sAct.Config);
+            }
+            m_mapActuators[sAct.Name] = pcAct;
+            m_pcController->AddActuator(sAct.Name, pcCIAct);
          }
          /* Go through sensors */
-         TConfigurationNode& tSensors = GetNode(tConfig, "sensors");
-         TConfigurationNodeIterator itSens;
-         for(itSens = itSens.begin(&tSensors);
-             itSens != itSens.end();
-             ++itSens) {
-            /* itSens->Value() is the name of the current actuator */
-            GetNodeAttribute(*itSens, "implementation", strImpl);
-            CSimulatedSensor* pcSens = CFactory<CSimulatedSensor>::New(itSens->Value() + " (" + strImpl + ")");
+         for(size_t i = 0; i < sTemplate.Sensors.size(); ++i) {
+            const SControllerTemplate::SDevice<CSimulatedSensor>& sSens = sTemplate.Sensors[i];
+            CSimulatedSensor* pcSens = sSens.Creator();
             CCI_Sensor* pcCISens = dynamic_cast<CCI_Sensor*>(pcSens);
             if(pcCISens == NULL) {
-               THROW_ARGOSEXCEPTION("BUG: sensor \"" << itSens->Value() << "\" does not inherit from CCI_Sensor");
+               THROW_ARGOSEXCEPTION("BUG: sensor \"" << sSens.Name << "\" does not inherit from CCI_Sensor");
             }
             pcSens->SetRobot(GetParent());
-            pcCISens->Init(*itSens);
-            m_mapSensors[itSens->Value()] = pcSens;
-            m_pcController->AddSensor(itSens->Value(), pcCISens);
+            CRNGStreamScope cStream(GetParent().GetId(), sTemplate.Actuators.size() + i);
+            if(sSens.Configuration != NULL) {
+               pcSens->InitFromConfiguration(*sSens.Configuration);
+            }
+            else {
+               pcCISens->Init(*sSens.Config);
+            }
+            m_mapSensors[sSens.Name] = pcSens;
+            m_pcController->AddSensor(sSens.Name, pcCISens);
+         }
+         /* Register the timed components, if profiling */
+         m_vecActuatorTimers.assign(m_mapActuators.size(), 0);
+         m_vecSensorTimers.assign(m_mapSensors.size(), 0);
+         if(CSimulator::GetInstance().IsProfiling() &&
+            CSimulator::GetInstance().GetProfiler().IsComponentTimingEnabled()) {
+            m_pcProfiler = &CSimulator::GetInstance().GetProfiler();
+            m_unControllerTimer = m_pcProfiler->RegisterComponent(sTemplate.ControllerComponent);
+            for(size_t i = 0; i < m_vecActuatorTimers.size(); ++i) {
+               m_vecActuatorTimers[i] = m_pcProfiler->RegisterComponent(sTemplate.ActuatorComponents[i]);
+            }
+            for(size_t i = 0; i < m_vecSensorTimers.size(); ++i) {
+               m_vecSensorTimers[i] = m_pcProfiler->RegisterComponent(sTemplate.SensorComponents[i]);
+            }
          }
          /* Configure the controller */
+         m_ptControllerConfig = &t_controller_config;
+         CRNGStreamScope cStream(GetParent().GetId(), m_mapActuators.size() + m_mapSensors.size());
          m_pcController->Init(t_controller_config);
       }
       catch(CARGoSException& ex) {
@@ -202,11 +407,29 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CControllableEntity::ReinitController() {
+      if(m_pcController == NULL) {
+         THROW_ARGOSEXCEPTION("Entity " << GetId() << " does not have any controller associated.");
+      }
+      try {
+         m_pcController->Destroy();
+         CRNGStreamScope cStream(GetParent().GetId(), m_mapActuators.size() + m_mapSensors.size());
+         m_pcController->Init(*m_ptControllerConfig);
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("Can't reinitialize the controller of controllable entity \"" << GetId() << "\"", ex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CControllableEntity::Sense() {
-      m_vecCheckedRays.clear();
-      m_vecIntersectionPoints.clear();
+      ClearCheckedRays();
+      size_t unIdx = 0;
       for(std::map<std::string, CSimulatedSensor*>::iterator it = m_mapSensors.begin();
-          it != m_mapSensors.end(); ++it) {
+          it != m_mapSensors.end(); ++it, ++unIdx) {
+         CProfiler::CScopedTimer cTimer(m_pcProfiler, m_vecSensorTimers[unIdx]);
          it->second->Update();
       }
    }
@@ -216,6 +439,7 @@ namespace argos {
 
    void CControllableEntity::ControlStep() {
       if(m_pcController != NULL) {
+         CProfiler::CScopedTimer cTimer(m_pcProfiler, m_unControllerTimer);
          m_pcController->ControlStep();
       }
       else {
@@ -227,8 +451,10 @@ namespace argos {
    /****************************************/
 
    void CControllableEntity::Act() {
+      size_t unIdx = 0;
       for(std::map<std::string, CSimulatedActuator*>::iterator it = m_mapActuators.begin();
-          it != m_mapActuators.end(); ++it) {
+          it != m_mapActuators.end(); ++it, ++unIdx) {
+         CProfiler::CScopedTimer cTimer(m_pcProfiler, m_vecActuatorTimers[unIdx]);
          it->second->Update();
       }
    }
@@ -16,6 +16,8 @@ namespace argos {
 #include <argos3/core/simulator/entity/entity.h>
 #include <argos3/core/control_interface/ci_controller.h>
 #include <argos3/core/utility/math/ray3.h>
+#include <argos3/core/utility/profiler/profiler.h>
+#include <argos3/core/utility/plugins/factory.h>
 
 namespace argos {
 
@@ -81,6 +83,21 @@ namespace argos {
        */
       virtual void Reset();
 
+      /**
+       * Saves the state of the entity to the given buffer.
+       * The sensors, the actuators and the controller are saved only if
+       * they implement CMemento.
+       * @param c_buffer the target buffer
+       */
+      virtual void SaveState(CByteArray& c_buffer);
+
+      /**
+       * Restores the state of the entity from the given buffer.
+       * The rays are cleared.
+       * @param c_buffer the source buffer
+       */
+      virtual void LoadState(CByteArray& c_buffer);
+
       /**
        * Destroys the entity, undoing whatever was done by Init() or by the standalone constructor.
        */
@@ -138,6 +155,90 @@ namespace argos {
       void SetController(const std::string& str_controller_id,
                          TConfigurationNode& t_controller_config);
 
+      /**
+       * Returns the XML tree that was passed to CCI_Controller::Init().
+       * This is the <tt>&lt;params&gt;</tt> section of the controller
+       * configuration, or the one of the entity if it has its own.
+       * @return The XML tree that was passed to CCI_Controller::Init().
+       * @throws CARGoSException If no controller has been associated.
+       */
+      inline TConfigurationNode& GetControllerConfig() {
+         if(m_ptControllerConfig == NULL) {
+            THROW_ARGOSEXCEPTION("Entity " << GetId() << " does not have any controller associated.");
+         }
+         return *m_ptControllerConfig;
+      }
+
+      /**
+       * Initializes the controller again with its XML configuration.
+       * The controller is destroyed with CCI_Controller::Destroy() and
+       * initialized with CCI_Controller::Init(), so changes to its
+       * configuration take effect; its sensors and actuators are kept.
+       * @throws CARGoSException If no controller has been associated, or if the initialization fails.
+       * @see GetControllerConfig()
+       */
+      void ReinitController();
+
+      /**
+       * The robot-independent part of a controller configuration.
+       * It is built the first time a controller id is assigned to a robot,
+       * and it is shared by all the robots that use that controller. The
+       * factory labels of the controller, the actuators and the sensors are
+       * resolved once, so creating the controller of a robot only requires
+       * to allocate the devices and initialize them. The XML configuration
+       * of the devices that implement ParseConfiguration() is also parsed
+       * once, and shared.
+       * @see GetControllerTemplate()
+       * @see CSimulatedSensor::ParseConfiguration()
+       * @see CSimulatedActuator::ParseConfiguration()
+       */
+      struct SControllerTemplate {
+         /**
+          * A sensor or an actuator of the controller.
+          */
+         template<class DEVICE>
+         struct SDevice {
+            /** The device type, e.g., "differential_steering" */
+            std::string Name;
+            /** The XML configuration of the device */
+            TConfigurationNode* Config;
+            /** The creator of the device implementation */
+            typename CFactory<DEVICE>::TCreator* Creator;
+            /** The parsed XML configuration, or <tt>NULL</tt> if the device parses it in Init() */
+            typename DEVICE::SConfiguration* Configuration;
+         };
+
+         ~SControllerTemplate();
+
+         /** The XML configuration of the controller */
+         TConfigurationNode* Config;
+         /** The creator of the controller */
+         CFactory<CCI_Controller>::TCreator* ControllerCreator;
+         /** The actuators, in XML order */
+         std::vector<SDevice<CSimulatedActuator> > Actuators;
+         /** The sensors, in XML order */
+         std::vector<SDevice<CSimulatedSensor> > Sensors;
+         /** The profiler component names, in the order of the device maps */
+         std::string ControllerComponent;
+         std::vector<std::string> ActuatorComponents;
+         std::vector<std::string> SensorComponents;
+      };
+
+      /**
+       * Returns the template of the controller with the given id.
+       * The template is built on the first call.
+       * @param str_controller_id The id of the controller as specified in the XML configuration file
+       * @return The template of the controller.
+       * @throws CARGoSException if the controller or one of its devices is unknown
+       */
+      static const SControllerTemplate& GetControllerTemplate(const std::string& str_controller_id);
+
+      /**
+       * Deletes the controller templates.
+       * Must be called when the XML configuration they refer to is discarded.
+       */
+      static void ClearControllerTemplates();
+
       /**
        * Executes the CSimulatedSensor::Update() method for all associated sensors.
        * In addition, it clears the list of rays and intersection points.
@@ -147,6 +248,16 @@ namespace argos {
        */
       virtual void Sense();
 
+      /**
+       * Clears the list of rays and intersection points.
+       * Called by Sense(), and by the space when it updates the sensors itself.
+       * @see CSpace::SetSensorMajorSense()
+       */
+      inline void ClearCheckedRays() {
+         m_vecCheckedRays.clear();
+         m_vecIntersectionPoints.clear();
+      }
+
       /**
        * Executes CCI_Controller::ControlStep().
        * @throws CARGoSException If no controller has been associated.
@@ -236,12 +347,27 @@ namespace argos {
       /** The pointer to the associated controller */
       CCI_Controller* m_pcController;
 
+      /** The XML tree passed to CCI_Controller::Init() */
+      TConfigurationNode* m_ptControllerConfig;
+
       /** The map of actuators, indexed by actuator type (not implementation!) */
       std::map<std::string, CSimulatedActuator*> m_mapActuators;
 
       /** The map of sensors, indexed by sensor type (not implementation!) */
       std::map<std::string, CSimulatedSensor*> m_mapSensors;
 
+      /** The profiler used to time sensors, actuators and controller, or <tt>NULL</tt> */
+      CProfiler* m_pcProfiler;
+
+      /** The profiler component id of the controller */
+      UInt32 m_unControllerTimer;
+
+      /** The profiler component ids of the actuators, in the order of m_mapActuators */
+      std::vector<UInt32> m_vecActuatorTimers;
+
+      /** The profiler component ids of the sensors, in the order of m_mapSensors */
+      std::vector<UInt32> m_vecSensorTimers;
+
       /** The list of checked rays */
       std::vector<std::pair<bool, CRay3> > m_vecCheckedRays;
 
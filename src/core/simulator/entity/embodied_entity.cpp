@@ -118,6 +118,51 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CEmbodiedEntity::SaveState(CByteArray& c_buffer) {
+      CEntity::SaveState(c_buffer);
+      /* The origin anchor is in the map too */
+      c_buffer << static_cast<UInt32>(m_mapAnchors.size());
+      for(std::map<std::string, SAnchor*>::iterator it = m_mapAnchors.begin();
+          it != m_mapAnchors.end(); ++it) {
+         c_buffer << it->second->Position.GetX()
+                  << it->second->Position.GetY()
+                  << it->second->Position.GetZ()
+                  << it->second->Orientation.GetW()
+                  << it->second->Orientation.GetX()
+                  << it->second->Orientation.GetY()
+                  << it->second->Orientation.GetZ();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CEmbodiedEntity::LoadState(CByteArray& c_buffer) {
+      CEntity::LoadState(c_buffer);
+      UInt32 unAnchors;
+      c_buffer >> unAnchors;
+      if(unAnchors != m_mapAnchors.size()) {
+         THROW_ARGOSEXCEPTION("Embodied entity \"" << GetContext() << GetId() << "\" has " << m_mapAnchors.size() << " anchors, but " << unAnchors << " were saved.");
+      }
+      Real fX, fY, fZ, fW;
+      for(std::map<std::string, SAnchor*>::iterator it = m_mapAnchors.begin();
+          it != m_mapAnchors.end(); ++it) {
+         c_buffer >> fX >> fY >> fZ;
+         it->second->Position.Set(fX, fY, fZ);
+         c_buffer >> fW >> fX >> fY >> fZ;
+         it->second->Orientation = CQuaternion(fW, fX, fY, fZ);
+      }
+      /* Move the physics models to the saved pose */
+      if(GetPhysicsModelsNum() > 0) {
+         CVector3 cPosition = m_psOriginAnchor->Position;
+         CQuaternion cOrientation = m_psOriginAnchor->Orientation;
+         MoveTo(cPosition, cOrientation, false, true);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    SAnchor& CEmbodiedEntity::AddAnchor(const std::string& str_id,
                                        const CVector3& c_offset_position,
                                        const CQuaternion& c_offset_orientation) {
@@ -94,6 +94,21 @@ namespace argos {
 
       virtual void Reset();
 
+      /**
+       * Saves the poses of the anchors to the given buffer.
+       * @param c_buffer the target buffer
+       */
+      virtual void SaveState(CByteArray& c_buffer);
+
+      /**
+       * Restores the poses of the anchors from the given buffer.
+       * The physics models are moved to the saved origin pose, ignoring
+       * collisions; the engines that keep more than the pose (e.g.,
+       * velocities) must save it themselves.
+       * @param c_buffer the source buffer
+       */
+      virtual void LoadState(CByteArray& c_buffer);
+
       /**
        * Returns <tt>true</tt> if the entity is movable.
        * @return <tt>true</tt> if the entity is movable.
@@ -143,6 +143,24 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CEntity::SaveState(CByteArray& c_buffer) {
+      c_buffer << static_cast<UInt8>(m_bEnabled);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CEntity::LoadState(CByteArray& c_buffer) {
+      UInt8 unEnabled;
+      c_buffer >> unEnabled;
+      if((unEnabled != 0) != m_bEnabled) {
+         SetEnabled(unEnabled != 0);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    INIT_VTABLE_FOR(CEntity);
 
    REGISTER_STANDARD_SPACE_OPERATIONS_ON_ENTITY(CEntity);
@@ -22,6 +22,7 @@ namespace argos {
 #include <argos3/core/utility/datatypes/datatypes.h>
 #include <argos3/core/utility/configuration/argos_configuration.h>
 #include <argos3/core/utility/configuration/base_configurable_resource.h>
+#include <argos3/core/utility/configuration/memento.h>
 #include <argos3/core/utility/plugins/factory.h>
 #include <argos3/core/utility/plugins/vtable.h>
 
@@ -87,6 +88,7 @@ namespace argos {
     * @see CSpaceHash
     */
    class CEntity : public CBaseConfigurableResource,
+                   public CMemento,
                    public EnableVTableFor<CEntity> {
 
    public:
@@ -150,6 +152,23 @@ namespace argos {
        */
       virtual void Destroy() {}
 
+      /**
+       * Saves the state of the entity to the given buffer.
+       * The state is what changes during an experiment; the configuration
+       * set by Init() is not saved. The default implementation saves
+       * whether the entity is enabled.
+       * @param c_buffer the target buffer
+       * @see CSimulator::SaveState()
+       */
+      virtual void SaveState(CByteArray& c_buffer);
+
+      /**
+       * Restores the state of the entity from the given buffer.
+       * @param c_buffer the source buffer
+       * @see SaveState()
+       */
+      virtual void LoadState(CByteArray& c_buffer);
+
       /**
        * Returns the id of this entity.
        * @return The id of this entity.
@@ -13,6 +13,9 @@
 #include <FreeImagePlus.h>
 #endif
 
+#include <atomic>
+#include <sched.h>
+
 namespace argos {
 
    /****************************************/
@@ -114,9 +117,18 @@ namespace argos {
 
    public:
 
-      CFloorColorFromLoopFunctions(UInt32 un_pixels_per_meter) :
+      CFloorColorFromLoopFunctions(UInt32 un_pixels_per_meter,
+                                   bool b_cache = false,
+                                   bool b_bilinear = false) :
          m_cLoopFunctions(CSimulator::GetInstance().GetLoopFunctions()),
-         m_unPixelsPerMeter(un_pixels_per_meter) {
+         m_unPixelsPerMeter(un_pixels_per_meter),
+         m_bCache(b_cache),
+         m_bBilinear(b_bilinear),
+         m_unWidth(0),
+         m_unHeight(0),
+         m_unTilesX(0),
+         m_unTilesY(0),
+         m_psTiles(NULL) {
          const CVector3& cArenaSize = CSimulator::GetInstance().GetSpace().GetArenaSize();
          m_cHalfArenaSize.Set(
             cArenaSize.GetX() * 0.5f,
@@ -124,11 +136,57 @@ namespace argos {
          const CVector3& cArenaCenter = CSimulator::GetInstance().GetSpace().GetArenaCenter();
          m_cArenaCenter.Set(cArenaCenter.GetX(),
                             cArenaCenter.GetY());
+         if(m_bCache) {
+            /* Lay out the tiles, they are rasterized on first use */
+            m_unWidth = Max<UInt32>(1, Ceil(cArenaSize.GetX() * m_unPixelsPerMeter));
+            m_unHeight = Max<UInt32>(1, Ceil(cArenaSize.GetY() * m_unPixelsPerMeter));
+            m_unTilesX = (m_unWidth + TILE_SIZE - 1) / TILE_SIZE;
+            m_unTilesY = (m_unHeight + TILE_SIZE - 1) / TILE_SIZE;
+            m_psTiles = new STile[m_unTilesX * m_unTilesY];
+         }
+      }
+
+      virtual ~CFloorColorFromLoopFunctions() {
+         delete[] m_psTiles;
+      }
+
+      virtual void Reset() {
+         Invalidate();
+      }
+
+      virtual void Invalidate() {
+         for(UInt32 i = 0; i < m_unTilesX * m_unTilesY; ++i) {
+            m_psTiles[i].State.store(TILE_EMPTY, std::memory_order_release);
+         }
       }
 
       virtual CColor GetColorAtPoint(Real f_x,
                                      Real f_y) {
-         return m_cLoopFunctions.GetFloorColor(CVector2(f_x, f_y));
+         if(!m_bCache) {
+            return m_cLoopFunctions.GetFloorColor(CVector2(f_x, f_y));
+         }
+         /* Position in pixels, with pixel centers at integer + 0.5 */
+         Real fU = (f_x - m_cArenaCenter.GetX() + m_cHalfArenaSize.GetX()) * m_unPixelsPerMeter;
+         Real fV = (f_y - m_cArenaCenter.GetY() + m_cHalfArenaSize.GetY()) * m_unPixelsPerMeter;
+         if(!m_bBilinear) {
+            return GetPixel(Floor(fU), Floor(fV));
+         }
+         /* Interpolate the four closest pixel centers */
+         fU -= 0.5;
+         fV -= 0.5;
+         SInt32 nU = Floor(fU);
+         SInt32 nV = Floor(fV);
+         Real fTU = fU - nU;
+         Real fTV = fV - nV;
+         const CColor& cC00 = GetPixel(nU,     nV);
+         const CColor& cC10 = GetPixel(nU + 1, nV);
+         const CColor& cC01 = GetPixel(nU,     nV + 1);
+         const CColor& cC11 = GetPixel(nU + 1, nV + 1);
+         return CColor(
+            Interpolate(cC00.GetRed(),   cC10.GetRed(),   cC01.GetRed(),   cC11.GetRed(),   fTU, fTV),
+            Interpolate(cC00.GetGreen(), cC10.GetGreen(), cC01.GetGreen(), cC11.GetGreen(), fTU, fTV),
+            Interpolate(cC00.GetBlue(),  cC10.GetBlue(),  cC01.GetBlue(),  cC11.GetBlue(),  fTU, fTV),
+            Interpolate(cC00.GetAlpha(), cC10.GetAlpha(), cC01.GetAlpha(), cC11.GetAlpha(), fTU, fTV));
       }
 
 #ifdef ARGOS_WITH_FREEIMAGE
@@ -156,12 +214,127 @@ namespace argos {
       }
 #endif
 
+   private:
+
+      /** The side of a tile, in pixels */
+      static const UInt32 TILE_SIZE = 64;
+
+      /** The states of a tile */
+      enum ETileState {
+         TILE_EMPTY = 0,
+         TILE_FILLING,
+         TILE_READY
+      };
+
+      /**
+       * A square of rasterized floor colors.
+       * A tile is rasterized by the first thread that needs it, while the
+       * other threads that need it wait.
+       */
+      struct STile {
+         std::atomic<UInt32> State;
+         std::vector<CColor> Pixels;
+
+         STile() : State(TILE_EMPTY) {}
+      };
+
+   private:
+
+      /*
+       * Returns the color of the given pixel, rasterizing its tile if needed.
+       * Pixels outside the floor are clamped to the border.
+       */
+      inline const CColor& GetPixel(SInt32 n_x,
+                                    SInt32 n_y) {
+         UInt32 unX = Min<SInt32>(Max<SInt32>(n_x, 0), m_unWidth - 1);
+         UInt32 unY = Min<SInt32>(Max<SInt32>(n_y, 0), m_unHeight - 1);
+         UInt32 unTileX = unX / TILE_SIZE;
+         UInt32 unTileY = unY / TILE_SIZE;
+         STile& sTile = m_psTiles[unTileY * m_unTilesX + unTileX];
+         if(sTile.State.load(std::memory_order_acquire) != TILE_READY) {
+            FillTile(sTile, unTileX, unTileY);
+         }
+         return sTile.Pixels[(unY % TILE_SIZE) * TILE_SIZE + (unX % TILE_SIZE)];
+      }
+
+      /*
+       * Makes sure the given tile is rasterized.
+       * The first thread that finds the tile empty rasterizes it, while
+       * the others wait. If rasterizing throws, the tile is emptied and
+       * the exception is rethrown; the waiting threads then try again
+       * themselves, so none of them waits for a tile that never gets ready.
+       */
+      void FillTile(STile& s_tile,
+                    UInt32 un_tile_x,
+                    UInt32 un_tile_y) {
+         UInt32 unState = s_tile.State.load(std::memory_order_acquire);
+         while(unState != TILE_READY) {
+            if(unState == TILE_EMPTY) {
+               if(s_tile.State.compare_exchange_strong(unState, TILE_FILLING,
+                                                       std::memory_order_acq_rel)) {
+                  /* This thread rasterizes the tile */
+                  try {
+                     RasterizeTile(s_tile, un_tile_x, un_tile_y);
+                  }
+                  catch(...) {
+                     s_tile.State.store(TILE_EMPTY, std::memory_order_release);
+                     throw;
+                  }
+                  s_tile.State.store(TILE_READY, std::memory_order_release);
+                  return;
+               }
+               /* Another thread got there first; unState holds the new state */
+            }
+            else {
+               /* Another thread is rasterizing the tile */
+               ::sched_yield();
+               unState = s_tile.State.load(std::memory_order_acquire);
+            }
+         }
+      }
+
+      void RasterizeTile(STile& s_tile,
+                         UInt32 un_tile_x,
+                         UInt32 un_tile_y) {
+         s_tile.Pixels.resize(TILE_SIZE * TILE_SIZE);
+         Real fFactor = 1.0f / static_cast<Real>(m_unPixelsPerMeter);
+         UInt32 unX0 = un_tile_x * TILE_SIZE;
+         UInt32 unY0 = un_tile_y * TILE_SIZE;
+         UInt32 unX1 = Min(unX0 + TILE_SIZE, m_unWidth);
+         UInt32 unY1 = Min(unY0 + TILE_SIZE, m_unHeight);
+         CVector2 cFloorPos;
+         for(UInt32 y = unY0; y < unY1; ++y) {
+            for(UInt32 x = unX0; x < unX1; ++x) {
+               cFloorPos.Set((x + 0.5f) * fFactor, (y + 0.5f) * fFactor);
+               cFloorPos -= m_cHalfArenaSize;
+               cFloorPos += m_cArenaCenter;
+               s_tile.Pixels[(y - unY0) * TILE_SIZE + (x - unX0)] =
+                  m_cLoopFunctions.GetFloorColor(cFloorPos);
+            }
+         }
+      }
+
+      static inline UInt8 Interpolate(UInt8 un_c00, UInt8 un_c10,
+                                      UInt8 un_c01, UInt8 un_c11,
+                                      Real f_tu, Real f_tv) {
+         Real fC0 = un_c00 + (un_c10 - un_c00) * f_tu;
+         Real fC1 = un_c01 + (un_c11 - un_c01) * f_tu;
+         return static_cast<UInt8>(fC0 + (fC1 - fC0) * f_tv + 0.5f);
+      }
+
    private:
 
       CLoopFunctions& m_cLoopFunctions;
       UInt32 m_unPixelsPerMeter;
       CVector2 m_cHalfArenaSize;
       CVector2 m_cArenaCenter;
+      bool m_bCache;
+      bool m_bBilinear;
+      UInt32 m_unWidth;
+      UInt32 m_unHeight;
+      UInt32 m_unTilesX;
+      UInt32 m_unTilesY;
+      STile* m_psTiles;
    };
 
    /****************************************/
@@ -221,7 +394,20 @@ namespace argos {
          m_eColorSource = FROM_LOOP_FUNCTIONS;
          UInt32 unPixelsPerMeter;
          GetNodeAttribute(t_tree, "pixels_per_meter", unPixelsPerMeter);
-         m_pcColorSource = new CFloorColorFromLoopFunctions(unPixelsPerMeter);
+         bool bCache = false;
+         GetNodeAttributeOrDefault(t_tree, "cache", bCache, bCache);
+         std::string strFilter = "nearest";
+         GetNodeAttributeOrDefault(t_tree, "filter", strFilter, strFilter);
+         if(strFilter != "nearest" && strFilter != "bilinear") {
+            THROW_ARGOSEXCEPTION("Unknown filter \"" <<
+                                 strFilter <<
+                                 "\" for the floor entity \"" <<
+                                 GetId() <<
+                                 "\". Available filters: \"nearest\" and \"bilinear\".");
+         }
+         m_pcColorSource = new CFloorColorFromLoopFunctions(unPixelsPerMeter,
+                                                            bCache,
+                                                            strFilter == "bilinear");
       }
       else if(strColorSource == "image") {
 #ifdef ARGOS_WITH_FREEIMAGE
@@ -315,7 +501,23 @@ namespace argos {
                    "    ...\n"
                    "  </arena>\n\n"
                    "OPTIONAL XML CONFIGURATION\n\n"
-                   "None for the time being.\n",
+                   "When 'source' is set to 'loop_functions', calling the loop functions every\n"
+                   "time a ground sensor reads the floor can be slow. Setting the attribute\n"
+                   "'cache' to 'true' rasterizes the floor at 'pixels_per_meter' and makes the\n"
+                   "sensors read the rasterized colors instead. The floor is rasterized lazily, in\n"
+                   "square tiles, the first time a sensor reads them, and again after the loop\n"
+                   "functions call SetChanged() on the floor entity. By default, the color of the\n"
+                   "closest pixel is returned; setting the attribute 'filter' to 'bilinear'\n"
+                   "interpolates the four closest pixels instead:\n\n"
+                   "  <arena ...>\n"
+                   "    ...\n"
+                   "    <floor id=\"floor\"\n"
+                   "           source=\"loop_functions\"\n"
+                   "           pixels_per_meter=\"100\"\n"
+                   "           cache=\"true\"\n"
+                   "           filter=\"bilinear\" />\n"
+                   "    ...\n"
+                   "  </arena>\n",
                    "Usable"
       );
 
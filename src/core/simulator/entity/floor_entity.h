@@ -30,6 +30,12 @@ namespace argos {
 
          virtual void Reset() {}
 
+         /**
+          * Called when the floor color has changed.
+          * Sources that cache colors must discard them.
+          */
+         virtual void Invalidate() {}
+
          virtual CColor GetColorAtPoint(Real f_x,
                                         Real f_y) = 0;
 
@@ -116,10 +122,15 @@ namespace argos {
 
       /**
        * Marks the floor color as changed.
+       * This also discards the cached colors, if any; it must not be called
+       * while the sensors are being updated.
        * @see HasChanged
        */
       inline void SetChanged() {
          m_bHasChanged = true;
+         if(m_pcColorSource != NULL) {
+            m_pcColorSource->Invalidate();
+         }
       }
 
       /**
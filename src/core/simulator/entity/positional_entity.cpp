@@ -62,6 +62,32 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CPositionalEntity::SaveState(CByteArray& c_buffer) {
+      CEntity::SaveState(c_buffer);
+      c_buffer << m_cPosition.GetX()
+               << m_cPosition.GetY()
+               << m_cPosition.GetZ()
+               << m_cOrientation.GetW()
+               << m_cOrientation.GetX()
+               << m_cOrientation.GetY()
+               << m_cOrientation.GetZ();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CPositionalEntity::LoadState(CByteArray& c_buffer) {
+      CEntity::LoadState(c_buffer);
+      Real fX, fY, fZ, fW;
+      c_buffer >> fX >> fY >> fZ;
+      m_cPosition.Set(fX, fY, fZ);
+      c_buffer >> fW >> fX >> fY >> fZ;
+      m_cOrientation = CQuaternion(fW, fX, fY, fZ);
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CPositionalEntity::MoveTo(const CVector3& c_position,
                                   const CQuaternion& c_orientation) {
       SetPosition(c_position);
@@ -33,6 +33,10 @@ namespace argos {
       virtual void Init(TConfigurationNode& t_tree);
       virtual void Reset();
 
+      virtual void SaveState(CByteArray& c_buffer);
+
+      virtual void LoadState(CByteArray& c_buffer);
+
       inline const CVector3& GetPosition() const {
          return m_cPosition;
       }
@@ -56,4 +56,32 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CLoopFunctions::QueueAddEntity(CEntity& c_entity) {
+      m_cSpace.QueueAddEntity(c_entity);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLoopFunctions::QueueRemoveEntity(const std::string& str_entity_id) {
+      QueueRemoveEntity(m_cSpace.GetEntity(str_entity_id));
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLoopFunctions::QueueRemoveEntity(CEntity& c_entity) {
+      m_cSpace.QueueRemoveEntity(c_entity);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLoopFunctions::CommitEntityChanges() {
+      m_cSpace.CommitEntityChanges();
+   }
+
+   /****************************************/
+   /****************************************/
+
 }
@@ -149,6 +149,37 @@ namespace argos {
       virtual void PostExperiment() {
       }
 
+      /**
+       * Writes the results of a trial run in batch mode.
+       * This method is called by CBatchRunner after PostExperiment(). The
+       * output is appended to the line of the trial in the results file,
+       * after the trial number, the random seed and the simulation clock;
+       * therefore, it should be a list of space-separated values with no
+       * newlines.
+       * The default implementation of this method writes nothing.
+       * @param c_output The stream to write the results to.
+       * @see CBatchRunner
+       */
+      virtual void WriteTrialResults(std::ostream& c_output) {
+      }
+
+      /**
+       * Reads the configuration of a trial run in batch mode.
+       * This method is called by CBatchRunner before Reset() when a trial
+       * overrides attributes of the <tt>&lt;loop_functions&gt;</tt>
+       * section, and again at the end of the trial, when the overrides are
+       * undone. Loop functions that read parameters in Init() must read
+       * them again here for the overrides to take effect.
+       * The default implementation of this method throws, so that
+       * overrides with no effect are reported instead of silently ignored.
+       * @param t_tree The <tt>&lt;loop_functions&gt;</tt> XML configuration tree.
+       * @throws CARGoSException if the loop functions do not support overrides.
+       * @see CBatchRunner
+       */
+      virtual void ReadTrialConfiguration(TConfigurationNode& t_tree) {
+         THROW_ARGOSEXCEPTION("The loop functions do not implement ReadTrialConfiguration(), so the <loop_functions> section cannot be overridden in batch trials.");
+      }
+
       /**
        * Returns the color of the floor in the specified point.
        * This function is called if the floor entity was configured to take the loop functions
@@ -234,6 +265,42 @@ namespace argos {
        */
       virtual void RemoveEntity(CEntity& c_entity);
 
+      /**
+       * Queues the passed entity for addition to the simulation.
+       * The entity is added at the end of the current step, after PostStep(),
+       * together with all the other queued additions and removals.
+       * Use this method instead of AddEntity() when many entities are added
+       * and removed during a step.
+       * Important: the entity must be created with a <tt>new</tt> statement or a CFactory::New() statement.
+       * @param c_entity A reference to the entity to add.
+       * @see CommitEntityChanges()
+       */
+      virtual void QueueAddEntity(CEntity& c_entity);
+
+      /**
+       * Queues an entity for removal from the simulation.
+       * The entity is removed at the end of the current step, after PostStep().
+       * @param str_entity_id The id of the entity to remove.
+       * @throws CARGoSException If an entity with the specified id was not found.
+       * @see CommitEntityChanges()
+       */
+      virtual void QueueRemoveEntity(const std::string& str_entity_id);
+
+      /**
+       * Queues an entity for removal from the simulation.
+       * The entity is removed at the end of the current step, after PostStep().
+       * @param c_entity A reference to the entity to remove.
+       * @see CommitEntityChanges()
+       */
+      virtual void QueueRemoveEntity(CEntity& c_entity);
+
+      /**
+       * Applies the queued entity removals and additions immediately.
+       * You don't need to call this method, unless the changes must be
+       * visible before the end of the current step.
+       */
+      virtual void CommitEntityChanges();
+
    private:
 
       /** A reference to the CSimulator instance */
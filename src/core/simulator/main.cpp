@@ -5,6 +5,7 @@
  */
 
 #include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/batch_runner.h>
 #include <argos3/core/utility/plugins/dynamic_loading.h>
 #include <argos3/core/simulator/query_plugins.h>
 #include <argos3/core/simulator/argos_command_line_arg_parser.h>
@@ -32,15 +33,32 @@ int main(int n_argc, char** ppch_argv) {
       cACLAP.Parse(n_argc, ppch_argv);
       switch(cACLAP.GetAction()) {
          case CARGoSCommandLineArgParser::ACTION_RUN_EXPERIMENT:
-            CDynamicLoading::LoadAllLibraries();
+            CDynamicLoading::EnableLazyLoading();
             cSimulator.SetExperimentFileName(cACLAP.GetExperimentConfigFile());
             cSimulator.LoadExperiment();
             cSimulator.Execute();
             break;
+         case CARGoSCommandLineArgParser::ACTION_RUN_BATCH: {
+            CDynamicLoading::EnableLazyLoading();
+            cSimulator.SetExperimentFileName(cACLAP.GetExperimentConfigFile());
+            cSimulator.LoadExperiment();
+            CBatchRunner cBatchRunner(cSimulator);
+            cBatchRunner.LoadTrials(cACLAP.GetBatchFile());
+            std::ofstream cResults(cACLAP.GetBatchOutputFile().c_str(), std::ios::trunc | std::ios::out);
+            if(cResults.fail()) {
+               THROW_ARGOSEXCEPTION("Error opening file \"" << cACLAP.GetBatchOutputFile() << "\"");
+            }
+            cBatchRunner.Run(cResults, cACLAP.GetBatchWorkers());
+            break;
+         }
          case CARGoSCommandLineArgParser::ACTION_QUERY:
             CDynamicLoading::LoadAllLibraries();
             QueryPlugins(cACLAP.GetQuery());
             break;
+         case CARGoSCommandLineArgParser::ACTION_WRITE_PLUGIN_MANIFEST:
+            CDynamicLoading::LoadAllLibraries();
+            WritePluginManifest(cACLAP.GetPluginManifestFile());
+            break;
          case CARGoSCommandLineArgParser::ACTION_SHOW_HELP:
             cACLAP.PrintUsage(LOG);
             break;
@@ -81,6 +81,91 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   /**
+    * Fills the closest intersection of each ray, skipping the entity excluded for the ray.
+    * Each engine checks all the rays in a single call.
+    */
+   template<class EXCLUDED>
+   static void FindClosestIntersections(std::vector<SEmbodiedEntityIntersectionItem>& vec_items,
+                                        const std::vector<CRay3>& vec_rays,
+                                        const EXCLUDED& t_excluded) {
+      /* This variable is instantiated at the first call of this function, once and forever */
+      static CSimulator& cSimulator = CSimulator::GetInstance();
+      /* Initialize the items */
+      vec_items.assign(vec_rays.size(), SEmbodiedEntityIntersectionItem());
+      /*
+       * The intersections of each ray, in a per-thread buffer that is reused
+       * across calls: the lists are cleared, so their memory is kept
+       */
+      static thread_local std::vector<TEmbodiedEntityIntersectionData> vecData;
+      if(vecData.size() < vec_rays.size()) {
+         vecData.resize(vec_rays.size());
+      }
+      for(size_t j = 0; j < vec_rays.size(); ++j) {
+         vecData[j].clear();
+      }
+      /* Ask each engine to perform all the ray queries */
+      CPhysicsEngine::TVector& vecEngines = cSimulator.GetPhysicsEngines();
+      for(size_t i = 0; i < vecEngines.size(); ++i) {
+         vecEngines[i]->CheckIntersectionWithRays(vecData, vec_rays);
+      }
+      /* Keep the closest intersection of each ray */
+      for(size_t j = 0; j < vec_rays.size(); ++j) {
+         SEmbodiedEntityIntersectionItem& sItem = vec_items[j];
+         for(size_t k = 0; k < vecData[j].size(); ++k) {
+            if(sItem.TOnRay > vecData[j][k].TOnRay &&
+               t_excluded(j) != vecData[j][k].IntersectedEntity) {
+               sItem = vecData[j][k];
+            }
+         }
+      }
+   }
+
+   /* The same entity is excluded for all the rays */
+   struct SExcludedForAll {
+      CEmbodiedEntity* Entity;
+      SExcludedForAll(CEmbodiedEntity* pc_entity) : Entity(pc_entity) {}
+      CEmbodiedEntity* operator()(size_t) const { return Entity; }
+   };
+
+   /* A different entity is excluded for each ray */
+   struct SExcludedPerRay {
+      const std::vector<CEmbodiedEntity*>& Entities;
+      SExcludedPerRay(const std::vector<CEmbodiedEntity*>& vec_entities) : Entities(vec_entities) {}
+      CEmbodiedEntity* operator()(size_t un_ray) const { return Entities[un_ray]; }
+   };
+
+   /****************************************/
+   /****************************************/
+
+   void GetClosestEmbodiedEntitiesIntersectedByRays(std::vector<SEmbodiedEntityIntersectionItem>& vec_items,
+                                                   const std::vector<CRay3>& vec_rays,
+                                                   CEmbodiedEntity* pc_entity) {
+      FindClosestIntersections(vec_items, vec_rays, SExcludedForAll(pc_entity));
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void GetClosestEmbodiedEntitiesIntersectedByRays(std::vector<SEmbodiedEntityIntersectionItem>& vec_items,
+                                                   const std::vector<CRay3>& vec_rays,
+                                                   const std::vector<CEmbodiedEntity*>& vec_entities) {
+      FindClosestIntersections(vec_items, vec_rays, SExcludedPerRay(vec_entities));
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CPhysicsEngine::CheckIntersectionWithRays(std::vector<TEmbodiedEntityIntersectionData>& vec_data,
+                                                  const std::vector<CRay3>& vec_rays) const {
+      for(size_t i = 0; i < vec_rays.size(); ++i) {
+         CheckIntersectionWithRay(vec_data[i], vec_rays[i]);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    /* The default value of the simulation clock tick */
    Real CPhysicsEngine::m_fSimulationClockTick = 0.1f;
    Real CPhysicsEngine::m_fInverseSimulationClockTick = 1.0f / CPhysicsEngine::m_fSimulationClockTick;
@@ -84,6 +84,31 @@ namespace argos {
                                                         const CRay3& c_ray,
                                                         CEmbodiedEntity& c_entity);
 
+   /**
+    * Returns the closest intersection with an embodied entity for each ray of a batch.
+    * Each engine checks all the rays at once through
+    * CPhysicsEngine::CheckIntersectionWithRays(). The results are the same
+    * as calling GetClosestEmbodiedEntityIntersectedByRay() for each ray.
+    * @param vec_items The closest intersection of each ray; an item with a <tt>NULL</tt> entity means no intersection.
+    * @param vec_rays The rays to test for intersections.
+    * @param pc_entity The entity to exclude from the intersection checks, or <tt>NULL</tt>.
+    */
+   extern void GetClosestEmbodiedEntitiesIntersectedByRays(std::vector<SEmbodiedEntityIntersectionItem>& vec_items,
+                                                          const std::vector<CRay3>& vec_rays,
+                                                          CEmbodiedEntity* pc_entity = NULL);
+
+   /**
+    * Returns the closest intersection with an embodied entity for each ray of a batch.
+    * This function allows you to exclude a different entity for each ray,
+    * so that the rays of many robots can be checked in one batch.
+    * @param vec_items The closest intersection of each ray; an item with a <tt>NULL</tt> entity means no intersection.
+    * @param vec_rays The rays to test for intersections.
+    * @param vec_entities For each ray, the entity to exclude from the intersection check, or <tt>NULL</tt>.
+    */
+   extern void GetClosestEmbodiedEntitiesIntersectedByRays(std::vector<SEmbodiedEntityIntersectionItem>& vec_items,
+                                                          const std::vector<CRay3>& vec_rays,
+                                                          const std::vector<CEmbodiedEntity*>& vec_entities);
+
    /****************************************/
    /****************************************/
 
@@ -227,6 +252,18 @@ namespace argos {
       virtual void CheckIntersectionWithRay(TEmbodiedEntityIntersectionData& t_data,
                                             const CRay3& c_ray) const = 0;
 
+      /**
+       * Check which objects in this engine intersect each of the given rays.
+       * The intersections of the i-th ray are appended to the i-th element
+       * of <tt>vec_data</tt>, which must have at least an element per ray.
+       * The default implementation calls CheckIntersectionWithRay() for
+       * each ray. Engines can override it to check all the rays at once.
+       * @param vec_data The lists of entities that intersect each ray.
+       * @param vec_rays The test rays.
+       */
+      virtual void CheckIntersectionWithRays(std::vector<TEmbodiedEntityIntersectionData>& vec_data,
+                                             const std::vector<CRay3>& vec_rays) const;
+
       /**
        * Returns the simulation clock tick.
        * The clock tick is the time elapsed between two control steps
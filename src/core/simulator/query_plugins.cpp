@@ -10,6 +10,9 @@
 #include <argos3/core/simulator/entity/entity.h>
 #include <argos3/core/simulator/actuator.h>
 #include <argos3/core/simulator/sensor.h>
+#include <argos3/core/simulator/loop_functions.h>
+#include <argos3/core/control_interface/ci_controller.h>
+#include <argos3/core/utility/plugins/dynamic_loading.h>
 
 namespace argos {
 
@@ -84,4 +87,22 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void WritePluginManifest(const std::string& str_file) {
+      CDynamicLoading::TManifest tManifest;
+      CDynamicLoading::AddToManifest<CSimulatedActuator>(tManifest);
+      CDynamicLoading::AddToManifest<CSimulatedSensor>  (tManifest);
+      CDynamicLoading::AddToManifest<CPhysicsEngine>    (tManifest);
+      CDynamicLoading::AddToManifest<CMedium>           (tManifest);
+      CDynamicLoading::AddToManifest<CVisualization>    (tManifest);
+      CDynamicLoading::AddToManifest<CEntity>           (tManifest);
+      CDynamicLoading::AddToManifest<CLoopFunctions>    (tManifest);
+      CDynamicLoading::AddToManifest<CCI_Controller>    (tManifest);
+      CDynamicLoading::WriteManifest(str_file, tManifest);
+      LOG << "[INFO] Written plugin manifest \"" << str_file << "\" with "
+          << tManifest.size() << " labels" << std::endl;
+   }
+
+   /****************************************/
+   /****************************************/
+
 }
@@ -56,6 +56,11 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void WritePluginManifest(const std::string& str_file);
+
+   /****************************************/
+   /****************************************/
+
    template <class TYPE>
    void QuerySearchPlugins(const std::string& str_query,
                            TQueryResult& t_result) {
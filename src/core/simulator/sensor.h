@@ -12,6 +12,7 @@ namespace argos {
 }
 
 #include <argos3/core/utility/plugins/factory.h>
+#include <argos3/core/utility/configuration/argos_configuration.h>
 
 namespace argos {
 
@@ -23,6 +24,18 @@ namespace argos {
     */
    class CSimulatedSensor {
 
+   public:
+
+      /**
+       * A function that updates many sensors of the same kind in one pass.
+       * It is called by the main thread, once per step.
+       * @param ppc_sensors The sensors to update.
+       * @param un_num_sensors The number of sensors.
+       * @see GetBatchUpdate()
+       */
+      typedef void TBatchUpdate(CSimulatedSensor** ppc_sensors,
+                                size_t un_num_sensors);
+
    public:
 
       /**
@@ -42,11 +55,66 @@ namespace argos {
        */
       virtual void SetRobot(CComposableEntity& c_entity) = 0;
 
+      /**
+       * The base class of the parsed XML configuration of a sensor.
+       * @see ParseConfiguration()
+       */
+      struct SConfiguration {
+         virtual ~SConfiguration() {}
+      };
+
+      /**
+       * Parses the XML configuration of the sensor.
+       * When this method returns a configuration, it is called once per
+       * controller, on a sensor that is then discarded, and the sensors of
+       * all the robots using that controller are initialized with
+       * InitFromConfiguration() instead of CCI_Sensor::Init(). The XML is then
+       * parsed once rather than once per robot. This method must not use
+       * the robot, since SetRobot() is not called.
+       * The default implementation returns <tt>NULL</tt>, in which case each
+       * sensor parses its XML configuration in CCI_Sensor::Init().
+       * @param t_tree The XML configuration of the sensor.
+       * @return The parsed configuration, owned by the caller, or <tt>NULL</tt>.
+       * @see InitFromConfiguration()
+       * @see CControllableEntity::SetController()
+       */
+      virtual SConfiguration* ParseConfiguration(TConfigurationNode& t_tree) {
+         return NULL;
+      }
+
+      /**
+       * Initializes the sensor from a configuration returned by ParseConfiguration().
+       * This method is called right after SetRobot(), in place of CCI_Sensor::Init().
+       * The default implementation throws, as it must be overridden by the
+       * sensors that implement ParseConfiguration().
+       * @param s_config The parsed configuration.
+       * @see ParseConfiguration()
+       */
+      virtual void InitFromConfiguration(const SConfiguration& s_config) {
+         THROW_ARGOSEXCEPTION("BUG: InitFromConfiguration() called on a sensor that does not implement it");
+      }
+
       /**
        * Updates the state of the entity associated to this sensor.
        */
       virtual void Update() = 0;
 
+      /**
+       * Returns the function that updates many sensors of this kind in one pass.
+       * When the space runs the sense phase sensor-major, the sensors of all
+       * the robots that return the same function are updated by a single call
+       * to it, rather than by calling Update() on each of them. The function
+       * must leave each sensor in the state Update() would, except for the
+       * values of the noise, which may be drawn in a different order.
+       * The default implementation returns <tt>NULL</tt>, in which case the
+       * sensors of the same class are still updated one after the other.
+       * @return The batch update function, or <tt>NULL</tt>.
+       * @see CSpace::SetSensorMajorSense()
+       */
+      virtual TBatchUpdate* GetBatchUpdate() {
+         return NULL;
+      }
+
    };
 
    /****************************************/
@@ -10,6 +10,13 @@
 #include <memory>
 #include <string>
 #include <sys/time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
 #include <argos3/core/utility/logging/argos_log.h>
 #include <argos3/core/utility/profiler/profiler.h>
 #include <argos3/core/utility/string_utilities.h>
@@ -192,6 +199,7 @@ namespace argos {
          m_unRandomSeed = unSeed;
          LOG << "[INFO] Using random seed = " << m_unRandomSeed << std::endl;
       }
+      CRandom::GetCategory("argos").SetTick(0);
       CRandom::GetCategory("argos").ResetRNGs();
       /* Reset the space */
       m_pcSpace->Reset();
@@ -249,6 +257,8 @@ namespace argos {
       if(CRandom::ExistsCategory("argos")) {
          CRandom::RemoveCategory("argos");
       }
+      /* The controller templates refer to the XML tree and to the factories */
+      CControllableEntity::ClearControllerTemplates();
       /* Free up factory data */
       CFactory<CMedium>::Destroy();
       CFactory<CPhysicsEngine>::Destroy();
@@ -270,6 +280,194 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   /* Identifies the checkpoints saved by CSimulator::SaveState() */
+   static const UInt32 CHECKPOINT_MAGIC   = 0x41524743; // "ARGC"
+   static const UInt32 CHECKPOINT_VERSION = 1;
+
+   /*
+    * Checks that all the elements of a map implement CMemento, as a
+    * checkpoint without the state of one of them could not be restored
+    * faithfully.
+    */
+   template <class MAP>
+   static void CheckMementoMap(MAP& t_map,
+                               const std::string& str_what) {
+      for(typename MAP::iterator it = t_map.begin(); it != t_map.end(); ++it) {
+         if(dynamic_cast<CMemento*>(it->second) == NULL) {
+            THROW_ARGOSEXCEPTION("Cannot save a checkpoint: the " << str_what <<
+                                 " \"" << it->first <<
+                                 "\" does not implement CMemento.");
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSimulator::SaveState(CByteArray& c_buffer) {
+      /* Fail before writing anything if a part of the state cannot be saved */
+      CheckMementoMap(m_mapPhysicsEngines, "physics engine");
+      CheckMementoMap(m_mapMedia, "medium");
+      /* The queued entity changes would be lost otherwise */
+      m_pcSpace->CommitEntityChanges();
+      /* Header */
+      c_buffer << CHECKPOINT_MAGIC
+               << CHECKPOINT_VERSION
+               << m_pcSpace->GetSimulationClock()
+               << m_unRandomSeed;
+      /* RNGs */
+      CByteArray cBlock;
+      CRandom::SaveState(cBlock);
+      c_buffer << static_cast<UInt32>(cBlock.Size());
+      c_buffer.AddBuffer(cBlock.ToCArray(), cBlock.Size());
+      /*
+       * Entities, parents before their components, so that enabling or
+       * disabling a parent on restore does not override its components
+       */
+      c_buffer << m_pcSpace->GetNumberEntities();
+      CEntity::TVector vecToVisit(m_pcSpace->GetRootEntityVector().rbegin(),
+                                  m_pcSpace->GetRootEntityVector().rend());
+      while(!vecToVisit.empty()) {
+         CEntity* pcEntity = vecToVisit.back();
+         vecToVisit.pop_back();
+         cBlock.Clear();
+         cBlock << pcEntity->GetContext() + pcEntity->GetId();
+         pcEntity->SaveState(cBlock);
+         c_buffer << static_cast<UInt32>(cBlock.Size());
+         c_buffer.AddBuffer(cBlock.ToCArray(), cBlock.Size());
+         CComposableEntity* pcComposable = dynamic_cast<CComposableEntity*>(pcEntity);
+         if(pcComposable != NULL) {
+            vecToVisit.insert(vecToVisit.end(),
+                              pcComposable->GetComponentVector().rbegin(),
+                              pcComposable->GetComponentVector().rend());
+         }
+      }
+      /* Physics engines and media */
+      SaveMementoMap(m_mapPhysicsEngines, c_buffer);
+      SaveMementoMap(m_mapMedia, c_buffer);
+      /* Loop functions, if they opt in */
+      CMemento* pcLoopFunctions = dynamic_cast<CMemento*>(m_pcLoopFunctions);
+      if(pcLoopFunctions != NULL) {
+         c_buffer << static_cast<UInt32>(1);
+         SaveStateBlock(*pcLoopFunctions, c_buffer);
+      }
+      else {
+         c_buffer << static_cast<UInt32>(0);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSimulator::LoadState(CByteArray& c_buffer) {
+      CMementoBlockReader cReader(c_buffer);
+      LoadState(cReader);
+      c_buffer.Clear();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSimulator::LoadState(CMementoBlockReader& c_reader) {
+      try {
+         /* Header */
+         if(c_reader.ReadUInt32() != CHECKPOINT_MAGIC) {
+            THROW_ARGOSEXCEPTION("The buffer does not contain an ARGoS checkpoint.");
+         }
+         UInt32 unVersion = c_reader.ReadUInt32();
+         if(unVersion != CHECKPOINT_VERSION) {
+            THROW_ARGOSEXCEPTION("Unsupported checkpoint version " << unVersion << ".");
+         }
+         m_pcSpace->CommitEntityChanges();
+         m_pcSpace->SetSimulationClock(c_reader.ReadUInt32());
+         m_unRandomSeed = c_reader.ReadUInt32();
+         /* RNGs */
+         CByteArray cBlock;
+         c_reader.ReadBlock(cBlock);
+         CRandom::LoadState(cBlock);
+         /* Entities */
+         UInt32 unEntities = c_reader.ReadUInt32();
+         if(unEntities != m_pcSpace->GetNumberEntities()) {
+            THROW_ARGOSEXCEPTION("The checkpoint contains " << unEntities << " entities, but the space contains " << m_pcSpace->GetNumberEntities() << ".");
+         }
+         CEntity::TMap& tEntities = m_pcSpace->GetEntityMapPerId();
+         std::string strId;
+         for(UInt32 i = 0; i < unEntities; ++i) {
+            c_reader.ReadBlock(cBlock);
+            cBlock >> strId;
+            CEntity::TMap::iterator it = tEntities.find(strId);
+            if(it == tEntities.end()) {
+               THROW_ARGOSEXCEPTION("Entity \"" << strId << "\" is in the checkpoint, but not in the space.");
+            }
+            it->second->LoadState(cBlock);
+         }
+         /* Physics engines and media */
+         LoadMementoMap(m_mapPhysicsEngines, c_reader);
+         LoadMementoMap(m_mapMedia, c_reader);
+         /* Loop functions */
+         if(c_reader.ReadUInt32() != 0) {
+            CMemento* pcLoopFunctions = dynamic_cast<CMemento*>(m_pcLoopFunctions);
+            if(pcLoopFunctions == NULL) {
+               THROW_ARGOSEXCEPTION("The loop functions do not implement CMemento.");
+            }
+            c_reader.LoadBlock(*pcLoopFunctions);
+         }
+         m_bTerminated = false;
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("Error restoring the simulation checkpoint", ex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSimulator::SaveStateToFile(const std::string& str_file_name) {
+      CByteArray cBuffer;
+      SaveState(cBuffer);
+      FILE* pcFile = ::fopen(str_file_name.c_str(), "wb");
+      if(pcFile == NULL) {
+         THROW_ARGOSEXCEPTION("Error opening file \"" << str_file_name << "\": " << ::strerror(errno));
+      }
+      size_t unWritten = ::fwrite(cBuffer.ToCArray(), 1, cBuffer.Size(), pcFile);
+      if(::fclose(pcFile) != 0 || unWritten != cBuffer.Size()) {
+         THROW_ARGOSEXCEPTION("Error writing file \"" << str_file_name << "\"");
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSimulator::LoadStateFromFile(const std::string& str_file_name) {
+      int nFD = ::open(str_file_name.c_str(), O_RDONLY);
+      if(nFD < 0) {
+         THROW_ARGOSEXCEPTION("Error opening file \"" << str_file_name << "\": " << ::strerror(errno));
+      }
+      struct stat sStat;
+      if(::fstat(nFD, &sStat) != 0 || sStat.st_size == 0) {
+         ::close(nFD);
+         THROW_ARGOSEXCEPTION("Error reading file \"" << str_file_name << "\"");
+      }
+      void* pMap = ::mmap(NULL, sStat.st_size, PROT_READ, MAP_PRIVATE, nFD, 0);
+      ::close(nFD);
+      if(pMap == MAP_FAILED) {
+         THROW_ARGOSEXCEPTION("Error mapping file \"" << str_file_name << "\": " << ::strerror(errno));
+      }
+      /* Deserialize straight from the mapping */
+      try {
+         CMementoBlockReader cReader(reinterpret_cast<const UInt8*>(pMap), sStat.st_size);
+         LoadState(cReader);
+      }
+      catch(CARGoSException& ex) {
+         ::munmap(pMap, sStat.st_size);
+         THROW_ARGOSEXCEPTION_NESTED("Error loading file \"" << str_file_name << "\"", ex);
+      }
+      ::munmap(pMap, sStat.st_size);
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CSimulator::Execute() {
       m_pcVisualization->Execute();
    }
@@ -278,6 +476,8 @@ namespace argos {
    /****************************************/
 
    void CSimulator::UpdateSpace() {
+      /* Key the draws of counter-based RNGs by the step about to be simulated */
+      CRandom::GetCategory("argos").SetTick(m_pcSpace->GetSimulationClock() + 1);
       /* Update the space */
       m_pcSpace->Update();
    }
@@ -335,6 +535,20 @@ namespace argos {
                   THROW_ARGOSEXCEPTION("Error parsing the <system> tag. Unknown threading method \"" << strThreadingMethod << "\". Available methods: \"balance_quantity\" and \"balance_length\".");
                }
             }
+            std::string strSense = "robot_major";
+            GetNodeAttributeOrDefault(tSystem, "sense", strSense, strSense);
+            if(strSense == "sensor_major") {
+               if(m_unThreads == 0) {
+                  LOG << "[INFO] Running the sense phase sensor-major" << std::endl;
+                  m_pcSpace->SetSensorMajorSense(true);
+               }
+               else {
+                  LOGERR << "[WARNING] The sensor-major sense phase requires threads=\"0\", ignored" << std::endl;
+               }
+            }
+            else if(strSense != "robot_major") {
+               THROW_ARGOSEXCEPTION("Error parsing the <system> tag. Unknown sense mode \"" << strSense << "\". Available modes: \"robot_major\" and \"sensor_major\".");
+            }
          }
          else {
             LOG << "[INFO] Not using threads" << std::endl;
@@ -350,9 +564,16 @@ namespace argos {
                                       "random_seed",
                                       m_unRandomSeed,
                                       static_cast<UInt32>(0));
+         /* Parse the RNG type */
+         std::string strRNGType = "mt19937";
+         GetNodeAttributeOrDefault(tExperiment, "rng", strRNGType, strRNGType);
+         CRandom::CRNG::EType eRNGType = CRandom::GetRNGType(strRNGType);
+         if(eRNGType == CRandom::CRNG::TYPE_PHILOX) {
+            LOG << "[INFO] Using the counter-based Philox random number generator" << std::endl;
+         }
          /* if random seed is 0 or is not specified, init with the current timeval */
          if(m_unRandomSeed != 0) {
-            CRandom::CreateCategory("argos", m_unRandomSeed);
+            CRandom::CreateCategory("argos", m_unRandomSeed, eRNGType);
             LOG << "[INFO] Using random seed = " << m_unRandomSeed << std::endl;
             m_bWasRandomSeedSet = true;
          }
@@ -363,7 +584,7 @@ namespace argos {
             ::gettimeofday(&sTimeValue, NULL);
             UInt32 unSeed = static_cast<UInt32>(sTimeValue.tv_usec);
             m_unRandomSeed = unSeed;
-            CRandom::CreateCategory("argos", unSeed);
+            CRandom::CreateCategory("argos", unSeed, eRNGType);
             LOG << "[INFO] Using random seed = " << unSeed << std::endl;
          }
          m_pcRNG = CRandom::CreateRNG("argos");
@@ -406,7 +627,9 @@ namespace argos {
             }
             bool bTrunc = true;
             GetNodeAttributeOrDefault(tProfiling, "truncate_file", bTrunc, bTrunc);
-            m_pcProfiler = new CProfiler(strFile, bTrunc);
+            bool bComponentTiming = true;
+            GetNodeAttributeOrDefault(tProfiling, "component_timing", bComponentTiming, bComponentTiming);
+            m_pcProfiler = new CProfiler(strFile, bTrunc, bComponentTiming);
          }
       }
       catch(CARGoSException& ex) {
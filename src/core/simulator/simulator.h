@@ -36,6 +36,7 @@ namespace argos {
 #include <argos3/core/config.h>
 #include <argos3/core/utility/math/rng.h>
 #include <argos3/core/utility/configuration/argos_configuration.h>
+#include <argos3/core/utility/configuration/memento.h>
 #include <argos3/core/utility/datatypes/datatypes.h>
 #include <argos3/core/simulator/physics_engine/physics_engine.h>
 #include <argos3/core/simulator/medium/medium.h>
@@ -59,7 +60,7 @@ namespace argos {
     * loop.
     *
     */
-   class CSimulator {
+   class CSimulator : public CMemento {
 
    private:
 
@@ -253,6 +254,15 @@ namespace argos {
          return m_unMaxSimulationClock;
       }
 
+      /**
+       * Sets the maximum simulation clock value.
+       * @param un_max_simulation_clock The maximum simulation clock value; 0 means unlimited.
+       * @see GetMaxSimulationClock()
+       */
+      inline void SetMaxSimulationClock(UInt32 un_max_simulation_clock) {
+         m_unMaxSimulationClock = un_max_simulation_clock;
+      }
+
       /**
        * Returns the number of threads used during the experiment.
        * @return The number of threads used during the experiment.
@@ -344,6 +354,64 @@ namespace argos {
        */
       void Destroy();
 
+      /**
+       * Saves a checkpoint of the running experiment to the given buffer.
+       * <p>
+       * The checkpoint contains the simulation clock, the state of all the
+       * RNG categories and the state of every entity, as saved by
+       * CEntity::SaveState(): poses, LED colors, and the state of the
+       * sensors, actuators and controllers that implement CMemento. The
+       * loop functions are saved if they implement CMemento.
+       * </p>
+       * <p>
+       * Every physics engine and every medium must implement CMemento;
+       * the dynamics2d and pointmass3d engines and the built-in media do.
+       * The dynamics2d engine does not save the contacts that chipmunk
+       * caches to warm-start its solver, so a run restored while bodies
+       * touch is not bit-exact: it diverges within the solver tolerance.
+       * </p>
+       * <p>
+       * The checkpoint is a flat sequence of size-prefixed binary blocks,
+       * so it can be written to a file as-is. To branch several runs from
+       * the same point, save once and restore a copy of the buffer before
+       * each run.
+       * </p>
+       * Queued entity additions and removals are committed first.
+       * @param c_buffer the target buffer
+       * @throws CARGoSException if a physics engine or a medium does not implement CMemento.
+       * @see LoadState()
+       * @see SaveStateToFile()
+       */
+      virtual void SaveState(CByteArray& c_buffer);
+
+      /**
+       * Restores a checkpoint saved by SaveState().
+       * The experiment must be the same that was running when the
+       * checkpoint was saved, with the same entities.
+       * @param c_buffer the source buffer; it is emptied.
+       * @throws CARGoSException if the checkpoint does not match the experiment.
+       * @see SaveState()
+       */
+      virtual void LoadState(CByteArray& c_buffer);
+
+      /**
+       * Saves a checkpoint of the running experiment to the given file.
+       * @param str_file_name the file name
+       * @throws CARGoSException in case of I/O errors.
+       * @see SaveState()
+       */
+      void SaveStateToFile(const std::string& str_file_name);
+
+      /**
+       * Restores a checkpoint from the given file.
+       * The file is memory-mapped and the checkpoint is read in place,
+       * without copying it into a buffer first.
+       * @param str_file_name the file name
+       * @throws CARGoSException in case of I/O errors or if the checkpoint does not match the experiment.
+       * @see LoadState()
+       */
+      void LoadStateFromFile(const std::string& str_file_name);
+
       /**
        * Executes the simulation loop.
        */
@@ -382,6 +450,8 @@ namespace argos {
       void InitMedia2();
       void InitVisualization(TConfigurationNode& t_tree);
 
+      void LoadState(CMementoBlockReader& c_reader);
+
    private:
 
       typedef std::map<std::string, TConfigurationNode*> TControllerConfigurationMap;
@@ -12,11 +12,14 @@
 #include <argos3/core/utility/math/range.h>
 #include <argos3/core/utility/logging/argos_log.h>
 #include <argos3/core/utility/math/rng.h>
+#include <argos3/core/utility/math/general.h>
 #include <argos3/core/simulator/simulator.h>
 #include <argos3/core/simulator/entity/composable_entity.h>
 #include <argos3/core/simulator/entity/positional_entity.h>
 #include <argos3/core/simulator/loop_functions.h>
+#include <algorithm>
 #include <cstring>
+#include <typeinfo>
 #include "space.h"
 
 namespace argos {
@@ -27,9 +30,15 @@ namespace argos {
    CSpace::CSpace() :
       m_cSimulator(CSimulator::GetInstance()),
       m_unSimulationClock(0),
+      m_bDeferCompaction(false),
+      m_unFirstEntityHole(NO_HOLE),
+      m_unFirstRootEntityHole(NO_HOLE),
+      m_bSensorMajorSense(false),
+      m_bSenseScheduleDirty(true),
       m_pcFloorEntity(NULL),
       m_ptPhysicsEngines(NULL),
-      m_ptMedia(NULL) {}
+      m_ptMedia(NULL),
+      m_pcProfiler(NULL) {}
 
    /****************************************/
    /****************************************/
@@ -38,6 +47,29 @@ namespace argos {
       /* Get reference to physics engine and media vectors */
       m_ptPhysicsEngines = &(m_cSimulator.GetPhysicsEngines());
       m_ptMedia = &(m_cSimulator.GetMedia());
+      /* Register the timed components, if profiling */
+      std::fill(m_punPhaseTimers, m_punPhaseTimers + PHASE_TIMER_NUM, 0);
+      m_vecPhysicsEngineTimers.assign(m_ptPhysicsEngines->size(), 0);
+      m_vecMediumTimers.assign(m_ptMedia->size(), 0);
+      if(m_cSimulator.IsProfiling() &&
+         m_cSimulator.GetProfiler().IsComponentTimingEnabled()) {
+         m_pcProfiler = &m_cSimulator.GetProfiler();
+         m_punPhaseTimers[PHASE_TIMER_STEP]          = m_pcProfiler->RegisterComponent("phase:step");
+         m_punPhaseTimers[PHASE_TIMER_ACT]           = m_pcProfiler->RegisterComponent("phase:act");
+         m_punPhaseTimers[PHASE_TIMER_PHYSICS]       = m_pcProfiler->RegisterComponent("phase:physics");
+         m_punPhaseTimers[PHASE_TIMER_MEDIA]         = m_pcProfiler->RegisterComponent("phase:media");
+         m_punPhaseTimers[PHASE_TIMER_PRE_STEP]      = m_pcProfiler->RegisterComponent("phase:pre_step");
+         m_punPhaseTimers[PHASE_TIMER_SENSE_CONTROL] = m_pcProfiler->RegisterComponent("phase:sense_control");
+         m_punPhaseTimers[PHASE_TIMER_POST_STEP]     = m_pcProfiler->RegisterComponent("phase:post_step");
+         for(size_t i = 0; i < m_ptPhysicsEngines->size(); ++i) {
+            m_vecPhysicsEngineTimers[i] =
+               m_pcProfiler->RegisterComponent("physics_engine:" + (*m_ptPhysicsEngines)[i]->GetId());
+         }
+         for(size_t i = 0; i < m_ptMedia->size(); ++i) {
+            m_vecMediumTimers[i] =
+               m_pcProfiler->RegisterComponent("medium:" + (*m_ptMedia)[i]->GetId());
+         }
+      }
       /* Get the arena center and size */
       GetNodeAttributeOrDefault(t_tree, "center", m_cArenaCenter, m_cArenaCenter);
       GetNodeAttribute(t_tree, "size", m_cArenaSize);
@@ -71,6 +103,8 @@ namespace argos {
    /****************************************/
 
    void CSpace::Reset() {
+      /* Apply the queued entity changes */
+      CommitEntityChanges();
       /* Reset the simulation clock */
       m_unSimulationClock = 0;
       /* Reset the entities */
@@ -83,6 +117,8 @@ namespace argos {
    /****************************************/
 
    void CSpace::Destroy() {
+      /* Apply the queued entity changes, so queued entities are not leaked */
+      CommitEntityChanges();
       /* Remove all entities */
       while(!m_vecRootEntities.empty()) {
          CallEntityOperation<CSpaceOperationRemoveEntity, CSpace, void>(*this, *m_vecRootEntities.back());
@@ -117,20 +153,41 @@ namespace argos {
    /****************************************/
 
    void CSpace::Update() {
+      CProfiler::CScopedTimer cStepTimer(m_pcProfiler, m_punPhaseTimers[PHASE_TIMER_STEP]);
       /* Increase the simulation clock */
       IncreaseSimulationClock();
       /* Perform the 'act' phase for controllable entities */
-      UpdateControllableEntitiesAct();
+      {
+         CProfiler::CScopedTimer cTimer(m_pcProfiler, m_punPhaseTimers[PHASE_TIMER_ACT]);
+         UpdateControllableEntitiesAct();
+      }
       /* Update the physics engines */
-      UpdatePhysics();
+      {
+         CProfiler::CScopedTimer cTimer(m_pcProfiler, m_punPhaseTimers[PHASE_TIMER_PHYSICS]);
+         UpdatePhysics();
+      }
       /* Update media */
-      UpdateMedia();
+      {
+         CProfiler::CScopedTimer cTimer(m_pcProfiler, m_punPhaseTimers[PHASE_TIMER_MEDIA]);
+         UpdateMedia();
+      }
       /* Call loop functions */
-      m_cSimulator.GetLoopFunctions().PreStep();
+      {
+         CProfiler::CScopedTimer cTimer(m_pcProfiler, m_punPhaseTimers[PHASE_TIMER_PRE_STEP]);
+         m_cSimulator.GetLoopFunctions().PreStep();
+      }
       /* Perform the 'sense+step' phase for controllable entities */
-      UpdateControllableEntitiesSenseStep();
+      {
+         CProfiler::CScopedTimer cTimer(m_pcProfiler, m_punPhaseTimers[PHASE_TIMER_SENSE_CONTROL]);
+         UpdateControllableEntitiesSenseStep();
+      }
       /* Call loop functions */
-      m_cSimulator.GetLoopFunctions().PostStep();
+      {
+         CProfiler::CScopedTimer cTimer(m_pcProfiler, m_punPhaseTimers[PHASE_TIMER_POST_STEP]);
+         m_cSimulator.GetLoopFunctions().PostStep();
+         /* Apply the entity changes queued during the step */
+         if(HasPendingEntityChanges()) CommitEntityChanges();
+      }
       /* Flush logs */
       LOG.Flush();
       LOGERR.Flush();
@@ -139,20 +196,286 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CSpace::QueueAddEntity(CEntity& c_entity) {
+      m_vecPendingAdditions.push_back(&c_entity);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpace::QueueRemoveEntity(CEntity& c_entity) {
+      m_vecPendingRemovals.push_back(GetEntityHandle(c_entity));
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpace::CommitEntityChanges() {
+      /*
+       * Removals first, so the freed slots and ids can be reused by the additions.
+       * The removals leave holes in the entity vectors, which are closed
+       * all at once at the end.
+       */
+      m_bDeferCompaction = true;
+      try {
+         for(size_t i = 0; i < m_vecPendingRemovals.size(); ++i) {
+            /* The handle is stale if the entity was queued twice or removed with its parent */
+            CEntity* pcEntity = GetEntity(m_vecPendingRemovals[i]);
+            if(pcEntity != NULL) {
+               CallEntityOperation<CSpaceOperationRemoveEntity, CSpace, void>(*this, *pcEntity);
+            }
+         }
+      }
+      catch(...) {
+         m_bDeferCompaction = false;
+         m_vecPendingRemovals.clear();
+         CompactEntityVectors();
+         throw;
+      }
+      m_bDeferCompaction = false;
+      m_vecPendingRemovals.clear();
+      CompactEntityVectors();
+      /* Additions; swap the queue out, in case an addition queues more changes */
+      CEntity::TVector vecAdditions;
+      vecAdditions.swap(m_vecPendingAdditions);
+      for(size_t i = 0; i < vecAdditions.size(); ++i) {
+         CallEntityOperation<CSpaceOperationAddEntity, CSpace, void>(*this, *vecAdditions[i]);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CSpace::SEntityHandle CSpace::GetEntityHandle(const CEntity& c_entity) const {
+      ssize_t nIndex = c_entity.GetIndex();
+      if(nIndex < 0 ||
+         static_cast<size_t>(nIndex) >= m_vecEntitySlots.size() ||
+         m_vecEntitySlots[nIndex].Entity != &c_entity) {
+         THROW_ARGOSEXCEPTION("Entity \"" << c_entity.GetContext() << c_entity.GetId() << "\" is not in the space.");
+      }
+      return SEntityHandle(nIndex, m_vecEntitySlots[nIndex].Generation);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   const CEntity::TVector& CSpace::GetEntityVectorByType(const std::string& str_type) const {
+      std::map<std::string, CEntity::TVector>::const_iterator it = m_mapEntityVectorsPerType.find(str_type);
+      if(it != m_mapEntityVectorsPerType.end()) {
+         return it->second;
+      }
+      THROW_ARGOSEXCEPTION("Entity vector for type \"" << str_type << "\" not found.");
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpace::IndexEntity(CEntity& c_entity) {
+      /* Take a free slot, or make a new one */
+      size_t unIdx;
+      if(!m_vecFreeEntitySlots.empty()) {
+         unIdx = m_vecFreeEntitySlots.back();
+         m_vecFreeEntitySlots.pop_back();
+      }
+      else {
+         unIdx = m_vecEntitySlots.size();
+         m_vecEntitySlots.push_back(SEntitySlot());
+         m_vecEntitySlots.back().Generation = 0;
+      }
+      SEntitySlot& sSlot = m_vecEntitySlots[unIdx];
+      sSlot.Entity = &c_entity;
+      /* Add entity to global vector */
+      sSlot.Position = m_vecEntities.size();
+      m_vecEntities.push_back(&c_entity);
+      /* Add entity to root vector */
+      if(!c_entity.HasParent()) {
+         sSlot.RootPosition = m_vecRootEntities.size();
+         m_vecRootEntities.push_back(&c_entity);
+      }
+      else {
+         sSlot.RootPosition = -1;
+      }
+      /* Add entity to the vector of its type */
+      sSlot.TypeVector = &m_mapEntityVectorsPerType[c_entity.GetTypeDescription()];
+      sSlot.TypePosition = sSlot.TypeVector->size();
+      sSlot.TypeVector->push_back(&c_entity);
+      c_entity.SetIndex(unIdx);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpace::UnindexEntity(CEntity& c_entity) {
+      SEntitySlot& sSlot = m_vecEntitySlots[c_entity.GetIndex()];
+      /* Leave a hole in each vector and remember the first one */
+      m_vecEntities[sSlot.Position] = NULL;
+      m_unFirstEntityHole = Min(m_unFirstEntityHole, sSlot.Position);
+      if(sSlot.RootPosition >= 0) {
+         m_vecRootEntities[sSlot.RootPosition] = NULL;
+         m_unFirstRootEntityHole = Min(m_unFirstRootEntityHole,
+                                       static_cast<size_t>(sSlot.RootPosition));
+      }
+      (*sSlot.TypeVector)[sSlot.TypePosition] = NULL;
+      std::map<CEntity::TVector*, size_t>::iterator itHole =
+         m_mapTypeVectorHoles.insert(std::make_pair(sSlot.TypeVector, sSlot.TypePosition)).first;
+      itHole->second = Min(itHole->second, sSlot.TypePosition);
+      /* Free the slot and invalidate its handles */
+      sSlot.Entity = NULL;
+      sSlot.TypeVector = NULL;
+      sSlot.TypeMap = NULL;
+      ++sSlot.Generation;
+      m_vecFreeEntitySlots.push_back(c_entity.GetIndex());
+      if(!m_bDeferCompaction) {
+         CompactEntityVectors();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   template <typename POSITION>
+   void CSpace::CompactEntityVector(CEntity::TVector& vec_entities,
+                                    size_t un_first_hole,
+                                    POSITION SEntitySlot::* pt_position) {
+      /* Move the entities after the first hole back, keeping their order */
+      size_t unTo = un_first_hole;
+      for(size_t unFrom = un_first_hole; unFrom < vec_entities.size(); ++unFrom) {
+         if(vec_entities[unFrom] != NULL) {
+            vec_entities[unTo] = vec_entities[unFrom];
+            m_vecEntitySlots[vec_entities[unTo]->GetIndex()].*pt_position = unTo;
+            ++unTo;
+         }
+      }
+      vec_entities.resize(unTo);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpace::CompactEntityVectors() {
+      if(m_unFirstEntityHole != NO_HOLE) {
+         CompactEntityVector(m_vecEntities, m_unFirstEntityHole, &SEntitySlot::Position);
+         m_unFirstEntityHole = NO_HOLE;
+      }
+      if(m_unFirstRootEntityHole != NO_HOLE) {
+         CompactEntityVector(m_vecRootEntities, m_unFirstRootEntityHole, &SEntitySlot::RootPosition);
+         m_unFirstRootEntityHole = NO_HOLE;
+      }
+      for(std::map<CEntity::TVector*, size_t>::iterator it = m_mapTypeVectorHoles.begin();
+          it != m_mapTypeVectorHoles.end();
+          ++it) {
+         CompactEntityVector(*it->first, it->second, &SEntitySlot::TypePosition);
+      }
+      m_mapTypeVectorHoles.clear();
+      /* Drop the removed controllable entities in a single pass */
+      if(!m_vecRemovedControllableEntities.empty()) {
+         std::sort(m_vecRemovedControllableEntities.begin(),
+                   m_vecRemovedControllableEntities.end());
+         size_t unTo = 0;
+         for(size_t unFrom = 0; unFrom < m_vecControllableEntities.size(); ++unFrom) {
+            if(!std::binary_search(m_vecRemovedControllableEntities.begin(),
+                                   m_vecRemovedControllableEntities.end(),
+                                   m_vecControllableEntities[unFrom])) {
+               m_vecControllableEntities[unTo] = m_vecControllableEntities[unFrom];
+               ++unTo;
+            }
+         }
+         m_vecControllableEntities.resize(unTo);
+         m_vecRemovedControllableEntities.clear();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CSpace::AddControllableEntity(CControllableEntity& c_entity) {
       m_vecControllableEntities.push_back(&c_entity);
+      m_bSenseScheduleDirty = true;
    }
 
    /****************************************/
    /****************************************/
 
    void CSpace::RemoveControllableEntity(CControllableEntity& c_entity) {
-      CControllableEntity::TVector::iterator it = find(m_vecControllableEntities.begin(),
-                                                       m_vecControllableEntities.end(),
-                                                       &c_entity);
-      if(it != m_vecControllableEntities.end()) {
-         m_vecControllableEntities.erase(it);
+      if(m_bDeferCompaction) {
+         /* Removed by CompactEntityVectors() with the other queued removals */
+         m_vecRemovedControllableEntities.push_back(&c_entity);
+      }
+      else {
+         CControllableEntity::TVector::iterator it = find(m_vecControllableEntities.begin(),
+                                                          m_vecControllableEntities.end(),
+                                                          &c_entity);
+         if(it != m_vecControllableEntities.end()) {
+            m_vecControllableEntities.erase(it);
+         }
+      }
+      m_bSenseScheduleDirty = true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpace::UpdateControllableEntitiesSenseSensorMajor() {
+      if(m_bSenseScheduleDirty) {
+         BuildSenseSchedule();
+      }
+      for(size_t i = 0; i < m_vecControllableEntities.size(); ++i) {
+         if(m_vecControllableEntities[i]->IsEnabled()) {
+            m_vecControllableEntities[i]->ClearCheckedRays();
+         }
+      }
+      for(size_t i = 0; i < m_vecSensePasses.size(); ++i) {
+         SSensePass& sPass = m_vecSensePasses[i];
+         /* Skip the sensors of the disabled entities */
+         sPass.EnabledSensors.clear();
+         for(size_t j = 0; j < sPass.Sensors.size(); ++j) {
+            if(sPass.Entities[j]->IsEnabled()) {
+               sPass.EnabledSensors.push_back(sPass.Sensors[j]);
+            }
+         }
+         if(sPass.EnabledSensors.empty()) continue;
+         if(sPass.BatchUpdate != NULL) {
+            sPass.BatchUpdate(&sPass.EnabledSensors[0], sPass.EnabledSensors.size());
+         }
+         else {
+            for(size_t j = 0; j < sPass.EnabledSensors.size(); ++j) {
+               sPass.EnabledSensors[j]->Update();
+            }
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CSpace::BuildSenseSchedule() {
+      m_vecSensePasses.clear();
+      /* Passes are identified by batch update function, or by sensor class */
+      std::map<CSimulatedSensor::TBatchUpdate*, size_t> mapBatchPasses;
+      std::map<std::string, size_t> mapClassPasses;
+      for(size_t i = 0; i < m_vecControllableEntities.size(); ++i) {
+         const std::map<std::string, CSimulatedSensor*>& mapSensors =
+            m_vecControllableEntities[i]->GetSensors();
+         for(std::map<std::string, CSimulatedSensor*>::const_iterator it = mapSensors.begin();
+             it != mapSensors.end();
+             ++it) {
+            CSimulatedSensor::TBatchUpdate* ptBatchUpdate = it->second->GetBatchUpdate();
+            size_t unPass = m_vecSensePasses.size();
+            if(ptBatchUpdate != NULL) {
+               unPass = mapBatchPasses.insert(std::make_pair(ptBatchUpdate, unPass)).first->second;
+            }
+            else {
+               unPass = mapClassPasses.insert(std::make_pair(std::string(typeid(*it->second).name()), unPass)).first->second;
+            }
+            if(unPass == m_vecSensePasses.size()) {
+               m_vecSensePasses.push_back(SSensePass());
+               m_vecSensePasses.back().BatchUpdate = ptBatchUpdate;
+            }
+            m_vecSensePasses[unPass].Sensors.push_back(it->second);
+            m_vecSensePasses[unPass].Entities.push_back(m_vecControllableEntities[i]);
+         }
       }
+      m_bSenseScheduleDirty = false;
    }
 
    /****************************************/
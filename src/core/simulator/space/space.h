@@ -17,9 +17,11 @@ namespace argos {
 }
 
 #include <argos3/core/utility/datatypes/any.h>
+#include <argos3/core/utility/profiler/profiler.h>
 #include <argos3/core/simulator/medium/medium.h>
 #include <argos3/core/simulator/entity/embodied_entity.h>
 #include <argos3/core/simulator/entity/controllable_entity.h>
+#include <argos3/core/simulator/sensor.h>
 
 namespace argos {
 
@@ -75,6 +77,36 @@ namespace argos {
        */
       typedef std::map <std::string, TMapPerType, std::less <std::string> > TMapPerTypePerId;
 
+      /**
+       * A generational handle to an entity in the space.
+       * <p>
+       * A handle stays valid as long as the entity is in the space. Once the
+       * entity is removed, CSpace::GetEntity(const SEntityHandle&) returns
+       * <tt>NULL</tt> for its handles, even if the index of the entity has
+       * been assigned to a new entity in the meantime.
+       * </p>
+       * @see CSpace::GetEntityHandle()
+       */
+      struct SEntityHandle {
+         /** The index of the entity, as returned by CEntity::GetIndex() */
+         ssize_t Index;
+         /** The generation of the index slot when the handle was created */
+         UInt32 Generation;
+
+         SEntityHandle() :
+            Index(-1),
+            Generation(0) {}
+
+         SEntityHandle(ssize_t n_index,
+                       UInt32 un_generation) :
+            Index(n_index),
+            Generation(un_generation) {}
+
+         bool operator==(const SEntityHandle& s_other) const {
+            return Index == s_other.Index && Generation == s_other.Generation;
+         }
+      };
+
       /****************************************/
       /****************************************/
 
@@ -116,6 +148,8 @@ namespace argos {
       /**
        * Returns a vector of all the entities in the space.
        * All entities are returned, i.e., all the components of a robot.
+       * The entities are in order of addition; removing entities does
+       * not change the order of the others.
        * @return a vector of all the entities in the space.
        * @see GetRootEntityVector()
        */
@@ -130,6 +164,8 @@ namespace argos {
        * returns all entities including the components of a composable
        * entity, while this method does not return any component, but only
        * the parentless composables.
+       * The entities are in order of addition; removing entities does
+       * not change the order of the others.
        * @return a vector of all the root entities in the space.
        * @see GetEntityVector()
        */
@@ -267,21 +303,14 @@ namespace argos {
                                  strEntityQualifiedName <<
                                  "\". An entity with that id already exists.");
          }
-         /* Add the entity to the indexes */
-         if(!c_entity.HasParent()) {
-            m_vecRootEntities.push_back(&c_entity);
-         }
-         /* Calculate index of in the global vector */
-         size_t unIdx =
-            !m_vecEntities.empty() ?
-            m_vecEntities.back()->GetIndex() + 1
-            :
-            0;
-         /* Add entity to global vector */
-         m_vecEntities.push_back(&c_entity);
-         c_entity.SetIndex(unIdx);
+         /* Add the entity to the vectors and assign it a slot */
+         IndexEntity(c_entity);
+         /* Add the entity to the maps */
          m_mapEntitiesPerId[strEntityQualifiedName] = &c_entity;
-         m_mapEntitiesPerTypePerId[c_entity.GetTypeDescription()][strEntityQualifiedName] = &c_entity;
+         SEntitySlot& sSlot = m_vecEntitySlots[c_entity.GetIndex()];
+         sSlot.TypeMap = &m_mapEntitiesPerTypePerId[c_entity.GetTypeDescription()];
+         sSlot.TypeMapEntry = sSlot.TypeMap->insert(std::make_pair(strEntityQualifiedName, CAny())).first;
+         sSlot.TypeMapEntry->second = &c_entity;
       }
 
       /**
@@ -291,38 +320,110 @@ namespace argos {
        */
       template <typename ENTITY>
       void RemoveEntity(ENTITY& c_entity) {
-         std::string strEntityQualifiedName = c_entity.GetContext() + c_entity.GetId();
-         /* Search for entity in the index per type */
-         TMapPerTypePerId::iterator itMapPerType = m_mapEntitiesPerTypePerId.find(c_entity.GetTypeDescription());
-         if(itMapPerType != m_mapEntitiesPerTypePerId.end()) {
-            /* Search for entity in the index per type per id */
-            TMapPerType::iterator itMapPerTypePerId = itMapPerType->second.find(strEntityQualifiedName);
-            if(itMapPerTypePerId != itMapPerType->second.end()) {
-               /* Remove the entity from the indexes */
-               CEntity::TVector::iterator itVec = find(m_vecEntities.begin(),
-                                                       m_vecEntities.end(),
-                                                       &c_entity);
-               m_vecEntities.erase(itVec);
-               CEntity::TMap::iterator itMap = m_mapEntitiesPerId.find(strEntityQualifiedName);
-               itMapPerType->second.erase(itMapPerTypePerId);
-               m_mapEntitiesPerId.erase(itMap);
-               if(!c_entity.HasParent()) {
-                  CEntity::TVector::iterator itRootVec = find(m_vecRootEntities.begin(),
-                                                              m_vecRootEntities.end(),
-                                                              &c_entity);
-                  m_vecRootEntities.erase(itRootVec);
-               }
-               /* Remove entity object */
-               c_entity.Destroy();
-               delete &c_entity;
-               return;
-            }
+         /* Find the entity through its slot */
+         ssize_t nIndex = c_entity.GetIndex();
+         if(nIndex < 0 ||
+            static_cast<size_t>(nIndex) >= m_vecEntitySlots.size() ||
+            m_vecEntitySlots[nIndex].Entity != &c_entity) {
+            THROW_ARGOSEXCEPTION("CSpace::RemoveEntity() : Entity \"" <<
+                                 c_entity.GetContext() << c_entity.GetId() <<
+                                 "\" has not been found in the indexes.");
          }
-         THROW_ARGOSEXCEPTION("CSpace::RemoveEntity() : Entity \"" <<
-                              strEntityQualifiedName <<
-                              "\" has not been found in the indexes.");
+         SEntitySlot& sSlot = m_vecEntitySlots[nIndex];
+         /* Remove the entity from the maps; the map per type is not searched */
+         m_mapEntitiesPerId.erase(c_entity.GetContext() + c_entity.GetId());
+         sSlot.TypeMap->erase(sSlot.TypeMapEntry);
+         /* Remove the entity from the vectors and free its slot */
+         UnindexEntity(c_entity);
+         /* Remove entity object */
+         c_entity.Destroy();
+         delete &c_entity;
+      }
+
+      /**
+       * Queues an entity to be added to the space at the end of the current step.
+       * The entity is added by CommitEntityChanges(), together with all the
+       * other queued additions and removals.
+       * @param c_entity The entity to add; it must be allocated with <tt>new</tt>.
+       * @see CommitEntityChanges()
+       */
+      void QueueAddEntity(CEntity& c_entity);
+
+      /**
+       * Queues an entity to be removed from the space at the end of the current step.
+       * Queueing an entity more than once is harmless.
+       * @param c_entity The entity to remove.
+       * @throws CARGoSException if the entity is not in the space.
+       * @see CommitEntityChanges()
+       */
+      void QueueRemoveEntity(CEntity& c_entity);
+
+      /**
+       * Performs the queued entity removals, then the queued additions.
+       * The entity vectors are compacted once after all the removals,
+       * rather than after each of them.
+       * This method is called by Update() after the loop functions
+       * PostStep(), and by Reset() and Destroy().
+       */
+      void CommitEntityChanges();
+
+      /**
+       * Returns <tt>true</tt> if there are queued entity additions or removals.
+       */
+      inline bool HasPendingEntityChanges() const {
+         return !m_vecPendingAdditions.empty() || !m_vecPendingRemovals.empty();
       }
 
+      /**
+       * Returns a handle to the given entity.
+       * @param c_entity The entity.
+       * @return A handle to the given entity.
+       * @throws CARGoSException if the entity is not in the space.
+       * @see GetEntity(const SEntityHandle&)
+       */
+      SEntityHandle GetEntityHandle(const CEntity& c_entity) const;
+
+      /**
+       * Returns the entity referred to by the given handle.
+       * @param s_handle The handle.
+       * @return The entity, or <tt>NULL</tt> if the entity has been removed.
+       */
+      inline CEntity* GetEntity(const SEntityHandle& s_handle) const {
+         if(s_handle.Index < 0 ||
+            static_cast<size_t>(s_handle.Index) >= m_vecEntitySlots.size()) return NULL;
+         const SEntitySlot& sSlot = m_vecEntitySlots[s_handle.Index];
+         return (sSlot.Generation == s_handle.Generation) ? sSlot.Entity : NULL;
+      }
+
+      /**
+       * Returns the entity with the given index.
+       * The index of an entity is returned by CEntity::GetIndex(); it does
+       * not change while the entity is in the space, but it is reused
+       * after the entity is removed.
+       * @param n_index The index of the wanted entity.
+       * @return The entity with the given index.
+       * @throws CARGoSException if no entity has the given index.
+       */
+      inline CEntity& GetEntityAtIndex(ssize_t n_index) const {
+         if(n_index >= 0 &&
+            static_cast<size_t>(n_index) < m_vecEntitySlots.size() &&
+            m_vecEntitySlots[n_index].Entity != NULL) {
+            return *m_vecEntitySlots[n_index].Entity;
+         }
+         THROW_ARGOSEXCEPTION("No entity has index " << n_index << ".");
+      }
+
+      /**
+       * Returns a vector of all the entities of the given type.
+       * The 'type' here refers to the string returned by CEntity::GetTypeDescription().
+       * Unlike GetEntitiesByType(), the entities are not ordered by id,
+       * but the vector can be iterated without chasing map nodes.
+       * @param str_type The wanted type.
+       * @return A vector of all the entities of the given type.
+       * @throws CARGoSException if the given type is not valid.
+       */
+      const CEntity::TVector& GetEntityVectorByType(const std::string& str_type) const;
+
       /**
        * Returns the current value of the simulation clock.
        * The clock is measured in ticks. You can set how much a tick is long in seconds in the XML.
@@ -396,6 +497,41 @@ namespace argos {
          return m_cArenaLimits;
       }
 
+      /**
+       * Returns <tt>true</tt> if the sense phase is run sensor-major.
+       * @return <tt>true</tt> if the sense phase is run sensor-major.
+       * @see SetSensorMajorSense()
+       */
+      inline bool IsSensorMajorSense() const {
+         return m_bSensorMajorSense;
+      }
+
+      /**
+       * Sets whether the sense phase is run sensor-major.
+       * <p>
+       * By default, the sense phase is robot-major: each robot updates all
+       * its sensors in turn. Sensor-major, the space runs a sequence of
+       * passes, one per kind of sensor, and each pass updates that kind of
+       * sensor for all the robots, through CSimulatedSensor::GetBatchUpdate()
+       * when available. The readings of noiseless sensors are the same in
+       * both modes. Noisy sensors draw from the shared random number
+       * generator in a different order, so their readings have the same
+       * distribution but not the same values, and a run is not reproduced
+       * by switching mode with the same random seed.
+       * </p>
+       * <p>
+       * The passes are rebuilt when controllable entities are added or
+       * removed; a controller changed afterwards must be re-added. The
+       * per-sensor profiler timers are not used in this mode. Only the
+       * space without threads supports it.
+       * </p>
+       * @param b_sensor_major <tt>true</tt> to run the sense phase sensor-major.
+       */
+      inline void SetSensorMajorSense(bool b_sensor_major) {
+         m_bSensorMajorSense = b_sensor_major;
+         m_bSenseScheduleDirty = true;
+      }
+
       virtual void AddControllableEntity(CControllableEntity& c_entity);
       virtual void RemoveControllableEntity(CControllableEntity& c_entity);
       virtual void AddEntityToPhysicsEngine(CEmbodiedEntity& c_entity);
@@ -407,10 +543,75 @@ namespace argos {
       virtual void UpdateMedia() = 0;
       virtual void UpdateControllableEntitiesSenseStep() = 0;
 
+      /**
+       * Assigns a slot to the entity and adds it to the entity vectors.
+       * @param c_entity The entity.
+       */
+      void IndexEntity(CEntity& c_entity);
+
+      /**
+       * Removes the entity from the entity vectors and frees its slot.
+       * The entity leaves a hole in each vector, which is closed by
+       * CompactEntityVectors(), keeping the order of the other entities.
+       * The vectors are compacted right away, unless CommitEntityChanges()
+       * is removing entities.
+       * @param c_entity The entity.
+       */
+      void UnindexEntity(CEntity& c_entity);
+
+      /**
+       * Closes the holes left in the entity vectors by UnindexEntity().
+       * Each vector is compacted in a single pass from its first hole.
+       */
+      void CompactEntityVectors();
+
+      /**
+       * Runs the sense phase sensor-major for the enabled controllable entities.
+       * @see SetSensorMajorSense()
+       */
+      void UpdateControllableEntitiesSenseSensorMajor();
+
+      /**
+       * Groups the sensors of the controllable entities into sense passes.
+       */
+      void BuildSenseSchedule();
+
       void Distribute(TConfigurationNode& t_tree);
 
       void AddBoxStrip(TConfigurationNode& t_tree);
 
+      /**
+       * Updates the i-th physics engine, timing it if profiling is active.
+       * @param un_index The index of the physics engine.
+       */
+      inline void UpdatePhysicsEngine(size_t un_index) {
+         CProfiler::CScopedTimer cTimer(m_pcProfiler, m_vecPhysicsEngineTimers[un_index]);
+         (*m_ptPhysicsEngines)[un_index]->Update();
+      }
+
+      /**
+       * Updates the i-th medium, timing it if profiling is active.
+       * @param un_index The index of the medium.
+       */
+      inline void UpdateMedium(size_t un_index) {
+         CProfiler::CScopedTimer cTimer(m_pcProfiler, m_vecMediumTimers[un_index]);
+         (*m_ptMedia)[un_index]->Update();
+      }
+
+   protected:
+
+      /** The phases of a simulation step timed by the profiler */
+      enum EPhaseTimer {
+         PHASE_TIMER_STEP = 0,
+         PHASE_TIMER_ACT,
+         PHASE_TIMER_PHYSICS,
+         PHASE_TIMER_MEDIA,
+         PHASE_TIMER_PRE_STEP,
+         PHASE_TIMER_SENSE_CONTROL,
+         PHASE_TIMER_POST_STEP,
+         PHASE_TIMER_NUM
+      };
+
    protected:
 
       friend class CSpaceOperationAddControllableEntity;
@@ -448,9 +649,89 @@ namespace argos {
           The second-level maps are indexed by entity id */
       TMapPerTypePerId m_mapEntitiesPerTypePerId;
 
+      /**
+       * The slot of an entity index.
+       * The index of an entity is the position of its slot in m_vecEntitySlots.
+       */
+      struct SEntitySlot {
+         /** The entity in the slot, or <tt>NULL</tt> if the slot is free */
+         CEntity* Entity;
+         /** Incremented every time the slot is freed */
+         UInt32 Generation;
+         /** The position of the entity in m_vecEntities */
+         size_t Position;
+         /** The position of the entity in m_vecRootEntities, or -1 */
+         ssize_t RootPosition;
+         /** The vector of the entities of the same type */
+         CEntity::TVector* TypeVector;
+         /** The position of the entity in the vector of its type */
+         size_t TypePosition;
+         /** The map of the entities of the same type */
+         TMapPerType* TypeMap;
+         /** The entry of the entity in the map of its type */
+         TMapPerType::iterator TypeMapEntry;
+      };
+
+      /** The entity index slots */
+      std::vector<SEntitySlot> m_vecEntitySlots;
+
+      /** The free entity index slots */
+      std::vector<size_t> m_vecFreeEntitySlots;
+
+      /** A vector of entities per type, as returned by CEntity::GetTypeDescription() */
+      std::map<std::string, CEntity::TVector> m_mapEntityVectorsPerType;
+
+      /** The entities queued for addition */
+      CEntity::TVector m_vecPendingAdditions;
+
+      /** The handles of the entities queued for removal */
+      std::vector<SEntityHandle> m_vecPendingRemovals;
+
+      /** Marks a vector without holes */
+      static const size_t NO_HOLE = static_cast<size_t>(-1);
+
+      /** True while CommitEntityChanges() removes entities */
+      bool m_bDeferCompaction;
+
+      /** The first hole in m_vecEntities, or NO_HOLE */
+      size_t m_unFirstEntityHole;
+
+      /** The first hole in m_vecRootEntities, or NO_HOLE */
+      size_t m_unFirstRootEntityHole;
+
+      /** The vectors per type with holes, with their first hole */
+      std::map<CEntity::TVector*, size_t> m_mapTypeVectorHoles;
+
+      /** The controllable entities removed while the compaction is deferred */
+      CControllableEntity::TVector m_vecRemovedControllableEntities;
+
       /** A vector of controllable entities */
       CControllableEntity::TVector m_vecControllableEntities;
 
+      /**
+       * A pass of the sensor-major sense phase.
+       * It updates one kind of sensor for all the robots.
+       */
+      struct SSensePass {
+         /** The batch update function, or <tt>NULL</tt> to call Update() on each sensor */
+         CSimulatedSensor::TBatchUpdate* BatchUpdate;
+         /** The sensors updated by the pass */
+         std::vector<CSimulatedSensor*> Sensors;
+         /** The entity each sensor belongs to */
+         CControllableEntity::TVector Entities;
+         /** The sensors of the enabled entities, refilled at each step */
+         std::vector<CSimulatedSensor*> EnabledSensors;
+      };
+
+      /** True when the sense phase is run sensor-major */
+      bool m_bSensorMajorSense;
+
+      /** True when the sense passes must be rebuilt */
+      bool m_bSenseScheduleDirty;
+
+      /** The passes of the sensor-major sense phase */
+      std::vector<SSensePass> m_vecSensePasses;
+
       /** The floor entity */
       CFloorEntity* m_pcFloorEntity;
 
@@ -460,8 +741,24 @@ namespace argos {
       /** A pointer to the list of media */
       CMedium::TVector* m_ptMedia;
 
+      /** The profiler used to time the components, or <tt>NULL</tt> */
+      CProfiler* m_pcProfiler;
+
+      /** The profiler component ids of the step phases */
+      UInt32 m_punPhaseTimers[PHASE_TIMER_NUM];
+
+      /** The profiler component ids of the physics engines */
+      std::vector<UInt32> m_vecPhysicsEngineTimers;
+
+      /** The profiler component ids of the media */
+      std::vector<UInt32> m_vecMediumTimers;
+
   private:
       TMapPerType& GetEntitiesByTypeImpl(const std::string& str_type) const;
+      template <typename POSITION>
+      void CompactEntityVector(CEntity::TVector& vec_entities,
+                               size_t un_first_hole,
+                               POSITION SEntitySlot::* pt_position);
    };
 
    /****************************************/
@@ -278,13 +278,13 @@ namespace argos {
          THREAD_PERFORM_TASK(
             Physics,
             *m_ptPhysicsEngines,
-            (*m_ptPhysicsEngines)[unTaskIndex]->Update();
+            UpdatePhysicsEngine(unTaskIndex);
             );
          THREAD_WAIT_FOR_START_OF(Media);
          THREAD_PERFORM_TASK(
             Media,
             *m_ptMedia,
-            (*m_ptMedia)[unTaskIndex]->Update();
+            UpdateMedium(unTaskIndex);
             );
          THREAD_WAIT_FOR_START_OF(SenseControl);
          THREAD_PERFORM_TASK(
@@ -314,7 +314,7 @@ namespace argos {
          if(cPhysicsRange.GetSpan() > 0) {
             /* This thread has engines, update them */
             for(size_t i = cPhysicsRange.GetMin(); i < cPhysicsRange.GetMax(); ++i) {
-               (*m_ptPhysicsEngines)[i]->Update();
+               UpdatePhysicsEngine(i);
             }
             pthread_testcancel();
             THREAD_SIGNAL_PHASE_DONE(Physics);
@@ -328,7 +328,7 @@ namespace argos {
          if(cMediaRange.GetSpan() > 0) {
             /* This thread has media, update them */
             for(size_t i = cMediaRange.GetMin(); i < cMediaRange.GetMax(); ++i) {
-               (*m_ptMedia)[i]->Update();
+               UpdateMedium(i);
             }
             pthread_testcancel();
             THREAD_SIGNAL_PHASE_DONE(Media);
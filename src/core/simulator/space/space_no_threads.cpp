@@ -29,7 +29,7 @@ namespace argos {
    void CSpaceNoThreads::UpdatePhysics() {
       /* Update the physics engines */
       for(size_t i = 0; i < m_ptPhysicsEngines->size(); ++i) {
-         (*m_ptPhysicsEngines)[i]->Update();
+         UpdatePhysicsEngine(i);
       }
       /* Perform entity transfer from engine to engine, if needed */
       for(size_t i = 0; i < m_ptPhysicsEngines->size(); ++i) {
@@ -44,7 +44,7 @@ namespace argos {
 
    void CSpaceNoThreads::UpdateMedia() {
       for(size_t i = 0; i < m_ptMedia->size(); ++i) {
-         (*m_ptMedia)[i]->Update();
+         UpdateMedium(i);
       }
    }
 
@@ -52,6 +52,15 @@ namespace argos {
    /****************************************/
 
    void CSpaceNoThreads::UpdateControllableEntitiesSenseStep() {
+      if(m_bSensorMajorSense) {
+         UpdateControllableEntitiesSenseSensorMajor();
+         for(size_t i = 0; i < m_vecControllableEntities.size(); ++i) {
+            if(m_vecControllableEntities[i]->IsEnabled()) {
+               m_vecControllableEntities[i]->ControlStep();
+            }
+         }
+         return;
+      }
       for(size_t i = 0; i < m_vecControllableEntities.size(); ++i) {
          if(m_vecControllableEntities[i]->IsEnabled()) {
             m_vecControllableEntities[i]->Sense();
@@ -49,6 +49,210 @@ namespace argos {
 
    };
 
+   /****************************************/
+   /****************************************/
+
+   /**
+    * Appends the state of the given object to a buffer as a size-prefixed block.
+    * The block can be read back with CMementoBlockReader.
+    * @param c_memento the object whose state must be saved
+    * @param c_buffer the target buffer
+    * @see CMementoBlockReader
+    */
+   inline void SaveStateBlock(CMemento& c_memento,
+                              CByteArray& c_buffer) {
+      CByteArray cBlock;
+      c_memento.SaveState(cBlock);
+      c_buffer << static_cast<UInt32>(cBlock.Size());
+      if(!cBlock.Empty()) {
+         c_buffer.AddBuffer(cBlock.ToCArray(), cBlock.Size());
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   /**
+    * Reads the size-prefixed blocks written by SaveStateBlock().
+    * <p>
+    * Unlike the extraction operators of CByteArray, the reader does not
+    * remove the data it reads from the front of the buffer; it keeps an
+    * offset instead. Reading a buffer made of many blocks thus takes time
+    * linear in the size of the buffer.
+    * </p>
+    * <p>
+    * The buffer must not be modified or destroyed while the reader is in use.
+    * </p>
+    * @see SaveStateBlock()
+    */
+   class CMementoBlockReader {
+
+   public:
+
+      /**
+       * Class constructor.
+       * @param c_buffer the buffer to read
+       * @param un_offset the offset of the first byte to read
+       */
+      CMementoBlockReader(const CByteArray& c_buffer,
+                          size_t un_offset = 0) :
+         m_punBuffer(c_buffer.ToCArray()),
+         m_unSize(c_buffer.Size()),
+         m_unOffset(un_offset) {}
+
+      /**
+       * Class constructor.
+       * Reads the given memory area in place, for instance a mapped file.
+       * @param pun_buffer the start of the memory area to read
+       * @param un_size the size of the memory area
+       * @param un_offset the offset of the first byte to read
+       */
+      CMementoBlockReader(const UInt8* pun_buffer,
+                          size_t un_size,
+                          size_t un_offset = 0) :
+         m_punBuffer(pun_buffer),
+         m_unSize(un_size),
+         m_unOffset(un_offset) {}
+
+      /**
+       * Returns <tt>true</tt> if the whole buffer has been read.
+       */
+      inline bool AtEnd() const {
+         return m_unOffset >= m_unSize;
+      }
+
+      /**
+       * Returns the offset of the next byte to read.
+       */
+      inline size_t GetOffset() const {
+         return m_unOffset;
+      }
+
+      /**
+       * Reads an unsigned 32-bit integer written with CByteArray::operator<<().
+       * @return the value
+       * @throws CARGoSException if the buffer is too short.
+       */
+      inline UInt32 ReadUInt32() {
+         CheckAvailable(4);
+         const UInt8* punByte = m_punBuffer + m_unOffset;
+         m_unOffset += 4;
+         /* CByteArray stores integers in network byte order */
+         return
+            (static_cast<UInt32>(punByte[0]) << 24) |
+            (static_cast<UInt32>(punByte[1]) << 16) |
+            (static_cast<UInt32>(punByte[2]) <<  8) |
+            (static_cast<UInt32>(punByte[3])      );
+      }
+
+      /**
+       * Reads the next block into a separate buffer.
+       * @param c_block the buffer to fill with the block
+       * @throws CARGoSException if the buffer is too short.
+       */
+      inline void ReadBlock(CByteArray& c_block) {
+         UInt32 unSize = ReadUInt32();
+         CheckAvailable(unSize);
+         CByteArray cBlock(m_punBuffer + m_unOffset, unSize);
+         c_block.Swap(cBlock);
+         m_unOffset += unSize;
+      }
+
+      /**
+       * Restores the state of the given object from the next block.
+       * @param c_memento the object whose state must be restored
+       * @throws CARGoSException if the buffer is too short.
+       */
+      inline void LoadBlock(CMemento& c_memento) {
+         CByteArray cBlock;
+         ReadBlock(cBlock);
+         c_memento.LoadState(cBlock);
+      }
+
+      /**
+       * Skips the next block.
+       * @throws CARGoSException if the buffer is too short.
+       */
+      inline void SkipBlock() {
+         UInt32 unSize = ReadUInt32();
+         CheckAvailable(unSize);
+         m_unOffset += unSize;
+      }
+
+   private:
+
+      inline void CheckAvailable(size_t un_size) const {
+         if(m_unOffset + un_size > m_unSize) {
+            THROW_ARGOSEXCEPTION("Attempting to read past the end of the state buffer (" << un_size << " bytes requested, " << (m_unSize - m_unOffset) << " available)");
+         }
+      }
+
+   private:
+
+      const UInt8* m_punBuffer;
+      size_t m_unSize;
+      size_t m_unOffset;
+
+   };
+
+   /****************************************/
+   /****************************************/
+
+   /**
+    * Saves the state of the elements of a map that implement CMemento.
+    * The map must be indexed by string and contain pointers. Each state
+    * is saved in a block that starts with the key of the element; the
+    * elements that do not implement CMemento are skipped.
+    * @param t_map the map
+    * @param c_buffer the target buffer
+    * @see LoadMementoMap()
+    */
+   template <class MAP>
+   void SaveMementoMap(MAP& t_map,
+                       CByteArray& c_buffer) {
+      UInt32 unMementos = 0;
+      CByteArray cBlocks;
+      for(typename MAP::iterator it = t_map.begin(); it != t_map.end(); ++it) {
+         CMemento* pcMemento = dynamic_cast<CMemento*>(it->second);
+         if(pcMemento == NULL) continue;
+         CByteArray cBlock;
+         cBlock << it->first;
+         pcMemento->SaveState(cBlock);
+         cBlocks << static_cast<UInt32>(cBlock.Size());
+         cBlocks.AddBuffer(cBlock.ToCArray(), cBlock.Size());
+         ++unMementos;
+      }
+      c_buffer << unMementos;
+      if(!cBlocks.Empty()) {
+         c_buffer.AddBuffer(cBlocks.ToCArray(), cBlocks.Size());
+      }
+   }
+
+   /**
+    * Restores the state of the elements of a map saved by SaveMementoMap().
+    * @param t_map the map
+    * @param c_reader the reader of the source buffer
+    * @throws CARGoSException if a saved element is not in the map or does not implement CMemento.
+    * @see SaveMementoMap()
+    */
+   template <class MAP>
+   void LoadMementoMap(MAP& t_map,
+                       CMementoBlockReader& c_reader) {
+      UInt32 unMementos = c_reader.ReadUInt32();
+      CByteArray cBlock;
+      std::string strKey;
+      for(UInt32 i = 0; i < unMementos; ++i) {
+         c_reader.ReadBlock(cBlock);
+         cBlock >> strKey;
+         typename MAP::iterator it = t_map.find(strKey);
+         CMemento* pcMemento = (it != t_map.end()) ? dynamic_cast<CMemento*>(it->second) : NULL;
+         if(pcMemento == NULL) {
+            THROW_ARGOSEXCEPTION("Cannot restore the state of \"" << strKey << "\".");
+         }
+         pcMemento->LoadState(cBlock);
+      }
+   }
+
 }
 
 #endif
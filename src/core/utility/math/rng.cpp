@@ -10,6 +10,7 @@
 #include <argos3/core/utility/configuration/argos_exception.h>
 #include <argos3/core/utility/logging/argos_log.h>
 #include <cstring>
+#include <arpa/inet.h>
 #include <limits>
 #include <cmath>
 
@@ -27,6 +28,7 @@ namespace argos {
    static const CRange<UInt32> INT_RANGE = CRange<UInt32>(0, 0xFFFFFFFFUL);
 
    std::map<std::string, CRandom::CCategory*> CRandom::m_mapCategories;
+   UInt32 CRandom::m_unCreationStream = 0;
 
    /* Checks that a category exists. It internally creates an iterator that points to the category, if found.  */
 #define CHECK_CATEGORY(category)                                        \
@@ -38,10 +40,27 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   CRandom::CRNG::CRNG(UInt32 un_seed) :
+   /* Philox4x32-10 constants */
+   static const UInt32 PHILOX_M0 = 0xD2511F53UL;
+   static const UInt32 PHILOX_M1 = 0xCD9E8D57UL;
+   static const UInt32 PHILOX_W0 = 0x9E3779B9UL;
+   static const UInt32 PHILOX_W1 = 0xBB67AE85UL;
+   static const UInt32 PHILOX_ROUNDS = 10;
+
+   /****************************************/
+   /****************************************/
+
+   CRandom::CRNG::CRNG(UInt32 un_seed,
+                       EType e_type,
+                       const UInt32* pun_tick) :
       m_unSeed(un_seed),
-      m_punState(new UInt32[N]),
-      m_nIndex(N+1) {
+      m_unStream(0),
+      m_eType(e_type),
+      m_punState(e_type == TYPE_MERSENNE_TWISTER ? new UInt32[N] : NULL),
+      m_nIndex(N+1),
+      m_unBlock(0),
+      m_unTick(0),
+      m_punTick(pun_tick) {
       Reset();
    }
    
@@ -50,9 +69,17 @@ namespace argos {
    
    CRandom::CRNG::CRNG(const CRNG& c_rng) :
       m_unSeed(c_rng.m_unSeed),
-      m_punState(new UInt32[N]),
-      m_nIndex(c_rng.m_nIndex) {
-      ::memcpy(m_punState, c_rng.m_punState, N * sizeof(UInt32));
+      m_unStream(c_rng.m_unStream),
+      m_eType(c_rng.m_eType),
+      m_punState(c_rng.m_punState != NULL ? new UInt32[N] : NULL),
+      m_nIndex(c_rng.m_nIndex),
+      m_unBlock(c_rng.m_unBlock),
+      m_unTick(c_rng.m_unTick),
+      m_punTick(c_rng.m_punTick) {
+      if(m_punState != NULL) {
+         ::memcpy(m_punState, c_rng.m_punState, N * sizeof(UInt32));
+      }
+      ::memcpy(m_unPhiloxOutput, c_rng.m_unPhiloxOutput, sizeof(m_unPhiloxOutput));
    }
 
    /****************************************/
@@ -66,7 +93,15 @@ namespace argos {
    /****************************************/
 
    void CRandom::CRNG::Reset() {
-      m_punState[0]= m_unSeed & 0xffffffffUL;
+      if(m_eType == TYPE_PHILOX) {
+         /* Restart from the first block of the current tick */
+         m_unTick = (m_punTick != NULL) ? *m_punTick : 0;
+         m_unBlock = 0;
+         m_nIndex = 4;
+         return;
+      }
+      /* Streams other than the default one are mixed into the seed */
+      m_punState[0]= (m_unSeed ^ (m_unStream * 0x9E3779B9UL)) & 0xffffffffUL;
       for (m_nIndex = 1; m_nIndex < N; ++m_nIndex) {
          m_punState[m_nIndex] = 
             (1812433253UL * (m_punState[m_nIndex-1] ^ (m_punState[m_nIndex-1] >> 30)) + m_nIndex); 
@@ -77,6 +112,54 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CRandom::CRNG::SaveState(CByteArray& c_buffer) {
+      c_buffer << static_cast<UInt32>(m_eType)
+               << m_unSeed
+               << m_unStream
+               << m_nIndex
+               << m_unBlock
+               << m_unTick;
+      for(size_t i = 0; i < 4; ++i) {
+         c_buffer << m_unPhiloxOutput[i];
+      }
+      if(m_punState != NULL) {
+         /* Append the whole state at once, in network byte order like the rest */
+         UInt32 punState[N];
+         for(SInt32 i = 0; i < N; ++i) {
+            punState[i] = htonl(m_punState[i]);
+         }
+         c_buffer.AddBuffer(reinterpret_cast<UInt8*>(punState), sizeof(punState));
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRandom::CRNG::LoadState(CByteArray& c_buffer) {
+      UInt32 unType;
+      c_buffer >> unType;
+      if(unType != static_cast<UInt32>(m_eType)) {
+         THROW_ARGOSEXCEPTION("CRandom::CRNG::LoadState(): the saved RNG type does not match.");
+      }
+      c_buffer >> m_unSeed
+               >> m_unStream
+               >> m_nIndex
+               >> m_unBlock
+               >> m_unTick;
+      for(size_t i = 0; i < 4; ++i) {
+         c_buffer >> m_unPhiloxOutput[i];
+      }
+      if(m_punState != NULL) {
+         c_buffer.FetchBuffer(reinterpret_cast<UInt8*>(m_punState), N * sizeof(UInt32));
+         for(SInt32 i = 0; i < N; ++i) {
+            m_punState[i] = ntohl(m_punState[i]);
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    bool CRandom::CRNG::Bernoulli(Real f_true) {
       return Uniform32bit() < f_true * INT_RANGE.GetMax();
    }
@@ -198,7 +281,59 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   UInt32 CRandom::CRNG::Uniform32bit() {
+   void CRandom::CRNG::Uniform(Real* pf_buffer,
+                               size_t un_size,
+                               const CRange<Real>& c_range) {
+      for(size_t i = 0; i < un_size; ++i) {
+         INT_RANGE.MapValueIntoRange(pf_buffer[i], Uniform32bit(), c_range);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRandom::CRNG::Gaussian(Real* pf_buffer,
+                                size_t un_size,
+                                Real f_std_dev,
+                                Real f_mean) {
+      for(size_t i = 0; i < un_size; ++i) {
+         pf_buffer[i] = Gaussian(f_std_dev, f_mean);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRandom::CRNG::PhiloxGenerate() {
+      /* The counter is (block low, block high, tick, 0), the key is (seed, stream) */
+      UInt32 unC0 = static_cast<UInt32>(m_unBlock);
+      UInt32 unC1 = static_cast<UInt32>(m_unBlock >> 32);
+      UInt32 unC2 = m_unTick;
+      UInt32 unC3 = 0;
+      UInt32 unK0 = m_unSeed;
+      UInt32 unK1 = m_unStream;
+      for(UInt32 i = 0; i < PHILOX_ROUNDS; ++i) {
+         UInt64 unProd0 = static_cast<UInt64>(PHILOX_M0) * unC0;
+         UInt64 unProd1 = static_cast<UInt64>(PHILOX_M1) * unC2;
+         unC0 = static_cast<UInt32>(unProd1 >> 32) ^ unC1 ^ unK0;
+         unC1 = static_cast<UInt32>(unProd1);
+         unC2 = static_cast<UInt32>(unProd0 >> 32) ^ unC3 ^ unK1;
+         unC3 = static_cast<UInt32>(unProd0);
+         unK0 += PHILOX_W0;
+         unK1 += PHILOX_W1;
+      }
+      m_unPhiloxOutput[0] = unC0;
+      m_unPhiloxOutput[1] = unC1;
+      m_unPhiloxOutput[2] = unC2;
+      m_unPhiloxOutput[3] = unC3;
+      ++m_unBlock;
+      m_nIndex = 0;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   UInt32 CRandom::CRNG::MersenneTwisterUniform32bit() {
       UInt32 y;
       static UInt32 mag01[2] = { 0x0UL, MATRIX_A };
       /* mag01[x] = x * MATRIX_A  for x=0,1 */
@@ -234,9 +369,12 @@ namespace argos {
    /****************************************/
 
    CRandom::CCategory::CCategory(const std::string& str_id,
-                                 UInt32 un_seed) :
+                                 UInt32 un_seed,
+                                 CRNG::EType e_type) :
       m_strId(str_id),
       m_unSeed(un_seed),
+      m_eRNGType(e_type),
+      m_unTick(0),
       m_cSeeder(un_seed),
       m_cSeedRange(1, std::numeric_limits<UInt32>::max()) {}
 
@@ -265,13 +403,53 @@ namespace argos {
       /* Get seed from internal RNG */
       UInt32 unSeed = m_cSeeder.Uniform(m_cSeedRange);
       /* Create new RNG */
-      m_vecRNGList.push_back(new CRNG(unSeed));
+      m_vecRNGList.push_back(new CRNG(unSeed, m_eRNGType, &m_unTick));
+      if(m_eRNGType == CRNG::TYPE_PHILOX && m_unCreationStream != 0) {
+         /* Key the RNG by the category seed and the stream, so the creation order does not matter */
+         m_vecRNGList.back()->SetSeed(m_unSeed);
+         m_vecRNGList.back()->SetStream(m_unCreationStream);
+         m_vecRNGList.back()->Reset();
+         /* A device that creates more RNGs gets the next streams */
+         m_unCreationStream = m_unCreationStream * 1664525UL + 1013904223UL;
+         if(m_unCreationStream == 0) m_unCreationStream = 1;
+      }
       return m_vecRNGList.back();
    }
 
    /****************************************/
    /****************************************/
 
+   void CRandom::CCategory::SaveState(CByteArray& c_buffer) {
+      c_buffer << m_unSeed
+               << m_unTick
+               << static_cast<UInt32>(m_vecRNGList.size());
+      SaveStateBlock(m_cSeeder, c_buffer);
+      for(size_t i = 0; i < m_vecRNGList.size(); ++i) {
+         SaveStateBlock(*m_vecRNGList[i], c_buffer);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRandom::CCategory::LoadState(CByteArray& c_buffer) {
+      CMementoBlockReader cReader(c_buffer);
+      m_unSeed = cReader.ReadUInt32();
+      m_unTick = cReader.ReadUInt32();
+      UInt32 unRNGs = cReader.ReadUInt32();
+      if(unRNGs != m_vecRNGList.size()) {
+         THROW_ARGOSEXCEPTION("CRandom::CCategory::LoadState(): category \"" << m_strId << "\" has " << m_vecRNGList.size() << " RNGs, but " << unRNGs << " were saved.");
+      }
+      cReader.LoadBlock(m_cSeeder);
+      for(size_t i = 0; i < m_vecRNGList.size(); ++i) {
+         cReader.LoadBlock(*m_vecRNGList[i]);
+      }
+      c_buffer.Clear();
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CRandom::CCategory::ResetRNGs() {
       /* Reset internal RNG */
       m_cSeeder.Reset();
@@ -288,7 +466,13 @@ namespace argos {
    void CRandom::CCategory::ReseedRNGs() {
       for(size_t i = 0; i < m_vecRNGList.size(); ++i) {
          /* Get seed from internal RNG */
-         m_vecRNGList[i]->SetSeed(m_cSeeder.Uniform(m_cSeedRange));
+         UInt32 unSeed = m_cSeeder.Uniform(m_cSeedRange);
+         /* The RNGs with a stream are keyed by the category seed */
+         if(m_vecRNGList[i]->GetType() == CRNG::TYPE_PHILOX &&
+            m_vecRNGList[i]->GetStream() != 0) {
+            unSeed = m_unSeed;
+         }
+         m_vecRNGList[i]->SetSeed(unSeed);
       }
    }
 
@@ -296,7 +480,8 @@ namespace argos {
    /****************************************/
 
    bool CRandom::CreateCategory(const std::string& str_category,
-                                UInt32 un_seed) {
+                                UInt32 un_seed,
+                                CRNG::EType e_type) {
       /* Is there a category already? */
       std::map<std::string, CCategory*>::iterator itCategory = m_mapCategories.find(str_category);
       if(itCategory == m_mapCategories.end()) {
@@ -305,7 +490,8 @@ namespace argos {
             std::pair<std::string,
             CRandom::CCategory*>(str_category,
                                  new CRandom::CCategory(str_category,
-                                                        un_seed)));
+                                                        un_seed,
+                                                        e_type)));
          return true;
       }
       return false;
@@ -314,6 +500,19 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   CRandom::CRNG::EType CRandom::GetRNGType(const std::string& str_type) {
+      if(str_type == "mt19937") {
+         return CRNG::TYPE_MERSENNE_TWISTER;
+      }
+      else if(str_type == "philox") {
+         return CRNG::TYPE_PHILOX;
+      }
+      THROW_ARGOSEXCEPTION("CRandom:: unknown RNG type \"" << str_type << "\". Available types: \"mt19937\" and \"philox\".");
+   }
+
+   /****************************************/
+   /****************************************/
+
    CRandom::CCategory& CRandom::GetCategory(const std::string& str_category) {
       CHECK_CATEGORY(str_category);
       return *(itCategory->second);
@@ -352,6 +551,39 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CRandom::SaveState(CByteArray& c_buffer) {
+      c_buffer << static_cast<UInt32>(m_mapCategories.size());
+      for(std::map<std::string, CCategory*>::iterator it = m_mapCategories.begin();
+          it != m_mapCategories.end(); ++it) {
+         /* Each category is a block that starts with the category id */
+         CByteArray cBlock;
+         cBlock << it->first;
+         it->second->SaveState(cBlock);
+         c_buffer << static_cast<UInt32>(cBlock.Size());
+         c_buffer.AddBuffer(cBlock.ToCArray(), cBlock.Size());
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CRandom::LoadState(CByteArray& c_buffer) {
+      CMementoBlockReader cReader(c_buffer);
+      UInt32 unCategories = cReader.ReadUInt32();
+      CByteArray cBlock;
+      std::string strCategory;
+      for(UInt32 i = 0; i < unCategories; ++i) {
+         cReader.ReadBlock(cBlock);
+         cBlock >> strCategory;
+         CHECK_CATEGORY(strCategory);
+         itCategory->second->LoadState(cBlock);
+      }
+      c_buffer.Clear();
+   }
+
+   /****************************************/
+   /****************************************/
+
    UInt32 CRandom::GetSeedOf(const std::string& str_category) {
       CHECK_CATEGORY(str_category);
       return itCategory->second->GetSeed();
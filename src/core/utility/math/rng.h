@@ -15,6 +15,7 @@ namespace argos {
 
 #include <argos3/core/utility/math/angles.h>
 #include <argos3/core/utility/math/range.h>
+#include <argos3/core/utility/configuration/memento.h>
 #include <map>
 
 namespace argos {
@@ -77,6 +78,25 @@ namespace argos {
  * <pre>
  * argos::CRandom::CRNG* m_pcRNG = argos::CRandom::CreateRNG("my_category");
  * </pre>
+ * <p>
+ * Two generators are available. The default is the Mersenne Twister, which keeps
+ * 624 words of state per RNG. The alternative is Philox4x32-10, a counter-based
+ * generator with a few words of state: the n-th draw is a pure function of the seed
+ * of the RNG, its stream and the current tick of its category. When the simulation
+ * runs with Philox, the ARGoS core sets the tick of the <tt>argos</tt> category at
+ * every step, so the numbers drawn in a step do not depend on what happened in the
+ * previous steps nor on the way the work is split among threads. The generator is
+ * chosen per category:
+ * </p>
+ * <pre>
+ * argos::CRandom::CreateCategory("my_category", my_seed, argos::CRandom::CRNG::TYPE_PHILOX);
+ * </pre>
+ * <p>
+ * The RNGs that the sensors, the actuators and the controller of a robot create in a
+ * Philox category are keyed by the seed of the category and by a stream derived from
+ * the id of the robot and the slot of the device (see SetCreationStream()), so their
+ * sequences do not depend on the order in which the robots are created either.
+ * </p>
 */
    class CRandom {
 
@@ -87,7 +107,17 @@ namespace argos {
        * This class is the real random number generator. You need an instance of this class
        * to be able to generate random numbers.
        */
-      class CRNG {
+      class CRNG : public CMemento {
+
+      public:
+
+         /**
+          * The available generators.
+          */
+         enum EType {
+            TYPE_MERSENNE_TWISTER = 0,
+            TYPE_PHILOX
+         };
 
       public:
 
@@ -95,9 +125,12 @@ namespace argos {
           * Class constructor.
           * To create a new RNG from user code, never use this method. Use CreateRNG() instead.
           * @param un_seed the seed of the RNG.
-          * @param str_type the type of RNG to use. By default, Mersenne Twister is used. For a list of available RNG types, see GetRNGTypes().
+          * @param e_type the type of RNG to use. By default, Mersenne Twister is used.
+          * @param pun_tick the tick counter-based RNGs are keyed by; <tt>NULL</tt> for none.
           */
-         CRNG(UInt32 un_seed);
+         CRNG(UInt32 un_seed,
+              EType e_type = TYPE_MERSENNE_TWISTER,
+              const UInt32* pun_tick = NULL);
 
          /**
           * Class copy constructor.
@@ -128,12 +161,58 @@ namespace argos {
             m_unSeed = un_seed;
          }
 
+         /**
+          * Returns the type of this RNG.
+          * @return the type of this RNG.
+          */
+         inline EType GetType() const throw() {
+            return m_eType;
+         }
+
+         /**
+          * Returns the stream of this RNG.
+          * @return the stream of this RNG.
+          * @see SetStream()
+          */
+         inline UInt32 GetStream() const throw() {
+            return m_unStream;
+         }
+
+         /**
+          * Sets the stream of this RNG.
+          * RNGs with the same seed and different streams generate independent
+          * sequences. Counter-based RNGs use the stream as part of their key. For
+          * the Mersenne Twister, the stream is mixed into the seed.
+          * The RNGs created in a Philox category get their stream from
+          * CRandom::SetCreationStream().
+          * This method does not reset the RNG. You must call Reset() explicitly.
+          * @param un_stream the new stream for this RNG.
+          * @see Reset()
+          */
+         inline void SetStream(UInt32 un_stream) throw() {
+            m_unStream = un_stream;
+         }
+
          /**
           * Reset the RNG.
           * Reset the RNG to the current seed value.
           */
          void Reset();
 
+         /**
+          * Saves the complete state of the RNG to the given buffer.
+          * @param c_buffer the target buffer
+          */
+         virtual void SaveState(CByteArray& c_buffer);
+
+         /**
+          * Restores the complete state of the RNG from the given buffer.
+          * The type of the RNG must match the saved one.
+          * @param c_buffer the source buffer
+          * @throws CARGoSException if the saved state is not valid for this RNG.
+          */
+         virtual void LoadState(CByteArray& c_buffer);
+
          /**
           * Returns a random value from a Bernoulli distribution.
           * @param f_true the probability to return a 1.
@@ -206,6 +285,30 @@ namespace argos {
           */
          Real Lognormal(Real f_sigma, Real f_mu);
 
+         /**
+          * Fills a buffer with random values from a uniform distribution.
+          * The values are the same that as many calls to Uniform() would return.
+          * @param pf_buffer the buffer to fill.
+          * @param un_size the number of values to draw.
+          * @param c_range the range of values to draw from.
+          */
+         void Uniform(Real* pf_buffer,
+                      size_t un_size,
+                      const CRange<Real>& c_range);
+
+         /**
+          * Fills a buffer with random values from a Gaussian distribution.
+          * The values are the same that as many calls to Gaussian() would return.
+          * @param pf_buffer the buffer to fill.
+          * @param un_size the number of values to draw.
+          * @param f_std_dev the standard deviation of the Gaussian distribution.
+          * @param f_mean the mean of the Gaussian distribution.
+          */
+         void Gaussian(Real* pf_buffer,
+                       size_t un_size,
+                       Real f_std_dev,
+                       Real f_mean = 0.0f);
+
          /**
           * Shuffles the values of the given vector in-place.
           * @param vec_data The vector whose values must be shuffled.
@@ -227,13 +330,40 @@ namespace argos {
           * Generates a random 32bit unsigned integer.
           * Used internally by all other functions.
           */
-         UInt32 Uniform32bit();
+         inline UInt32 Uniform32bit() {
+            if(m_eType == TYPE_PHILOX) {
+               if(m_punTick != NULL && *m_punTick != m_unTick) {
+                  /* New tick, restart the sequence */
+                  m_unTick = *m_punTick;
+                  m_unBlock = 0;
+                  m_nIndex = 4;
+               }
+               if(m_nIndex >= 4) {
+                  PhiloxGenerate();
+               }
+               return m_unPhiloxOutput[m_nIndex++];
+            }
+            return MersenneTwisterUniform32bit();
+         }
+
+         UInt32 MersenneTwisterUniform32bit();
+
+         void PhiloxGenerate();
 
       private:
 
          UInt32 m_unSeed;
+         UInt32 m_unStream;
+         EType m_eType;
+         /* Mersenne Twister state, NULL for Philox */
          UInt32* m_punState;
+         /* Index of the next word to use in the state or in the Philox output */
          SInt32 m_nIndex;
+         /* Philox counter and last output block */
+         UInt64 m_unBlock;
+         UInt32 m_unTick;
+         const UInt32* m_punTick;
+         UInt32 m_unPhiloxOutput[4];
 
       };
 
@@ -241,7 +371,7 @@ namespace argos {
        * The RNG category.
        * This class stores a specific category of RNGs.
        */
-      class CCategory {
+      class CCategory : public CMemento {
 
       public:
 
@@ -249,9 +379,11 @@ namespace argos {
           * Class constructor.
           * @param str_id the id of the category.
           * @param un_seed the seed of the category.
+          * @param e_type the type of the RNGs created in this category.
           */
          CCategory(const std::string& str_id,
-                   UInt32 un_seed);
+                   UInt32 un_seed,
+                   CRNG::EType e_type = CRNG::TYPE_MERSENNE_TWISTER);
 
          /**
           * Class destructor.
@@ -288,12 +420,59 @@ namespace argos {
           */
          void SetSeed(UInt32 un_seed);
 
+         /**
+          * Returns the type of the RNGs created in this category.
+          * @return the type of the RNGs created in this category.
+          */
+         inline CRNG::EType GetRNGType() const {
+            return m_eRNGType;
+         }
+
+         /**
+          * Returns the current tick of the category.
+          * @return the current tick of the category.
+          * @see SetTick()
+          */
+         inline UInt32 GetTick() const {
+            return m_unTick;
+         }
+
+         /**
+          * Sets the current tick of the category.
+          * The draws of the counter-based RNGs of this category are keyed by the tick:
+          * when it changes, their sequence restarts from a position that depends only
+          * on their seed, their stream and the new tick.
+          * @param un_tick the new tick.
+          */
+         inline void SetTick(UInt32 un_tick) {
+            m_unTick = un_tick;
+         }
+
          /**
           * Creates a new RNG inside this category.
+          * The seed of the RNG is drawn from the seeder of the category. In a Philox
+          * category, if a creation stream is set, the RNG is keyed by the seed of the
+          * category and by the creation stream instead, which then advances to the
+          * next stream.
           * @return the pointer to a new RNG inside this category.
+          * @see CRandom::SetCreationStream()
           */
          CRNG* CreateRNG();
 
+         /**
+          * Saves the state of the category and of all its RNGs to the given buffer.
+          * @param c_buffer the target buffer
+          */
+         virtual void SaveState(CByteArray& c_buffer);
+
+         /**
+          * Restores the state of the category and of all its RNGs from the given buffer.
+          * The category must contain as many RNGs as when the state was saved.
+          * @param c_buffer the source buffer
+          * @throws CARGoSException if the saved state does not match the category.
+          */
+         virtual void LoadState(CByteArray& c_buffer);
+
          /**
           * Resets the RNGs in this category.
           */
@@ -311,6 +490,8 @@ namespace argos {
          std::string m_strId;
          std::vector<CRNG*> m_vecRNGList;
          UInt32 m_unSeed;
+         CRNG::EType m_eRNGType;
+         UInt32 m_unTick;
          CRNG m_cSeeder;
          CRange<UInt32> m_cSeedRange;
       };
@@ -321,10 +502,21 @@ namespace argos {
        * Creates a new category.
        * @param str_category the id of the category.
        * @param un_seed the base seed of the category.
+       * @param e_type the type of the RNGs created in the category.
        * @return <tt>true</tt> if the category was created; <tt>false</tt> if a category with the passed id exists already.
        */
       static bool CreateCategory(const std::string& str_category,
-                                 UInt32 un_seed);
+                                 UInt32 un_seed,
+                                 CRNG::EType e_type = CRNG::TYPE_MERSENNE_TWISTER);
+
+      /**
+       * Returns the RNG type corresponding to the given name.
+       * Accepted names are <tt>mt19937</tt> and <tt>philox</tt>.
+       * @param str_type the name of the RNG type.
+       * @return the RNG type corresponding to the given name.
+       * @throws CARGoSException if the name is not valid.
+       */
+      static CRNG::EType GetRNGType(const std::string& str_type);
       /**
        * Returns a reference to the wanted category.
        * @param str_category the id of the category.
@@ -352,6 +544,29 @@ namespace argos {
        */
       static CRNG* CreateRNG(const std::string& str_category);
 
+      /**
+       * Sets the stream given to the RNGs created from now on in the Philox categories.
+       * CControllableEntity sets it from the id of the robot and the slot of the device
+       * before initializing each sensor, actuator and the controller, and sets it back
+       * to 0 afterwards. A stream of 0 means that the RNGs are seeded by the seeder of
+       * the category, in creation order. The Mersenne Twister categories ignore it, so
+       * their sequences are unchanged.
+       * @param un_stream the stream; 0 to disable.
+       * @see CCategory::CreateRNG()
+       */
+      static void SetCreationStream(UInt32 un_stream) {
+         m_unCreationStream = un_stream;
+      }
+
+      /**
+       * Returns the stream given to the RNGs created from now on in the Philox categories.
+       * @return the stream given to the RNGs created from now on in the Philox categories.
+       * @see SetCreationStream()
+       */
+      static UInt32 GetCreationStream() {
+         return m_unCreationStream;
+      }
+
       /**
        * Returns the seed of the wanted category.
        * @param str_category the id of the category.
@@ -374,9 +589,25 @@ namespace argos {
        */
       static void Reset();
 
+      /**
+       * Saves the state of all the RNG categories to the given buffer.
+       * @param c_buffer the target buffer
+       */
+      static void SaveState(CByteArray& c_buffer);
+
+      /**
+       * Restores the state of the RNG categories from the given buffer.
+       * All the saved categories must exist; categories that were not
+       * saved are left untouched.
+       * @param c_buffer the source buffer
+       * @throws CARGoSException if a saved category does not exist or does not match.
+       */
+      static void LoadState(CByteArray& c_buffer);
+
    private:
 
       static std::map<std::string, CCategory*> m_mapCategories;
+      static UInt32 m_unCreationStream;
    };
 
 }
@@ -0,0 +1,174 @@
+/**
+ * @file <argos3/core/utility/math/vector3_array.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "vector3_array.h"
+#include "quaternion.h"
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * Calculates the matrix M such that M * v = q * v * q^-1, with
+    * q^-1 = Conjugate(q) as in CQuaternion::Inverse(), stored row-major.
+    */
+   static void RotationMatrix(Real* pf_matrix,
+                              const CQuaternion& c_quaternion) {
+      Real fW = c_quaternion.GetW();
+      Real fX = c_quaternion.GetX();
+      Real fY = c_quaternion.GetY();
+      Real fZ = c_quaternion.GetZ();
+      pf_matrix[0] = fW * fW + fX * fX - fY * fY - fZ * fZ;
+      pf_matrix[1] = 2.0f * (fX * fY - fW * fZ);
+      pf_matrix[2] = 2.0f * (fX * fZ + fW * fY);
+      pf_matrix[3] = 2.0f * (fX * fY + fW * fZ);
+      pf_matrix[4] = fW * fW - fX * fX + fY * fY - fZ * fZ;
+      pf_matrix[5] = 2.0f * (fY * fZ - fW * fX);
+      pf_matrix[6] = 2.0f * (fX * fZ - fW * fY);
+      pf_matrix[7] = 2.0f * (fY * fZ + fW * fX);
+      pf_matrix[8] = fW * fW - fX * fX - fY * fY + fZ * fZ;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * The kernel of the transforms: out = M * in + t over n vectors.
+    * The input and output can be the same arrays, as each iteration
+    * reads a vector before writing it.
+    */
+   static void TransformKernel(Real* pf_out_x,
+                               Real* pf_out_y,
+                               Real* pf_out_z,
+                               const Real* pf_in_x,
+                               const Real* pf_in_y,
+                               const Real* pf_in_z,
+                               const Real* pf_matrix,
+                               const CVector3& c_translation,
+                               size_t un_count) {
+      const Real fM0 = pf_matrix[0], fM1 = pf_matrix[1], fM2 = pf_matrix[2];
+      const Real fM3 = pf_matrix[3], fM4 = pf_matrix[4], fM5 = pf_matrix[5];
+      const Real fM6 = pf_matrix[6], fM7 = pf_matrix[7], fM8 = pf_matrix[8];
+      const Real fTX = c_translation.GetX();
+      const Real fTY = c_translation.GetY();
+      const Real fTZ = c_translation.GetZ();
+      for(size_t i = 0; i < un_count; ++i) {
+         Real fX = pf_in_x[i];
+         Real fY = pf_in_y[i];
+         Real fZ = pf_in_z[i];
+         pf_out_x[i] = fM0 * fX + fM1 * fY + fM2 * fZ + fTX;
+         pf_out_y[i] = fM3 * fX + fM4 * fY + fM5 * fZ + fTY;
+         pf_out_z[i] = fM6 * fX + fM7 * fY + fM8 * fZ + fTZ;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CVector3Array& CVector3Array::Rotate(const CQuaternion& c_quaternion) {
+      Transform(*this, c_quaternion, CVector3::ZERO, 0, GetSize());
+      return *this;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CVector3Array& CVector3Array::Translate(const CVector3& c_translation) {
+      Real* pfX = GetX();
+      Real* pfY = GetY();
+      Real* pfZ = GetZ();
+      const Real fTX = c_translation.GetX();
+      const Real fTY = c_translation.GetY();
+      const Real fTZ = c_translation.GetZ();
+      for(size_t i = 0; i < GetSize(); ++i) {
+         pfX[i] += fTX;
+         pfY[i] += fTY;
+         pfZ[i] += fTZ;
+      }
+      return *this;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CVector3Array::Transform(CVector3Array& c_result,
+                                 const CQuaternion& c_orientation,
+                                 const CVector3& c_position,
+                                 size_t un_first,
+                                 size_t un_count) const {
+      if(un_count == 0) return;
+      Real pfMatrix[9];
+      RotationMatrix(pfMatrix, c_orientation);
+      TransformKernel(c_result.GetX() + un_first,
+                      c_result.GetY() + un_first,
+                      c_result.GetZ() + un_first,
+                      GetX() + un_first,
+                      GetY() + un_first,
+                      GetZ() + un_first,
+                      pfMatrix,
+                      c_position,
+                      un_count);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CVector3Array::Transform(CVector3Array& c_result,
+                                 const CQuaternion& c_orientation,
+                                 const CVector3& c_position) const {
+      c_result.Resize(GetSize());
+      Transform(c_result, c_orientation, c_position, 0, GetSize());
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CVector3Array::DotProduct(std::vector<Real>& vec_result,
+                                  const CVector3Array& c_other) const {
+      vec_result.resize(GetSize());
+      if(vec_result.empty()) return;
+      const Real* pfX1 = GetX();
+      const Real* pfY1 = GetY();
+      const Real* pfZ1 = GetZ();
+      const Real* pfX2 = c_other.GetX();
+      const Real* pfY2 = c_other.GetY();
+      const Real* pfZ2 = c_other.GetZ();
+      Real* pfResult = &vec_result[0];
+      for(size_t i = 0; i < GetSize(); ++i) {
+         pfResult[i] = pfX1[i] * pfX2[i] + pfY1[i] * pfY2[i] + pfZ1[i] * pfZ2[i];
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CVector3Array::CrossProduct(CVector3Array& c_result,
+                                    const CVector3Array& c_other) const {
+      c_result.Resize(GetSize());
+      const Real* pfX1 = GetX();
+      const Real* pfY1 = GetY();
+      const Real* pfZ1 = GetZ();
+      const Real* pfX2 = c_other.GetX();
+      const Real* pfY2 = c_other.GetY();
+      const Real* pfZ2 = c_other.GetZ();
+      Real* pfX = c_result.GetX();
+      Real* pfY = c_result.GetY();
+      Real* pfZ = c_result.GetZ();
+      for(size_t i = 0; i < GetSize(); ++i) {
+         Real fX = pfY1[i] * pfZ2[i] - pfZ1[i] * pfY2[i];
+         Real fY = pfZ1[i] * pfX2[i] - pfX1[i] * pfZ2[i];
+         Real fZ = pfX1[i] * pfY2[i] - pfY1[i] * pfX2[i];
+         pfX[i] = fX;
+         pfY[i] = fY;
+         pfZ[i] = fZ;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
@@ -0,0 +1,225 @@
+/**
+ * @file <argos3/core/utility/math/vector3_array.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef VECTOR3_ARRAY_H
+#define VECTOR3_ARRAY_H
+
+namespace argos {
+   class CVector3Array;
+   class CQuaternion;
+}
+
+#include <argos3/core/utility/math/vector3.h>
+#include <vector>
+
+namespace argos {
+
+   /**
+    * An array of 3D vectors, stored as structure of arrays.
+    *
+    * The coordinates of the vectors are kept in three contiguous arrays,
+    * one per axis. The batch operations of this class are plain loops
+    * over these arrays, without dependencies between iterations, so the
+    * compiler can vectorize them for the target instruction set (SSE,
+    * AVX, NEON) in single or double precision, depending on how Real is
+    * defined.
+    *
+    * The batch operations give the same results as the corresponding
+    * operations of CVector3 applied to each vector, up to rounding.
+    */
+   class CVector3Array {
+
+   public:
+
+      /**
+       * Class constructor.
+       * @param un_size The number of vectors, initialized to (0,0,0).
+       */
+      explicit CVector3Array(size_t un_size = 0) :
+         m_vecX(un_size, 0.0),
+         m_vecY(un_size, 0.0),
+         m_vecZ(un_size, 0.0) {}
+
+      /**
+       * Returns the number of vectors.
+       * @return The number of vectors.
+       */
+      inline size_t GetSize() const {
+         return m_vecX.size();
+      }
+
+      /**
+       * Changes the number of vectors.
+       * The new vectors are initialized to (0,0,0).
+       * @param un_size The number of vectors.
+       */
+      inline void Resize(size_t un_size) {
+         m_vecX.resize(un_size, 0.0);
+         m_vecY.resize(un_size, 0.0);
+         m_vecZ.resize(un_size, 0.0);
+      }
+
+      /**
+       * Removes all the vectors.
+       */
+      inline void Clear() {
+         m_vecX.clear();
+         m_vecY.clear();
+         m_vecZ.clear();
+      }
+
+      /**
+       * Appends a vector.
+       * @param c_vector The vector.
+       */
+      inline void PushBack(const CVector3& c_vector) {
+         m_vecX.push_back(c_vector.GetX());
+         m_vecY.push_back(c_vector.GetY());
+         m_vecZ.push_back(c_vector.GetZ());
+      }
+
+      /**
+       * Returns a vector.
+       * @param un_idx The index of the vector.
+       * @return The vector.
+       */
+      inline CVector3 Get(size_t un_idx) const {
+         return CVector3(m_vecX[un_idx], m_vecY[un_idx], m_vecZ[un_idx]);
+      }
+
+      /**
+       * Sets a vector.
+       * @param un_idx The index of the vector.
+       * @param c_vector The vector.
+       */
+      inline void Set(size_t un_idx,
+                      const CVector3& c_vector) {
+         m_vecX[un_idx] = c_vector.GetX();
+         m_vecY[un_idx] = c_vector.GetY();
+         m_vecZ[un_idx] = c_vector.GetZ();
+      }
+
+      /**
+       * Returns the <em>x</em> coordinates of the vectors.
+       * @return The <em>x</em> coordinates of the vectors.
+       */
+      inline Real* GetX() {
+         return m_vecX.empty() ? NULL : &m_vecX[0];
+      }
+
+      /**
+       * Returns the <em>x</em> coordinates of the vectors.
+       * @return The <em>x</em> coordinates of the vectors.
+       */
+      inline const Real* GetX() const {
+         return m_vecX.empty() ? NULL : &m_vecX[0];
+      }
+
+      /**
+       * Returns the <em>y</em> coordinates of the vectors.
+       * @return The <em>y</em> coordinates of the vectors.
+       */
+      inline Real* GetY() {
+         return m_vecY.empty() ? NULL : &m_vecY[0];
+      }
+
+      /**
+       * Returns the <em>y</em> coordinates of the vectors.
+       * @return The <em>y</em> coordinates of the vectors.
+       */
+      inline const Real* GetY() const {
+         return m_vecY.empty() ? NULL : &m_vecY[0];
+      }
+
+      /**
+       * Returns the <em>z</em> coordinates of the vectors.
+       * @return The <em>z</em> coordinates of the vectors.
+       */
+      inline Real* GetZ() {
+         return m_vecZ.empty() ? NULL : &m_vecZ[0];
+      }
+
+      /**
+       * Returns the <em>z</em> coordinates of the vectors.
+       * @return The <em>z</em> coordinates of the vectors.
+       */
+      inline const Real* GetZ() const {
+         return m_vecZ.empty() ? NULL : &m_vecZ[0];
+      }
+
+      /**
+       * Rotates all the vectors by the given quaternion.
+       * @param c_quaternion The quaternion.
+       * @return A reference to this array.
+       * @see CVector3::Rotate(const CQuaternion&)
+       */
+      CVector3Array& Rotate(const CQuaternion& c_quaternion);
+
+      /**
+       * Adds the given vector to all the vectors.
+       * @param c_translation The vector to add.
+       * @return A reference to this array.
+       */
+      CVector3Array& Translate(const CVector3& c_translation);
+
+      /**
+       * Rotates and then translates a range of vectors, storing the result in another array.
+       * For each vector <em>v</em> in the range, the result is
+       * <em>v</em>.Rotate(<tt>c_orientation</tt>) + <tt>c_position</tt>,
+       * stored at the same index. The result array must be at least as
+       * large as this array, and it can be this array.
+       * @param c_result The array where the result is stored.
+       * @param c_orientation The rotation.
+       * @param c_position The translation.
+       * @param un_first The index of the first vector to transform.
+       * @param un_count The number of vectors to transform.
+       */
+      void Transform(CVector3Array& c_result,
+                     const CQuaternion& c_orientation,
+                     const CVector3& c_position,
+                     size_t un_first,
+                     size_t un_count) const;
+
+      /**
+       * Rotates and then translates all the vectors, storing the result in another array.
+       * The result array is resized to the size of this array.
+       * @param c_result The array where the result is stored.
+       * @param c_orientation The rotation.
+       * @param c_position The translation.
+       */
+      void Transform(CVector3Array& c_result,
+                     const CQuaternion& c_orientation,
+                     const CVector3& c_position) const;
+
+      /**
+       * Calculates the dot products of the vectors of this array with those of another array.
+       * @param vec_result Set to the dot products, one per vector.
+       * @param c_other The other array, of the same size.
+       * @see CVector3::DotProduct
+       */
+      void DotProduct(std::vector<Real>& vec_result,
+                      const CVector3Array& c_other) const;
+
+      /**
+       * Calculates the cross products of the vectors of this array with those of another array.
+       * @param c_result Set to the cross products, one per vector.
+       * @param c_other The other array, of the same size.
+       * @see CVector3::CrossProduct
+       */
+      void CrossProduct(CVector3Array& c_result,
+                        const CVector3Array& c_other) const;
+
+   private:
+
+      std::vector<Real> m_vecX;
+      std::vector<Real> m_vecY;
+      std::vector<Real> m_vecZ;
+
+   };
+
+}
+
+#endif
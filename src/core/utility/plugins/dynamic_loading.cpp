@@ -8,6 +8,7 @@
 
 #include <dirent.h>
 #include <cerrno>
+#include <fstream>
 
 namespace argos {
 
@@ -15,7 +16,10 @@ namespace argos {
    /****************************************/
 
    CDynamicLoading::TDLHandleMap CDynamicLoading::m_tOpenLibs;
+   CDynamicLoading::TManifest CDynamicLoading::m_tManifest;
+   bool CDynamicLoading::m_bAllLibrariesLoaded = false;
    const std::string CDynamicLoading::DEFAULT_PLUGIN_PATH = ARGOS_INSTALL_PREFIX "/lib/argos3/";
+   const std::string CDynamicLoading::MANIFEST_FILE_NAME = "argos3_plugins.manifest";
 
    /****************************************/
    /****************************************/
@@ -178,34 +182,18 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   void CDynamicLoading::LoadAllLibraries() {      
-      /* String to store the full path to a library */
-      std::string strLibPath;
-      /* String to store the list of paths to search */
-      std::string strPluginPath = DEFAULT_PLUGIN_PATH;
-      /* Get variable ARGOS_PLUGIN_PATH from the environment */
-      if(::getenv("ARGOS_PLUGIN_PATH") != NULL) {
-         /* Add value of the variable to list of paths to check */
-         strPluginPath = std::string(::getenv("ARGOS_PLUGIN_PATH")) + ":" + strPluginPath;
-      }
-      /* Add : at the end to make parsing easier */
-      if(strPluginPath[strPluginPath.length()-1] != ':') {
-         strPluginPath.append(":");
-      }
+   void CDynamicLoading::LoadAllLibraries() {
+      /* Get the directories to scan */
+      std::vector<std::string> vecDirs;
+      GetPluginDirectories(vecDirs);
       /*
        * Go through paths and load all the libraries
        */
       /* Directory info */
       DIR* ptDir;
       struct dirent* ptDirData;
-      /* Parse the string */
-      std::istringstream issPluginPath(strPluginPath);
-      std::string strDir;
-      while(std::getline(issPluginPath, strDir, ':')) {
-         /* Add '/' to dir if missing */
-         if(strDir[strDir.length()-1] != '/') {
-            strDir.append("/");
-         }
+      for(size_t i = 0; i < vecDirs.size(); ++i) {
+         const std::string& strDir = vecDirs[i];
          /* Try to open the directory */
          ptDir = ::opendir(strDir.c_str());
          if(ptDir != NULL) {
@@ -240,6 +228,7 @@ namespace argos {
             LOGERR.Flush();
          }
       }
+      m_bAllLibrariesLoaded = true;
    }
 
    /****************************************/
@@ -252,6 +241,158 @@ namespace argos {
          UnloadLibrary(it->first);
       }
       m_tOpenLibs.clear();
+      m_bAllLibrariesLoaded = false;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamicLoading::EnableLazyLoading() {
+      /* Read the manifests in the plugin path */
+      std::vector<std::string> vecDirs;
+      GetPluginDirectories(vecDirs);
+      bool bFound = false;
+      for(size_t i = 0; i < vecDirs.size(); ++i) {
+         bFound |= ReadManifest(vecDirs[i]);
+      }
+      if(! bFound) {
+         /* No manifest, nothing to be lazy about */
+         LoadAllLibraries();
+         return;
+      }
+      CFactoryMissHandler::Get() = &LoadLibraryForLabel;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CDynamicLoading::LoadLibraryForLabel(const std::string& str_label) {
+      /* After a full scan, there is nothing left to load */
+      if(m_bAllLibrariesLoaded) {
+         return false;
+      }
+      /* Load the libraries listed in the manifest for the label */
+      size_t unOpenLibs = m_tOpenLibs.size();
+      std::pair<TManifest::const_iterator, TManifest::const_iterator> cRange =
+         m_tManifest.equal_range(str_label);
+      for(TManifest::const_iterator it = cRange.first;
+          it != cRange.second;
+          ++it) {
+         try {
+            LoadLibrary(it->second);
+         }
+         catch(CARGoSException& ex) {
+            LOGERR << "[WARNING] Can't load library \""
+                   << it->second
+                   << "\" listed in the plugin manifest for \""
+                   << str_label
+                   << "\""
+                   << std::endl;
+            LOGERR.Flush();
+         }
+      }
+      /* Next time the label misses, go straight to the full scan */
+      m_tManifest.erase(str_label);
+      if(m_tOpenLibs.size() > unOpenLibs) {
+         return true;
+      }
+      /* The label is unknown or the manifest is stale, fall back to the full scan */
+      LOGERR << "[WARNING] Symbol \""
+             << str_label
+             << "\" not found in the plugin manifest, loading all the libraries"
+             << std::endl;
+      LOGERR.Flush();
+      LoadAllLibraries();
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamicLoading::WriteManifest(const std::string& str_file,
+                                       const TManifest& t_manifest) {
+      std::ofstream cOFS(str_file.c_str(), std::ios::out | std::ios::trunc);
+      if(cOFS.fail()) {
+         THROW_ARGOSEXCEPTION("Error opening file \"" << str_file << "\"");
+      }
+      cOFS << "# ARGoS plugin manifest, generated by argos3 --plugin-manifest" << std::endl;
+      cOFS << "# <label><TAB><library>" << std::endl;
+      for(TManifest::const_iterator it = t_manifest.begin();
+          it != t_manifest.end();
+          ++it) {
+         cOFS << it->first << '\t' << it->second << std::endl;
+      }
+      if(cOFS.fail()) {
+         THROW_ARGOSEXCEPTION("Error writing file \"" << str_file << "\"");
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   std::string CDynamicLoading::GetLibraryFileName(void* pt_addr) {
+      Dl_info tInfo;
+      if(::dladdr(pt_addr, &tInfo) == 0 || tInfo.dli_fname == NULL) {
+         return "";
+      }
+      /* Skip the core library, it is always loaded */
+      Dl_info tCoreInfo;
+      if(::dladdr(&m_tOpenLibs, &tCoreInfo) != 0 &&
+         tCoreInfo.dli_fname != NULL &&
+         strcmp(tInfo.dli_fname, tCoreInfo.dli_fname) == 0) {
+         return "";
+      }
+      std::string strLib(tInfo.dli_fname);
+      size_t unSlash = strLib.rfind('/');
+      if(unSlash != std::string::npos) {
+         strLib.erase(0, unSlash + 1);
+      }
+      return strLib;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamicLoading::GetPluginDirectories(std::vector<std::string>& vec_dirs) {
+      /* String to store the list of paths to search */
+      std::string strPluginPath = DEFAULT_PLUGIN_PATH;
+      /* Get variable ARGOS_PLUGIN_PATH from the environment */
+      if(::getenv("ARGOS_PLUGIN_PATH") != NULL) {
+         /* Add value of the variable to list of paths to check */
+         strPluginPath = std::string(::getenv("ARGOS_PLUGIN_PATH")) + ":" + strPluginPath;
+      }
+      /* Parse the string */
+      std::istringstream issPluginPath(strPluginPath);
+      std::string strDir;
+      while(std::getline(issPluginPath, strDir, ':')) {
+         if(strDir.empty()) continue;
+         /* Add '/' to dir if missing */
+         if(strDir[strDir.length()-1] != '/') {
+            strDir.append("/");
+         }
+         vec_dirs.push_back(strDir);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CDynamicLoading::ReadManifest(const std::string& str_dir) {
+      std::ifstream cIFS((str_dir + MANIFEST_FILE_NAME).c_str());
+      if(cIFS.fail()) {
+         return false;
+      }
+      std::string strLine;
+      while(std::getline(cIFS, strLine)) {
+         if(strLine.empty() || strLine[0] == '#') continue;
+         size_t unTab = strLine.rfind('\t');
+         if(unTab == std::string::npos) continue;
+         m_tManifest.insert(std::make_pair(strLine.substr(0, unTab),
+                                           strLine.substr(unTab + 1)));
+      }
+      LOG << "[INFO] Read plugin manifest \"" << str_dir << MANIFEST_FILE_NAME << "\"" << std::endl;
+      LOG.Flush();
+      return true;
    }
 
    /****************************************/
@@ -9,9 +9,11 @@
 
 #include <argos3/core/utility/configuration/argos_exception.h>
 #include <argos3/core/utility/logging/argos_log.h>
+#include <argos3/core/utility/plugins/factory.h>
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include <dlfcn.h>
 #include <cstdlib>
@@ -30,6 +32,13 @@ namespace argos {
        */
       typedef void* TDLHandle;
 
+      /**
+       * The plugin manifest.
+       * Maps each factory label to the file names of the libraries that
+       * register it.
+       */
+      typedef std::multimap<std::string, std::string> TManifest;
+
    public:
 
       /**
@@ -78,6 +87,82 @@ namespace argos {
        */
       static void UnloadAllLibraries();
 
+      /**
+       * Loads the libraries on demand.
+       * <p>
+       * This method reads the plugin manifest (#MANIFEST_FILE_NAME) in each
+       * directory of the default loading path and of ARGOS_PLUGIN_PATH, and
+       * installs LoadLibraryForLabel() as the factory miss handler. From then
+       * on, the first time a factory is asked for a label that is not
+       * registered, the libraries that provide it are loaded.
+       * </p>
+       * <p>
+       * If no manifest is found, this method loads all the libraries, as
+       * LoadAllLibraries() does.
+       * </p>
+       * @throws CARGoSException in case of error
+       * @see CFactoryMissHandler
+       */
+      static void EnableLazyLoading();
+
+      /**
+       * Loads the libraries that provide the given factory label.
+       * The libraries are looked up in the plugin manifest. When the label is
+       * not in the manifest, or it was already looked up there, this method
+       * falls back to LoadAllLibraries().
+       * @param str_label The factory label
+       * @return <tt>true</tt> if new libraries were loaded
+       * @throws CARGoSException in case of error
+       */
+      static bool LoadLibraryForLabel(const std::string& str_label);
+
+      /**
+       * Adds the labels registered in the factory of <tt>TYPE</tt> to a manifest.
+       * Each label is associated to the library that contains its creator;
+       * labels provided by the core library are skipped.
+       * @param t_manifest The manifest to fill
+       */
+      template<typename TYPE>
+      static void AddToManifest(TManifest& t_manifest);
+
+      /**
+       * Writes a plugin manifest to file.
+       * @param str_file The file to write
+       * @param t_manifest The manifest
+       * @throws CARGoSException in case of error
+       */
+      static void WriteManifest(const std::string& str_file,
+                                const TManifest& t_manifest);
+
+   public:
+
+      /**
+       * The name of the plugin manifest file
+       */
+      static const std::string MANIFEST_FILE_NAME;
+
+   private:
+
+      /**
+       * Returns the file name of the library that contains the given address.
+       * @param pt_addr The address
+       * @return The file name, without directory, or an empty string if the address is in the core library
+       */
+      static std::string GetLibraryFileName(void* pt_addr);
+
+      /**
+       * Returns the directories of the default loading path and of ARGOS_PLUGIN_PATH.
+       * @param vec_dirs The list of directories to fill, each ending with '/'
+       */
+      static void GetPluginDirectories(std::vector<std::string>& vec_dirs);
+
+      /**
+       * Reads the plugin manifest file in the given directory, if any.
+       * @param str_dir The directory
+       * @return <tt>true</tt> if a manifest was read
+       */
+      static bool ReadManifest(const std::string& str_dir);
+
    private:
 
       /**
@@ -90,12 +175,41 @@ namespace argos {
        */
       static TDLHandleMap m_tOpenLibs;
 
+      /**
+       * The plugin manifest read by EnableLazyLoading()
+       */
+      static TManifest m_tManifest;
+
+      /**
+       * <tt>true</tt> once all the libraries in the plugin path are loaded
+       */
+      static bool m_bAllLibrariesLoaded;
+
       /**
        * Default plugin paths
        */
       static const std::string DEFAULT_PLUGIN_PATH;
    };
 
+   /****************************************/
+   /****************************************/
+
+   template<typename TYPE>
+   void CDynamicLoading::AddToManifest(TManifest& t_manifest) {
+      typename CFactory<TYPE>::TTypeMap& tTypeMap = CFactory<TYPE>::GetTypeMap();
+      for(typename CFactory<TYPE>::TTypeMap::iterator it = tTypeMap.begin();
+          it != tTypeMap.end();
+          ++it) {
+         std::string strLib = GetLibraryFileName(reinterpret_cast<void*>(it->second->Creator));
+         if(! strLib.empty()) {
+            t_manifest.insert(std::make_pair(it->first, strLib));
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
 }
 
 #endif
@@ -52,6 +52,52 @@
 
 namespace argos {
 
+   /**
+    * Hook called by the factories when a label is not registered.
+    * <p>
+    * The plugin loader installs a handler to load the library that provides
+    * a missing label on demand. As long as the handler returns <tt>true</tt>,
+    * the factory retries the lookup; the handler must eventually return
+    * <tt>false</tt> for labels that cannot be provided.
+    * </p>
+    * @see CDynamicLoading::EnableLazyLoading()
+    */
+   class CFactoryMissHandler {
+
+   public:
+
+      /**
+       * Function called when a label is missing.
+       * @param str_label The missing label.
+       * @return <tt>true</tt> if new symbols were registered and the lookup should be retried.
+       */
+      typedef bool THandler(const std::string& str_label);
+
+   public:
+
+      /**
+       * Returns the current handler, or <tt>NULL</tt>.
+       * @return The current handler, or <tt>NULL</tt>.
+       */
+      static THandler*& Get() {
+         static THandler* ptHandler = NULL;
+         return ptHandler;
+      }
+
+      /**
+       * Calls the current handler, if any.
+       * @param str_label The missing label.
+       * @return <tt>true</tt> if the lookup should be retried.
+       */
+      static bool Call(const std::string& str_label) {
+         return (Get() != NULL) && Get()(str_label);
+      }
+
+   };
+
+   /****************************************/
+   /****************************************/
+
    /**
     * Basic factory template
     */
@@ -105,8 +151,21 @@ namespace argos {
                            const std::string& str_long_desc,
                            const std::string& str_status,
                            TCreator* pc_creator);
+      /**
+       * Returns the creator of the given label.
+       * If the label is not registered, the miss handler is given a chance to
+       * load it before failing. Calling the creator is equivalent to New(),
+       * without looking the label up again.
+       * @param str_label The label of the <tt>TYPE</tt> to create
+       * @return The creator of the label
+       * @throw CARGoSException if the label is not registered
+       */
+      static TCreator* GetCreator(const std::string& str_label);
+
       /**
        * Creates a new object of type <tt>TYPE</tt>
+       * If the label is not registered, the miss handler is given a chance to
+       * load it before failing.
        * @param str_label The label of the <tt>TYPE</tt> to create
        * @return A new object of type <tt>TYPE</tt>
        */
@@ -114,6 +173,8 @@ namespace argos {
 
       /**
        * Returns <tt>true</tt> if the given label exists in the <tt>TYPE</tt> map
+       * If the label is not registered, the miss handler is given a chance to
+       * load it.
        * @return <tt>true</tt> if the given label exists in the <tt>TYPE</tt> map
        */
       static bool Exists(const std::string& str_label);
@@ -45,10 +45,13 @@ void CFactory<TYPE>::Register(const std::string& str_label,
 /****************************************/
 
 template<typename TYPE>
-TYPE* CFactory<TYPE>::New(const std::string& str_label) {
+typename CFactory<TYPE>::TCreator* CFactory<TYPE>::GetCreator(const std::string& str_label) {
    typename TTypeMap::iterator it = GetTypeMap().find(str_label);
+   while(it == GetTypeMap().end() && CFactoryMissHandler::Call(str_label)) {
+      it = GetTypeMap().find(str_label);
+   }
    if(it != GetTypeMap().end()) {
-      return it->second->Creator();
+      return it->second->Creator;
    }
    else {
       THROW_ARGOSEXCEPTION("Symbol \"" << str_label << "\" not found");
@@ -58,9 +61,20 @@ TYPE* CFactory<TYPE>::New(const std::string& str_label) {
 /****************************************/
 /****************************************/
 
+template<typename TYPE>
+TYPE* CFactory<TYPE>::New(const std::string& str_label) {
+   return GetCreator(str_label)();
+}
+
+/****************************************/
+/****************************************/
+
 template<typename TYPE>
 bool CFactory<TYPE>::Exists(const std::string& str_label) {
    typename TTypeMap::iterator it = GetTypeMap().find(str_label);
+   while(it == GetTypeMap().end() && CFactoryMissHandler::Call(str_label)) {
+      it = GetTypeMap().find(str_label);
+   }
    return(it != GetTypeMap().end());
 }
 
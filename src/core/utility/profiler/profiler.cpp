@@ -7,12 +7,29 @@
 #include "profiler.h"
 #include <argos3/core/utility/logging/argos_log.h>
 #include <argos3/core/utility/configuration/argos_configuration.h>
+#include <algorithm>
+#include <iomanip>
 
 namespace argos {
 
    /****************************************/
    /****************************************/
 
+   /*
+    * Serial number of the last created profiler, used to detect stale
+    * thread-local timing buffers left by a previous profiler
+    */
+   static UInt32 PROFILER_SERIAL = 0;
+
+   /*
+    * Timing buffer of the calling thread and serial number of its owner profiler
+    */
+   static thread_local CProfiler::SThreadTiming* THREAD_TIMING = NULL;
+   static thread_local UInt32 THREAD_TIMING_SERIAL = 0;
+
+   /****************************************/
+   /****************************************/
+
    static double TV2Sec(const ::timeval& t_timeval) {
       return
          static_cast<double>(t_timeval.tv_sec) +
@@ -113,8 +130,61 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   static UInt32 HistogramBin(UInt64 un_time) {
+      if(un_time == 0) return 0;
+      UInt32 unBin = 63 - __builtin_clzll(un_time);
+      return unBin < CProfiler::HISTOGRAM_BINS ? unBin : CProfiler::HISTOGRAM_BINS - 1;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CProfiler::SComponentTiming::SComponentTiming() :
+      Calls(0),
+      TotalTime(0),
+      MinTime(0),
+      MaxTime(0) {
+      std::fill(Histogram, Histogram + HISTOGRAM_BINS, 0);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CProfiler::SComponentTiming::Merge(const SComponentTiming& s_timing) {
+      if(s_timing.Calls == 0) return;
+      if(Calls == 0 || s_timing.MinTime < MinTime) MinTime = s_timing.MinTime;
+      if(s_timing.MaxTime > MaxTime) MaxTime = s_timing.MaxTime;
+      Calls += s_timing.Calls;
+      TotalTime += s_timing.TotalTime;
+      for(UInt32 i = 0; i < HISTOGRAM_BINS; ++i) {
+         Histogram[i] += s_timing.Histogram[i];
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   UInt64 CProfiler::SComponentTiming::Percentile(Real f_percentile) const {
+      /* The result is the upper bound of the bin containing the percentile */
+      UInt64 unThreshold = static_cast<UInt64>(f_percentile * Calls);
+      UInt64 unCount = 0;
+      for(UInt32 i = 0; i < HISTOGRAM_BINS; ++i) {
+         unCount += Histogram[i];
+         if(unCount > unThreshold) {
+            return std::min(MaxTime, (2ull << i) - 1);
+         }
+      }
+      return MaxTime;
+   }
+
+   /****************************************/
+   /****************************************/
+
    CProfiler::CProfiler(const std::string& str_file_name,
-                        bool b_trunc) {
+                        bool b_trunc,
+                        bool b_component_timing) :
+      m_bComponentTiming(b_component_timing),
+      m_unSerial(++PROFILER_SERIAL) {
       if(b_trunc) {
          m_cOutFile.open(str_file_name.c_str(),
                          std::ios::trunc | std::ios::out);
@@ -128,6 +198,10 @@ namespace argos {
       if(nError) {
          THROW_ARGOSEXCEPTION("Error creating thread profiler mutex " << ::strerror(nError));
       }
+      nError = pthread_mutex_init(&m_tComponentTimingMutex, NULL);
+      if(nError) {
+         THROW_ARGOSEXCEPTION("Error creating component timing mutex " << ::strerror(nError));
+      }
    }
 
    /****************************************/
@@ -136,6 +210,10 @@ namespace argos {
    CProfiler::~CProfiler() {
       m_cOutFile.close();
       pthread_mutex_destroy(&m_tThreadResourceUsageMutex);
+      for(size_t i = 0; i < m_vecThreadTimings.size(); ++i) {
+         delete m_vecThreadTimings[i];
+      }
+      pthread_mutex_destroy(&m_tComponentTimingMutex);
    }
 
    /****************************************/
@@ -186,6 +264,73 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   UInt32 CProfiler::RegisterComponent(const std::string& str_name) {
+      pthread_mutex_lock(&m_tComponentTimingMutex);
+      std::vector<std::string>::iterator it =
+         std::find(m_vecComponentNames.begin(), m_vecComponentNames.end(), str_name);
+      UInt32 unId = it - m_vecComponentNames.begin();
+      if(it == m_vecComponentNames.end()) {
+         m_vecComponentNames.push_back(str_name);
+      }
+      pthread_mutex_unlock(&m_tComponentTimingMutex);
+      return unId;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CProfiler::RecordTime(UInt32 un_component,
+                              UInt64 un_time) {
+      SThreadTiming& sThreadTiming = GetThreadTiming();
+      if(un_component >= sThreadTiming.Components.size()) {
+         sThreadTiming.Components.resize(un_component + 1);
+      }
+      SComponentTiming& sTiming = sThreadTiming.Components[un_component];
+      if(sTiming.Calls == 0 || un_time < sTiming.MinTime) sTiming.MinTime = un_time;
+      if(un_time > sTiming.MaxTime) sTiming.MaxTime = un_time;
+      ++sTiming.Calls;
+      sTiming.TotalTime += un_time;
+      ++sTiming.Histogram[HistogramBin(un_time)];
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CProfiler::SThreadTiming& CProfiler::GetThreadTiming() {
+      if(THREAD_TIMING_SERIAL != m_unSerial) {
+         /* First measurement of this thread: create its buffer */
+         THREAD_TIMING = new SThreadTiming;
+         THREAD_TIMING_SERIAL = m_unSerial;
+         pthread_mutex_lock(&m_tComponentTimingMutex);
+         m_vecThreadTimings.push_back(THREAD_TIMING);
+         pthread_mutex_unlock(&m_tComponentTimingMutex);
+      }
+      return *THREAD_TIMING;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CProfiler::MergeComponentTimings(std::vector<SComponentTiming>& vec_timings,
+                                         std::vector<UInt32>& vec_threads) {
+      pthread_mutex_lock(&m_tComponentTimingMutex);
+      vec_timings.assign(m_vecComponentNames.size(), SComponentTiming());
+      vec_threads.assign(m_vecComponentNames.size(), 0);
+      for(size_t t = 0; t < m_vecThreadTimings.size(); ++t) {
+         const std::vector<SComponentTiming>& vecComponents = m_vecThreadTimings[t]->Components;
+         for(size_t i = 0; i < vecComponents.size() && i < vec_timings.size(); ++i) {
+            if(vecComponents[i].Calls > 0) {
+               vec_timings[i].Merge(vecComponents[i]);
+               ++vec_threads[i];
+            }
+         }
+      }
+      pthread_mutex_unlock(&m_tComponentTimingMutex);
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CProfiler::FlushHumanReadable() {
       m_cOutFile << "[profiled portion overall]" << std::endl << std::endl;
       double fStartTime = TV2Sec(m_tWallClockStart);
@@ -214,6 +359,39 @@ namespace argos {
             DumpResourceUsageHumanReadable(m_cOutFile, m_vecThreadResourceUsage[i]);
          }
       }
+      if(m_bComponentTiming && ! m_vecComponentNames.empty()) {
+         std::vector<SComponentTiming> vecTimings;
+         std::vector<UInt32> vecThreads;
+         MergeComponentTimings(vecTimings, vecThreads);
+         m_cOutFile << std::endl << "[component timing]" << std::endl << std::endl;
+         m_cOutFile << "Times in microseconds, percentiles are histogram bin upper bounds" << std::endl << std::endl;
+         m_cOutFile << std::left << std::setw(40) << "Component" << std::right
+                    << std::setw(10) << "Threads"
+                    << std::setw(12) << "Calls"
+                    << std::setw(14) << "Total"
+                    << std::setw(9) << "Wall%"
+                    << std::setw(12) << "Mean"
+                    << std::setw(12) << "Min"
+                    << std::setw(12) << "Max"
+                    << std::setw(12) << "P50"
+                    << std::setw(12) << "P99"
+                    << std::endl;
+         for(size_t i = 0; i < vecTimings.size(); ++i) {
+            const SComponentTiming& sTiming = vecTimings[i];
+            if(sTiming.Calls == 0) continue;
+            m_cOutFile << std::left << std::setw(40) << m_vecComponentNames[i] << std::right
+                       << std::setw(10) << vecThreads[i]
+                       << std::setw(12) << sTiming.Calls
+                       << std::setw(14) << sTiming.TotalTime * 1e-3
+                       << std::setw(9) << 100.0 * sTiming.TotalTime * 1e-9 / fElapsedTime
+                       << std::setw(12) << sTiming.TotalTime * 1e-3 / sTiming.Calls
+                       << std::setw(12) << sTiming.MinTime * 1e-3
+                       << std::setw(12) << sTiming.MaxTime * 1e-3
+                       << std::setw(12) << sTiming.Percentile(0.5) * 1e-3
+                       << std::setw(12) << sTiming.Percentile(0.99) * 1e-3
+                       << std::endl;
+         }
+      }
    }
 
    /****************************************/
@@ -247,6 +425,29 @@ namespace argos {
          }
       }
       m_cOutFile << std::endl;
+      if(m_bComponentTiming && ! m_vecComponentNames.empty()) {
+         /*
+          * One row per component:
+          * name threads calls total mean min max p50 p99 (times in microseconds)
+          */
+         std::vector<SComponentTiming> vecTimings;
+         std::vector<UInt32> vecThreads;
+         MergeComponentTimings(vecTimings, vecThreads);
+         for(size_t i = 0; i < vecTimings.size(); ++i) {
+            const SComponentTiming& sTiming = vecTimings[i];
+            if(sTiming.Calls == 0) continue;
+            m_cOutFile << "timing_" << m_vecComponentNames[i]
+                       << " " << vecThreads[i]
+                       << " " << sTiming.Calls
+                       << " " << sTiming.TotalTime * 1e-3
+                       << " " << sTiming.TotalTime * 1e-3 / sTiming.Calls
+                       << " " << sTiming.MinTime * 1e-3
+                       << " " << sTiming.MaxTime * 1e-3
+                       << " " << sTiming.Percentile(0.5) * 1e-3
+                       << " " << sTiming.Percentile(0.99) * 1e-3
+                       << std::endl;
+         }
+      }
    }
 
    /****************************************/
@@ -6,9 +6,12 @@
 #ifndef PROFILER_H
 #define PROFILER_H
 
+#include <argos3/core/utility/datatypes/datatypes.h>
+
 #include <sys/time.h>
 #include <sys/resource.h>
 #include <pthread.h>
+#include <time.h>
 
 #include <string>
 #include <iostream>
@@ -19,10 +22,42 @@ namespace argos {
 
    class CProfiler {
 
+   public:
+
+      /**
+       * Measures the time spent in a scope and records it for a component.
+       * When the given profiler is <tt>NULL</tt>, the timer does nothing.
+       * @see CProfiler::RegisterComponent
+       */
+      class CScopedTimer {
+
+      public:
+
+         CScopedTimer(CProfiler* pc_profiler,
+                      UInt32 un_component) :
+            m_pcProfiler(pc_profiler),
+            m_unComponent(un_component),
+            m_unStart(pc_profiler != NULL ? GetTime() : 0) {}
+
+         ~CScopedTimer() {
+            if(m_pcProfiler != NULL) {
+               m_pcProfiler->RecordTime(m_unComponent, GetTime() - m_unStart);
+            }
+         }
+
+      private:
+
+         CProfiler* m_pcProfiler;
+         UInt32 m_unComponent;
+         UInt64 m_unStart;
+
+      };
+
    public:
 
       CProfiler(const std::string& str_file_name,
-                bool b_trunc=true);
+                bool b_trunc=true,
+                bool b_component_timing=true);
       ~CProfiler();
 
       void Start();
@@ -30,6 +65,69 @@ namespace argos {
       void Flush(bool b_human_readable);
       void CollectThreadResourceUsage();
 
+      /**
+       * Returns <tt>true</tt> if the per-component timing is enabled.
+       * @return <tt>true</tt> if the per-component timing is enabled.
+       */
+      inline bool IsComponentTimingEnabled() const {
+         return m_bComponentTiming;
+      }
+
+      /**
+       * Registers a component to time and returns its id.
+       * Registering the same name twice returns the same id. This method
+       * is thread-safe, but it locks a mutex: call it at initialization
+       * and store the returned id.
+       * @param str_name The name of the component, e.g., "sensor:positioning".
+       * @return The id of the component.
+       */
+      UInt32 RegisterComponent(const std::string& str_name);
+
+      /**
+       * Records a time measurement for the given component.
+       * Measurements are stored in buffers owned by the calling thread,
+       * so no lock is taken except the first time a thread records.
+       * @param un_component The component id.
+       * @param un_time The measured time, in nanoseconds.
+       * @see RegisterComponent
+       */
+      void RecordTime(UInt32 un_component,
+                      UInt64 un_time);
+
+      /**
+       * Returns the current value of the monotonic clock, in nanoseconds.
+       * @return the current value of the monotonic clock, in nanoseconds.
+       */
+      static inline UInt64 GetTime() {
+         ::timespec tTime;
+         ::clock_gettime(CLOCK_MONOTONIC, &tTime);
+         return static_cast<UInt64>(tTime.tv_sec) * 1000000000ull +
+            static_cast<UInt64>(tTime.tv_nsec);
+      }
+
+   public:
+
+      /** Number of bins of the timing histograms, one per power of two of nanoseconds */
+      static const UInt32 HISTOGRAM_BINS = 40;
+
+      /** The timing data of a component */
+      struct SComponentTiming {
+         UInt64 Calls;
+         UInt64 TotalTime;
+         UInt64 MinTime;
+         UInt64 MaxTime;
+         UInt64 Histogram[HISTOGRAM_BINS];
+
+         SComponentTiming();
+         void Merge(const SComponentTiming& s_timing);
+         UInt64 Percentile(Real f_percentile) const;
+      };
+
+      /** The timing data collected by a thread */
+      struct SThreadTiming {
+         std::vector<SComponentTiming> Components;
+      };
+
    private:
 
       void StartWallClock();
@@ -41,6 +139,10 @@ namespace argos {
       void FlushHumanReadable();
       void FlushAsTable();
 
+      SThreadTiming& GetThreadTiming();
+      void MergeComponentTimings(std::vector<SComponentTiming>& vec_timings,
+                                 std::vector<UInt32>& vec_threads);
+
    private:
 
       std::ofstream m_cOutFile;
@@ -51,6 +153,12 @@ namespace argos {
       std::vector< ::rusage > m_vecThreadResourceUsage;
       pthread_mutex_t m_tThreadResourceUsageMutex;
 
+      bool m_bComponentTiming;
+      UInt32 m_unSerial;
+      std::vector<std::string> m_vecComponentNames;
+      std::vector<SThreadTiming*> m_vecThreadTimings;
+      pthread_mutex_t m_tComponentTimingMutex;
+
    };
 
 }
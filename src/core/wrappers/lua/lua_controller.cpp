@@ -12,6 +12,9 @@
 #include <argos3/core/wrappers/lua/lua_vector2.h>
 #include <argos3/core/wrappers/lua/lua_vector3.h>
 
+#include <algorithm>
+#include <set>
+
 namespace argos {
 
    /****************************************/
@@ -21,7 +24,12 @@ namespace argos {
       m_ptLuaState(NULL),
       m_bScriptActive(false),
       m_bIsOK(true),
-      m_pcRNG(NULL) {
+      m_pcRNG(NULL),
+      m_bLazySensorReadings(true),
+      m_unLuaStep(0),
+      m_nLuaSensorTablesRef(LUA_NOREF),
+      m_nLuaSnapshotRef(LUA_NOREF),
+      m_bLuaSnapshotRestorable(false) {
    }
 
    /****************************************/
@@ -37,6 +45,8 @@ namespace argos {
       try {
          /* Create RNG */
          m_pcRNG = CRandom::CreateRNG("argos");
+         /* Whether to refresh sensor tables only when the script accesses them */
+         GetNodeAttributeOrDefault(t_tree, "lazy_sensor_readings", m_bLazySensorReadings, m_bLazySensorReadings);
          /* Load script */
          std::string strScriptFileName;
          GetNodeAttributeOrDefault(t_tree, "script", strScriptFileName, strScriptFileName);
@@ -84,7 +94,24 @@ namespace argos {
             m_bIsOK = CLuaUtility::CallLuaFunction(m_ptLuaState, "reset");
          }
          else {
-            SetLuaScript(m_strScriptFileName);
+            /* Go back to the state before init(), and run init() again
+               for the effects it has on the robot */
+            if(RestoreLuaSnapshot()) {
+               m_bIsOK = CLuaUtility::CallLuaFunction(m_ptLuaState, "init");
+            }
+            else if(m_bScriptActive && !m_bLuaSnapshotRestorable) {
+               /* The robots usually share the script, so warn once per script */
+               static std::set<std::string> setWarnedScripts;
+               if(setWarnedScripts.insert(m_strScriptFileName).second) {
+                  LOGERR << "[WARNING] Reloading \"" << m_strScriptFileName
+                         << "\" on reset, because \"" << m_strLuaSnapshotBlocker
+                         << "\" refers to local variables of the script, which can't be saved."
+                         << " Make them global to reset the script without reloading it." << std::endl;
+               }
+            }
+            if(!m_bIsOK) {
+               SetLuaScript(m_strScriptFileName);
+            }
          }
       }
    }
@@ -133,19 +160,175 @@ namespace argos {
       lua_pushstring(m_ptLuaState, strPackagePath.c_str());
       lua_setfield(m_ptLuaState, -2, "path");
       lua_pop(m_ptLuaState, 1);
+      /* Take note of the globals that do not belong to the script */
+      m_nLuaSnapshotRef = LUA_NOREF;
+      m_vecLuaBaseGlobals.clear();
+      lua_pushglobaltable(m_ptLuaState);
+      lua_pushnil(m_ptLuaState);
+      while(lua_next(m_ptLuaState, -2)) {
+         if(lua_type(m_ptLuaState, -2) == LUA_TSTRING) {
+            m_vecLuaBaseGlobals.push_back(lua_tostring(m_ptLuaState, -2));
+         }
+         lua_pop(m_ptLuaState, 1);
+      }
+      lua_pop(m_ptLuaState, 1);
+      std::sort(m_vecLuaBaseGlobals.begin(), m_vecLuaBaseGlobals.end());
       /* Load script */
       if(!CLuaUtility::LoadScript(m_ptLuaState, str_script)) {
          m_bIsOK = false;
          return;
       }
       m_strScriptFileName = str_script;
+      m_bScriptActive = true;
+      TakeLuaSnapshot();
       /* Execute script init function */
       if(!CLuaUtility::CallLuaFunction(m_ptLuaState, "init")) {
          m_bIsOK = false;
          return;
       }
       m_bIsOK = true;
-      m_bScriptActive = true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * Returns true if the value at the top of the stack is, or contains, a Lua
+    * function with upvalues other than _ENV, i.e., one that refers to the
+    * local variables of the script. Such upvalues can't be copied.
+    */
+   static bool HasLocalUpvalues(lua_State* pt_state,
+                                int n_visited) {
+      if(lua_isfunction(pt_state, -1) && !lua_iscfunction(pt_state, -1)) {
+         for(int i = 1; ; ++i) {
+            const char* pchName = lua_getupvalue(pt_state, -1, i);
+            if(pchName == NULL) return false;
+            lua_pop(pt_state, 1);
+            if(std::string(pchName) != "_ENV") return true;
+         }
+      }
+      if(lua_istable(pt_state, -1)) {
+         /* Visit each table once */
+         lua_pushvalue(pt_state, -1);
+         lua_rawget(pt_state, n_visited);
+         bool bVisited = lua_toboolean(pt_state, -1);
+         lua_pop(pt_state, 1);
+         if(bVisited) return false;
+         lua_pushvalue(pt_state, -1);
+         lua_pushboolean(pt_state, 1);
+         lua_rawset(pt_state, n_visited);
+         lua_pushnil(pt_state);
+         while(lua_next(pt_state, -2)) {
+            if(HasLocalUpvalues(pt_state, n_visited)) {
+               lua_pop(pt_state, 2);
+               return true;
+            }
+            lua_pop(pt_state, 1);
+         }
+      }
+      return false;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLuaController::TakeLuaSnapshot() {
+      /* Release the previous snapshot */
+      if(m_nLuaSnapshotRef != LUA_NOREF) {
+         luaL_unref(m_ptLuaState, LUA_REGISTRYINDEX, m_nLuaSnapshotRef);
+      }
+      /* Stack: copies, visited, snapshot, script globals, base globals, globals */
+      lua_newtable(m_ptLuaState);
+      int nCopies = lua_gettop(m_ptLuaState);
+      lua_newtable(m_ptLuaState);
+      m_bLuaSnapshotRestorable = true;
+      m_strLuaSnapshotBlocker.clear();
+      lua_newtable(m_ptLuaState);
+      lua_newtable(m_ptLuaState);
+      lua_newtable(m_ptLuaState);
+      lua_pushglobaltable(m_ptLuaState);
+      lua_pushnil(m_ptLuaState);
+      while(lua_next(m_ptLuaState, -2)) {
+         if(lua_type(m_ptLuaState, -2) != LUA_TSTRING ||
+            !std::binary_search(m_vecLuaBaseGlobals.begin(),
+                                m_vecLuaBaseGlobals.end(),
+                                std::string(lua_tostring(m_ptLuaState, -2)))) {
+            /* Script global: deep copy */
+            if(m_bLuaSnapshotRestorable &&
+               HasLocalUpvalues(m_ptLuaState, nCopies + 1)) {
+               m_bLuaSnapshotRestorable = false;
+               m_strLuaSnapshotBlocker = (lua_type(m_ptLuaState, -2) == LUA_TSTRING) ?
+                  lua_tostring(m_ptLuaState, -2) : "a global";
+            }
+            CLuaUtility::DeepCopy(m_ptLuaState, nCopies);
+            lua_remove(m_ptLuaState, -2);
+            lua_pushvalue(m_ptLuaState, -2);
+            lua_insert(m_ptLuaState, -2);
+            lua_rawset(m_ptLuaState, -6);
+         }
+         else {
+            /* Base global: the value itself, which is shared with the state */
+            lua_pushvalue(m_ptLuaState, -2);
+            lua_insert(m_ptLuaState, -2);
+            lua_rawset(m_ptLuaState, -5);
+         }
+      }
+      lua_pop(m_ptLuaState, 1);
+      lua_rawseti(m_ptLuaState, -3, 2);
+      lua_rawseti(m_ptLuaState, -2, 1);
+      m_nLuaSnapshotRef = luaL_ref(m_ptLuaState, LUA_REGISTRYINDEX);
+      lua_pop(m_ptLuaState, 2);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CLuaController::RestoreLuaSnapshot() {
+      if(!m_bScriptActive ||
+         m_nLuaSnapshotRef == LUA_NOREF ||
+         !m_bLuaSnapshotRestorable) return false;
+      /* Get rid of whatever an error left on the stack */
+      lua_settop(m_ptLuaState, 0);
+      /* Delete all the string-keyed globals */
+      lua_pushglobaltable(m_ptLuaState);
+      std::vector<std::string> vecGlobals;
+      lua_pushnil(m_ptLuaState);
+      while(lua_next(m_ptLuaState, -2)) {
+         if(lua_type(m_ptLuaState, -2) == LUA_TSTRING) {
+            vecGlobals.push_back(lua_tostring(m_ptLuaState, -2));
+         }
+         lua_pop(m_ptLuaState, 1);
+      }
+      for(size_t i = 0; i < vecGlobals.size(); ++i) {
+         lua_pushnil(m_ptLuaState);
+         lua_setfield(m_ptLuaState, -2, vecGlobals[i].c_str());
+      }
+      /* Put back the base globals as they were */
+      lua_rawgeti(m_ptLuaState, LUA_REGISTRYINDEX, m_nLuaSnapshotRef);
+      lua_rawgeti(m_ptLuaState, -1, 2);
+      lua_pushnil(m_ptLuaState);
+      while(lua_next(m_ptLuaState, -2)) {
+         /* Stack: globals, snapshot, base globals, key, value */
+         lua_pushvalue(m_ptLuaState, -2);
+         lua_insert(m_ptLuaState, -2);
+         lua_rawset(m_ptLuaState, -6);
+      }
+      lua_pop(m_ptLuaState, 1);
+      /* Copy the script globals, so the snapshot stays untouched */
+      lua_newtable(m_ptLuaState);
+      int nCopies = lua_gettop(m_ptLuaState);
+      lua_rawgeti(m_ptLuaState, -2, 1);
+      lua_pushnil(m_ptLuaState);
+      while(lua_next(m_ptLuaState, -2)) {
+         /* Stack: globals, snapshot, copies, script globals, key, value */
+         CLuaUtility::DeepCopy(m_ptLuaState, nCopies);
+         lua_remove(m_ptLuaState, -2);
+         lua_pushvalue(m_ptLuaState, -2);
+         lua_insert(m_ptLuaState, -2);
+         lua_rawset(m_ptLuaState, -7);
+      }
+      lua_pop(m_ptLuaState, 4);
+      return true;
    }
 
    /****************************************/
@@ -180,10 +363,35 @@ namespace argos {
           ++it) {
          it->second->CreateLuaState(m_ptLuaState);
       }
+      m_vecLuaSensors.clear();
+      if(m_bLazySensorReadings) {
+         /* The table that holds the actual sensor tables */
+         lua_newtable(m_ptLuaState);
+         m_nLuaSensorTablesRef = luaL_ref(m_ptLuaState, LUA_REGISTRYINDEX);
+         /* The lazy tables keep pointers to the elements of this vector */
+         m_vecLuaSensors.reserve(m_mapSensors.size());
+      }
       for(CCI_Sensor::TMap::iterator it = m_mapSensors.begin();
           it != m_mapSensors.end();
           ++it) {
-         it->second->CreateLuaState(m_ptLuaState);
+         if(!m_bLazySensorReadings) {
+            it->second->CreateLuaState(m_ptLuaState);
+         }
+         else {
+            /* Take note of the fields of the robot table before the sensor adds its own */
+            std::vector<std::string> vecOldKeys;
+            lua_pushnil(m_ptLuaState);
+            while(lua_next(m_ptLuaState, -2)) {
+               if(lua_type(m_ptLuaState, -2) == LUA_TSTRING) {
+                  vecOldKeys.push_back(lua_tostring(m_ptLuaState, -2));
+               }
+               lua_pop(m_ptLuaState, 1);
+            }
+            std::sort(vecOldKeys.begin(), vecOldKeys.end());
+            it->second->CreateLuaState(m_ptLuaState);
+            m_vecLuaSensors.push_back(SLuaSensor(this, it->second));
+            CreateLazySensorTables(m_vecLuaSensors.back(), vecOldKeys);
+         }
       }
       /* Set the name of the table */
       lua_setglobal(m_ptLuaState, "robot");
@@ -192,14 +400,142 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CLuaController::CreateLazySensorTables(SLuaSensor& s_sensor,
+                                               const std::vector<std::string>& vec_old_keys) {
+      /*
+       * The robot table is at the top of the stack.
+       * Each table the sensor added is moved into the sensor table holder,
+       * and replaced in the robot table by an empty proxy whose metatable
+       * refreshes the actual table before forwarding the access to it.
+       */
+      std::vector<std::string> vecNewKeys;
+      lua_pushnil(m_ptLuaState);
+      while(lua_next(m_ptLuaState, -2)) {
+         if(lua_type(m_ptLuaState, -2) == LUA_TSTRING &&
+            !std::binary_search(vec_old_keys.begin(), vec_old_keys.end(),
+                                std::string(lua_tostring(m_ptLuaState, -2)))) {
+            if(!lua_istable(m_ptLuaState, -1)) {
+               /* Values that are not tables can only be updated eagerly */
+               s_sensor.Eager = true;
+            }
+            vecNewKeys.push_back(lua_tostring(m_ptLuaState, -2));
+         }
+         lua_pop(m_ptLuaState, 1);
+      }
+      if(vecNewKeys.empty()) {
+         /* The sensor updates fields created by others, it can't be lazy */
+         s_sensor.Eager = true;
+      }
+      if(s_sensor.Eager) return;
+      lua_rawgeti(m_ptLuaState, LUA_REGISTRYINDEX, m_nLuaSensorTablesRef);
+      for(size_t i = 0; i < vecNewKeys.size(); ++i) {
+         /* Move the actual table into the holder */
+         lua_getfield(m_ptLuaState, -2, vecNewKeys[i].c_str());
+         lua_pushvalue(m_ptLuaState, -1);
+         lua_setfield(m_ptLuaState, -3, vecNewKeys[i].c_str());
+         /* Create the proxy and its metatable */
+         lua_newtable(m_ptLuaState);
+         lua_newtable(m_ptLuaState);
+         /* The actual table is also reachable from the metatable, for inspection */
+         lua_pushvalue(m_ptLuaState, -3);
+         lua_setfield(m_ptLuaState, -2, "__readings");
+         static const char* const pchMetamethods[] = { "__index", "__newindex", "__len", "__pairs" };
+         static const lua_CFunction ptMetamethods[] = {
+            LuaSensorTableIndex,
+            LuaSensorTableNewIndex,
+            LuaSensorTableLen,
+            LuaSensorTablePairs
+         };
+         for(size_t j = 0; j < 4; ++j) {
+            lua_pushlightuserdata(m_ptLuaState, &s_sensor);
+            lua_pushvalue(m_ptLuaState, -4);
+            lua_pushcclosure(m_ptLuaState, ptMetamethods[j], 2);
+            lua_setfield(m_ptLuaState, -2, pchMetamethods[j]);
+         }
+         lua_setmetatable(m_ptLuaState, -2);
+         /* Replace the actual table with the proxy in the robot table */
+         lua_setfield(m_ptLuaState, -4, vecNewKeys[i].c_str());
+         lua_pop(m_ptLuaState, 1);
+      }
+      lua_pop(m_ptLuaState, 1);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLuaController::SLuaSensor::Refresh(lua_State* pt_lua_state) {
+      if(LastStep != Controller->m_unLuaStep) {
+         LastStep = Controller->m_unLuaStep;
+         if(Sensor->LuaReadingsChanged()) {
+            lua_rawgeti(pt_lua_state, LUA_REGISTRYINDEX, Controller->m_nLuaSensorTablesRef);
+            Sensor->ReadingsToLuaState(pt_lua_state);
+            lua_pop(pt_lua_state, 1);
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   /*
+    * The metamethods of the lazy sensor tables.
+    * Upvalue 1 is the SLuaSensor, upvalue 2 is the actual table.
+    */
+
+   int CLuaController::LuaSensorTableIndex(lua_State* pt_lua_state) {
+      reinterpret_cast<SLuaSensor*>(lua_touserdata(pt_lua_state, lua_upvalueindex(1)))->Refresh(pt_lua_state);
+      lua_pushvalue(pt_lua_state, 2);
+      lua_gettable(pt_lua_state, lua_upvalueindex(2));
+      return 1;
+   }
+
+   int CLuaController::LuaSensorTableNewIndex(lua_State* pt_lua_state) {
+      lua_pushvalue(pt_lua_state, 2);
+      lua_pushvalue(pt_lua_state, 3);
+      lua_settable(pt_lua_state, lua_upvalueindex(2));
+      return 0;
+   }
+
+   int CLuaController::LuaSensorTableLen(lua_State* pt_lua_state) {
+      reinterpret_cast<SLuaSensor*>(lua_touserdata(pt_lua_state, lua_upvalueindex(1)))->Refresh(pt_lua_state);
+      lua_pushinteger(pt_lua_state, lua_rawlen(pt_lua_state, lua_upvalueindex(2)));
+      return 1;
+   }
+
+   int CLuaController::LuaSensorTablePairs(lua_State* pt_lua_state) {
+      reinterpret_cast<SLuaSensor*>(lua_touserdata(pt_lua_state, lua_upvalueindex(1)))->Refresh(pt_lua_state);
+      lua_getglobal(pt_lua_state, "next");
+      lua_pushvalue(pt_lua_state, lua_upvalueindex(2));
+      lua_pushnil(pt_lua_state);
+      return 3;
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CLuaController::SensorReadingsToLuaState() {
       /* Put the robot state table on top */
       lua_getglobal(m_ptLuaState, "robot");
-      /* Go through the sensors */
-      for(CCI_Sensor::TMap::iterator it = m_mapSensors.begin();
-          it != m_mapSensors.end();
-          ++it) {
-         it->second->ReadingsToLuaState(m_ptLuaState);
+      if(!m_bLazySensorReadings) {
+         /* Go through the sensors */
+         for(CCI_Sensor::TMap::iterator it = m_mapSensors.begin();
+             it != m_mapSensors.end();
+             ++it) {
+            if(it->second->LuaReadingsChanged()) {
+               it->second->ReadingsToLuaState(m_ptLuaState);
+            }
+         }
+      }
+      else {
+         /* Mark the lazy tables as outdated */
+         ++m_unLuaStep;
+         /* Update the sensors that can't be lazy */
+         for(size_t i = 0; i < m_vecLuaSensors.size(); ++i) {
+            if(m_vecLuaSensors[i].Eager &&
+               m_vecLuaSensors[i].Sensor->LuaReadingsChanged()) {
+               m_vecLuaSensors[i].Sensor->ReadingsToLuaState(m_ptLuaState);
+            }
+         }
       }
       /* Pop the robot state table */
       lua_pop(m_ptLuaState, 1);
@@ -6,6 +6,7 @@
 
 #include <argos3/core/control_interface/ci_controller.h>
 #include <argos3/core/utility/math/rng.h>
+#include <vector>
 
 extern "C" {
 #include <lua.h>
@@ -40,6 +41,12 @@ namespace argos {
 
       virtual void CreateLuaState();
 
+      /**
+       * Updates the sensor tables in the Lua state.
+       * When lazy sensor readings are enabled (the default), this method only
+       * marks the sensor tables as outdated: each table is then refreshed the
+       * first time the script accesses it during the current step.
+       */
       virtual void SensorReadingsToLuaState();
 
       virtual void ParametersToLuaState(TConfigurationNode& t_tree);
@@ -48,8 +55,69 @@ namespace argos {
          return m_bIsOK;
       }
 
+      /**
+       * Stores a copy of the global variables.
+       * This method is called automatically after the script has been
+       * loaded, right before its <tt>init</tt> function is executed.
+       * The globals created by the script are deep-copied; the globals that
+       * existed before the script was loaded (the Lua libraries, the
+       * <tt>robot</tt> table) are stored as they are.
+       * @see RestoreLuaSnapshot()
+       */
+      virtual void TakeLuaSnapshot();
+
+      /**
+       * Restores the global variables to the last snapshot.
+       * Reset() uses this method, followed by a call to the script
+       * <tt>init</tt> function, to recover from script errors without
+       * reloading the script. The restored state is the one of a freshly
+       * loaded script, with these limits:
+       * - the contents of the tables that existed before the script was
+       *   loaded are not restored, e.g., a function the script added to
+       *   <tt>math</tt> stays there;
+       * - the upvalues of the functions can't be copied, so when a function
+       *   of the script refers to a local variable of the script, the
+       *   snapshot is not restorable and Reset() reloads the script,
+       *   logging a warning the first time this happens for the script;
+       * - userdata other than vectors and quaternions are shared.
+       * @return <tt>false</tt> if no restorable snapshot is available.
+       * @see TakeLuaSnapshot()
+       */
+      virtual bool RestoreLuaSnapshot();
+
       std::string GetErrorMessage();
 
+   private:
+
+      /**
+       * A sensor whose tables in the Lua state are refreshed on demand.
+       */
+      struct SLuaSensor {
+         CLuaController* Controller;
+         CCI_Sensor* Sensor;
+         /* The step in which the tables were last refreshed */
+         UInt32 LastStep;
+         /* Whether the sensor cannot be refreshed lazily */
+         bool Eager;
+
+         SLuaSensor(CLuaController* pc_controller,
+                    CCI_Sensor* pc_sensor) :
+            Controller(pc_controller),
+            Sensor(pc_sensor),
+            LastStep(0),
+            Eager(false) {}
+
+         void Refresh(lua_State* pt_lua_state);
+      };
+
+      void CreateLazySensorTables(SLuaSensor& s_sensor,
+                                  const std::vector<std::string>& vec_old_keys);
+
+      static int LuaSensorTableIndex(lua_State* pt_lua_state);
+      static int LuaSensorTableNewIndex(lua_State* pt_lua_state);
+      static int LuaSensorTableLen(lua_State* pt_lua_state);
+      static int LuaSensorTablePairs(lua_State* pt_lua_state);
+
    private:
 
       lua_State* m_ptLuaState;
@@ -58,6 +126,21 @@ namespace argos {
       bool m_bIsOK;
       CRandom::CRNG* m_pcRNG;
 
+      bool m_bLazySensorReadings;
+      UInt32 m_unLuaStep;
+      /* Registry reference to the table holding the actual sensor tables */
+      int m_nLuaSensorTablesRef;
+      std::vector<SLuaSensor> m_vecLuaSensors;
+
+      /* The globals that existed before the script was loaded, sorted */
+      std::vector<std::string> m_vecLuaBaseGlobals;
+      /* Registry reference to the snapshot of the script globals */
+      int m_nLuaSnapshotRef;
+      /* Whether the snapshot can be restored, see RestoreLuaSnapshot() */
+      bool m_bLuaSnapshotRestorable;
+      /* The first global that made the snapshot not restorable */
+      std::string m_strLuaSnapshotBlocker;
+
    };
 
 }
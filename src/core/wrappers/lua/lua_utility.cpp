@@ -17,6 +17,10 @@
 #include <argos3/core/wrappers/lua/lua_vector3.h>
 #include <argos3/core/wrappers/lua/lua_quaternion.h>
 
+#include <map>
+#include <pthread.h>
+#include <sys/stat.h>
+
 namespace argos {
 
    /****************************************/
@@ -178,12 +182,78 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   struct SLuaBytecode {
+      ::time_t ModificationTime;
+      ::off_t Size;
+      std::string Code;
+   };
+
+   typedef std::map<std::string, SLuaBytecode> TLuaBytecodeCache;
+
+   static TLuaBytecodeCache& GetLuaBytecodeCache() {
+      static TLuaBytecodeCache tCache;
+      return tCache;
+   }
+
+   /* Controllers can be created by several threads at once */
+   static pthread_mutex_t LUA_BYTECODE_CACHE_MUTEX = PTHREAD_MUTEX_INITIALIZER;
+
+   static int LuaBytecodeWriter(lua_State*,
+                                const void* pt_data,
+                                size_t un_size,
+                                void* pt_code) {
+      reinterpret_cast<std::string*>(pt_code)->append(
+         reinterpret_cast<const char*>(pt_data), un_size);
+      return 0;
+   }
+
    bool CLuaUtility::LoadScript(lua_State* pt_state,
                                 const std::string& str_filename) {
-      if(luaL_loadfile(pt_state, str_filename.c_str())) {
-         LOGERR << "[FATAL] Error loading \"" << str_filename
-                << "\"" << std::endl;
-         return false;
+      /* Is the compiled script in the cache and up to date? */
+      struct ::stat tStat;
+      bool bCacheable = (::stat(str_filename.c_str(), &tStat) == 0);
+      std::string strCode;
+      bool bCached = false;
+      if(bCacheable) {
+         pthread_mutex_lock(&LUA_BYTECODE_CACHE_MUTEX);
+         TLuaBytecodeCache& tCache = GetLuaBytecodeCache();
+         TLuaBytecodeCache::iterator it = tCache.find(str_filename);
+         if(it != tCache.end() &&
+            it->second.ModificationTime == tStat.st_mtime &&
+            it->second.Size == tStat.st_size) {
+            strCode = it->second.Code;
+            bCached = true;
+         }
+         pthread_mutex_unlock(&LUA_BYTECODE_CACHE_MUTEX);
+      }
+      if(bCached) {
+         /* Yes, load the bytecode; the chunk name is the same luaL_loadfile() uses */
+         if(luaL_loadbuffer(pt_state,
+                            strCode.data(),
+                            strCode.size(),
+                            ("@" + str_filename).c_str())) {
+            LOGERR << "[FATAL] Error loading \"" << str_filename
+                   << "\"" << std::endl;
+            return false;
+         }
+      }
+      else {
+         /* No, compile the script */
+         if(luaL_loadfile(pt_state, str_filename.c_str())) {
+            LOGERR << "[FATAL] Error loading \"" << str_filename
+                   << "\"" << std::endl;
+            return false;
+         }
+         /* Store the bytecode, with debug information for error messages */
+         if(bCacheable) {
+            SLuaBytecode sBytecode;
+            sBytecode.ModificationTime = tStat.st_mtime;
+            sBytecode.Size = tStat.st_size;
+            lua_dump(pt_state, LuaBytecodeWriter, &sBytecode.Code, 0);
+            pthread_mutex_lock(&LUA_BYTECODE_CACHE_MUTEX);
+            GetLuaBytecodeCache()[str_filename] = sBytecode;
+            pthread_mutex_unlock(&LUA_BYTECODE_CACHE_MUTEX);
+         }
       }
       if(lua_pcall(pt_state, 0, 0, 0)) {
          LOGERR << "[FATAL] Error executing \"" << str_filename
@@ -198,6 +268,60 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CLuaUtility::ClearBytecodeCache() {
+      pthread_mutex_lock(&LUA_BYTECODE_CACHE_MUTEX);
+      GetLuaBytecodeCache().clear();
+      pthread_mutex_unlock(&LUA_BYTECODE_CACHE_MUTEX);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLuaUtility::DeepCopy(lua_State* pt_state,
+                              int n_copies) {
+      if(lua_istable(pt_state, -1)) {
+         /* Was this table copied already? */
+         lua_pushvalue(pt_state, -1);
+         lua_rawget(pt_state, n_copies);
+         if(!lua_isnil(pt_state, -1)) return;
+         lua_pop(pt_state, 1);
+         /* Create the copy and register it */
+         lua_newtable(pt_state);
+         lua_pushvalue(pt_state, -2);
+         lua_pushvalue(pt_state, -2);
+         lua_rawset(pt_state, n_copies);
+         /* Copy the elements */
+         lua_pushnil(pt_state);
+         while(lua_next(pt_state, -3)) {
+            /* Stack: original, copy, key, value */
+            DeepCopy(pt_state, n_copies);
+            lua_remove(pt_state, -2);
+            lua_pushvalue(pt_state, -2);
+            lua_insert(pt_state, -2);
+            lua_rawset(pt_state, -4);
+         }
+         /* Share the metatable */
+         if(lua_getmetatable(pt_state, -2)) {
+            lua_setmetatable(pt_state, -2);
+         }
+      }
+      else if(luaL_testudata(pt_state, -1, CLuaVector2::GetTypeId().c_str())) {
+         CLuaVector2::PushVector2(pt_state, CLuaVector2::ToVector2(pt_state, -1));
+      }
+      else if(luaL_testudata(pt_state, -1, CLuaVector3::GetTypeId().c_str())) {
+         CLuaVector3::PushVector3(pt_state, CLuaVector3::ToVector3(pt_state, -1));
+      }
+      else if(luaL_testudata(pt_state, -1, CLuaQuaternion::GetTypeId().c_str())) {
+         CLuaQuaternion::PushQuaternion(pt_state, CLuaQuaternion::ToQuaternion(pt_state, -1));
+      }
+      else {
+         lua_pushvalue(pt_state, -1);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    bool CLuaUtility::CallLuaFunction(lua_State* pt_state,
                                      const std::string& str_function) {
       lua_getglobal(pt_state, str_function.c_str());
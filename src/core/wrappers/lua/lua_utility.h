@@ -34,12 +34,34 @@ namespace argos {
 
       /**
        * Loads the given Lua script.
+       * Each script file is compiled only once: its bytecode is cached and shared
+       * among all the Lua states that load it, until the file is modified.
+       * The cache is thread-safe, so controllers can be created by several threads.
        * @param pt_state The Lua state.
        * @param str_filename The script file name.
        * @return <tt>false</tt> in case of errors, <tt>true</tt> otherwise.
+       * @see ClearBytecodeCache()
        */
       static bool LoadScript(lua_State* pt_state,
                              const std::string& str_filename);
+
+      /**
+       * Empties the cache of compiled scripts.
+       * @see LoadScript()
+       */
+      static void ClearBytecodeCache();
+
+      /**
+       * Pushes a deep copy of the value at the top of the stack.
+       * Tables are copied recursively and share their metatable with the
+       * original. Vectors and quaternions are duplicated. Any other value,
+       * including functions and table keys, is shared with the original.
+       * @param pt_state The Lua state.
+       * @param n_copies The absolute stack index of a table that maps the
+       * tables copied so far to their copy, which handles cycles.
+       */
+      static void DeepCopy(lua_State* pt_state,
+                           int n_copies);
       
       /**
        * Calls a parameter-less function in the Lua script.
@@ -17,6 +17,7 @@ namespace argos {
   /****************************************/
 
   const CCI_CrazyflieDistanceScannerSensor::TReadingsMap& CCI_CrazyflieDistanceScannerSensor::GetReadingsMap(){
+    UpdateReadingsMaps();
     return m_tReadingsMap;
   }
 
@@ -24,6 +25,7 @@ namespace argos {
   /****************************************/
 
   const CCI_CrazyflieDistanceScannerSensor::TReadingsMap& CCI_CrazyflieDistanceScannerSensor::GetShortReadingsMap(){
+    UpdateReadingsMaps();
     return m_tShortReadingsMap;
   }
 
@@ -31,10 +33,60 @@ namespace argos {
   /****************************************/
 
   const CCI_CrazyflieDistanceScannerSensor::TReadingsMap& CCI_CrazyflieDistanceScannerSensor::GetLongReadingsMap(){
+    UpdateReadingsMaps();
     return m_tLongReadingsMap;
   }
 
-   
+  /****************************************/
+  /****************************************/
+
+  void CCI_CrazyflieDistanceScannerSensor::ClearReadings() {
+    m_tShortReadings.clear();
+    m_tLongReadings.clear();
+    m_bReadingsMapsStale = true;
+  }
+
+  /****************************************/
+  /****************************************/
+
+  void CCI_CrazyflieDistanceScannerSensor::AddShortReading(const CRadians& c_angle,
+                                                           Real f_distance) {
+    m_tShortReadings.push_back(SReading(c_angle, f_distance));
+    m_bReadingsMapsStale = true;
+  }
+
+  /****************************************/
+  /****************************************/
+
+  void CCI_CrazyflieDistanceScannerSensor::AddLongReading(const CRadians& c_angle,
+                                                          Real f_distance) {
+    m_tLongReadings.push_back(SReading(c_angle, f_distance));
+    m_bReadingsMapsStale = true;
+  }
+
+  /****************************************/
+  /****************************************/
+
+  void CCI_CrazyflieDistanceScannerSensor::UpdateReadingsMaps() {
+    if(!m_bReadingsMapsStale) return;
+    m_tReadingsMap.clear();
+    m_tShortReadingsMap.clear();
+    m_tLongReadingsMap.clear();
+    /* Later readings at the same angle replace earlier ones */
+    for(size_t i = 0; i < m_tShortReadings.size(); ++i) {
+      m_tShortReadingsMap[m_tShortReadings[i].Angle] = m_tShortReadings[i].Distance;
+      m_tReadingsMap[m_tShortReadings[i].Angle] = m_tShortReadings[i].Distance;
+    }
+    for(size_t i = 0; i < m_tLongReadings.size(); ++i) {
+      m_tLongReadingsMap[m_tLongReadings[i].Angle] = m_tLongReadings[i].Distance;
+      m_tReadingsMap[m_tLongReadings[i].Angle] = m_tLongReadings[i].Distance;
+    }
+    m_bReadingsMapsStale = false;
+  }
+
+  /****************************************/
+  /****************************************/
+
 #ifdef ARGOS_WITH_LUA
   void CCI_CrazyflieDistanceScannerSensor::CreateLuaState(lua_State* pt_lua_state) {
     CLuaUtility::OpenRobotStateTable (pt_lua_state, "distance_scanner");
@@ -51,6 +103,7 @@ namespace argos {
 
 #ifdef ARGOS_WITH_LUA
   void CCI_CrazyflieDistanceScannerSensor::ReadingsToLuaState(lua_State* pt_lua_state) {
+    UpdateReadingsMaps();
     lua_getfield(pt_lua_state, -1, "distance_scanner");
     CLuaUtility::StartTable(pt_lua_state, "short_range");
     int nCounter = 1;
@@ -102,6 +102,22 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CDynamics2DEPuckModel::SaveState(CByteArray& c_buffer) {
+      CDynamics2DSingleBodyObjectModel::SaveState(c_buffer);
+      m_cDiffSteering.SaveState(c_buffer);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics2DEPuckModel::LoadState(CByteArray& c_buffer) {
+      CDynamics2DSingleBodyObjectModel::LoadState(c_buffer);
+      m_cDiffSteering.LoadState(c_buffer);
+   }
+
+   /****************************************/
+   /****************************************/
+
    REGISTER_STANDARD_DYNAMICS2D_OPERATIONS_ON_ENTITY(CEPuckEntity, CDynamics2DEPuckModel);
 
    /****************************************/
@@ -31,6 +31,10 @@ namespace argos {
       virtual void Reset();
 
       virtual void UpdateFromEntityStatus();
+
+      virtual void SaveState(CByteArray& c_buffer);
+
+      virtual void LoadState(CByteArray& c_buffer);
       
    private:
 
@@ -73,14 +73,10 @@ namespace argos {
    
    void CEPuckProximityDefaultSensor::Update()
    {
-      /* Ray used for scanning the environment for obstacles */
-      CRay3 cScanningRay;
+      /* Compute the rays of the sensors */
       CVector3 cRayStart, cRayEnd;
-      /* Buffers to contain data about the intersection */
-      SEmbodiedEntityIntersectionItem sIntersection;
-      /* Go through the sensors */
+      m_vecRays.resize(m_tReadings.size());
       for(UInt32 i = 0; i < m_tReadings.size(); ++i) {
-         /* Compute ray for sensor i */
          cRayStart = m_pcProximityEntity->GetSensor(i).Offset;
          cRayStart.Rotate(m_pcProximityEntity->GetSensor(i).Anchor.Orientation);
          cRayStart += m_pcProximityEntity->GetSensor(i).Anchor.Position;
@@ -88,12 +84,18 @@ namespace argos {
          cRayEnd += m_pcProximityEntity->GetSensor(i).Direction;
          cRayEnd.Rotate(m_pcProximityEntity->GetSensor(i).Anchor.Orientation);
          cRayEnd += m_pcProximityEntity->GetSensor(i).Anchor.Position;
-         cScanningRay.Set(cRayStart,cRayEnd);
+         m_vecRays[i].Set(cRayStart,cRayEnd);
+      }
+      /* Get the closest intersection of each ray */
+      GetClosestEmbodiedEntitiesIntersectedByRays(m_vecIntersections,
+                                                  m_vecRays,
+                                                  m_pcEmbodiedEntity);
+      /* Go through the sensors */
+      for(UInt32 i = 0; i < m_tReadings.size(); ++i) {
+         const CRay3& cScanningRay = m_vecRays[i];
+         const SEmbodiedEntityIntersectionItem& sIntersection = m_vecIntersections[i];
          /* Compute reading */
-         /* Get the closest intersection */
-         if(GetClosestEmbodiedEntityIntersectedByRay(sIntersection,
-                                                     cScanningRay,
-                                                     *m_pcEmbodiedEntity)) {
+         if(sIntersection.IntersectedEntity != NULL) {
             /* There is an intersection */
             if(m_bShowRays) {
                m_pcControllableEntity->AddIntersectionPoint(cScanningRay,
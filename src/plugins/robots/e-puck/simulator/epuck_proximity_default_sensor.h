@@ -20,6 +20,9 @@ namespace argos {
 #include <argos3/core/utility/math/rng.h>
 #include <argos3/core/simulator/space/space.h>
 #include <argos3/core/simulator/sensor.h>
+#include <argos3/core/simulator/physics_engine/physics_engine.h>
+#include <argos3/core/utility/math/ray3.h>
+#include <vector>
 
 namespace argos {
 
@@ -88,6 +91,12 @@ namespace argos {
 
       /** Reference to the space */
       CSpace& m_cSpace;
+
+      /** The rays of the sensors, cast in one batch */
+      std::vector<CRay3> m_vecRays;
+
+      /** The closest intersection of each ray */
+      std::vector<SEmbodiedEntityIntersectionItem> m_vecIntersections;
    };
 
 }
@@ -9,6 +9,7 @@
 #include <argos3/core/simulator/entity/composable_entity.h>
 #include <argos3/plugins/simulator/entities/light_entity.h>
 #include <argos3/plugins/simulator/entities/light_sensor_equipped_entity.h>
+#include <argos3/plugins/simulator/media/light_medium.h>
 
 #include "eyebot_light_rotzonly_sensor.h"
 
@@ -30,8 +31,11 @@ namespace argos {
       return n_value;
    }
 
+   /* Scaled distance beyond which a light is not perceived */
+   static const Real MAX_SCALED_DISTANCE = 2.5f;
+
    static Real ComputeReading(Real f_distance) {
-      if(f_distance > 2.5f) {
+      if(f_distance > MAX_SCALED_DISTANCE) {
          return 0.0f;
       }
       else {
@@ -56,7 +60,8 @@ namespace argos {
       m_bShowRays(false),
       m_pcRNG(NULL),
       m_bAddNoise(false),
-      m_cSpace(CSimulator::GetInstance().GetSpace()) {}
+      m_cSpace(CSimulator::GetInstance().GetSpace()),
+      m_pcLightMedium(NULL) {}
 
    /****************************************/
    /****************************************/
@@ -92,6 +97,12 @@ namespace argos {
             m_pcRNG = CRandom::CreateRNG("argos");
          }
          m_tReadings.resize(m_pcLightEntity->GetNumSensors());
+         /* Light medium */
+         if(NodeAttributeExists(t_tree, "medium")) {
+            std::string strMedium;
+            GetNodeAttribute(t_tree, "medium", strMedium);
+            m_pcLightMedium = &CSimulator::GetInstance().GetMedium<CLightMedium>(strMedium);
+         }
       }
       catch(CARGoSException& ex) {
          THROW_ARGOSEXCEPTION_NESTED("Initialization error in rot_z_only light sensor", ex);
@@ -117,8 +128,25 @@ namespace argos {
       CRadians cAngleLightWrtEyebot;
       /* Buffers to contain data about the intersection */
       SEmbodiedEntityIntersectionItem sIntersection;
-      /* List of light entities */
-      CSpace::TMapPerType& mapLights = m_cSpace.GetEntitiesByType("light");
+      /* Get the lights to consider */
+      if(m_pcLightMedium != NULL) {
+         /* Beyond the maximum scaled distance, a light contributes nothing */
+         m_pcLightMedium->GetLightsInRange(m_vecLights,
+                                           m_pcEmbodiedEntity->GetOriginAnchor().Position,
+                                           MAX_SCALED_DISTANCE);
+      }
+      else {
+         m_vecLights.clear();
+         CSpace::TMapPerTypePerId::iterator itLights = m_cSpace.GetEntityMapPerTypePerId().find("light");
+         if(itLights != m_cSpace.GetEntityMapPerTypePerId().end()) {
+            CSpace::TMapPerType& mapLights = itLights->second;
+            for(CSpace::TMapPerType::iterator it = mapLights.begin();
+                it != mapLights.end();
+                ++it) {
+               m_vecLights.push_back(any_cast<CLightEntity*>(it->second));
+            }
+         }
+      }
       /*
        * 1. go through the list of light entities in the scene
        * 2. check if a light is occluded
@@ -126,11 +154,9 @@ namespace argos {
        *    NOTE: the readings are additive
        * 4. go through the sensors and clamp their values
        */
-      for(CSpace::TMapPerType::iterator it = mapLights.begin();
-          it != mapLights.end();
-          ++it) {
+      for(size_t l = 0; l < m_vecLights.size(); ++l) {
          /* Get a reference to the light */
-         CLightEntity& cLight = *(any_cast<CLightEntity*>(it->second));
+         CLightEntity& cLight = *m_vecLights[l];
          /* Consider the light only if it has non zero intensity */
          if(cLight.GetIntensity() > 0.0f) {
             /* Set the ray end */
@@ -283,8 +309,24 @@ namespace argos {
                    "    </my_controller>\n"
                    "    ...\n"
                    "  </controllers>\n\n"
-                   "OPTIONAL XML CONFIGURATION\n\n"
-                   "None.\n",
+                   "With many lights, the sensor can look the lights up in a light medium instead\n"
+                   "of going through all of them. The lights must be added to the medium with their\n"
+                   "'light_medium' attribute. Only the lights close enough to affect the readings\n"
+                   "are then checked for occlusions, and the readings do not change.\n\n"
+                   "  <controllers>\n"
+                   "    ...\n"
+                   "    <my_controller ...>\n"
+                   "      ...\n"
+                   "      <sensors>\n"
+                   "        ...\n"
+                   "        <eyebot_light implementation=\"rot_z_only\"\n"
+                   "                      medium=\"lights\" />\n"
+                   "        ...\n"
+                   "      </sensors>\n"
+                   "      ...\n"
+                   "    </my_controller>\n"
+                   "    ...\n"
+                   "  </controllers>\n",
                    "Usable"
       );
 
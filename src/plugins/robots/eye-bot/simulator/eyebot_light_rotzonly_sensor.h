@@ -9,10 +9,13 @@
 
 #include <string>
 #include <map>
+#include <vector>
 
 namespace argos {
    class CEyeBotLightRotZOnlySensor;
    class CLightSensorEquippedEntity;
+   class CLightEntity;
+   class CLightMedium;
 }
 
 #include <argos3/plugins/robots/eye-bot/control_interface/ci_eyebot_light_sensor.h>
@@ -81,6 +84,12 @@ namespace argos {
 
       /** Reference to the space */
       CSpace& m_cSpace;
+
+      /** The light medium, or NULL to go through all the lights */
+      CLightMedium* m_pcLightMedium;
+
+      /** Buffer for the lights to consider */
+      std::vector<CLightEntity*> m_vecLights;
    };
 
 }
@@ -67,6 +67,33 @@ namespace argos {
 
    void CEyeBotProximityDefaultSensor::Update() {
       m_pcProximityImpl->Update();
+      CopyReadings();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CEyeBotProximityDefaultSensor::BatchUpdate(CSimulatedSensor** ppc_sensors,
+                                                   size_t un_num_sensors) {
+      /* Update the implementations in one batch; the buffer is reused across steps */
+      static std::vector<CSimulatedSensor*> vecImpls;
+      vecImpls.resize(un_num_sensors);
+      for(size_t i = 0; i < un_num_sensors; ++i) {
+         vecImpls[i] = static_cast<CEyeBotProximityDefaultSensor*>(ppc_sensors[i])->m_pcProximityImpl;
+      }
+      if(!vecImpls.empty()) {
+         CProximityDefaultSensor::BatchUpdate(&vecImpls[0], un_num_sensors);
+      }
+      /* Copy the readings */
+      for(size_t i = 0; i < un_num_sensors; ++i) {
+         static_cast<CEyeBotProximityDefaultSensor*>(ppc_sensors[i])->CopyReadings();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CEyeBotProximityDefaultSensor::CopyReadings() {
       for(size_t i = 0; i < 24; ++i) {
          m_tReadings[i].Value = m_pcProximityImpl->GetReadings()[i];
       }
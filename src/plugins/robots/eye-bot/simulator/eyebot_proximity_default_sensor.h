@@ -9,6 +9,7 @@
 
 #include <string>
 #include <map>
+#include <vector>
 
 namespace argos {
    class CEyeBotProximityDefaultSensor;
@@ -36,6 +37,21 @@ namespace argos {
 
       virtual void Reset();
 
+      virtual TBatchUpdate* GetBatchUpdate() {
+         return &BatchUpdate;
+      }
+
+      /**
+       * Updates the given sensors, casting the rays of all of them in one batch.
+       * @see CProximityDefaultSensor::BatchUpdate
+       */
+      static void BatchUpdate(CSimulatedSensor** ppc_sensors,
+                              size_t un_num_sensors);
+
+   private:
+
+      void CopyReadings();
+
    private:
 
       CProximityDefaultSensor* m_pcProximityImpl;
@@ -95,7 +95,8 @@ namespace argos {
        * Constructor
        */
       CCI_FootBotDistanceScannerSensor() :
-         m_tReadings(4){
+         m_tReadings(4),
+         m_bReadingsMapsStale(false) {
       }
 
       /**
@@ -145,12 +146,60 @@ namespace argos {
        */
       const TReadingsMap& GetLongReadingsMap();
 
+      /**
+       * @brief Return the readings of the short range sensors
+       * The readings are stored one per ray, in the order in which the
+       * rays were cast. Unlike the map, a reading is returned for every
+       * ray, even when two rays share the same angle.
+       */
+      inline const TReadings& GetShortReadings() const {
+         return m_tShortReadings;
+      }
+
+      /**
+       * @brief Return the readings of the long range sensors
+       * @see GetShortReadings()
+       */
+      inline const TReadings& GetLongReadings() const {
+         return m_tLongReadings;
+      }
+
 #ifdef ARGOS_WITH_LUA
       virtual void CreateLuaState(lua_State* pt_lua_state);
 
       virtual void ReadingsToLuaState(lua_State* pt_lua_state);
 #endif
 
+   protected:
+
+      /**
+       * Discards the readings of the short and long range sensors.
+       * The storage is kept for the next readings.
+       */
+      void ClearReadings();
+
+      /**
+       * Adds a reading of a short range sensor.
+       * @param c_angle The angle of the reading.
+       * @param f_distance The distance.
+       */
+      void AddShortReading(const CRadians& c_angle,
+                           Real f_distance);
+
+      /**
+       * Adds a reading of a long range sensor.
+       * @param c_angle The angle of the reading.
+       * @param f_distance The distance.
+       */
+      void AddLongReading(const CRadians& c_angle,
+                          Real f_distance);
+
+      /**
+       * Rebuilds the maps from the readings added since the last call to ClearReadings().
+       * The maps are rebuilt only when they are requested.
+       */
+      void UpdateReadingsMaps();
+
    protected:
 
       /** A vector of sReadings */
@@ -168,6 +217,15 @@ namespace argos {
       /** Map storing the last received packets from the long distance sensors. */
       TReadingsMap m_tLongReadingsMap;
 
+      /** The last readings of the short distance sensors, one per ray. */
+      TReadings m_tShortReadings;
+
+      /** The last readings of the long distance sensors, one per ray. */
+      TReadings m_tLongReadings;
+
+      /** True when the maps do not reflect the last readings. */
+      bool m_bReadingsMapsStale;
+
    };
 
 }
@@ -298,6 +298,75 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   static bool IsTurretActive(UInt8 un_mode) {
+      return
+         un_mode == MODE_SPEED_CONTROL ||
+         un_mode == MODE_POSITION_CONTROL;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics2DFootBotModel::SaveState(CByteArray& c_buffer) {
+      CDynamics2DMultiBodyObjectModel::SaveState(c_buffer);
+      m_cDiffSteering.SaveState(c_buffer);
+      /* Turret */
+      c_buffer << m_unLastTurretMode
+               << static_cast<double>(m_fPreviousTurretAngleError);
+      cpVect tLinearImpulse = reinterpret_cast<cpPivotJoint*>(m_ptBaseGripperLinearMotion)->jAcc;
+      c_buffer << static_cast<double>(tLinearImpulse.x)
+               << static_cast<double>(tLinearImpulse.y);
+      if(IsTurretActive(m_unLastTurretMode)) {
+         c_buffer << static_cast<double>(m_ptControlGripperBody->w)
+                  << static_cast<double>(reinterpret_cast<cpGearJoint*>(m_ptGripperControlAngularMotion)->jAcc);
+      }
+      else {
+         c_buffer << static_cast<double>(reinterpret_cast<cpGearJoint*>(m_ptBaseGripperAngularMotion)->jAcc);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics2DFootBotModel::LoadState(CByteArray& c_buffer) {
+      CDynamics2DMultiBodyObjectModel::LoadState(c_buffer);
+      m_cDiffSteering.LoadState(c_buffer);
+      /* Turret: switch the constraints if the mode changed since the checkpoint */
+      UInt8 unTurretMode;
+      double fTurretAngleError;
+      c_buffer >> unTurretMode >> fTurretAngleError;
+      if(IsTurretActive(unTurretMode) && !IsTurretActive(m_unLastTurretMode)) {
+         TurretPassiveToActive();
+      }
+      else if(!IsTurretActive(unTurretMode) && IsTurretActive(m_unLastTurretMode)) {
+         TurretActiveToPassive();
+      }
+      if(unTurretMode != MODE_OFF) {
+         GetEmbodiedEntity().EnableAnchor("turret");
+      }
+      else {
+         GetEmbodiedEntity().DisableAnchor("turret");
+      }
+      m_unLastTurretMode = unTurretMode;
+      m_fPreviousTurretAngleError = fTurretAngleError;
+      double fJX, fJY, fValue;
+      c_buffer >> fJX >> fJY;
+      reinterpret_cast<cpPivotJoint*>(m_ptBaseGripperLinearMotion)->jAcc = cpv(fJX, fJY);
+      if(IsTurretActive(m_unLastTurretMode)) {
+         c_buffer >> fValue;
+         m_ptControlGripperBody->w = fValue;
+         c_buffer >> fValue;
+         reinterpret_cast<cpGearJoint*>(m_ptGripperControlAngularMotion)->jAcc = fValue;
+      }
+      else {
+         c_buffer >> fValue;
+         reinterpret_cast<cpGearJoint*>(m_ptBaseGripperAngularMotion)->jAcc = fValue;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CDynamics2DFootBotModel::TurretPassiveToActive() {
       /* Delete constraints to actual base body */
       cpSpaceRemoveConstraint(GetDynamics2DEngine().GetPhysicsSpace(), m_ptBaseGripperAngularMotion);
@@ -36,6 +36,19 @@ namespace argos {
 
       virtual void UpdateFromEntityStatus();
 
+      /**
+       * Saves the state of the bodies, of the differential steering and of the turret.
+       * The objects held by the gripper are not saved.
+       * @param c_buffer The target buffer.
+       */
+      virtual void SaveState(CByteArray& c_buffer);
+
+      /**
+       * Restores the state saved by SaveState().
+       * @param c_buffer The source buffer.
+       */
+      virtual void LoadState(CByteArray& c_buffer);
+
       void UpdateOriginAnchor(SAnchor& s_anchor);
 
       void UpdateTurretAnchor(SAnchor& s_anchor);
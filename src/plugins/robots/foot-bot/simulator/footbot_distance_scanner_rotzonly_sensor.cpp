@@ -70,10 +70,11 @@ namespace argos {
    /****************************************/
 
    void CFootBotDistanceScannerRotZOnlySensor::Update() {
-      /* Clear the maps */
-      m_tReadingsMap.clear();
-      m_tShortReadingsMap.clear();
-      m_tLongReadingsMap.clear();
+      /* Clear the readings */
+      ClearReadings();
+      m_vecRays.clear();
+      m_vecRayAngles.clear();
+      m_vecRayLongRange.clear();
       /* Perform calculations only if the sensor is on */
       if(m_pcDistScanEntity->GetMode() != CFootBotDistanceScannerEquippedEntity::MODE_OFF) {
          /* Update the readings wrt to device mode */
@@ -95,6 +96,8 @@ namespace argos {
             /* Save the rotation for next time */
             m_cLastDistScanRotation = m_pcDistScanEntity->GetRotation();
          }
+         /* Cast all the rays of this step at once */
+         CastRays();
       }
    }
 
@@ -102,10 +105,8 @@ namespace argos {
    /****************************************/
 
    void CFootBotDistanceScannerRotZOnlySensor::Reset() {
-      /* Clear the maps */
-      m_tReadingsMap.clear();
-      m_tShortReadingsMap.clear();
-      m_tLongReadingsMap.clear();
+      /* Clear the readings */
+      ClearReadings();
       /* Zero the last rotation */
       m_cLastDistScanRotation = CRadians::ZERO;
    }
@@ -116,93 +117,95 @@ namespace argos {
    void CFootBotDistanceScannerRotZOnlySensor::UpdateNotRotating() {
       /* Short range [0] */
       CRadians cAngle = m_cLastDistScanRotation;
-      cAngle.SignedNormalize();
-      Real fReading = CalculateReadingForRay(m_cShortRangeRays0[0], SHORT_RANGE_MIN_DISTANCE);
-      m_tShortReadingsMap[cAngle] = fReading;
-      m_tReadingsMap[cAngle] = fReading;
+      AddRay(m_cShortRangeRays0[0], cAngle, false);
       /* Long range [1] */
       cAngle += CRadians::PI_OVER_TWO;
       cAngle.SignedNormalize();
-      fReading = CalculateReadingForRay(m_cLongRangeRays1[0], LONG_RANGE_MIN_DISTANCE);
-      m_tLongReadingsMap[cAngle] = fReading;
-      m_tReadingsMap[cAngle] = fReading;
+      AddRay(m_cLongRangeRays1[0], cAngle, true);
       /* Short range [2] */
       cAngle += CRadians::PI_OVER_TWO;
       cAngle.SignedNormalize();
-      fReading = CalculateReadingForRay(m_cShortRangeRays2[0], SHORT_RANGE_MIN_DISTANCE);
-      m_tShortReadingsMap[cAngle] = fReading;
-      m_tReadingsMap[cAngle] = fReading;
+      AddRay(m_cShortRangeRays2[0], cAngle, false);
       /* Long range [3] */
       cAngle += CRadians::PI_OVER_TWO;
       cAngle.SignedNormalize();
-      fReading = CalculateReadingForRay(m_cLongRangeRays3[0], LONG_RANGE_MIN_DISTANCE);
-      m_tLongReadingsMap[cAngle] = fReading;
-      m_tReadingsMap[cAngle] = fReading;
+      AddRay(m_cLongRangeRays3[0], cAngle, true);
    }
 
    /****************************************/
    /****************************************/
 
-#define ADD_READING(RAYS,MAP,INDEX,MINDIST)                 \
-   cAngle += cInterSensorSpan;                              \
-   cAngle.SignedNormalize();                                \
-   fReading = CalculateReadingForRay(RAYS[INDEX],MINDIST);  \
-   MAP[cAngle] = fReading;                                  \
-   m_tReadingsMap[cAngle] = fReading;
-
-#define ADD_READINGS(RAYS,MAP,MINDIST)          \
-   ADD_READING(RAYS,MAP,1,MINDIST)              \
-   ADD_READING(RAYS,MAP,2,MINDIST)              \
-   ADD_READING(RAYS,MAP,3,MINDIST)              \
-   ADD_READING(RAYS,MAP,4,MINDIST)              \
-   ADD_READING(RAYS,MAP,5,MINDIST)
-
    void CFootBotDistanceScannerRotZOnlySensor::UpdateRotating() {
       CRadians cInterSensorSpan = (m_pcDistScanEntity->GetRotation() - m_cLastDistScanRotation).UnsignedNormalize() / 6.0f;
       CRadians cStartAngle = m_cLastDistScanRotation;
       /* Short range [0] */
-      CRadians cAngle = cStartAngle;
-      cAngle.SignedNormalize();
-      Real fReading = CalculateReadingForRay(m_cShortRangeRays0[0], SHORT_RANGE_MIN_DISTANCE);
-      m_tShortReadingsMap[cAngle] = fReading;
-      m_tReadingsMap[cAngle] = fReading;
-      ADD_READINGS(m_cShortRangeRays0, m_tShortReadingsMap, SHORT_RANGE_MIN_DISTANCE);
+      AddRays(m_cShortRangeRays0, cStartAngle, cInterSensorSpan, false);
       /* Short range [2] */
-      cAngle = cStartAngle + CRadians::PI;
-      cAngle.SignedNormalize();
-      fReading = CalculateReadingForRay(m_cShortRangeRays2[0], SHORT_RANGE_MIN_DISTANCE);
-      m_tShortReadingsMap[cAngle] = fReading;
-      m_tReadingsMap[cAngle] = fReading;
-      ADD_READINGS(m_cShortRangeRays2, m_tShortReadingsMap, SHORT_RANGE_MIN_DISTANCE);
+      AddRays(m_cShortRangeRays2, cStartAngle + CRadians::PI, cInterSensorSpan, false);
       /* Long range [1] */
-      cAngle = cStartAngle + CRadians::PI_OVER_TWO;
-      cAngle.SignedNormalize();
-      fReading = CalculateReadingForRay(m_cLongRangeRays1[0], LONG_RANGE_MIN_DISTANCE);
-      m_tLongReadingsMap[cAngle] = fReading;
-      m_tReadingsMap[cAngle] = fReading;
-      ADD_READINGS(m_cLongRangeRays1, m_tLongReadingsMap, LONG_RANGE_MIN_DISTANCE);
+      AddRays(m_cLongRangeRays1, cStartAngle + CRadians::PI_OVER_TWO, cInterSensorSpan, true);
       /* Long range [3] */
-      cAngle = cStartAngle + CRadians::PI_OVER_TWO + CRadians::PI;
+      AddRays(m_cLongRangeRays3, cStartAngle + CRadians::PI_OVER_TWO + CRadians::PI, cInterSensorSpan, true);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CFootBotDistanceScannerRotZOnlySensor::AddRay(const CRay3& c_ray,
+                                                      const CRadians& c_angle,
+                                                      bool b_long_range) {
+      m_vecRays.push_back(c_ray);
+      m_vecRayAngles.push_back(c_angle);
+      m_vecRayAngles.back().SignedNormalize();
+      m_vecRayLongRange.push_back(b_long_range);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CFootBotDistanceScannerRotZOnlySensor::AddRays(const CRay3* pc_rays,
+                                                       const CRadians& c_start_angle,
+                                                       const CRadians& c_inter_sensor_span,
+                                                       bool b_long_range) {
+      CRadians cAngle = c_start_angle;
       cAngle.SignedNormalize();
-      fReading = CalculateReadingForRay(m_cLongRangeRays3[0], LONG_RANGE_MIN_DISTANCE);
-      m_tLongReadingsMap[cAngle] = fReading;
-      m_tReadingsMap[cAngle] = fReading;
-      ADD_READINGS(m_cLongRangeRays3, m_tLongReadingsMap, LONG_RANGE_MIN_DISTANCE);
+      AddRay(pc_rays[0], cAngle, b_long_range);
+      for(size_t i = 1; i < 6; ++i) {
+         cAngle += c_inter_sensor_span;
+         cAngle.SignedNormalize();
+         AddRay(pc_rays[i], cAngle, b_long_range);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CFootBotDistanceScannerRotZOnlySensor::CastRays() {
+      GetClosestEmbodiedEntitiesIntersectedByRays(m_vecIntersections,
+                                                  m_vecRays,
+                                                  m_pcEmbodiedEntity);
+      for(size_t i = 0; i < m_vecRays.size(); ++i) {
+         if(m_vecRayLongRange[i]) {
+            AddLongReading(m_vecRayAngles[i],
+                           CalculateReadingForRay(m_vecRays[i], m_vecIntersections[i], LONG_RANGE_MIN_DISTANCE));
+         }
+         else {
+            AddShortReading(m_vecRayAngles[i],
+                            CalculateReadingForRay(m_vecRays[i], m_vecIntersections[i], SHORT_RANGE_MIN_DISTANCE));
+         }
+      }
    }
 
    /****************************************/
    /****************************************/
 
    Real CFootBotDistanceScannerRotZOnlySensor::CalculateReadingForRay(const CRay3& c_ray,
+                                                                      const SEmbodiedEntityIntersectionItem& s_intersection,
                                                                       Real f_min_distance) {
-      /* Get the closest intersection */
-      SEmbodiedEntityIntersectionItem sIntersection;
-      if(GetClosestEmbodiedEntityIntersectedByRay(sIntersection,
-                                                  c_ray,
-                                                  *m_pcEmbodiedEntity)) {
-         if(m_bShowRays) m_pcControllableEntity->AddIntersectionPoint(c_ray, sIntersection.TOnRay);
+      if(s_intersection.IntersectedEntity != NULL) {
+         if(m_bShowRays) m_pcControllableEntity->AddIntersectionPoint(c_ray, s_intersection.TOnRay);
          /* There is an intersection! */
-         Real fDistance = c_ray.GetDistance(sIntersection.TOnRay);
+         Real fDistance = c_ray.GetDistance(s_intersection.TOnRay);
          if(fDistance > f_min_distance) {
             /* The distance is returned in meters, but the reading must be in cm */
             if(m_bShowRays) m_pcControllableEntity->AddCheckedRay(true, c_ray);
@@ -16,12 +16,14 @@ namespace argos {
 #include <argos3/plugins/robots/foot-bot/control_interface/ci_footbot_distance_scanner_sensor.h>
 #include <argos3/plugins/robots/foot-bot/simulator/footbot_distance_scanner_equipped_entity.h>
 #include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/core/simulator/physics_engine/physics_engine.h>
 #include <argos3/core/utility/math/rng.h>
 #include <argos3/core/utility/math/ray3.h>
 #include <argos3/core/simulator/sensor.h>
 
 #include <string>
 #include <map>
+#include <vector>
 
 namespace argos {
    
@@ -47,7 +49,19 @@ namespace argos {
       void UpdateNotRotating();
       void UpdateRotating();
 
+      void AddRay(const CRay3& c_ray,
+                  const CRadians& c_angle,
+                  bool b_long_range);
+
+      void AddRays(const CRay3* pc_rays,
+                   const CRadians& c_start_angle,
+                   const CRadians& c_inter_sensor_span,
+                   bool b_long_range);
+
+      void CastRays();
+
       Real CalculateReadingForRay(const CRay3& c_ray,
+                                  const SEmbodiedEntityIntersectionItem& s_intersection,
                                   Real f_min_distance);
 
       void CalculateRaysNotRotating();
@@ -93,6 +107,12 @@ namespace argos {
       CRay3 m_cLongRangeRays1[6];
       CRay3 m_cLongRangeRays3[6];
 
+      /* The rays to cast in this step, with the angle and type of each */
+      std::vector<CRay3> m_vecRays;
+      std::vector<CRadians> m_vecRayAngles;
+      std::vector<bool> m_vecRayLongRange;
+      std::vector<SEmbodiedEntityIntersectionItem> m_vecIntersections;
+
       /* Internally used to speed up ray calculations */
       CVector3 m_cDirection;
       CVector3 m_cOriginRayStart;
@@ -9,10 +9,13 @@
 
 #include <string>
 #include <map>
+#include <vector>
 
 namespace argos {
    class CFootBotLightRotZOnlySensor;
    class CLightSensorEquippedEntity;
+   class CLightEntity;
+   class CLightMedium;
 }
 
 #include <argos3/plugins/robots/foot-bot/control_interface/ci_footbot_light_sensor.h>
@@ -87,6 +90,12 @@ namespace argos {
 
       /** Reference to the space */
       CSpace& m_cSpace;
+
+      /** The light medium, or NULL to go through all the lights */
+      CLightMedium* m_pcLightMedium;
+
+      /** Buffer for the lights to consider */
+      std::vector<CLightEntity*> m_vecLights;
    };
 
 }
@@ -67,6 +67,33 @@ namespace argos {
 
    void CFootBotProximityDefaultSensor::Update() {
       m_pcProximityImpl->Update();
+      CopyReadings();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CFootBotProximityDefaultSensor::BatchUpdate(CSimulatedSensor** ppc_sensors,
+                                                    size_t un_num_sensors) {
+      /* Update the implementations in one batch; the buffer is reused across steps */
+      static std::vector<CSimulatedSensor*> vecImpls;
+      vecImpls.resize(un_num_sensors);
+      for(size_t i = 0; i < un_num_sensors; ++i) {
+         vecImpls[i] = static_cast<CFootBotProximityDefaultSensor*>(ppc_sensors[i])->m_pcProximityImpl;
+      }
+      if(!vecImpls.empty()) {
+         CProximityDefaultSensor::BatchUpdate(&vecImpls[0], un_num_sensors);
+      }
+      /* Copy the readings */
+      for(size_t i = 0; i < un_num_sensors; ++i) {
+         static_cast<CFootBotProximityDefaultSensor*>(ppc_sensors[i])->CopyReadings();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CFootBotProximityDefaultSensor::CopyReadings() {
       for(size_t i = 0; i < m_pcProximityImpl->GetReadings().size(); ++i) {
          m_tReadings[i].Value = m_pcProximityImpl->GetReadings()[i];
       }
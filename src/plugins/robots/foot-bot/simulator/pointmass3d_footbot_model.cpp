@@ -65,6 +65,26 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CPointMass3DFootBotModel::SaveState(CByteArray& c_buffer) {
+      CPointMass3DModel::SaveState(c_buffer);
+      c_buffer << static_cast<double>(m_cYaw.GetValue())
+               << static_cast<double>(m_fAngularVelocity);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CPointMass3DFootBotModel::LoadState(CByteArray& c_buffer) {
+      CPointMass3DModel::LoadState(c_buffer);
+      double fYaw, fAngularVelocity;
+      c_buffer >> fYaw >> fAngularVelocity;
+      m_cYaw.SetValue(fYaw);
+      m_fAngularVelocity = fAngularVelocity;
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CPointMass3DFootBotModel::CalculateBoundingBox() {
       GetBoundingBox().MinCorner.Set(
          GetEmbodiedEntity().GetOriginAnchor().Position.GetX() - FOOTBOT_RADIUS,
@@ -272,6 +272,83 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CQTOpenGLFootBot::DrawLowDetail(CFootBotEntity& c_entity) {
+      /* Place the base */
+      glCallList(m_unBaseList);
+      /* Place the LEDs of the gripper module */
+      glPushMatrix();
+      glRotatef(ToDegrees(c_entity.GetTurretEntity().GetRotation()).GetValue(), 0.0f, 0.0f, 1.0f);
+      CLEDEquippedEntity& cLEDEquippedEntity = c_entity.GetLEDEquippedEntity();
+      for(UInt32 i = 0; i < 12; i++) {
+         const CColor& cColor = cLEDEquippedEntity.GetLED(i).GetColor();
+         glRotatef(m_fLEDAngleSlice, 0.0f, 0.0f, 1.0f);
+         SetLEDMaterial(cColor.GetRed()   / 255.0f,
+                        cColor.GetGreen() / 255.0f,
+                        cColor.GetBlue()  / 255.0f);
+         glCallList(m_unGrippableSliceList);
+      }
+      glPopMatrix();
+      /* Place the RAB */
+      glCallList(m_unRABList);
+      /* Place the beacon on top of the iMX module */
+      glCallList(m_unIMXList);
+      const CColor& cBeaconColor = cLEDEquippedEntity.GetLED(12).GetColor();
+      SetLEDMaterial(cBeaconColor.GetRed()   / 255.0f,
+                     cBeaconColor.GetGreen() / 255.0f,
+                     cBeaconColor.GetBlue()  / 255.0f);
+      glCallList(m_unBeaconList);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLFootBot::AddLowDetailInstances(CQTOpenGLWidget& c_visualization,
+                                                CFootBotEntity& c_entity) {
+      const SAnchor& sOrigin = c_entity.GetEmbodiedEntity().GetOriginAnchor();
+      CLEDEquippedEntity& cLEDEquippedEntity = c_entity.GetLEDEquippedEntity();
+      static const CColor cWhite(255, 255, 255);
+      static const CColor cCircuitBoard(0, 0, 255);
+      /* The modules are stacked along the Z axis of the robot */
+      CVector3 cUp(CVector3::Z);
+      cUp.Rotate(sOrigin.Orientation);
+      /* Place the base */
+      c_visualization.AddCylinderInstance(sOrigin.Position + (BATTERY_SOCKET_ELEVATION + WHEEL_DIAMETER) * cUp,
+                                          sOrigin.Orientation,
+                                          BASE_MODULE_RADIUS,
+                                          BASE_MODULE_HEIGHT,
+                                          cCircuitBoard);
+      /* Place the gripper module and its LEDs, which turn with the turret */
+      c_visualization.AddCylinderInstance(sOrigin.Position + GRIPPER_MODULE_ELEVATION * cUp,
+                                          sOrigin.Orientation,
+                                          GRIPPER_MODULE_INNER_RADIUS,
+                                          GRIPPER_MODULE_HEIGHT,
+                                          cWhite);
+      c_visualization.AddLEDInstances(sOrigin.Position,
+                                      sOrigin.Orientation *
+                                      CQuaternion(c_entity.GetTurretEntity().GetRotation(), CVector3::Z),
+                                      cLEDEquippedEntity);
+      /* Place the RAB */
+      c_visualization.AddCylinderInstance(sOrigin.Position + RAB_ELEVATION * cUp,
+                                          sOrigin.Orientation,
+                                          RAB_MAX_RADIUS,
+                                          RAB_HEIGHT,
+                                          cWhite);
+      /* Place the beacon on top of the iMX module */
+      c_visualization.AddCylinderInstance(sOrigin.Position + IMX_MODULE_ELEVATION * cUp,
+                                          sOrigin.Orientation,
+                                          IMX_MODULE_RADIUS,
+                                          IMX_MODULE_HEIGHT,
+                                          cWhite);
+      c_visualization.AddCylinderInstance(sOrigin.Position + BEACON_ELEVATION * cUp,
+                                          sOrigin.Orientation,
+                                          BEACON_RADIUS,
+                                          BEACON_HEIGHT,
+                                          cLEDEquippedEntity.GetLED(12).GetColor());
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CQTOpenGLFootBot::MakeWheel() {
       /* Right side */
       CVector2 cVertex(WHEEL_RADIUS, 0.0f);
@@ -973,7 +1050,17 @@ namespace argos {
          static CQTOpenGLFootBot m_cModel;
          c_visualization.DrawRays(c_entity.GetControllableEntity());
          c_visualization.DrawEntity(c_entity.GetEmbodiedEntity());
-         m_cModel.Draw(c_entity);
+         if(c_visualization.GetLevelOfDetail() == CQTOpenGLWidget::LOD_LOW) {
+            if(c_visualization.IsInstancingEnabled()) {
+               CQTOpenGLFootBot::AddLowDetailInstances(c_visualization, c_entity);
+            }
+            else {
+               m_cModel.DrawLowDetail(c_entity);
+            }
+         }
+         else {
+            m_cModel.Draw(c_entity);
+         }
       }
    };
 
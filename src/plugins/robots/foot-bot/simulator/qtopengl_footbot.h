@@ -9,6 +9,7 @@
 
 namespace argos {
    class CQTOpenGLFootBot;
+   class CQTOpenGLWidget;
    class CFootBotEntity;
 }
 
@@ -30,6 +31,21 @@ namespace argos {
 
       virtual void Draw(CFootBotEntity& c_entity);
 
+      /**
+       * Draws the foot-bot as seen from far away: the base, the LED ring,
+       * the range-and-bearing module and the beacon.
+       */
+      virtual void DrawLowDetail(CFootBotEntity& c_entity);
+
+      /**
+       * Queues the low-detail foot-bot for instanced drawing.
+       * The modules are approximated by cylinders and the LEDs by spheres,
+       * so that all the far-away foot-bots are drawn with a few draw calls.
+       * @see CQTOpenGLWidget::IsInstancingEnabled
+       */
+      static void AddLowDetailInstances(CQTOpenGLWidget& c_visualization,
+                                        CFootBotEntity& c_entity);
+
    protected:
 
       /** Renders a materialless wheel
@@ -29,6 +29,7 @@ namespace argos {
          CLuaUtility::AddToTable(pt_lua_state, i+1, m_tReadings[i]);
       }
       CLuaUtility::CloseRobotStateTable(pt_lua_state);
+      m_tLuaReadings = m_tReadings;
    }
 #endif
 
@@ -44,6 +45,16 @@ namespace argos {
          lua_settable  (pt_lua_state, -3            );
       }
       lua_pop(pt_lua_state, 1);
+      m_tLuaReadings = m_tReadings;
+   }
+#endif
+
+   /****************************************/
+   /****************************************/
+
+#ifdef ARGOS_WITH_LUA
+   bool CCI_ProximitySensor::LuaReadingsChanged() const {
+      return m_tReadings != m_tLuaReadings;
    }
 #endif
 
@@ -27,12 +27,19 @@ namespace argos {
       virtual void CreateLuaState(lua_State* pt_lua_state);
 
       virtual void ReadingsToLuaState(lua_State* pt_lua_state);
+
+      virtual bool LuaReadingsChanged() const;
 #endif
 
    protected:
 
       std::vector<Real> m_tReadings;
 
+#ifdef ARGOS_WITH_LUA
+      /* The readings last written into the Lua state */
+      std::vector<Real> m_tLuaReadings;
+#endif
+
    };
 
 }
@@ -16,6 +16,7 @@ namespace argos {
 
    CCameraDefaultSensor::CCameraDefaultSensor() :
       m_bShowFrustum(false),
+      m_bSharedVisibility(true),
       m_pcEmbodiedEntity(nullptr),
       m_pcControllableEntity(nullptr) {}
 
@@ -37,6 +38,8 @@ namespace argos {
          CCI_CameraSensor::Init(t_tree);
          /* Show the frustums */
          GetNodeAttributeOrDefault(t_tree, "show_frustum", m_bShowFrustum, m_bShowFrustum);
+         /* Share the index queries and occlusion checks among cameras and algorithms */
+         GetNodeAttributeOrDefault(t_tree, "shared_visibility", m_bSharedVisibility, m_bSharedVisibility);
          /* For each camera */
          TConfigurationNodeIterator itCamera("camera");
          for(itCamera = itCamera.begin(&t_tree);
@@ -104,6 +107,10 @@ namespace argos {
                }
                /* initialize the algorithm's control interface */
                pcCIAlgorithm->Init(*itAlgorithm);
+               /* share the visibility pass */
+               if(m_bSharedVisibility) {
+                  pcAlgorithm->SetVisibilityPass(&m_cVisibilityPass);
+               }
                /* store pointers to the algorithms */
                vecSimulatedAlgorithms.push_back(pcAlgorithm);
                vecAlgorithms.push_back(pcCIAlgorithm);
@@ -128,106 +135,44 @@ namespace argos {
       /* vector of controller rays */
       std::vector<std::pair<bool, CRay3> >& vecCheckedRays =
          m_pcControllableEntity->GetCheckedRays();
-      /* sensor parameters */
-      CTransformationMatrix3 cWorldToAnchorTransform;
-      CTransformationMatrix3 cWorldToCameraTransform;
-      CTransformationMatrix3 cCameraToWorldTransform;
-      CVector3 cCameraLocation, cLookAt, cUp;
-      CVector3 cX, cY, cZ;
-      CVector3 cNearCenter, cNearTopLeft, cNearTopRight, cNearBottomLeft, cNearBottomRight;
-      CVector3 cFarCenter, cFarTopLeft, cFarTopRight, cFarBottomLeft, cFarBottomRight;
-      std::array<CPlane, 6> arrFrustumPlanes;
-      CVector3 cBoundingBoxMinCorner, cBoundingBoxMaxCorner;
-      CVector3 cBoundingBoxPosition, cBoundingBoxHalfExtents;
-      /* for each camera sensor */
+      /* calculate the view of each camera */
+      if(m_vecSensors.empty()) {
+         return;
+      }
       for(SSensor& s_sensor : m_vecSensors) {
-         /* calculate transform matrices */
-         cWorldToAnchorTransform.SetFromComponents(s_sensor.Anchor.Orientation, s_sensor.Anchor.Position);
-         cWorldToCameraTransform = cWorldToAnchorTransform * s_sensor.Offset;
-         cCameraToWorldTransform = cWorldToCameraTransform.GetInverse();
-         /* calculate camera direction vectors */
-         cCameraLocation = cWorldToCameraTransform.GetTranslationVector();
-         cLookAt = cWorldToCameraTransform * CVector3::Z;
-         cUp = CVector3(0,-1,0); // -Y
-         cUp.Rotate(cWorldToCameraTransform.GetRotationMatrix());
-         /* calculate direction vectors */
-         cZ = cCameraLocation - cLookAt;
-         cZ.Normalize();
-         cX = cUp;
-         cX.CrossProduct(cZ);
-         cX.Normalize();
-         cY = cZ;
-         cY.CrossProduct(cX);
-         /* calculate frustum coordinates */
-         cNearCenter = cCameraLocation - cZ * s_sensor.Range.GetMin();
-         cFarCenter = cCameraLocation - cZ * s_sensor.Range.GetMax();
-         cNearTopLeft = cNearCenter + (cY * s_sensor.NearPlaneHeight) - (cX * s_sensor.NearPlaneWidth);
-         cNearTopRight = cNearCenter + (cY * s_sensor.NearPlaneHeight) + (cX * s_sensor.NearPlaneWidth);
-         cNearBottomLeft = cNearCenter - (cY * s_sensor.NearPlaneHeight) - (cX * s_sensor.NearPlaneWidth);
-         cNearBottomRight = cNearCenter - (cY * s_sensor.NearPlaneHeight) + (cX * s_sensor.NearPlaneWidth);
-         cFarTopLeft = cFarCenter + (cY * s_sensor.FarPlaneHeight) - (cX * s_sensor.FarPlaneWidth);
-         cFarTopRight = cFarCenter + (cY * s_sensor.FarPlaneHeight) + (cX * s_sensor.FarPlaneWidth);
-         cFarBottomLeft = cFarCenter - (cY * s_sensor.FarPlaneHeight) - (cX * s_sensor.FarPlaneWidth);
-         cFarBottomRight = cFarCenter - (cY * s_sensor.FarPlaneHeight) + (cX * s_sensor.FarPlaneWidth);
-         /* show frustum if enabled by adding outline to the checked rays vector */
-         if(m_bShowFrustum) {
-            vecCheckedRays.emplace_back(false, CRay3(cNearTopLeft, cNearTopRight));
-            vecCheckedRays.emplace_back(false, CRay3(cNearTopRight, cNearBottomRight));
-            vecCheckedRays.emplace_back(false, CRay3(cNearBottomRight, cNearBottomLeft));
-            vecCheckedRays.emplace_back(false, CRay3(cNearBottomLeft, cNearTopLeft));
-            vecCheckedRays.emplace_back(false, CRay3(cFarTopLeft, cFarTopRight));
-            vecCheckedRays.emplace_back(false, CRay3(cFarTopRight, cFarBottomRight));
-            vecCheckedRays.emplace_back(false, CRay3(cFarBottomRight, cFarBottomLeft));
-            vecCheckedRays.emplace_back(false, CRay3(cFarBottomLeft, cFarTopLeft));
-            vecCheckedRays.emplace_back(false, CRay3(cNearTopLeft, cFarTopLeft));
-            vecCheckedRays.emplace_back(false, CRay3(cNearTopRight, cFarTopRight));
-            vecCheckedRays.emplace_back(false, CRay3(cNearBottomRight, cFarBottomRight));
-            vecCheckedRays.emplace_back(false, CRay3(cNearBottomLeft, cFarBottomLeft));
+         UpdateView(s_sensor, vecCheckedRays);
+      }
+      /* the candidate targets are looked up once, in the box containing all the frusta */
+      if(m_bSharedVisibility) {
+         CVector3 cMinCorner(m_vecSensors.front().BoundingBoxMinCorner);
+         CVector3 cMaxCorner(m_vecSensors.front().BoundingBoxMaxCorner);
+         for(const SSensor& s_sensor : m_vecSensors) {
+            cMinCorner.SetX(Min(cMinCorner.GetX(), s_sensor.BoundingBoxMinCorner.GetX()));
+            cMinCorner.SetY(Min(cMinCorner.GetY(), s_sensor.BoundingBoxMinCorner.GetY()));
+            cMinCorner.SetZ(Min(cMinCorner.GetZ(), s_sensor.BoundingBoxMinCorner.GetZ()));
+            cMaxCorner.SetX(Max(cMaxCorner.GetX(), s_sensor.BoundingBoxMaxCorner.GetX()));
+            cMaxCorner.SetY(Max(cMaxCorner.GetY(), s_sensor.BoundingBoxMaxCorner.GetY()));
+            cMaxCorner.SetZ(Max(cMaxCorner.GetZ(), s_sensor.BoundingBoxMaxCorner.GetZ()));
          }
-         //std::cerr << cFarBottomRight.GetZ() << "\t" << cFarBottomLeft.GetZ() << std::endl; TODO
-         /* generate a bounding box for the frustum */
-         cBoundingBoxMinCorner = cNearCenter;
-         cBoundingBoxMaxCorner = cNearCenter;
-         for(const CVector3& c_point : {
-               cNearTopLeft, cNearTopRight, cNearBottomLeft, cNearBottomRight, 
-               cFarTopLeft, cFarTopRight, cFarBottomLeft, cFarBottomRight
-            }) {
-            if(c_point.GetX() > cBoundingBoxMaxCorner.GetX()) {
-               cBoundingBoxMaxCorner.SetX(c_point.GetX());
-            }
-            if(c_point.GetX() < cBoundingBoxMinCorner.GetX()) {
-               cBoundingBoxMinCorner.SetX(c_point.GetX());
-            }
-            if(c_point.GetY() > cBoundingBoxMaxCorner.GetY()) {
-               cBoundingBoxMaxCorner.SetY(c_point.GetY());
-            }
-            if(c_point.GetY() < cBoundingBoxMinCorner.GetY()) {
-               cBoundingBoxMinCorner.SetY(c_point.GetY());
-            }
-            if(c_point.GetZ() > cBoundingBoxMaxCorner.GetZ()) {
-               cBoundingBoxMaxCorner.SetZ(c_point.GetZ());
-            }
-            if(c_point.GetZ() < cBoundingBoxMinCorner.GetZ()) {
-               cBoundingBoxMinCorner.SetZ(c_point.GetZ());
-            }
+         cMaxCorner *= 0.5;
+         cMinCorner *= 0.5;
+         m_cVisibilityPass.BeginUpdate(cMaxCorner + cMinCorner,
+                                       cMaxCorner - cMinCorner);
+      }
+      /* for each camera sensor */
+      CVector3 cBoundingBoxPosition, cBoundingBoxHalfExtents;
+      for(SSensor& s_sensor : m_vecSensors) {
+         cBoundingBoxPosition = s_sensor.BoundingBoxMaxCorner * 0.5 + s_sensor.BoundingBoxMinCorner * 0.5;
+         cBoundingBoxHalfExtents = s_sensor.BoundingBoxMaxCorner * 0.5 - s_sensor.BoundingBoxMinCorner * 0.5;
+         if(m_bSharedVisibility) {
+            m_cVisibilityPass.BeginCamera();
          }
-         cBoundingBoxMaxCorner *= 0.5;
-         cBoundingBoxMinCorner *= 0.5;
-         cBoundingBoxPosition = (cBoundingBoxMaxCorner + cBoundingBoxMinCorner);
-         cBoundingBoxHalfExtents = (cBoundingBoxMaxCorner - cBoundingBoxMinCorner);
-         /* generate frustum planes */
-         arrFrustumPlanes[0].SetFromThreePoints(cNearTopRight, cNearTopLeft, cFarTopLeft);
-         arrFrustumPlanes[1].SetFromThreePoints(cNearBottomLeft, cNearBottomRight, cFarBottomRight);
-         arrFrustumPlanes[2].SetFromThreePoints(cNearTopLeft, cNearBottomLeft, cFarBottomLeft);
-         arrFrustumPlanes[3].SetFromThreePoints(cNearBottomRight, cNearTopRight, cFarBottomRight);
-         arrFrustumPlanes[4].SetFromThreePoints(cNearTopLeft, cNearTopRight, cNearBottomRight);
-         arrFrustumPlanes[5].SetFromThreePoints(cFarTopRight, cFarTopLeft, cFarBottomLeft);
          /* execute each algorithm */
          for(CCameraSensorSimulatedAlgorithm* pc_algorithm : s_sensor.Algorithms) {
             pc_algorithm->Update(s_sensor.ProjectionMatrix,
-                                 arrFrustumPlanes,
-                                 cCameraToWorldTransform,
-                                 cCameraLocation,
+                                 s_sensor.FrustumPlanes,
+                                 s_sensor.CameraToWorldTransform,
+                                 s_sensor.CameraLocation,
                                  cBoundingBoxPosition,
                                  cBoundingBoxHalfExtents);
             /* transfer any rays to the controllable entity for rendering */
@@ -241,6 +186,99 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CCameraDefaultSensor::UpdateView(SSensor& s_sensor,
+                                         std::vector<std::pair<bool, CRay3> >& vec_checked_rays) {
+      CTransformationMatrix3 cWorldToAnchorTransform;
+      CTransformationMatrix3 cWorldToCameraTransform;
+      CVector3 cLookAt, cUp;
+      CVector3 cX, cY, cZ;
+      CVector3 cNearCenter, cNearTopLeft, cNearTopRight, cNearBottomLeft, cNearBottomRight;
+      CVector3 cFarCenter, cFarTopLeft, cFarTopRight, cFarBottomLeft, cFarBottomRight;
+      /* calculate transform matrices */
+      cWorldToAnchorTransform.SetFromComponents(s_sensor.Anchor.Orientation, s_sensor.Anchor.Position);
+      cWorldToCameraTransform = cWorldToAnchorTransform * s_sensor.Offset;
+      s_sensor.CameraToWorldTransform = cWorldToCameraTransform.GetInverse();
+      /* calculate camera direction vectors */
+      const CVector3& cCameraLocation = s_sensor.CameraLocation =
+         cWorldToCameraTransform.GetTranslationVector();
+      cLookAt = cWorldToCameraTransform * CVector3::Z;
+      cUp = CVector3(0,-1,0); // -Y
+      cUp.Rotate(cWorldToCameraTransform.GetRotationMatrix());
+      /* calculate direction vectors */
+      cZ = cCameraLocation - cLookAt;
+      cZ.Normalize();
+      cX = cUp;
+      cX.CrossProduct(cZ);
+      cX.Normalize();
+      cY = cZ;
+      cY.CrossProduct(cX);
+      /* calculate frustum coordinates */
+      cNearCenter = cCameraLocation - cZ * s_sensor.Range.GetMin();
+      cFarCenter = cCameraLocation - cZ * s_sensor.Range.GetMax();
+      cNearTopLeft = cNearCenter + (cY * s_sensor.NearPlaneHeight) - (cX * s_sensor.NearPlaneWidth);
+      cNearTopRight = cNearCenter + (cY * s_sensor.NearPlaneHeight) + (cX * s_sensor.NearPlaneWidth);
+      cNearBottomLeft = cNearCenter - (cY * s_sensor.NearPlaneHeight) - (cX * s_sensor.NearPlaneWidth);
+      cNearBottomRight = cNearCenter - (cY * s_sensor.NearPlaneHeight) + (cX * s_sensor.NearPlaneWidth);
+      cFarTopLeft = cFarCenter + (cY * s_sensor.FarPlaneHeight) - (cX * s_sensor.FarPlaneWidth);
+      cFarTopRight = cFarCenter + (cY * s_sensor.FarPlaneHeight) + (cX * s_sensor.FarPlaneWidth);
+      cFarBottomLeft = cFarCenter - (cY * s_sensor.FarPlaneHeight) - (cX * s_sensor.FarPlaneWidth);
+      cFarBottomRight = cFarCenter - (cY * s_sensor.FarPlaneHeight) + (cX * s_sensor.FarPlaneWidth);
+      /* show frustum if enabled by adding outline to the checked rays vector */
+      if(m_bShowFrustum) {
+         vec_checked_rays.emplace_back(false, CRay3(cNearTopLeft, cNearTopRight));
+         vec_checked_rays.emplace_back(false, CRay3(cNearTopRight, cNearBottomRight));
+         vec_checked_rays.emplace_back(false, CRay3(cNearBottomRight, cNearBottomLeft));
+         vec_checked_rays.emplace_back(false, CRay3(cNearBottomLeft, cNearTopLeft));
+         vec_checked_rays.emplace_back(false, CRay3(cFarTopLeft, cFarTopRight));
+         vec_checked_rays.emplace_back(false, CRay3(cFarTopRight, cFarBottomRight));
+         vec_checked_rays.emplace_back(false, CRay3(cFarBottomRight, cFarBottomLeft));
+         vec_checked_rays.emplace_back(false, CRay3(cFarBottomLeft, cFarTopLeft));
+         vec_checked_rays.emplace_back(false, CRay3(cNearTopLeft, cFarTopLeft));
+         vec_checked_rays.emplace_back(false, CRay3(cNearTopRight, cFarTopRight));
+         vec_checked_rays.emplace_back(false, CRay3(cNearBottomRight, cFarBottomRight));
+         vec_checked_rays.emplace_back(false, CRay3(cNearBottomLeft, cFarBottomLeft));
+      }
+      /* generate a bounding box for the frustum */
+      CVector3& cBoundingBoxMinCorner = s_sensor.BoundingBoxMinCorner;
+      CVector3& cBoundingBoxMaxCorner = s_sensor.BoundingBoxMaxCorner;
+      cBoundingBoxMinCorner = cNearCenter;
+      cBoundingBoxMaxCorner = cNearCenter;
+      for(const CVector3& c_point : {
+            cNearTopLeft, cNearTopRight, cNearBottomLeft, cNearBottomRight, 
+            cFarTopLeft, cFarTopRight, cFarBottomLeft, cFarBottomRight
+         }) {
+         if(c_point.GetX() > cBoundingBoxMaxCorner.GetX()) {
+            cBoundingBoxMaxCorner.SetX(c_point.GetX());
+         }
+         if(c_point.GetX() < cBoundingBoxMinCorner.GetX()) {
+            cBoundingBoxMinCorner.SetX(c_point.GetX());
+         }
+         if(c_point.GetY() > cBoundingBoxMaxCorner.GetY()) {
+            cBoundingBoxMaxCorner.SetY(c_point.GetY());
+         }
+         if(c_point.GetY() < cBoundingBoxMinCorner.GetY()) {
+            cBoundingBoxMinCorner.SetY(c_point.GetY());
+         }
+         if(c_point.GetZ() > cBoundingBoxMaxCorner.GetZ()) {
+            cBoundingBoxMaxCorner.SetZ(c_point.GetZ());
+         }
+         if(c_point.GetZ() < cBoundingBoxMinCorner.GetZ()) {
+            cBoundingBoxMinCorner.SetZ(c_point.GetZ());
+         }
+      }
+      /* generate frustum planes */
+      std::array<CPlane, 6>& arrFrustumPlanes = s_sensor.FrustumPlanes;
+      arrFrustumPlanes[0].SetFromThreePoints(cNearTopRight, cNearTopLeft, cFarTopLeft);
+      arrFrustumPlanes[1].SetFromThreePoints(cNearBottomLeft, cNearBottomRight, cFarBottomRight);
+      arrFrustumPlanes[2].SetFromThreePoints(cNearTopLeft, cNearBottomLeft, cFarBottomLeft);
+      arrFrustumPlanes[3].SetFromThreePoints(cNearBottomRight, cNearTopRight, cFarBottomRight);
+      arrFrustumPlanes[4].SetFromThreePoints(cNearTopLeft, cNearTopRight, cNearBottomRight);
+      arrFrustumPlanes[5].SetFromThreePoints(cFarTopRight, cFarTopLeft, cFarBottomLeft);
+   }
+
+   /****************************************/
+   /****************************************/
+
    REGISTER_SENSOR(CCameraDefaultSensor,
                    "cameras", "default",
                    "Michael Allwright [allsey87@gmail.com]",
@@ -291,6 +329,12 @@ namespace argos {
                    "    ...\n"
                    "  </controllers>\n\n"
 
+                   "By default, the cameras of a robot share their work: the positional indices\n"
+                   "are queried once over the box containing all the frusta, and the occlusion\n"
+                   "rays cast from a camera are shared among its algorithms. The readings are\n"
+                   "the same as when each camera works alone, which can be restored by setting\n"
+                   "the attribute \"shared_visibility\" to false.\n\n"
+
                    "To add a camera to the plugin, create a camera node as shown in the following\n"
                    "example. A camera is defined by its range (how close and how far the camera\n"
                    "can see), its anchor and its position and orientation offsets from that\n"
@@ -17,6 +17,7 @@ namespace argos {
 #include <argos3/core/simulator/sensor.h>
 #include <argos3/plugins/robots/generic/control_interface/ci_camera_sensor.h>
 #include <argos3/plugins/robots/generic/simulator/camera_sensor_algorithm.h>
+#include <argos3/plugins/robots/generic/simulator/camera_sensor_visibility_pass.h>
 
 namespace argos {
 
@@ -32,6 +33,11 @@ namespace argos {
          std::vector<CCameraSensorSimulatedAlgorithm*> Algorithms;
          Real NearPlaneWidth, NearPlaneHeight;
          Real FarPlaneWidth, FarPlaneHeight;
+         /* view of the camera, computed at each update */
+         CTransformationMatrix3 CameraToWorldTransform;
+         CVector3 CameraLocation;
+         std::array<CPlane, 6> FrustumPlanes;
+         CVector3 BoundingBoxMinCorner, BoundingBoxMaxCorner;
          /* constructor */
          SSensor(SAnchor& s_anchor,
                  const CTransformationMatrix3& c_offset,
@@ -65,11 +71,21 @@ namespace argos {
 
       virtual void Update();
 
+   protected:
+
+      /**
+       * Computes the transforms, the frustum and its bounding box for a camera.
+       */
+      void UpdateView(SSensor& s_sensor,
+                      std::vector<std::pair<bool, CRay3> >& vec_checked_rays);
+
    protected:
       bool m_bShowFrustum;
+      bool m_bSharedVisibility;
       CEmbodiedEntity* m_pcEmbodiedEntity;
       CControllableEntity* m_pcControllableEntity;
       std::vector<SSensor> m_vecSensors;
+      CCameraSensorVisibilityPass m_cVisibilityPass;
    };
 }
 
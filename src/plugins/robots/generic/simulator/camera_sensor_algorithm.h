@@ -16,6 +16,7 @@ namespace argos {
 #include <argos3/core/utility/math/plane.h>
 #include <argos3/core/utility/math/matrix/transformationmatrix3.h>
 #include <argos3/core/simulator/entity/positional_entity.h>
+#include <argos3/plugins/robots/generic/simulator/camera_sensor_visibility_pass.h>
 #include <array>
 
 namespace argos {
@@ -81,6 +82,9 @@ namespace argos {
 
    public:
 
+      CCameraSensorSimulatedAlgorithm() :
+         m_pcVisibilityPass(nullptr) {}
+
       virtual ~CCameraSensorSimulatedAlgorithm() {}
 
       virtual void Update(const CSquareMatrix<3>& c_projection_matrix,
@@ -93,11 +97,55 @@ namespace argos {
       const std::vector<std::pair<bool, CRay3> >& GetCheckedRays() const {
          return m_vecCheckedRays;
       }
+
+      /**
+       * Sets the visibility pass shared with the other cameras and algorithms of the robot.
+       * @param pc_visibility_pass The visibility pass, or <tt>nullptr</tt> to work alone.
+       */
+      void SetVisibilityPass(CCameraSensorVisibilityPass* pc_visibility_pass) {
+         m_pcVisibilityPass = pc_visibility_pass;
+      }
+
+      /**
+       * Applies an operation to the entities of an index that lie in a box.
+       * With a visibility pass, the entities come from the box containing
+       * the frusta of all the cameras, so the operation must discard the
+       * entities outside of the frustum of its camera.
+       */
+      template<class ENTITY>
+      void ForEntitiesInView(CPositionalIndex<ENTITY>& c_index,
+                             const CVector3& c_bounding_box_position,
+                             const CVector3& c_bounding_box_half_extents,
+                             typename CPositionalIndex<ENTITY>::COperation& c_operation) {
+         if(m_pcVisibilityPass != nullptr) {
+            m_pcVisibilityPass->ForCandidates(c_index, c_operation);
+         }
+         else {
+            c_index.ForEntitiesInBoxRange(c_bounding_box_position,
+                                          c_bounding_box_half_extents,
+                                          c_operation);
+         }
+      }
+
+      /**
+       * Checks whether a ray cast from the camera is occluded.
+       * With a visibility pass, the result is shared with the other
+       * algorithms of the same camera.
+       */
+      bool IsOccluded(SEmbodiedEntityIntersectionItem& s_item,
+                      const CRay3& c_ray) {
+         if(m_pcVisibilityPass != nullptr) {
+            return m_pcVisibilityPass->GetClosestEmbodiedEntityIntersected(s_item, c_ray);
+         }
+         return GetClosestEmbodiedEntityIntersectedByRay(s_item, c_ray);
+      }
       
    protected:
 
       std::vector<std::pair<bool, CRay3> > m_vecCheckedRays;
 
+      CCameraSensorVisibilityPass* m_pcVisibilityPass;
+
    };   
 }
 
@@ -59,9 +59,10 @@ namespace argos {
       /* Clear out checked rays from last update */
       m_vecCheckedRays.clear();
       /* Run the operation */
-      m_pcLEDIndex->ForEntitiesInBoxRange(c_bounding_box_position,
-                                          c_bounding_box_half_extents,
-                                          cUpdateOperation);
+      ForEntitiesInView(*m_pcLEDIndex,
+                        c_bounding_box_position,
+                        c_bounding_box_half_extents,
+                        cUpdateOperation);
    }
 
    /****************************************/
@@ -63,7 +63,7 @@ namespace argos {
                return true;
             }
             m_cOcclusionCheckRay.SetEnd(cLedPosition);
-            if(GetClosestEmbodiedEntityIntersectedByRay(m_sIntersectionItem, m_cOcclusionCheckRay)) {
+            if(m_cAlgorithm.IsOccluded(m_sIntersectionItem, m_cOcclusionCheckRay)) {
                m_cAlgorithm.AddCheckedRay(true, m_cOcclusionCheckRay);
                return true;
             }
@@ -35,6 +35,8 @@ namespace argos {
          std::string strMedium;
          GetNodeAttribute(t_tree, "medium", strMedium);
          m_pcLEDIndex = &(CSimulator::GetInstance().GetMedium<CLEDMedium>(strMedium).GetIndex());
+         /* Temporal coherence of the occlusion checks */
+         m_cOcclusionCache.Init(t_tree);
       }
       catch(CARGoSException& ex) {
          THROW_ARGOSEXCEPTION_NESTED("Error initializing the LED detector algorithm", ex);
@@ -59,9 +61,11 @@ namespace argos {
       /* Clear out checked rays from last update */
       m_vecCheckedRays.clear();
       /* Run the operation */
-      m_pcLEDIndex->ForEntitiesInBoxRange(c_bounding_box_position,
-                                          c_bounding_box_half_extents,
-                                          cUpdateOperation);
+      m_cOcclusionCache.BeginUpdate();
+      ForEntitiesInView(*m_pcLEDIndex,
+                        c_bounding_box_position,
+                        c_bounding_box_half_extents,
+                        cUpdateOperation);
    }
 
    /****************************************/
@@ -74,6 +78,11 @@ namespace argos {
                                     "This algorithm detects nearby LEDs seen by the camera and\n"
                                     "returns the X and Y coordinates on the sensor",
                                     "This algorithm detects nearby LEDs seen by the camera and\n"
-                                    "returns the X and Y coordinates on the sensor",
+                                    "returns the X and Y coordinates on the sensor.\n"
+                                    "With coherence=\"true\", the occlusion check of an LED is reused while\n"
+                                    "neither the LED nor the camera moves more than 'coherence_tolerance' (default 0)\n"
+                                    "meters. An occluded LED stays occluded while its occluder\n"
+                                    "does not move; a visible LED is checked again after 'coherence_max_age'\n"
+                                    "(default 0) updates",
                                     "Under development");  
 }
@@ -18,6 +18,7 @@ namespace argos {
 
 #include <argos3/plugins/simulator/entities/led_entity.h>
 #include <argos3/plugins/robots/generic/simulator/camera_sensor_algorithm.h>
+#include <argos3/plugins/robots/generic/simulator/camera_sensor_occlusion_cache.h>
 #include <argos3/plugins/robots/generic/control_interface/ci_camera_sensor_algorithms/ci_camera_sensor_led_detector_algorithm.h>
 
 namespace argos {
@@ -60,10 +61,24 @@ namespace argos {
                return true;
             }
             m_cOcclusionCheckRay.SetEnd(cLedPosition);
-            if(GetClosestEmbodiedEntityIntersectedByRay(m_sIntersectionItem, m_cOcclusionCheckRay)) {
+            /* reuse the last occlusion check if neither the LED nor the camera moved */
+            CCameraSensorOcclusionCache& cCache = m_cAlgorithm.GetOcclusionCache();
+            m_arrLEDPosition[0] = cLedPosition;
+            bool bOccluded = false;
+            if(cCache.Lookup(c_led, m_cCameraLocation, m_arrLEDPosition, 1, bOccluded)) {
+               if(bOccluded) {
+                  m_cAlgorithm.AddCheckedRay(true, m_cOcclusionCheckRay);
+                  return true;
+               }
+            }
+            else if(m_cAlgorithm.IsOccluded(m_sIntersectionItem, m_cOcclusionCheckRay)) {
                m_cAlgorithm.AddCheckedRay(true, m_cOcclusionCheckRay);
+               cCache.Store(c_led, m_cCameraLocation, m_arrLEDPosition, 1, m_sIntersectionItem.IntersectedEntity);
                return true;
             }
+            else {
+               cCache.Store(c_led, m_cCameraLocation, m_arrLEDPosition, 1, nullptr);
+            }
             m_cAlgorithm.AddCheckedRay(false, m_cOcclusionCheckRay);
             m_cAlgorithm.AddReading(c_led.GetColor(), ProjectOntoSensor(cLedPosition));
             return true;
@@ -71,6 +86,7 @@ namespace argos {
 
       private:
          CRay3 m_cOcclusionCheckRay;
+         CCameraSensorOcclusionCache::TPoints m_arrLEDPosition;
          SEmbodiedEntityIntersectionItem m_sIntersectionItem;
          CCameraSensorLEDDetectorAlgorithm& m_cAlgorithm;
       };
@@ -100,6 +116,10 @@ namespace argos {
          m_vecReadings.emplace_back(c_color, c_center);
       }
 
+      CCameraSensorOcclusionCache& GetOcclusionCache() {
+         return m_cOcclusionCache;
+      }
+
       /**
        * Returns true if the rays must be shown in the GUI.
        * @return true if the rays must be shown in the GUI.
@@ -119,6 +139,7 @@ namespace argos {
    private:
       bool                           m_bShowRays;
       CPositionalIndex<CLEDEntity>*  m_pcLEDIndex;
+      CCameraSensorOcclusionCache    m_cOcclusionCache;
    };
 }         
 
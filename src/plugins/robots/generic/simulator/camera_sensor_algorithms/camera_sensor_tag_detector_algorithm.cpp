@@ -20,7 +20,8 @@ namespace argos {
 
    CCameraSensorTagDetectorAlgorithm::CCameraSensorTagDetectorAlgorithm() :
       m_bShowRays(false),
-      m_pcTagIndex(nullptr) {}
+      m_pcTagIndex(nullptr),
+      m_unNumReadings(0) {}
 
    /****************************************/
    /****************************************/   
@@ -35,6 +36,8 @@ namespace argos {
          std::string strMedium;
          GetNodeAttribute(t_tree, "medium", strMedium);
          m_pcTagIndex = &(CSimulator::GetInstance().GetMedium<CTagMedium>(strMedium).GetIndex());
+         /* Temporal coherence of the occlusion checks */
+         m_cOcclusionCache.Init(t_tree);
       }
       catch(CARGoSException& ex) {
          THROW_ARGOSEXCEPTION_NESTED("Error initializing the tag detector algorithm", ex);
@@ -54,14 +57,18 @@ namespace argos {
       CUpdateOperation cUpdateOperation(c_projection_matrix, arr_frustum_planes,
                                         c_camera_to_world_transform, c_camera_location,
                                         *this);
-      /* Clear out readings from last update */
-      m_vecReadings.clear();
+      /* Overwrite the readings from last update, keeping their memory */
+      m_unNumReadings = 0;
       /* Clear out checked rays from last update */
       m_vecCheckedRays.clear();
       /* Run the operation */
-      m_pcTagIndex->ForEntitiesInBoxRange(c_bounding_box_position,
-                                          c_bounding_box_half_extents,
-                                          cUpdateOperation);
+      m_cOcclusionCache.BeginUpdate();
+      ForEntitiesInView(*m_pcTagIndex,
+                        c_bounding_box_position,
+                        c_bounding_box_half_extents,
+                        cUpdateOperation);
+      /* Drop the readings left over from last update */
+      m_vecReadings.erase(m_vecReadings.begin() + m_unNumReadings, m_vecReadings.end());
    }
 
    /****************************************/
@@ -74,6 +81,11 @@ namespace argos {
                                     "This algorithm detects nearby tags seen by the camera and\n"
                                     "returns the coordinates of their corners to the sensor",
                                     "This algorithm detects nearby tags seen by the camera and\n"
-                                    "returns the coordinates of their corners to the sensor",
+                                    "returns the coordinates of their corners to the sensor.\n"
+                                    "With coherence=\"true\", the occlusion checks of a tag are reused while\n"
+                                    "neither the tag nor the camera moves more than 'coherence_tolerance' (default 0)\n"
+                                    "meters. An occluded tag stays occluded while its occluder\n"
+                                    "does not move; a visible tag is checked again after 'coherence_max_age'\n"
+                                    "(default 0) updates",
                                     "Under development");
 }
@@ -18,6 +18,7 @@ namespace argos {
 
 #include <argos3/plugins/simulator/entities/tag_entity.h>
 #include <argos3/plugins/robots/generic/simulator/camera_sensor_algorithm.h>
+#include <argos3/plugins/robots/generic/simulator/camera_sensor_occlusion_cache.h>
 #include <argos3/plugins/robots/generic/control_interface/ci_camera_sensor_algorithms/ci_camera_sensor_tag_detector_algorithm.h>
 
 namespace argos {
@@ -69,17 +70,37 @@ namespace argos {
                   return true;
                }
             }
-            for(const CVector3& c_corner : m_arrTagCorners) {
-               m_cOcclusionCheckRay.SetEnd(c_corner);
-               if(GetClosestEmbodiedEntityIntersectedByRay(m_sIntersectionItem, m_cOcclusionCheckRay)) {
-                  /* corner is occluded */
+            /* reuse the last occlusion check if neither the tag nor the camera moved */
+            CCameraSensorOcclusionCache& cCache = m_cAlgorithm.GetOcclusionCache();
+            bool bOccluded = false;
+            if(cCache.Lookup(c_tag, m_cCameraLocation, m_arrTagCorners, m_arrTagCorners.size(), bOccluded)) {
+               if(bOccluded) {
+                  /* the cache does not record which corner is occluded, show the first one */
+                  m_cOcclusionCheckRay.SetEnd(m_arrTagCorners[0]);
                   m_cAlgorithm.AddCheckedRay(true, m_cOcclusionCheckRay);
                   return true;
                }
-               else {
+               for(const CVector3& c_corner : m_arrTagCorners) {
+                  m_cOcclusionCheckRay.SetEnd(c_corner);
                   m_cAlgorithm.AddCheckedRay(false, m_cOcclusionCheckRay);
                }
             }
+            else {
+               for(const CVector3& c_corner : m_arrTagCorners) {
+                  m_cOcclusionCheckRay.SetEnd(c_corner);
+                  if(m_cAlgorithm.IsOccluded(m_sIntersectionItem, m_cOcclusionCheckRay)) {
+                     /* corner is occluded */
+                     m_cAlgorithm.AddCheckedRay(true, m_cOcclusionCheckRay);
+                     cCache.Store(c_tag, m_cCameraLocation, m_arrTagCorners, m_arrTagCorners.size(),
+                                  m_sIntersectionItem.IntersectedEntity);
+                     return true;
+                  }
+                  else {
+                     m_cAlgorithm.AddCheckedRay(false, m_cOcclusionCheckRay);
+                  }
+               }
+               cCache.Store(c_tag, m_cCameraLocation, m_arrTagCorners, m_arrTagCorners.size(), nullptr);
+            }
             std::transform(std::begin(m_arrTagCorners),
                            std::end(m_arrTagCorners),
                            std::begin(m_arrTagCornerPixels),
@@ -100,7 +121,7 @@ namespace argos {
             { 0.5,  0.5, 0},
             { 0.5, -0.5, 0},
          }};
-         std::array<CVector3, 4> m_arrTagCorners;
+         CCameraSensorOcclusionCache::TPoints m_arrTagCorners;
          std::array<CVector2, 4> m_arrTagCornerPixels;
          CRay3 m_cOcclusionCheckRay;
          SEmbodiedEntityIntersectionItem m_sIntersectionItem;
@@ -131,7 +152,21 @@ namespace argos {
       void AddReading(const std::string& str_payload,
                       const CVector2& c_center_pixel,
                       const std::array<CVector2, 4>& arr_corner_pixels) {
-         m_vecReadings.emplace_back(str_payload, c_center_pixel, arr_corner_pixels);
+         if(m_unNumReadings < m_vecReadings.size()) {
+            /* reuse the reading of the last update, and the memory of its payload */
+            SReading& sReading = m_vecReadings[m_unNumReadings];
+            sReading.Payload = str_payload;
+            sReading.Center = c_center_pixel;
+            sReading.Corners = arr_corner_pixels;
+         }
+         else {
+            m_vecReadings.emplace_back(str_payload, c_center_pixel, arr_corner_pixels);
+         }
+         ++m_unNumReadings;
+      }
+
+      CCameraSensorOcclusionCache& GetOcclusionCache() {
+         return m_cOcclusionCache;
       }
 
       /**
@@ -153,6 +188,8 @@ namespace argos {
    private:
       bool                           m_bShowRays;
       CPositionalIndex<CTagEntity>*  m_pcTagIndex;
+      size_t                         m_unNumReadings;
+      CCameraSensorOcclusionCache    m_cOcclusionCache;
    };
 }         
 
@@ -0,0 +1,156 @@
+/**
+ * @file <argos3/plugins/robots/generic/simulator/camera_sensor_occlusion_cache.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "camera_sensor_occlusion_cache.h"
+
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/entity/embodied_entity.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   CCameraSensorOcclusionCache::CCameraSensorOcclusionCache() :
+      m_bEnabled(false),
+      m_fSquareTolerance(0.0f),
+      m_unMaxAge(0),
+      m_unUpdate(0),
+      m_cSpace(CSimulator::GetInstance().GetSpace()) {}
+
+   /****************************************/
+   /****************************************/
+
+   void CCameraSensorOcclusionCache::Init(TConfigurationNode& t_tree) {
+      GetNodeAttributeOrDefault(t_tree, "coherence", m_bEnabled, m_bEnabled);
+      Real fTolerance = 0.0f;
+      GetNodeAttributeOrDefault(t_tree, "coherence_tolerance", fTolerance, fTolerance);
+      if(fTolerance < 0.0f) {
+         THROW_ARGOSEXCEPTION("Can't specify a negative value for the coherence tolerance");
+      }
+      m_fSquareTolerance = fTolerance * fTolerance;
+      GetNodeAttributeOrDefault(t_tree, "coherence_max_age", m_unMaxAge, m_unMaxAge);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CCameraSensorOcclusionCache::BeginUpdate() {
+      if(!m_bEnabled) return;
+      /* Discard the targets that left the camera view, or the space */
+      for(TEntries::iterator it = m_tEntries.begin(); it != m_tEntries.end();) {
+         if(it->second.SeenAt != m_unUpdate) {
+            it = m_tEntries.erase(it);
+         }
+         else {
+            ++it;
+         }
+      }
+      ++m_unUpdate;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CCameraSensorOcclusionCache::GetHandle(const CEntity& c_target,
+                                               CSpace::SEntityHandle& s_handle) const {
+      try {
+         s_handle = m_cSpace.GetEntityHandle(c_target);
+         return true;
+      }
+      catch(CARGoSException&) {
+         return false;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CCameraSensorOcclusionCache::Lookup(const CEntity& c_target,
+                                            const CVector3& c_camera_location,
+                                            const TPoints& t_points,
+                                            size_t un_num_points,
+                                            bool& b_occluded) {
+      if(!m_bEnabled) return false;
+      CSpace::SEntityHandle sHandle;
+      if(!GetHandle(c_target, sHandle)) return false;
+      TEntries::iterator it = m_tEntries.find(sHandle);
+      if(it == m_tEntries.end()) return false;
+      SEntry& sEntry = it->second;
+      sEntry.SeenAt = m_unUpdate;
+      /* The rays must not have moved: check both of their ends */
+      if(SquareDistance(sEntry.CameraLocation, c_camera_location) > m_fSquareTolerance) {
+         return false;
+      }
+      for(size_t i = 0; i < un_num_points; ++i) {
+         if(SquareDistance(sEntry.Points[i], t_points[i]) > m_fSquareTolerance) {
+            return false;
+         }
+      }
+      if(sEntry.Occluded) {
+         /* The occluder must still be in the space, where it was */
+         if(sEntry.Occluder == NULL ||
+            m_cSpace.GetEntity(sEntry.OccluderHandle) != sEntry.Occluder) {
+            return false;
+         }
+         const SBoundingBox& sBox = sEntry.Occluder->GetBoundingBox();
+         if(sBox.MinCorner != sEntry.OccluderBox.MinCorner ||
+            sBox.MaxCorner != sEntry.OccluderBox.MaxCorner) {
+            return false;
+         }
+      }
+      else if(m_unUpdate - sEntry.CheckedAt > m_unMaxAge) {
+         return false;
+      }
+      b_occluded = sEntry.Occluded;
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CCameraSensorOcclusionCache::Store(const CEntity& c_target,
+                                           const CVector3& c_camera_location,
+                                           const TPoints& t_points,
+                                           size_t un_num_points,
+                                           CEmbodiedEntity* pc_occluder) {
+      if(!m_bEnabled) return;
+      CSpace::SEntityHandle sHandle;
+      if(!GetHandle(c_target, sHandle)) return;
+      SEntry& sEntry = m_tEntries[sHandle];
+      sEntry.CameraLocation = c_camera_location;
+      for(size_t i = 0; i < un_num_points; ++i) {
+         sEntry.Points[i] = t_points[i];
+      }
+      sEntry.CheckedAt = m_unUpdate;
+      sEntry.SeenAt = m_unUpdate;
+      sEntry.Occluded = (pc_occluder != NULL);
+      sEntry.Occluder = NULL;
+      sEntry.OccluderHandle = CSpace::SEntityHandle();
+      if(pc_occluder != NULL) {
+         /* Remember the occluder, to know when it moves or disappears;
+            without a handle, the occlusion can't be reused */
+         try {
+            sEntry.OccluderHandle = m_cSpace.GetEntityHandle(*pc_occluder);
+            sEntry.Occluder = pc_occluder;
+            sEntry.OccluderBox = pc_occluder->GetBoundingBox();
+         }
+         catch(CARGoSException&) {}
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CCameraSensorOcclusionCache::Clear() {
+      m_tEntries.clear();
+      m_unUpdate = 0;
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
@@ -0,0 +1,164 @@
+/**
+ * @file <argos3/plugins/robots/generic/simulator/camera_sensor_occlusion_cache.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef CAMERA_SENSOR_OCCLUSION_CACHE_H
+#define CAMERA_SENSOR_OCCLUSION_CACHE_H
+
+namespace argos {
+   class CCameraSensorOcclusionCache;
+   class CEmbodiedEntity;
+   class CEntity;
+}
+
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/simulator/physics_engine/physics_model.h>
+#include <argos3/core/utility/configuration/argos_configuration.h>
+#include <argos3/core/utility/math/vector3.h>
+#include <array>
+#include <unordered_map>
+
+namespace argos {
+
+   /**
+    * Keeps the occlusion checks of a camera sensor algorithm from one
+    * update to the next.
+    *
+    * An algorithm checks whether a target (a tag, an LED) is occluded by
+    * casting rays from the camera to a few points of the target. When
+    * neither the camera nor the points moved by more than a tolerance in
+    * the global frame, the rays are about the same as in the last check,
+    * and its result is reused as follows:
+    * - an occluded target stays occluded while the entity that occluded it
+    *   does not move, since other movements can only add occlusions;
+    * - a visible target is considered visible for a maximum number of
+    *   updates, after which its rays are cast again.
+    *
+    * The rays are compared in the global frame rather than in the camera
+    * frame: a camera and a target moving together keep the same relative
+    * position, but their rays sweep across the static entities.
+    *
+    * The cache is disabled by default, in which case every lookup fails.
+    * One instance must be used per camera algorithm, so the cache is keyed
+    * by (camera, target). Targets are identified by their handle in the
+    * space, so an entry is never reused by a new entity that happens to
+    * get the address or the index of a removed one.
+    */
+   class CCameraSensorOcclusionCache {
+
+   public:
+
+      /** The maximum number of points checked per target */
+      static const size_t MAX_POINTS = 4;
+
+      typedef std::array<CVector3, MAX_POINTS> TPoints;
+
+   public:
+
+      CCameraSensorOcclusionCache();
+
+      /**
+       * Parses the optional 'coherence', 'coherence_tolerance' and
+       * 'coherence_max_age' attributes of the algorithm.
+       * @param t_tree The XML configuration of the algorithm.
+       */
+      void Init(TConfigurationNode& t_tree);
+
+      /**
+       * Returns true if the cache is enabled.
+       */
+      inline bool IsEnabled() const {
+         return m_bEnabled;
+      }
+
+      /**
+       * Starts a new update.
+       * The entries of the targets that were not looked up during the
+       * last update are discarded.
+       */
+      void BeginUpdate();
+
+      /**
+       * Looks up the last occlusion check of a target.
+       * @param c_target The target.
+       * @param c_camera_location The position of the camera, in the global frame.
+       * @param t_points The points of the target, in the global frame.
+       * @param un_num_points The number of points.
+       * @param b_occluded Set to the cached result when found.
+       * @return <tt>true</tt> if the cached result can be reused.
+       */
+      bool Lookup(const CEntity& c_target,
+                  const CVector3& c_camera_location,
+                  const TPoints& t_points,
+                  size_t un_num_points,
+                  bool& b_occluded);
+
+      /**
+       * Stores the result of an occlusion check.
+       * Nothing is stored if the target is not in the space.
+       * @param c_target The target.
+       * @param c_camera_location The position of the camera, in the global frame.
+       * @param t_points The points of the target, in the global frame.
+       * @param un_num_points The number of points.
+       * @param pc_occluder The entity occluding the target, or <tt>NULL</tt> if the target is visible.
+       */
+      void Store(const CEntity& c_target,
+                 const CVector3& c_camera_location,
+                 const TPoints& t_points,
+                 size_t un_num_points,
+                 CEmbodiedEntity* pc_occluder);
+
+      /**
+       * Discards all the entries.
+       */
+      void Clear();
+
+   private:
+
+      bool GetHandle(const CEntity& c_target,
+                     CSpace::SEntityHandle& s_handle) const;
+
+   private:
+
+      struct SEntry {
+         /** The position of the camera, in the global frame */
+         CVector3 CameraLocation;
+         /** The points of the target, in the global frame */
+         TPoints Points;
+         /** The update in which the rays were cast */
+         UInt32 CheckedAt;
+         /** The last update in which the target was looked up */
+         UInt32 SeenAt;
+         /** Whether the target was occluded */
+         bool Occluded;
+         /** The entity that occluded the target, and its state at the time */
+         CEmbodiedEntity* Occluder;
+         CSpace::SEntityHandle OccluderHandle;
+         SBoundingBox OccluderBox;
+      };
+
+      struct SHandleHash {
+         size_t operator()(const CSpace::SEntityHandle& s_handle) const {
+            return std::hash<ssize_t>()(s_handle.Index) ^
+               (std::hash<UInt32>()(s_handle.Generation) << 1);
+         }
+      };
+
+      typedef std::unordered_map<CSpace::SEntityHandle, SEntry, SHandleHash> TEntries;
+
+   private:
+
+      bool m_bEnabled;
+      Real m_fSquareTolerance;
+      UInt32 m_unMaxAge;
+      UInt32 m_unUpdate;
+      TEntries m_tEntries;
+      CSpace& m_cSpace;
+
+   };
+
+}
+
+#endif
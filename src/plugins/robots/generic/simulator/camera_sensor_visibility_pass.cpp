@@ -0,0 +1,53 @@
+/**
+ * @file <argos3/plugins/robots/generic/simulator/camera_sensor_visibility_pass.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "camera_sensor_visibility_pass.h"
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   CCameraSensorVisibilityPass::CCameraSensorVisibilityPass() :
+      m_unUpdate(0) {}
+
+   /****************************************/
+   /****************************************/
+
+   void CCameraSensorVisibilityPass::BeginUpdate(const CVector3& c_position,
+                                                 const CVector3& c_half_extents) {
+      ++m_unUpdate;
+      m_cBoxPosition = c_position;
+      m_cBoxHalfExtents = c_half_extents;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CCameraSensorVisibilityPass::BeginCamera() {
+      m_mapOcclusions.clear();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CCameraSensorVisibilityPass::GetClosestEmbodiedEntityIntersected(SEmbodiedEntityIntersectionItem& s_item,
+                                                                         const CRay3& c_ray) {
+      std::unordered_map<CVector3, SOcclusion, SPointHash>::iterator it =
+         m_mapOcclusions.find(c_ray.GetEnd());
+      if(it == m_mapOcclusions.end()) {
+         SOcclusion sOcclusion;
+         sOcclusion.Occluded = GetClosestEmbodiedEntityIntersectedByRay(sOcclusion.Item, c_ray);
+         it = m_mapOcclusions.insert(std::make_pair(c_ray.GetEnd(), sOcclusion)).first;
+      }
+      s_item = it->second.Item;
+      return it->second.Occluded;
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
@@ -0,0 +1,150 @@
+/**
+ * @file <argos3/plugins/robots/generic/simulator/camera_sensor_visibility_pass.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef CAMERA_SENSOR_VISIBILITY_PASS_H
+#define CAMERA_SENSOR_VISIBILITY_PASS_H
+
+namespace argos {
+   class CCameraSensorVisibilityPass;
+   class CEntity;
+}
+
+#include <argos3/core/simulator/space/positional_indices/positional_index.h>
+#include <argos3/core/simulator/physics_engine/physics_engine.h>
+#include <argos3/core/utility/math/vector3.h>
+#include <argos3/core/utility/math/ray3.h>
+#include <unordered_map>
+#include <vector>
+
+namespace argos {
+
+   /**
+    * The visibility work shared by the cameras and algorithms of a robot.
+    *
+    * At each update, the camera sensor sets the box that contains the
+    * frusta of all its cameras. The first algorithm that looks for targets
+    * in a positional index queries the index once over this box; the other
+    * algorithms and cameras reuse the collected candidates, and each of
+    * them discards the candidates outside of its own frustum as before.
+    *
+    * Before running the algorithms of a camera, the sensor calls
+    * BeginCamera(). From then on, the occlusion rays cast from the camera
+    * are remembered by end point, so a target seen by several algorithms
+    * of that camera (e.g., an LED detected by the LED and directional LED
+    * detectors) is checked once.
+    */
+   class CCameraSensorVisibilityPass {
+
+   public:
+
+      CCameraSensorVisibilityPass();
+
+      /**
+       * Starts a new update.
+       * The candidates collected during the last update are discarded.
+       * @param c_position The center of the box containing all the frusta.
+       * @param c_half_extents The half extents of the box containing all the frusta.
+       */
+      void BeginUpdate(const CVector3& c_position,
+                       const CVector3& c_half_extents);
+
+      /**
+       * Starts running the algorithms of a camera.
+       * The occlusion rays remembered for the last camera are discarded.
+       */
+      void BeginCamera();
+
+      /**
+       * Applies an operation to the entities of an index that lie in the
+       * box containing all the frusta.
+       * The index is queried at the first call of each update.
+       * @param c_index The positional index.
+       * @param c_operation The operation; it can stop the iteration by returning <tt>false</tt>.
+       */
+      template<class ENTITY>
+      void ForCandidates(CPositionalIndex<ENTITY>& c_index,
+                         typename CPositionalIndex<ENTITY>::COperation& c_operation) {
+         SCandidates& sCandidates = m_mapCandidates[&c_index];
+         if(sCandidates.CollectedAt != m_unUpdate) {
+            sCandidates.Entities.clear();
+            CCollector<ENTITY> cCollector(sCandidates.Entities);
+            c_index.ForEntitiesInBoxRange(m_cBoxPosition,
+                                          m_cBoxHalfExtents,
+                                          cCollector);
+            sCandidates.CollectedAt = m_unUpdate;
+         }
+         for(CEntity* pc_entity : sCandidates.Entities) {
+            if(!c_operation(static_cast<ENTITY&>(*pc_entity))) {
+               return;
+            }
+         }
+      }
+
+      /**
+       * Looks for the closest embodied entity intersected by a ray cast
+       * from the current camera.
+       * The result is remembered until the next call to BeginCamera().
+       * @param s_item Set to the closest intersection, if any.
+       * @param c_ray The ray, starting at the camera location.
+       * @return <tt>true</tt> if the ray is occluded.
+       * @see GetClosestEmbodiedEntityIntersectedByRay
+       */
+      bool GetClosestEmbodiedEntityIntersected(SEmbodiedEntityIntersectionItem& s_item,
+                                               const CRay3& c_ray);
+
+   private:
+
+      template<class ENTITY>
+      class CCollector : public CPositionalIndex<ENTITY>::COperation {
+      public:
+         CCollector(std::vector<CEntity*>& vec_entities) :
+            m_vecEntities(vec_entities) {}
+         virtual ~CCollector() {}
+         virtual bool operator()(ENTITY& c_entity) {
+            m_vecEntities.push_back(&c_entity);
+            return true;
+         }
+      private:
+         std::vector<CEntity*>& m_vecEntities;
+      };
+
+      struct SCandidates {
+         /** The update in which the candidates were collected */
+         UInt32 CollectedAt;
+         /** The candidates, in the order given by the index */
+         std::vector<CEntity*> Entities;
+         SCandidates() : CollectedAt(0) {}
+      };
+
+      struct SOcclusion {
+         bool Occluded;
+         SEmbodiedEntityIntersectionItem Item;
+      };
+
+      /** Hashes the exact coordinates of a ray end point */
+      struct SPointHash {
+         size_t operator()(const CVector3& c_point) const {
+            std::hash<Real> cHash;
+            size_t unSeed = cHash(c_point.GetX());
+            unSeed ^= cHash(c_point.GetY()) + 0x9e3779b9 + (unSeed << 6) + (unSeed >> 2);
+            unSeed ^= cHash(c_point.GetZ()) + 0x9e3779b9 + (unSeed << 6) + (unSeed >> 2);
+            return unSeed;
+         }
+      };
+
+   private:
+
+      UInt32 m_unUpdate;
+      CVector3 m_cBoxPosition;
+      CVector3 m_cBoxHalfExtents;
+      std::unordered_map<const void*, SCandidates> m_mapCandidates;
+      std::unordered_map<CVector3, SOcclusion, SPointHash> m_mapOcclusions;
+
+   };
+
+}
+
+#endif
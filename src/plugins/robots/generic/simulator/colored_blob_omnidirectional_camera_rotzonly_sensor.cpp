@@ -28,73 +28,94 @@ namespace argos {
          m_cEmbodiedEntity(c_embodied_entity),
          m_cControllableEntity(c_controllable_entity),
          m_bShowRays(b_show_rays),
+         m_pcRootSensingEntity(NULL),
          m_fDistanceNoiseStdDev(f_noise_std_dev),
          m_pcRNG(NULL) {
-         m_pcRootSensingEntity = &m_cEmbodiedEntity.GetParent();
          if(m_fDistanceNoiseStdDev > 0.0f) {
             m_pcRNG = CRandom::CreateRNG("argos");
          }
       }
       virtual ~COmnidirectionalCameraLEDCheckOperation() {
-         while(! m_tBlobs.empty()) {
-            delete m_tBlobs.back();
-            m_tBlobs.pop_back();
-         }
+         /* The blobs point into the pool */
+         m_tBlobs.clear();
       }
 
       virtual bool operator()(CLEDEntity& c_led) {
          /* Process this LED only if it's lit */
          if(c_led.GetColor() != CColor::BLACK) {
-            if(c_led.HasParent()) {
-               /* Filter out the LEDs belonging to the sensing entity by checking if they share the same parent entity */
-               m_pcRootOfLEDEntity = &c_led.GetParent();
-               while(m_pcRootOfLEDEntity->HasParent()) m_pcRootOfLEDEntity = &m_pcRootOfLEDEntity->GetParent();
-               if(m_pcRootSensingEntity == m_pcRootOfLEDEntity) {
-                  return true;
-               }
+            /* Filter out the LEDs belonging to the sensing entity */
+            if(&c_led.GetRootEntity() == m_pcRootSensingEntity) {
+               return true;
             }
             /* If we are here, it's because the LED must be processed */
-            m_cOcclusionCheckRay.SetEnd(c_led.GetPosition());
             m_cLEDRelativePos = c_led.GetPosition();
             m_cLEDRelativePos -= m_cCameraPos;
-            m_cLEDRelativePosXY.Set(m_cLEDRelativePos.GetX(),
-                                    m_cLEDRelativePos.GetY());
             if(Abs(m_cLEDRelativePos.GetX()) < m_fGroundHalfRange &&
                Abs(m_cLEDRelativePos.GetY()) < m_fGroundHalfRange &&
-               m_cLEDRelativePos.GetZ() < m_cCameraPos.GetZ() &&
-               !GetClosestEmbodiedEntityIntersectedByRay(m_sIntersectionItem,
-                                                         m_cOcclusionCheckRay,
-                                                         m_cEmbodiedEntity)) {
-               /* If noise was setup, add it */
-               if(m_fDistanceNoiseStdDev > 0.0f) {
-                  m_cLEDRelativePosXY += CVector2(
-                     m_cLEDRelativePosXY.Length() * m_pcRNG->Gaussian(m_fDistanceNoiseStdDev),
-                     m_pcRNG->Uniform(CRadians::UNSIGNED_RANGE));
-               }
-               m_tBlobs.push_back(new CCI_ColoredBlobOmnidirectionalCameraSensor::SBlob(
-                                     c_led.GetColor(),
-                                     NormalizedDifference(m_cLEDRelativePosXY.Angle(), m_cCameraOrient),
-                                     m_cLEDRelativePosXY.Length() * 100.0f));
-               if(m_bShowRays) {
-                  m_cControllableEntity.AddCheckedRay(false, CRay3(m_cCameraPos, c_led.GetPosition()));
-               }
+               m_cLEDRelativePos.GetZ() < m_cCameraPos.GetZ()) {
+               /* The LED is in range, check occlusions later in one batch */
+               m_vecCandidates.push_back(&c_led);
+               m_vecOcclusionCheckRays.push_back(CRay3(m_cCameraPos, c_led.GetPosition()));
             }
          }
          return true;
       }
 
       void Setup(Real f_ground_half_range) {
-         while(! m_tBlobs.empty()) {
-            delete m_tBlobs.back();
-            m_tBlobs.pop_back();
-         }
+         /* The LEDs of the sensing entity share its root */
+         m_pcRootSensingEntity = &m_cEmbodiedEntity.GetRootEntity();
+         m_vecCandidates.clear();
+         m_vecOcclusionCheckRays.clear();
          m_fGroundHalfRange = f_ground_half_range;
          m_cEmbodiedEntity.GetOriginAnchor().Orientation.ToEulerAngles(m_cCameraOrient, m_cTmp1, m_cTmp2);
          m_cCameraPos = m_cEmbodiedEntity.GetOriginAnchor().Position;
          m_cCameraPos += m_cOmnicamEntity.GetOffset();
-         m_cOcclusionCheckRay.SetStart(m_cCameraPos);
       }
-      
+
+      void Finish() {
+         /* Check the occlusions of all the LEDs in range */
+         GetClosestEmbodiedEntitiesIntersectedByRays(m_vecIntersectionItems,
+                                                     m_vecOcclusionCheckRays,
+                                                     &m_cEmbodiedEntity);
+         /* Make a blob for each visible LED, reusing the blobs of the last update */
+         size_t unNumBlobs = 0;
+         for(size_t i = 0; i < m_vecCandidates.size(); ++i) {
+            if(m_vecIntersectionItems[i].IntersectedEntity != NULL) {
+               continue;
+            }
+            const CLEDEntity& cLED = *m_vecCandidates[i];
+            m_cLEDRelativePos = cLED.GetPosition();
+            m_cLEDRelativePos -= m_cCameraPos;
+            m_cLEDRelativePosXY.Set(m_cLEDRelativePos.GetX(),
+                                    m_cLEDRelativePos.GetY());
+            /* If noise was setup, add it */
+            if(m_fDistanceNoiseStdDev > 0.0f) {
+               m_cLEDRelativePosXY += CVector2(
+                  m_cLEDRelativePosXY.Length() * m_pcRNG->Gaussian(m_fDistanceNoiseStdDev),
+                  m_pcRNG->Uniform(CRadians::UNSIGNED_RANGE));
+            }
+            CCI_ColoredBlobOmnidirectionalCameraSensor::SBlob sBlob(
+               cLED.GetColor(),
+               NormalizedDifference(m_cLEDRelativePosXY.Angle(), m_cCameraOrient),
+               m_cLEDRelativePosXY.Length() * 100.0f);
+            if(unNumBlobs < m_vecBlobPool.size()) {
+               m_vecBlobPool[unNumBlobs] = sBlob;
+            }
+            else {
+               m_vecBlobPool.push_back(sBlob);
+            }
+            ++unNumBlobs;
+            if(m_bShowRays) {
+               m_cControllableEntity.AddCheckedRay(false, m_vecOcclusionCheckRays[i]);
+            }
+         }
+         /* The pool does not grow anymore, so the blobs can point into it */
+         m_tBlobs.resize(unNumBlobs);
+         for(size_t i = 0; i < unNumBlobs; ++i) {
+            m_tBlobs[i] = &m_vecBlobPool[i];
+         }
+      }
+
    private:
       
       CCI_ColoredBlobOmnidirectionalCameraSensor::TBlobList& m_tBlobs;
@@ -103,15 +124,16 @@ namespace argos {
       CControllableEntity& m_cControllableEntity;
       Real m_fGroundHalfRange;
       bool m_bShowRays;
-      CEntity* m_pcRootSensingEntity;
-      CEntity* m_pcRootOfLEDEntity;
+      const CEntity* m_pcRootSensingEntity;
+      std::vector<const CLEDEntity*> m_vecCandidates;
+      std::vector<CRay3> m_vecOcclusionCheckRays;
+      std::vector<SEmbodiedEntityIntersectionItem> m_vecIntersectionItems;
+      std::vector<CCI_ColoredBlobOmnidirectionalCameraSensor::SBlob> m_vecBlobPool;
       CVector3 m_cCameraPos;
       CRadians m_cCameraOrient;
       CRadians m_cTmp1, m_cTmp2;
       CVector3 m_cLEDRelativePos;
       CVector2 m_cLEDRelativePosXY;
-      SEmbodiedEntityIntersectionItem m_sIntersectionItem;
-      CRay3 m_cOcclusionCheckRay;
       Real m_fDistanceNoiseStdDev;
       CRandom::CRNG* m_pcRNG;
    };
@@ -197,6 +219,8 @@ namespace argos {
                      cCameraPos.GetZ() * 0.5f),
             CVector3(fGroundHalfRange, fGroundHalfRange, cCameraPos.GetZ() * 0.5f),
             *m_pcOperation);
+         /* Check the occlusions and make the blobs */
+         m_pcOperation->Finish();
       }
    }
 
@@ -28,28 +28,24 @@ namespace argos {
          m_cEmbodiedEntity(c_embodied_entity),
          m_cControllableEntity(c_controllable_entity),
          m_bShowRays(b_show_rays),
+         m_pcRootSensingEntity(NULL),
          m_fNoiseStdDev(f_noise_std_dev),
          m_pcRNG(NULL) {
-         m_pcRootSensingEntity = &m_cEmbodiedEntity.GetRootEntity();
          if(m_fNoiseStdDev > 0.0f) {
             m_pcRNG = CRandom::CreateRNG("argos");
          }
       }
       virtual ~CPerspectiveCameraLEDCheckOperation() {
-         while(! m_tBlobs.empty()) {
-            delete m_tBlobs.back();
-            m_tBlobs.pop_back();
-         }
+         /* The blobs point into the pool */
+         m_tBlobs.clear();
       }
 
       virtual bool operator()(CLEDEntity& c_led) {
          /* Process this LED only if it's lit */
          if(c_led.GetColor() != CColor::BLACK) {
-            /* Filter out the LEDs belonging to the sensing entity by checking if they share the same parent entity */
-            if(m_pcRootSensingEntity == &c_led.GetRootEntity()) return true;
+            /* Filter out the LEDs belonging to the sensing entity */
+            if(&c_led.GetRootEntity() == m_pcRootSensingEntity) return true;
             /* If we are here, it's because the LED must be processed */
-            /* Set the end of the ray for occlusion checking */
-            m_cOcclusionCheckRay.SetEnd(c_led.GetPosition());
             /* Calculate the vector to LED in the camera-anchor frame of reference */
             m_cLEDRelative = c_led.GetPosition();
             m_cLEDRelative -= m_cCamEntity.GetAnchor().Position;
@@ -60,13 +56,11 @@ namespace argos {
              * 1. It is within the distance range AND
              * 2. It is within the aperture range AND
              * 3. There are no occlusions
+             * The occlusions are checked later, in one batch, for the LEDs
+             * that fall in the image
              */
             if(fDotProd < m_cCamEntity.GetRange() &&
-               ACos(fDotProd / m_cLEDRelative.Length()) < m_cCamEntity.GetAperture() &&
-               !GetClosestEmbodiedEntityIntersectedByRay(m_sIntersectionItem,
-                                                         m_cOcclusionCheckRay,
-                                                         m_cEmbodiedEntity)) {
-               /* The LED is visibile */
+               ACos(fDotProd / m_cLEDRelative.Length()) < m_cCamEntity.GetAperture()) {
                /* Calculate the intersection point between the LED ray and the image plane */
                m_cLEDRelative.Normalize();
                m_cLEDRelative *= m_cCamEntity.GetFocalLength() / m_cLEDRelative.GetX();
@@ -90,34 +84,58 @@ namespace argos {
                if((unI >= m_cCamEntity.GetImagePxWidth() || unI < 0) ||
                   (unJ >= m_cCamEntity.GetImagePxHeight() || unJ < 0))
                   return true;
-               /* Add new blob */
-               m_tBlobs.push_back(
-                  new CCI_ColoredBlobPerspectiveCameraSensor::SBlob(
+               /* Add candidate blob */
+               m_vecCandidates.push_back(
+                  CCI_ColoredBlobPerspectiveCameraSensor::SBlob(
                      c_led.GetColor(), unI, unJ));
-               /* Draw ray */
-               if(m_bShowRays) {
-                  m_cControllableEntity.AddCheckedRay(
-                     false,
-                     CRay3(m_cCamEntity.GetAnchor().Position,
-                           c_led.GetPosition()));
-               }
+               m_vecOcclusionCheckRays.push_back(
+                  CRay3(m_cCamEntity.GetAnchor().Position,
+                        c_led.GetPosition()));
             }
          }
          return true;
       }
       
       void Setup() {
-         /* Erase blobs */
-         while(! m_tBlobs.empty()) {
-            delete m_tBlobs.back();
-            m_tBlobs.pop_back();
-         }
-         /* Reset ray start */
-         m_cOcclusionCheckRay.SetStart(m_cCamEntity.GetAnchor().Position);
+         /* The LEDs of the sensing entity share its root */
+         m_pcRootSensingEntity = &m_cEmbodiedEntity.GetRootEntity();
+         /* Erase candidates */
+         m_vecCandidates.clear();
+         m_vecOcclusionCheckRays.clear();
          /* Calculate inverse of camera orientation */
          m_cInvCameraOrient = m_cCamEntity.GetAnchor().Orientation.Inverse();
       }
-      
+
+      void Finish() {
+         /* Check the occlusions of all the candidate blobs */
+         GetClosestEmbodiedEntitiesIntersectedByRays(m_vecIntersectionItems,
+                                                     m_vecOcclusionCheckRays,
+                                                     &m_cEmbodiedEntity);
+         /* Keep the visible blobs, reusing the blobs of the last update */
+         size_t unNumBlobs = 0;
+         for(size_t i = 0; i < m_vecCandidates.size(); ++i) {
+            if(m_vecIntersectionItems[i].IntersectedEntity != NULL) {
+               continue;
+            }
+            if(unNumBlobs < m_vecBlobPool.size()) {
+               m_vecBlobPool[unNumBlobs] = m_vecCandidates[i];
+            }
+            else {
+               m_vecBlobPool.push_back(m_vecCandidates[i]);
+            }
+            ++unNumBlobs;
+            /* Draw ray */
+            if(m_bShowRays) {
+               m_cControllableEntity.AddCheckedRay(false, m_vecOcclusionCheckRays[i]);
+            }
+         }
+         /* The pool does not grow anymore, so the blobs can point into it */
+         m_tBlobs.resize(unNumBlobs);
+         for(size_t i = 0; i < unNumBlobs; ++i) {
+            m_tBlobs[i] = &m_vecBlobPool[i];
+         }
+      }
+
    private:
       
       CCI_ColoredBlobPerspectiveCameraSensor::TBlobList& m_tBlobs;
@@ -126,11 +144,12 @@ namespace argos {
       CControllableEntity& m_cControllableEntity;
       CQuaternion m_cInvCameraOrient;
       bool m_bShowRays;
-      CEntity* m_pcRootSensingEntity;
-      CRadians m_cTmp1, m_cTmp2;
+      const CEntity* m_pcRootSensingEntity;
+      std::vector<CCI_ColoredBlobPerspectiveCameraSensor::SBlob> m_vecCandidates;
+      std::vector<CRay3> m_vecOcclusionCheckRays;
+      std::vector<SEmbodiedEntityIntersectionItem> m_vecIntersectionItems;
+      std::vector<CCI_ColoredBlobPerspectiveCameraSensor::SBlob> m_vecBlobPool;
       CVector3 m_cLEDRelative;
-      SEmbodiedEntityIntersectionItem m_sIntersectionItem;
-      CRay3 m_cOcclusionCheckRay;
       Real m_fNoiseStdDev;
       CRandom::CRNG* m_pcRNG;
    };
@@ -222,6 +241,8 @@ namespace argos {
          /* Go through LED entities in box range */
          m_pcLEDIndex->ForEntitiesInBoxRange(
             cCenter, cHalfSize, *m_pcOperation);
+         /* Check the occlusions and make the blobs */
+         m_pcOperation->Finish();
       }
    }
 
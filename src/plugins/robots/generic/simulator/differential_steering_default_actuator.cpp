@@ -56,32 +56,38 @@ namespace argos {
    GetNodeAttributeOrDefault<Real>(t_tree, ATTR "_left", VAR[LEFT_WHEEL], VAR[LEFT_WHEEL]); \
    GetNodeAttributeOrDefault<Real>(t_tree, ATTR "_right", VAR[RIGHT_WHEEL], VAR[RIGHT_WHEEL]);
 
-#define PICK_BIAS(LRW) m_fNoiseBias[LRW ## _WHEEL] = m_pcRNG->Gaussian(fNoiseBiasStdDev[LRW ## _WHEEL], fNoiseBiasAvg[LRW ## _WHEEL])
-   
+#define PICK_BIAS(LRW) m_fNoiseBias[LRW ## _WHEEL] = m_pcRNG->Gaussian(sConfig.BiasStdDev[LRW ## _WHEEL], sConfig.BiasAvg[LRW ## _WHEEL])
+
+   void CDifferentialSteeringDefaultActuator::ParseNoise(TConfigurationNode& t_tree,
+                                                         SNoiseConfiguration& s_config) {
+      /* Check if any noise attribute was specified */
+      s_config.Noise =
+         CHECK_ATTRIBUTE("bias_avg")    ||
+         CHECK_ATTRIBUTE("bias_stddev") ||
+         CHECK_ATTRIBUTE("factor_avg")  ||
+         CHECK_ATTRIBUTE("factor_stddev");
+      /* Parse noise attributes, if any */
+      s_config.BiasAvg[LEFT_WHEEL] = s_config.BiasAvg[RIGHT_WHEEL] = 0.0;
+      s_config.BiasStdDev[LEFT_WHEEL] = s_config.BiasStdDev[RIGHT_WHEEL] = 0.0;
+      s_config.FactorAvg[LEFT_WHEEL] = s_config.FactorAvg[RIGHT_WHEEL] = 1.0;
+      s_config.FactorStdDev[LEFT_WHEEL] = s_config.FactorStdDev[RIGHT_WHEEL] = 0.0;
+      if(s_config.Noise) {
+         PARSE_ATTRIBUTES("bias_avg", s_config.BiasAvg);
+         PARSE_ATTRIBUTES("bias_stddev", s_config.BiasStdDev);
+         PARSE_ATTRIBUTES("factor_avg", s_config.FactorAvg);
+         PARSE_ATTRIBUTES("factor_stddev", s_config.FactorStdDev);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CDifferentialSteeringDefaultActuator::Init(TConfigurationNode& t_tree) {
       try {
          CCI_DifferentialSteeringActuator::Init(t_tree);
-         /* Check if any noise attribute was specified */
-         bool bNoise =
-            CHECK_ATTRIBUTE("bias_avg")    ||
-            CHECK_ATTRIBUTE("bias_stddev") ||
-            CHECK_ATTRIBUTE("factor_avg")  ||
-            CHECK_ATTRIBUTE("factor_stddev");
-         /* Handle noise attributes, if any */
-         if(bNoise) {
-            /* Create RNG */
-            m_pcRNG = CRandom::CreateRNG("argos");
-            /* Parse noise attributes */
-            Real fNoiseBiasAvg[2];
-            Real fNoiseBiasStdDev[2];
-            PARSE_ATTRIBUTES("bias_avg", fNoiseBiasAvg);
-            PARSE_ATTRIBUTES("bias_stddev", fNoiseBiasStdDev);
-            PARSE_ATTRIBUTES("factor_avg", m_fNoiseFactorAvg);
-            PARSE_ATTRIBUTES("factor_stddev", m_fNoiseFactorStdDev);
-            /* Choose robot bias */
-            PICK_BIAS(LEFT);
-            PICK_BIAS(RIGHT);
-         }
+         SNoiseConfiguration sConfig;
+         ParseNoise(t_tree, sConfig);
+         InitFromConfiguration(sConfig);
       }
       catch(CARGoSException& ex) {
          THROW_ARGOSEXCEPTION_NESTED("Initialization error in foot-bot steering actuator.", ex);
@@ -91,6 +97,40 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   CSimulatedActuator::SConfiguration* CDifferentialSteeringDefaultActuator::ParseConfiguration(TConfigurationNode& t_tree) {
+      SNoiseConfiguration* psConfig = new SNoiseConfiguration;
+      try {
+         ParseNoise(t_tree, *psConfig);
+      }
+      catch(CARGoSException& ex) {
+         delete psConfig;
+         THROW_ARGOSEXCEPTION_NESTED("Initialization error in foot-bot steering actuator.", ex);
+      }
+      return psConfig;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDifferentialSteeringDefaultActuator::InitFromConfiguration(const CSimulatedActuator::SConfiguration& s_config) {
+      const SNoiseConfiguration& sConfig = static_cast<const SNoiseConfiguration&>(s_config);
+      /* Handle noise attributes, if any */
+      if(sConfig.Noise) {
+         /* Create RNG */
+         m_pcRNG = CRandom::CreateRNG("argos");
+         m_fNoiseFactorAvg[LEFT_WHEEL] = sConfig.FactorAvg[LEFT_WHEEL];
+         m_fNoiseFactorAvg[RIGHT_WHEEL] = sConfig.FactorAvg[RIGHT_WHEEL];
+         m_fNoiseFactorStdDev[LEFT_WHEEL] = sConfig.FactorStdDev[LEFT_WHEEL];
+         m_fNoiseFactorStdDev[RIGHT_WHEEL] = sConfig.FactorStdDev[RIGHT_WHEEL];
+         /* Choose robot bias */
+         PICK_BIAS(LEFT);
+         PICK_BIAS(RIGHT);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
 #define ADD_GAUSSIAN(LRW)                                  \
    (m_fNoiseFactorStdDev[LRW ## _WHEEL] > 0.0 ?            \
     m_pcRNG->Gaussian(m_fNoiseFactorStdDev[LRW ## _WHEEL], \
@@ -145,6 +185,26 @@ namespace argos {
    /****************************************/
    /****************************************/
    
+   void CDifferentialSteeringDefaultActuator::SaveState(CByteArray& c_buffer) {
+      c_buffer << m_fCurrentVelocity[LEFT_WHEEL]
+               << m_fCurrentVelocity[RIGHT_WHEEL]
+               << m_fNoiseBias[LEFT_WHEEL]
+               << m_fNoiseBias[RIGHT_WHEEL];
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDifferentialSteeringDefaultActuator::LoadState(CByteArray& c_buffer) {
+      c_buffer >> m_fCurrentVelocity[LEFT_WHEEL]
+               >> m_fCurrentVelocity[RIGHT_WHEEL]
+               >> m_fNoiseBias[LEFT_WHEEL]
+               >> m_fNoiseBias[RIGHT_WHEEL];
+   }
+
+   /****************************************/
+   /****************************************/
+
 }
 
 REGISTER_ACTUATOR(CDifferentialSteeringDefaultActuator,
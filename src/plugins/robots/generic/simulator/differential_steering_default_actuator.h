@@ -19,11 +19,13 @@ namespace argos {
 #include <argos3/plugins/simulator/entities/wheeled_entity.h>
 #include <argos3/core/simulator/entity/composable_entity.h>
 #include <argos3/core/utility/math/rng.h>
+#include <argos3/core/utility/configuration/memento.h>
 
 namespace argos {
 
    class CDifferentialSteeringDefaultActuator : public CSimulatedActuator,
-                                                public CCI_DifferentialSteeringActuator {
+                                                public CCI_DifferentialSteeringActuator,
+                                                public CMemento {
 
    public:
 
@@ -48,6 +50,20 @@ namespace argos {
 
       virtual void Init(TConfigurationNode& t_tree);
 
+      /**
+       * Parses the noise attributes, once for all the robots.
+       * @param t_tree The XML configuration of the actuator.
+       * @return The parsed configuration.
+       */
+      virtual CSimulatedActuator::SConfiguration* ParseConfiguration(TConfigurationNode& t_tree);
+
+      /**
+       * Initializes the actuator from the parsed noise attributes.
+       * The noise bias of the robot is drawn here.
+       * @param s_config The parsed configuration.
+       */
+      virtual void InitFromConfiguration(const CSimulatedActuator::SConfiguration& s_config);
+
       /**
        * @brief Sets the linear velocity of the two steering.
        * Velocities are expressed in cm per second.
@@ -62,6 +78,35 @@ namespace argos {
 
       virtual void Reset();
 
+      /**
+       * Saves the wheel velocities set by the controller and the noise bias.
+       * @param c_buffer The target buffer.
+       */
+      virtual void SaveState(CByteArray& c_buffer);
+
+      /**
+       * Restores the state saved by SaveState().
+       * @param c_buffer The source buffer.
+       */
+      virtual void LoadState(CByteArray& c_buffer);
+
+   protected:
+
+      /**
+       * The parsed noise attributes.
+       */
+      struct SNoiseConfiguration : public CSimulatedActuator::SConfiguration {
+         /** True if any noise attribute was specified */
+         bool Noise;
+         Real BiasAvg[2];
+         Real BiasStdDev[2];
+         Real FactorAvg[2];
+         Real FactorStdDev[2];
+      };
+
+      static void ParseNoise(TConfigurationNode& t_tree,
+                             SNoiseConfiguration& s_config);
+
    protected:
 
       CWheeledEntity* m_pcWheeledEntity;
@@ -28,14 +28,46 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   /**
+    * The parsed configuration of the actuator.
+    */
+   struct SLEDsConfiguration : public CSimulatedActuator::SConfiguration {
+      CLEDMedium* Medium;
+   };
+
+   /****************************************/
+   /****************************************/
+
+   static CLEDMedium& GetLEDMedium(TConfigurationNode& t_tree) {
+      std::string strMedium;
+      GetNodeAttribute(t_tree, "medium", strMedium);
+      return CSimulator::GetInstance().GetMedium<CLEDMedium>(strMedium);
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CLEDsDefaultActuator::Init(TConfigurationNode& t_tree) {
       try {
          CCI_LEDsActuator::Init(t_tree);
-         std::string strMedium;
-         GetNodeAttribute(t_tree, "medium", strMedium);
-         m_pcLEDMedium = &CSimulator::GetInstance().GetMedium<CLEDMedium>(strMedium);
-            m_pcLEDEquippedEntity->SetMedium(*m_pcLEDMedium);
-            m_pcLEDEquippedEntity->Enable();
+         SLEDsConfiguration sConfig;
+         sConfig.Medium = &GetLEDMedium(t_tree);
+         InitFromConfiguration(sConfig);
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("Error initializing the LEDs default actuator", ex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CSimulatedActuator::SConfiguration* CLEDsDefaultActuator::ParseConfiguration(TConfigurationNode& t_tree) {
+      try {
+         CLEDMedium& cMedium = GetLEDMedium(t_tree);
+         SLEDsConfiguration* psConfig = new SLEDsConfiguration;
+         psConfig->Medium = &cMedium;
+         return psConfig;
       }
       catch(CARGoSException& ex) {
          THROW_ARGOSEXCEPTION_NESTED("Error initializing the LEDs default actuator", ex);
@@ -45,6 +77,15 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CLEDsDefaultActuator::InitFromConfiguration(const CSimulatedActuator::SConfiguration& s_config) {
+      m_pcLEDMedium = static_cast<const SLEDsConfiguration&>(s_config).Medium;
+      m_pcLEDEquippedEntity->SetMedium(*m_pcLEDMedium);
+      m_pcLEDEquippedEntity->Enable();
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CLEDsDefaultActuator::Update() {
       m_pcLEDEquippedEntity->SetAllLEDsColors(m_tSettings);
    }
@@ -66,6 +107,29 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CLEDsDefaultActuator::SaveState(CByteArray& c_buffer) {
+      for(size_t i = 0; i < m_tSettings.size(); ++i) {
+         c_buffer << m_tSettings[i].GetRed()
+                  << m_tSettings[i].GetGreen()
+                  << m_tSettings[i].GetBlue()
+                  << m_tSettings[i].GetAlpha();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLEDsDefaultActuator::LoadState(CByteArray& c_buffer) {
+      UInt8 unRed, unGreen, unBlue, unAlpha;
+      for(size_t i = 0; i < m_tSettings.size(); ++i) {
+         c_buffer >> unRed >> unGreen >> unBlue >> unAlpha;
+         m_tSettings[i].Set(unRed, unGreen, unBlue, unAlpha);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
 }
 
 REGISTER_ACTUATOR(CLEDsDefaultActuator,
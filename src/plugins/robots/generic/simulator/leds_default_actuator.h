@@ -18,11 +18,13 @@ namespace argos {
 #include <argos3/plugins/robots/generic/control_interface/ci_leds_actuator.h>
 #include <argos3/plugins/simulator/entities/led_equipped_entity.h>
 #include <argos3/core/simulator/actuator.h>
+#include <argos3/core/utility/configuration/memento.h>
 
 namespace argos {
 
    class CLEDsDefaultActuator : public CSimulatedActuator,
-                                public CCI_LEDsActuator {
+                                public CCI_LEDsActuator,
+                                public CMemento {
 
    public:
 
@@ -33,10 +35,35 @@ namespace argos {
       virtual void SetRobot(CComposableEntity& c_entity);
 
       virtual void Init(TConfigurationNode& t_tree);
+
+      /**
+       * Looks up the LED medium, once for all the robots.
+       * @param t_tree The XML configuration of the actuator.
+       * @return The parsed configuration.
+       */
+      virtual CSimulatedActuator::SConfiguration* ParseConfiguration(TConfigurationNode& t_tree);
+
+      /**
+       * Initializes the actuator with the LED medium looked up by ParseConfiguration().
+       * @param s_config The parsed configuration.
+       */
+      virtual void InitFromConfiguration(const CSimulatedActuator::SConfiguration& s_config);
       virtual void Update();
       virtual void Reset();
       virtual void Destroy();
 
+      /**
+       * Saves the colors set by the controller.
+       * @param c_buffer The target buffer.
+       */
+      virtual void SaveState(CByteArray& c_buffer);
+
+      /**
+       * Restores the colors saved by SaveState().
+       * @param c_buffer The source buffer.
+       */
+      virtual void LoadState(CByteArray& c_buffer);
+
    private:
 
       CLEDEquippedEntity* m_pcLEDEquippedEntity;
@@ -9,6 +9,7 @@
 #include <argos3/core/simulator/entity/composable_entity.h>
 #include <argos3/plugins/simulator/entities/light_entity.h>
 #include <argos3/plugins/simulator/entities/light_sensor_equipped_entity.h>
+#include <argos3/plugins/simulator/media/light_medium.h>
 
 #include "light_default_sensor.h"
 
@@ -19,6 +20,11 @@ namespace argos {
 
    static CRange<Real> UNIT(0.0f, 1.0f);
 
+   /* Occlusion check states of a sensor towards a light */
+   static const UInt8 LIGHT_UNCHECKED = 0;
+   static const UInt8 LIGHT_VISIBLE   = 1;
+   static const UInt8 LIGHT_OCCLUDED  = 2;
+
    /****************************************/
    /****************************************/
 
@@ -26,7 +32,10 @@ namespace argos {
       m_bShowRays(false),
       m_pcRNG(NULL),
       m_bAddNoise(false),
-      m_cSpace(CSimulator::GetInstance().GetSpace()) {}
+      m_cSpace(CSimulator::GetInstance().GetSpace()),
+      m_pcLightMedium(NULL),
+      m_fRangePerIntensity(0.0f),
+      m_fShadowTolerance(0.0f) {}
 
    /****************************************/
    /****************************************/
@@ -62,6 +71,28 @@ namespace argos {
             m_pcRNG = CRandom::CreateRNG("argos");
          }
          m_tReadings.resize(m_pcLightEntity->GetNumSensors());
+         /* Light medium */
+         if(NodeAttributeExists(t_tree, "medium")) {
+            std::string strMedium;
+            GetNodeAttribute(t_tree, "medium", strMedium);
+            m_pcLightMedium = &CSimulator::GetInstance().GetMedium<CLightMedium>(strMedium);
+            /* The reading (I/x)^2 falls below the cutoff c beyond x = I/sqrt(c) */
+            Real fCutoff = 0.0f;
+            GetNodeAttributeOrDefault(t_tree, "cutoff", fCutoff, fCutoff);
+            if(fCutoff < 0.0f) {
+               THROW_ARGOSEXCEPTION("Can't specify a negative value for the cutoff of the light sensor");
+            }
+            else if(fCutoff > 0.0f) {
+               m_fRangePerIntensity = 1.0f / Sqrt(fCutoff);
+            }
+            GetNodeAttributeOrDefault(t_tree, "shadow_tolerance", m_fShadowTolerance, m_fShadowTolerance);
+            if(m_fShadowTolerance < 0.0f) {
+               THROW_ARGOSEXCEPTION("Can't specify a negative value for the shadow tolerance of the light sensor");
+            }
+            m_vecSensorPositions.resize(m_tReadings.size());
+            m_vecRayOwners.resize(m_tReadings.size());
+            m_vecLightState.resize(m_tReadings.size());
+         }
       }
       catch(CARGoSException& ex) {
          THROW_ARGOSEXCEPTION_NESTED("Initialization error in default light sensor", ex);
@@ -72,6 +103,10 @@ namespace argos {
    /****************************************/
    
    void CLightDefaultSensor::Update() {
+      if(m_pcLightMedium != NULL) {
+         UpdateWithLightMedium();
+         return;
+      }
       /* Erase readings */
       for(size_t i = 0; i < m_tReadings.size(); ++i)  m_tReadings[i] = 0.0f;
       /* Ray used for scanning the environment for obstacles */
@@ -147,6 +182,95 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CLightDefaultSensor::UpdateWithLightMedium() {
+      /* Erase readings */
+      for(size_t i = 0; i < m_tReadings.size(); ++i)  m_tReadings[i] = 0.0f;
+      /*
+       * Calculate the sensor positions and their center. A sensor shares
+       * the occlusion rays of the first sensor found within the tolerance.
+       */
+      CVector3 cCenter;
+      for(UInt32 i = 0; i < m_tReadings.size(); ++i) {
+         m_vecSensorPositions[i] = m_pcLightEntity->GetSensor(i).Position;
+         m_vecSensorPositions[i].Rotate(m_pcLightEntity->GetSensor(i).Anchor.Orientation);
+         m_vecSensorPositions[i] += m_pcLightEntity->GetSensor(i).Anchor.Position;
+         cCenter += m_vecSensorPositions[i];
+         m_vecRayOwners[i] = i;
+         for(UInt32 j = 0; j < i; ++j) {
+            if(m_vecRayOwners[j] == j &&
+               Distance(m_vecSensorPositions[i], m_vecSensorPositions[j]) <= m_fShadowTolerance) {
+               m_vecRayOwners[i] = j;
+               break;
+            }
+         }
+      }
+      Real fRadius = 0.0f;
+      if(!m_tReadings.empty()) {
+         cCenter /= m_tReadings.size();
+         for(UInt32 i = 0; i < m_tReadings.size(); ++i) {
+            fRadius = Max(fRadius, Distance(cCenter, m_vecSensorPositions[i]));
+         }
+      }
+      /* Get the lights that are in range of at least one sensor */
+      m_pcLightMedium->GetLightsInRange(m_vecLights, cCenter, m_fRangePerIntensity, fRadius);
+      /* Ray used for scanning the environment for obstacles */
+      CRay3 cScanningRay;
+      CVector3 cSensorToLight;
+      /* Buffers to contain data about the intersection */
+      SEmbodiedEntityIntersectionItem sIntersection;
+      for(size_t l = 0; l < m_vecLights.size(); ++l) {
+         CLightEntity& cLight = *m_vecLights[l];
+         Real fRange = m_fRangePerIntensity * cLight.GetIntensity();
+         for(UInt32 i = 0; i < m_tReadings.size(); ++i) {
+            m_vecLightState[i] = LIGHT_UNCHECKED;
+            /* Skip the light if its contribution is below the cutoff */
+            if(m_fRangePerIntensity > 0.0f &&
+               SquareDistance(m_vecSensorPositions[i], cLight.GetPosition()) > fRange * fRange) {
+               continue;
+            }
+            cScanningRay.Set(m_vecSensorPositions[i], cLight.GetPosition());
+            if(m_vecLightState[m_vecRayOwners[i]] != LIGHT_UNCHECKED) {
+               /* Share the occlusion check of a nearby sensor */
+               m_vecLightState[i] = m_vecLightState[m_vecRayOwners[i]];
+            }
+            else if(GetClosestEmbodiedEntityIntersectedByRay(sIntersection,
+                                                             cScanningRay)) {
+               /* There is an occlusion, the light is not visible */
+               m_vecLightState[i] = LIGHT_OCCLUDED;
+               if(m_bShowRays) {
+                  m_pcControllableEntity->AddIntersectionPoint(cScanningRay,
+                                                               sIntersection.TOnRay);
+               }
+            }
+            else {
+               /* No occlusion, the light is visibile */
+               m_vecLightState[i] = LIGHT_VISIBLE;
+            }
+            if(m_bShowRays) {
+               m_pcControllableEntity->AddCheckedRay(m_vecLightState[i] == LIGHT_OCCLUDED,
+                                                     cScanningRay);
+            }
+            if(m_vecLightState[i] == LIGHT_VISIBLE) {
+               /* Calculate reading */
+               cScanningRay.ToVector(cSensorToLight);
+               m_tReadings[i] += CalculateReading(cSensorToLight.Length(),
+                                                  cLight.GetIntensity());
+            }
+         }
+      }
+      for(UInt32 i = 0; i < m_tReadings.size(); ++i) {
+         /* Apply noise to the sensor */
+         if(m_bAddNoise) {
+            m_tReadings[i] += m_pcRNG->Uniform(m_cNoiseRange);
+         }
+         /* Trunc the reading between 0 and 1 */
+         UNIT.TruncValue(m_tReadings[i]);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CLightDefaultSensor::Reset() {
       for(UInt32 i = 0; i < GetReadings().size(); ++i) {
          m_tReadings[i] = 0.0f;
@@ -241,6 +365,31 @@ namespace argos {
                    "    ...\n"
                    "  </controllers>\n\n"
 
+                   "With many lights, the sensor can look the lights up in a light medium instead\n"
+                   "of going through all of them. The lights must be added to the medium with their\n"
+                   "'light_medium' attribute. The attribute \"cutoff\" sets the smallest reading a\n"
+                   "light can contribute: the lights farther than I/sqrt(cutoff) from a sensor are\n"
+                   "ignored. By default it is 0, and all the lights are considered. The sensors\n"
+                   "closer than \"shadow_tolerance\" to each other share the occlusion check towards\n"
+                   "a light. By default it is 0, so only sensors in the same position share it.\n\n"
+
+                   "  <controllers>\n"
+                   "    ...\n"
+                   "    <my_controller ...>\n"
+                   "      ...\n"
+                   "      <sensors>\n"
+                   "        ...\n"
+                   "        <light implementation=\"default\"\n"
+                   "                   medium=\"lights\"\n"
+                   "                   cutoff=\"0.01\"\n"
+                   "                   shadow_tolerance=\"0.02\" />\n"
+                   "        ...\n"
+                   "      </sensors>\n"
+                   "      ...\n"
+                   "    </my_controller>\n"
+                   "    ...\n"
+                   "  </controllers>\n\n"
+
                    "OPTIMIZATION HINTS\n\n"
 
                    "1. For small swarms, enabling the light sensor (and therefore causing ARGoS to\n"
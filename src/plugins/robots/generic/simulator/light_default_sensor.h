@@ -13,6 +13,8 @@
 namespace argos {
    class CLightDefaultSensor;
    class CLightSensorEquippedEntity;
+   class CLightEntity;
+   class CLightMedium;
 }
 
 #include <argos3/plugins/robots/generic/control_interface/ci_light_sensor.h>
@@ -20,6 +22,7 @@ namespace argos {
 #include <argos3/core/utility/math/rng.h>
 #include <argos3/core/simulator/space/space.h>
 #include <argos3/core/simulator/sensor.h>
+#include <vector>
 
 namespace argos {
 
@@ -67,6 +70,15 @@ namespace argos {
          m_bShowRays = b_show_rays;
       }
 
+   protected:
+
+      /**
+       * Calculates the readings using the light medium.
+       * The lights out of range are skipped, and the occlusion rays are
+       * shared among the sensors with the same line of sight to a light.
+       */
+      void UpdateWithLightMedium();
+
    protected:
 
       /** Reference to light sensor equipped entity associated to this sensor */
@@ -89,6 +101,27 @@ namespace argos {
 
       /** Reference to the space */
       CSpace& m_cSpace;
+
+      /** The light medium, or NULL to go through all the lights */
+      CLightMedium* m_pcLightMedium;
+
+      /** Range of a light of unit intensity, or 0 for an unlimited range */
+      Real m_fRangePerIntensity;
+
+      /** Distance within which two sensors share an occlusion ray */
+      Real m_fShadowTolerance;
+
+      /** Buffer for the lights in range */
+      std::vector<CLightEntity*> m_vecLights;
+
+      /** Buffer for the sensor positions */
+      std::vector<CVector3> m_vecSensorPositions;
+
+      /** For each sensor, the sensor whose occlusion ray it shares */
+      std::vector<UInt32> m_vecRayOwners;
+
+      /** For each sensor, the result of the occlusion check towards the current light */
+      std::vector<UInt8> m_vecLightState;
    };
 
 }
@@ -46,23 +46,90 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CProximityDefaultSensor::ParseProximity(TConfigurationNode& t_tree,
+                                                SProximityConfiguration& s_config) {
+      /* Show rays? */
+      s_config.ShowRays = false;
+      GetNodeAttributeOrDefault(t_tree, "show_rays", s_config.ShowRays, s_config.ShowRays);
+      /* Parse noise level */
+      s_config.NoiseLevel = 0.0f;
+      GetNodeAttributeOrDefault(t_tree, "noise_level", s_config.NoiseLevel, s_config.NoiseLevel);
+      if(s_config.NoiseLevel < 0.0f) {
+         THROW_ARGOSEXCEPTION("Can't specify a negative value for the noise level of the proximity sensor");
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CProximityDefaultSensor::Init(TConfigurationNode& t_tree) {
       try {
          CCI_ProximitySensor::Init(t_tree);
-         /* Show rays? */
-         GetNodeAttributeOrDefault(t_tree, "show_rays", m_bShowRays, m_bShowRays);
-         /* Parse noise level */
-         Real fNoiseLevel = 0.0f;
-         GetNodeAttributeOrDefault(t_tree, "noise_level", fNoiseLevel, fNoiseLevel);
-         if(fNoiseLevel < 0.0f) {
-            THROW_ARGOSEXCEPTION("Can't specify a negative value for the noise level of the proximity sensor");
-         }
-         else if(fNoiseLevel > 0.0f) {
+         SProximityConfiguration sConfig;
+         ParseProximity(t_tree, sConfig);
+         InitFromConfiguration(sConfig);
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("Initialization error in default proximity sensor", ex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CSimulatedSensor::SConfiguration* CProximityDefaultSensor::ParseConfiguration(TConfigurationNode& t_tree) {
+      SProximityConfiguration* psConfig = new SProximityConfiguration;
+      try {
+         ParseProximity(t_tree, *psConfig);
+      }
+      catch(CARGoSException& ex) {
+         delete psConfig;
+         THROW_ARGOSEXCEPTION_NESTED("Initialization error in default proximity sensor", ex);
+      }
+      return psConfig;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CProximityDefaultSensor::InitFromConfiguration(const CSimulatedSensor::SConfiguration& s_config) {
+      const SProximityConfiguration& sConfig = static_cast<const SProximityConfiguration&>(s_config);
+      try {
+         m_bShowRays = sConfig.ShowRays;
+         if(sConfig.NoiseLevel > 0.0f) {
             m_bAddNoise = true;
-            m_cNoiseRange.Set(-fNoiseLevel, fNoiseLevel);
+            m_cNoiseRange.Set(-sConfig.NoiseLevel, sConfig.NoiseLevel);
             m_pcRNG = CRandom::CreateRNG("argos");
          }
          m_tReadings.resize(m_pcProximityEntity->GetNumSensors());
+         /* Store the rays of the sensors in the frame of their anchor,
+            grouped by anchor */
+         m_vecAnchorPoses.clear();
+         m_vecRaySensors.clear();
+         m_cLocalRayStarts.Clear();
+         m_cLocalRayEnds.Clear();
+         std::vector<bool> vecStored(m_tReadings.size(), false);
+         for(size_t i = 0; i < m_tReadings.size(); ++i) {
+            if(vecStored[i]) continue;
+            SAnchorPose sPose;
+            sPose.Anchor = &m_pcProximityEntity->GetSensor(i).Anchor;
+            sPose.Valid = false;
+            sPose.FirstRay = m_vecRaySensors.size();
+            for(size_t j = i; j < m_tReadings.size(); ++j) {
+               const CProximitySensorEquippedEntity::SSensor& sSensor = m_pcProximityEntity->GetSensor(j);
+               if(&sSensor.Anchor == sPose.Anchor) {
+                  m_vecRaySensors.push_back(j);
+                  m_cLocalRayStarts.PushBack(sSensor.Offset);
+                  m_cLocalRayEnds.PushBack(sSensor.Offset + sSensor.Direction);
+                  vecStored[j] = true;
+               }
+            }
+            sPose.NumRays = m_vecRaySensors.size() - sPose.FirstRay;
+            m_vecAnchorPoses.push_back(sPose);
+         }
+         m_cRayStarts.Resize(m_tReadings.size());
+         m_cRayEnds.Resize(m_tReadings.size());
+         m_vecRays.resize(m_tReadings.size());
       }
       catch(CARGoSException& ex) {
          THROW_ARGOSEXCEPTION_NESTED("Initialization error in default proximity sensor", ex);
@@ -73,27 +140,95 @@ namespace argos {
    /****************************************/
    
    void CProximityDefaultSensor::Update() {
-      /* Ray used for scanning the environment for obstacles */
-      CRay3 cScanningRay;
-      CVector3 cRayStart, cRayEnd;
-      /* Buffers to contain data about the intersection */
-      SEmbodiedEntityIntersectionItem sIntersection;
+      if(m_tReadings.empty()) return;
+      /* Compute the rays */
+      UpdateRays();
+      /* Get the closest intersection of each ray */
+      GetClosestEmbodiedEntitiesIntersectedByRays(m_vecIntersections,
+                                                  m_vecRays,
+                                                  m_pcEmbodiedEntity);
+      /* Compute the readings */
+      UpdateReadings(&m_vecIntersections[0]);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CProximityDefaultSensor::BatchUpdate(CSimulatedSensor** ppc_sensors,
+                                             size_t un_num_sensors) {
+      /*
+       * The buffers are reused across steps, so they only allocate when the
+       * number of rays grows. The batch updates run in the main thread.
+       */
+      static std::vector<CRay3> vecRays;
+      static std::vector<CEmbodiedEntity*> vecExcluded;
+      static std::vector<SEmbodiedEntityIntersectionItem> vecIntersections;
+      vecRays.clear();
+      vecExcluded.clear();
+      /* Compute the rays of all the sensors */
+      for(size_t i = 0; i < un_num_sensors; ++i) {
+         CProximityDefaultSensor& cSensor = static_cast<CProximityDefaultSensor&>(*ppc_sensors[i]);
+         cSensor.UpdateRays();
+         vecRays.insert(vecRays.end(), cSensor.m_vecRays.begin(), cSensor.m_vecRays.end());
+         vecExcluded.insert(vecExcluded.end(), cSensor.m_vecRays.size(), cSensor.m_pcEmbodiedEntity);
+      }
+      /* Get the closest intersection of each ray, in one batch */
+      GetClosestEmbodiedEntitiesIntersectedByRays(vecIntersections,
+                                                  vecRays,
+                                                  vecExcluded);
+      /* Compute the readings of each sensor */
+      size_t unFirstRay = 0;
+      for(size_t i = 0; i < un_num_sensors; ++i) {
+         CProximityDefaultSensor& cSensor = static_cast<CProximityDefaultSensor&>(*ppc_sensors[i]);
+         if(!cSensor.m_vecRays.empty()) {
+            cSensor.UpdateReadings(&vecIntersections[unFirstRay]);
+            unFirstRay += cSensor.m_vecRays.size();
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CProximityDefaultSensor::UpdateRays() {
+      for(size_t i = 0; i < m_vecAnchorPoses.size(); ++i) {
+         SAnchorPose& sPose = m_vecAnchorPoses[i];
+         /* The rays of an anchor that did not move are still valid */
+         if(sPose.Valid &&
+            sPose.Position == sPose.Anchor->Position &&
+            sPose.Orientation == sPose.Anchor->Orientation) {
+            continue;
+         }
+         sPose.Position = sPose.Anchor->Position;
+         sPose.Orientation = sPose.Anchor->Orientation;
+         sPose.Valid = true;
+         /* Transform the rays of the anchor */
+         m_cLocalRayStarts.Transform(m_cRayStarts,
+                                     sPose.Orientation,
+                                     sPose.Position,
+                                     sPose.FirstRay,
+                                     sPose.NumRays);
+         m_cLocalRayEnds.Transform(m_cRayEnds,
+                                   sPose.Orientation,
+                                   sPose.Position,
+                                   sPose.FirstRay,
+                                   sPose.NumRays);
+         for(size_t j = sPose.FirstRay; j < sPose.FirstRay + sPose.NumRays; ++j) {
+            m_vecRays[m_vecRaySensors[j]].Set(m_cRayStarts.Get(j),
+                                              m_cRayEnds.Get(j));
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CProximityDefaultSensor::UpdateReadings(const SEmbodiedEntityIntersectionItem* ps_intersections) {
       /* Go through the sensors */
       for(UInt32 i = 0; i < m_tReadings.size(); ++i) {
-         /* Compute ray for sensor i */
-         cRayStart = m_pcProximityEntity->GetSensor(i).Offset;
-         cRayStart.Rotate(m_pcProximityEntity->GetSensor(i).Anchor.Orientation);
-         cRayStart += m_pcProximityEntity->GetSensor(i).Anchor.Position;
-         cRayEnd = m_pcProximityEntity->GetSensor(i).Offset;
-         cRayEnd += m_pcProximityEntity->GetSensor(i).Direction;
-         cRayEnd.Rotate(m_pcProximityEntity->GetSensor(i).Anchor.Orientation);
-         cRayEnd += m_pcProximityEntity->GetSensor(i).Anchor.Position;
-         cScanningRay.Set(cRayStart,cRayEnd);
-         /* Compute reading */
-         /* Get the closest intersection */
-         if(GetClosestEmbodiedEntityIntersectedByRay(sIntersection,
-                                                     cScanningRay,
-                                                     *m_pcEmbodiedEntity)) {
+         const CRay3& cScanningRay = m_vecRays[i];
+         const SEmbodiedEntityIntersectionItem& sIntersection = ps_intersections[i];
+         if(sIntersection.IntersectedEntity != NULL) {
             /* There is an intersection */
             if(m_bShowRays) {
                m_pcControllableEntity->AddIntersectionPoint(cScanningRay,
@@ -125,6 +260,10 @@ namespace argos {
       for(UInt32 i = 0; i < GetReadings().size(); ++i) {
          m_tReadings[i] = 0.0f;
       }
+      /* Recalculate all the rays at the next update */
+      for(size_t i = 0; i < m_vecAnchorPoses.size(); ++i) {
+         m_vecAnchorPoses[i].Valid = false;
+      }
    }
 
    /****************************************/
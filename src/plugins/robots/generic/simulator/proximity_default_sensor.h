@@ -20,6 +20,11 @@ namespace argos {
 #include <argos3/core/utility/math/rng.h>
 #include <argos3/core/simulator/space/space.h>
 #include <argos3/core/simulator/sensor.h>
+#include <argos3/core/simulator/physics_engine/physics_engine.h>
+#include <argos3/core/simulator/physics_engine/physics_model.h>
+#include <argos3/core/utility/math/ray3.h>
+#include <argos3/core/utility/math/vector3_array.h>
+#include <vector>
 
 namespace argos {
 
@@ -36,10 +41,38 @@ namespace argos {
 
       virtual void Init(TConfigurationNode& t_tree);
 
+      /**
+       * Parses the attributes of the sensor, once for all the robots.
+       * @param t_tree The XML configuration of the sensor.
+       * @return The parsed configuration.
+       */
+      virtual CSimulatedSensor::SConfiguration* ParseConfiguration(TConfigurationNode& t_tree);
+
+      /**
+       * Initializes the sensor from the parsed attributes.
+       * @param s_config The parsed configuration.
+       */
+      virtual void InitFromConfiguration(const CSimulatedSensor::SConfiguration& s_config);
+
       virtual void Update();
 
       virtual void Reset();
 
+      virtual TBatchUpdate* GetBatchUpdate() {
+         return &BatchUpdate;
+      }
+
+      /**
+       * Updates the given proximity sensors in one pass.
+       * The rays of all the sensors are checked in one batch.
+       * Subclasses that override Update() must also override GetBatchUpdate().
+       * @param ppc_sensors The sensors.
+       * @param un_num_sensors The number of sensors.
+       * @see CSimulatedSensor::GetBatchUpdate()
+       */
+      static void BatchUpdate(CSimulatedSensor** ppc_sensors,
+                              size_t un_num_sensors);
+
       /**
        * Calculates the proximity reading when the closest occluding object is located as the given distance.
        * @param f_distance The distance of the closest occluding object in meters
@@ -63,6 +96,19 @@ namespace argos {
          m_bShowRays = b_show_rays;
       }
 
+   protected:
+
+      /**
+       * The parsed attributes of the sensor.
+       */
+      struct SProximityConfiguration : public CSimulatedSensor::SConfiguration {
+         bool ShowRays;
+         Real NoiseLevel;
+      };
+
+      static void ParseProximity(TConfigurationNode& t_tree,
+                                 SProximityConfiguration& s_config);
+
    protected:
 
       /** Reference to embodied entity associated to this sensor */
@@ -88,6 +134,54 @@ namespace argos {
 
       /** Reference to the space */
       CSpace& m_cSpace;
+
+   protected:
+
+      /**
+       * Calculates the scanning rays of the sensors whose anchor moved since the last update.
+       */
+      void UpdateRays();
+
+      /**
+       * Calculates the readings from the intersections of the scanning rays.
+       * @param ps_intersections The intersection of each ray.
+       */
+      void UpdateReadings(const SEmbodiedEntityIntersectionItem* ps_intersections);
+
+   protected:
+
+      /** The anchors of the sensors, with their pose when the rays were calculated */
+      struct SAnchorPose {
+         const SAnchor* Anchor;
+         CVector3 Position;
+         CQuaternion Orientation;
+         /** Whether the pose was ever stored */
+         bool Valid;
+         /** The range of the sensors of the anchor in the ray arrays */
+         size_t FirstRay;
+         size_t NumRays;
+      };
+      std::vector<SAnchorPose> m_vecAnchorPoses;
+
+      /**
+       * The sensor of each entry of the ray arrays.
+       * The entries are grouped by anchor.
+       */
+      std::vector<size_t> m_vecRaySensors;
+
+      /** The ray starts and ends in the anchor frame */
+      CVector3Array m_cLocalRayStarts;
+      CVector3Array m_cLocalRayEnds;
+
+      /** The ray starts and ends in the global frame */
+      CVector3Array m_cRayStarts;
+      CVector3Array m_cRayEnds;
+
+      /** The scanning ray of each sensor */
+      std::vector<CRay3> m_vecRays;
+
+      /** The intersection of each scanning ray */
+      std::vector<SEmbodiedEntityIntersectionItem> m_vecIntersections;
    };
 
 }
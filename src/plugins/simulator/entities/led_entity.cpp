@@ -66,6 +66,27 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CLEDEntity::SaveState(CByteArray& c_buffer) {
+      CPositionalEntity::SaveState(c_buffer);
+      c_buffer << m_cColor.GetRed()
+               << m_cColor.GetGreen()
+               << m_cColor.GetBlue()
+               << m_cColor.GetAlpha();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLEDEntity::LoadState(CByteArray& c_buffer) {
+      CPositionalEntity::LoadState(c_buffer);
+      UInt8 unRed, unGreen, unBlue, unAlpha;
+      c_buffer >> unRed >> unGreen >> unBlue >> unAlpha;
+      m_cColor.Set(unRed, unGreen, unBlue, unAlpha);
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CLEDEntity::SetEnabled(bool b_enabled) {
       /* Perform generic enable behavior */
       CEntity::SetEnabled(b_enabled);
@@ -242,14 +242,30 @@ namespace argos {
    /****************************************/
 
    void CLEDEquippedEntity::UpdateComponents() {
-      /* LED position wrt global reference frame */
-      CVector3 cLEDPosition;
+      /* Collect the LED offsets */
+      m_cLEDOffsets.Resize(m_tLEDs.size());
+      m_cLEDPositions.Resize(m_tLEDs.size());
+      for(UInt32 i = 0; i < m_tLEDs.size(); ++i) {
+         m_cLEDOffsets.Set(i, m_tLEDs[i]->Offset);
+      }
+      /* LED position wrt global reference frame, transforming the
+         consecutive LEDs that share an anchor in one batch */
+      for(UInt32 i = 0; i < m_tLEDs.size();) {
+         const SAnchor& sAnchor = m_tLEDs[i]->Anchor;
+         UInt32 j = i + 1;
+         while(j < m_tLEDs.size() && &m_tLEDs[j]->Anchor == &sAnchor) {
+            ++j;
+         }
+         m_cLEDOffsets.Transform(m_cLEDPositions,
+                                 sAnchor.Orientation,
+                                 sAnchor.Position,
+                                 i,
+                                 j - i);
+         i = j;
+      }
       for(UInt32 i = 0; i < m_tLEDs.size(); ++i) {
          if(m_tLEDs[i]->LED.IsEnabled()) {
-            cLEDPosition = m_tLEDs[i]->Offset;
-            cLEDPosition.Rotate(m_tLEDs[i]->Anchor.Orientation);
-            cLEDPosition += m_tLEDs[i]->Anchor.Position;
-            m_tLEDs[i]->LED.SetPosition(cLEDPosition);
+            m_tLEDs[i]->LED.SetPosition(m_cLEDPositions.Get(i));
          }
       }
    }
@@ -14,6 +14,7 @@ namespace argos {
 
 #include <argos3/core/simulator/entity/composable_entity.h>
 #include <argos3/plugins/simulator/entities/led_entity.h>
+#include <argos3/core/utility/math/vector3_array.h>
 #include <map>
 
 namespace argos {
@@ -194,6 +195,10 @@ namespace argos {
 
       /** List of the LEDs managed by this entity */
       SActuator::TList m_tLEDs;
+
+      /** Buffers for the LED offsets and positions, transformed in batches */
+      CVector3Array m_cLEDOffsets;
+      CVector3Array m_cLEDPositions;
    };
 
 }
@@ -8,6 +8,7 @@
 #include <argos3/core/simulator/simulator.h>
 #include <argos3/core/simulator/space/space.h>
 #include <argos3/plugins/simulator/media/led_medium.h>
+#include <argos3/plugins/simulator/media/light_medium.h>
 
 namespace argos {
 
@@ -16,7 +17,8 @@ namespace argos {
 
    CLightEntity::CLightEntity() :
       CLEDEntity(NULL),
-      m_fIntensity(1.0f) {}
+      m_fIntensity(1.0f),
+      m_pcLightMedium(NULL) {}
       
    /****************************************/
    /****************************************/
@@ -29,7 +31,8 @@ namespace argos {
                  str_id,
                  c_position,
                  c_color),
-      m_fIntensity(f_intensity) {}
+      m_fIntensity(f_intensity),
+      m_pcLightMedium(NULL) {}
 
    /****************************************/
    /****************************************/
@@ -44,6 +47,11 @@ namespace argos {
          GetNodeAttribute(t_tree, "medium", strMedium);
          CLEDMedium& cLEDMedium = CSimulator::GetInstance().GetMedium<CLEDMedium>(strMedium);
          cLEDMedium.AddEntity(*this);
+         /* Optional light medium, added to when the light enters the space */
+         if(NodeAttributeExists(t_tree, "light_medium")) {
+            GetNodeAttribute(t_tree, "light_medium", strMedium);
+            SetLightMedium(CSimulator::GetInstance().GetMedium<CLightMedium>(strMedium));
+         }
       }
       catch(CARGoSException& ex) {
          THROW_ARGOSEXCEPTION_NESTED("Error while initializing light entity", ex);
@@ -53,6 +61,67 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CLightEntity::SetEnabled(bool b_enabled) {
+      CLEDEntity::SetEnabled(b_enabled);
+      if(b_enabled) {
+         /* Enable entity in the light medium */
+         if(m_pcLightMedium && GetIndex() >= 0)
+            m_pcLightMedium->AddEntity(*this);
+      }
+      else {
+         /* Disable entity in the light medium */
+         if(m_pcLightMedium)
+            m_pcLightMedium->RemoveEntity(*this);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CLightMedium& CLightEntity::GetLightMedium() const {
+      if(m_pcLightMedium == NULL) {
+         THROW_ARGOSEXCEPTION("Light entity \"" << GetContext() << GetId() << "\" has no light medium associated.");
+      }
+      return *m_pcLightMedium;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightEntity::SetLightMedium(CLightMedium& c_medium) {
+      if(m_pcLightMedium != NULL && m_pcLightMedium != &c_medium)
+         m_pcLightMedium->RemoveEntity(*this);
+      m_pcLightMedium = &c_medium;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CLightEntityGridUpdater::CLightEntityGridUpdater(CGrid<CLightEntity>& c_grid) :
+      m_cGrid(c_grid),
+      m_fMaxIntensity(0.0f) {}
+
+   /****************************************/
+   /****************************************/
+
+   bool CLightEntityGridUpdater::operator()(CLightEntity& c_entity) {
+      /* Discard lights that emit nothing */
+      if(c_entity.GetIntensity() > 0.0f) {
+         /* Calculate the position of the light in the grid; lights outside
+            the arena are kept in the closest border cell */
+         m_cGrid.PositionToCellUnsafe(m_nI, m_nJ, m_nK, c_entity.GetPosition());
+         m_cGrid.ClampCoordinates(m_nI, m_nJ, m_nK);
+         /* Update the corresponding cell */
+         m_cGrid.UpdateCell(m_nI, m_nJ, m_nK, c_entity);
+         m_fMaxIntensity = Max(m_fMaxIntensity, c_entity.GetIntensity());
+      }
+      /* Continue with the other entities */
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
    REGISTER_ENTITY(CLightEntity,
                    "light",
                    "Carlo Pinciroli [ilpincy@gmail.com]",
@@ -90,14 +159,48 @@ namespace argos {
                    "those of the cameras.\n"
                    "The 'medium' attribute is used to add the light the corresponding LED medium.\n\n"
                    "OPTIONAL XML CONFIGURATION\n\n"
-                   "None.\n",
+                   "The 'light_medium' attribute adds the light to a light medium, which indexes\n"
+                   "the lights by position. Light sensors configured with the same medium only\n"
+                   "consider the lights that are close enough to affect their readings:\n\n"
+                   "  <arena ...>\n"
+                   "    ...\n"
+                   "    <light id=\"light0\"\n"
+                   "           ...\n"
+                   "           medium=\"leds\"\n"
+                   "           light_medium=\"lights\"/>\n"
+                   "    ...\n"
+                   "  </arena>\n",
                    "Usable"
       );
 
    /****************************************/
    /****************************************/
 
-   REGISTER_STANDARD_SPACE_OPERATIONS_ON_ENTITY(CLightEntity);
+   class CSpaceOperationAddCLightEntity : public CSpaceOperationAddEntity {
+   public:
+      void ApplyTo(CSpace& c_space, CLightEntity& c_entity) {
+         /* Add entity to space - this ensures that the light entity
+          * gets an id before being added to the light medium */
+         c_space.AddEntity(c_entity);
+         /* Enable the light entity, if it's enabled - this ensures that
+          * the entity gets added to the light medium if it's enabled */
+         c_entity.SetEnabled(c_entity.IsEnabled());
+      }
+   };
+
+   class CSpaceOperationRemoveCLightEntity : public CSpaceOperationRemoveEntity {
+   public:
+      void ApplyTo(CSpace& c_space, CLightEntity& c_entity) {
+         /* Disable the entity - this ensures that the entity is
+          * removed from the light medium */
+         c_entity.Disable();
+         /* Remove the light entity from space */
+         c_space.RemoveEntity(c_entity);
+      }
+   };
+
+   REGISTER_SPACE_OPERATION(CSpaceOperationAddEntity, CSpaceOperationAddCLightEntity, CLightEntity);
+   REGISTER_SPACE_OPERATION(CSpaceOperationRemoveEntity, CSpaceOperationRemoveCLightEntity, CLightEntity);
 
    /****************************************/
    /****************************************/
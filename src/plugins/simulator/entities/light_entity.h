@@ -10,9 +10,11 @@
 namespace argos {
    class CLightEntity;
    class CLedEquippedEntity;
+   class CLightMedium;
 }
 
 #include <argos3/core/simulator/entity/positional_entity.h>
+#include <argos3/core/simulator/space/positional_indices/grid.h>
 #include <argos3/plugins/simulator/entities/led_equipped_entity.h>
 
 namespace argos {
@@ -46,11 +48,72 @@ namespace argos {
          return "light";
       }
 
+      virtual void SetEnabled(bool b_enabled);
+
+      /**
+       * Returns true if this light is associated to a light medium.
+       * @return true if this light is associated to a light medium.
+       * @see CLightMedium
+       */
+      inline bool HasLightMedium() const {
+         return m_pcLightMedium != NULL;
+      }
+
+      /**
+       * Returns the light medium associated to this light.
+       * @return The light medium associated to this light.
+       * @throw CARGoSException if no light medium is associated.
+       * @see CLightMedium
+       */
+      CLightMedium& GetLightMedium() const;
+
+      /**
+       * Sets the light medium associated to this light.
+       * @param c_medium The light medium.
+       * @see CLightMedium
+       */
+      void SetLightMedium(CLightMedium& c_medium);
+
    protected:
 
       Real m_fIntensity;
+
+      CLightMedium* m_pcLightMedium;
    };
 
+   /****************************************/
+   /****************************************/
+
+   class CLightEntityGridUpdater : public CGrid<CLightEntity>::COperation {
+
+   public:
+
+      CLightEntityGridUpdater(CGrid<CLightEntity>& c_grid);
+      virtual bool operator()(CLightEntity& c_entity);
+
+      /**
+       * Returns the highest intensity among the lights indexed since the
+       * last call to ResetMaxIntensity().
+       */
+      inline Real GetMaxIntensity() const {
+         return m_fMaxIntensity;
+      }
+
+      inline void ResetMaxIntensity() {
+         m_fMaxIntensity = 0.0f;
+      }
+
+   private:
+
+      CGrid<CLightEntity>& m_cGrid;
+      SInt32 m_nI, m_nJ, m_nK;
+      Real m_fMaxIntensity;
+
+   };
+
+   /****************************************/
+   /****************************************/
+
 }
 
 #endif
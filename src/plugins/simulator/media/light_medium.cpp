@@ -0,0 +1,211 @@
+/**
+ * @file <argos3/plugins/simulator/media/light_medium.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "light_medium.h"
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/simulator/space/positional_indices/grid.h>
+#include <argos3/core/utility/configuration/argos_exception.h>
+#include <argos3/core/utility/logging/argos_log.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   /**
+    * Collects the lights whose perception range contains a point.
+    */
+   class CLightInRangeCollector : public CPositionalIndex<CLightEntity>::COperation {
+
+   public:
+
+      CLightInRangeCollector(std::vector<CLightEntity*>& vec_lights,
+                             const CVector3& c_point,
+                             Real f_range_per_intensity,
+                             Real f_margin) :
+         m_vecLights(vec_lights),
+         m_cPoint(c_point),
+         m_fRangePerIntensity(f_range_per_intensity),
+         m_fMargin(f_margin) {}
+
+      virtual bool operator()(CLightEntity& c_light) {
+         if(c_light.GetIntensity() > 0.0f) {
+            if(m_fRangePerIntensity <= 0.0f) {
+               m_vecLights.push_back(&c_light);
+            }
+            else {
+               Real fRange = m_fRangePerIntensity * c_light.GetIntensity() + m_fMargin;
+               if(SquareDistance(c_light.GetPosition(), m_cPoint) <= fRange * fRange) {
+                  m_vecLights.push_back(&c_light);
+               }
+            }
+         }
+         return true;
+      }
+
+   private:
+
+      std::vector<CLightEntity*>& m_vecLights;
+      const CVector3& m_cPoint;
+      Real m_fRangePerIntensity;
+      Real m_fMargin;
+
+   };
+
+   /****************************************/
+   /****************************************/
+
+   CLightMedium::CLightMedium() :
+      m_pcLightEntityIndex(NULL),
+      m_pcLightEntityGridUpdateOperation(NULL) {
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CLightMedium::~CLightMedium() {
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightMedium::Init(TConfigurationNode& t_tree) {
+      try {
+         CMedium::Init(t_tree);
+         /* Get the positional index method */
+         std::string strPosIndexMethod("grid");
+         GetNodeAttributeOrDefault(t_tree, "index", strPosIndexMethod, strPosIndexMethod);
+         /* Get the arena center and size */
+         CVector3 cArenaCenter;
+         CVector3 cArenaSize;
+         TConfigurationNode& tArena = GetNode(CSimulator::GetInstance().GetConfigurationRoot(), "arena");
+         GetNodeAttribute(tArena, "size", cArenaSize);
+         GetNodeAttributeOrDefault(tArena, "center", cArenaCenter, cArenaCenter);
+         /* Create the positional index for light entities */
+         if(strPosIndexMethod == "grid") {
+            size_t punGridSize[3];
+            if(!NodeAttributeExists(t_tree, "grid_size")) {
+               punGridSize[0] = Max<size_t>(1, cArenaSize.GetX());
+               punGridSize[1] = Max<size_t>(1, cArenaSize.GetY());
+               punGridSize[2] = Max<size_t>(1, cArenaSize.GetZ());
+            }
+            else {
+               std::string strPosGridSize;
+               GetNodeAttribute(t_tree, "grid_size", strPosGridSize);
+               ParseValues<size_t>(strPosGridSize, 3, punGridSize, ',');
+            }
+            CGrid<CLightEntity>* pcGrid = new CGrid<CLightEntity>(
+               cArenaCenter - cArenaSize * 0.5f, cArenaCenter + cArenaSize * 0.5f,
+               punGridSize[0], punGridSize[1], punGridSize[2]);
+            m_pcLightEntityGridUpdateOperation = new CLightEntityGridUpdater(*pcGrid);
+            pcGrid->SetUpdateEntityOperation(m_pcLightEntityGridUpdateOperation);
+            m_pcLightEntityIndex = pcGrid;
+         }
+         else {
+            THROW_ARGOSEXCEPTION("Unknown method \"" << strPosIndexMethod << "\" for the positional index.");
+         }
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("Error in initialization of the light medium", ex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightMedium::PostSpaceInit() {
+      Update();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightMedium::Reset() {
+      m_pcLightEntityIndex->Reset();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightMedium::Destroy() {
+      delete m_pcLightEntityIndex;
+      if(m_pcLightEntityGridUpdateOperation != NULL) {
+         delete m_pcLightEntityGridUpdateOperation;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightMedium::Update() {
+      m_pcLightEntityGridUpdateOperation->ResetMaxIntensity();
+      m_pcLightEntityIndex->Update();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightMedium::AddEntity(CLightEntity& c_entity) {
+      m_pcLightEntityIndex->AddEntity(c_entity);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightMedium::RemoveEntity(CLightEntity& c_entity) {
+      m_pcLightEntityIndex->RemoveEntity(c_entity);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CLightMedium::GetLightsInRange(std::vector<CLightEntity*>& vec_lights,
+                                       const CVector3& c_point,
+                                       Real f_range_per_intensity,
+                                       Real f_margin) const {
+      vec_lights.clear();
+      CLightInRangeCollector cCollector(vec_lights, c_point, f_range_per_intensity, f_margin);
+      if(f_range_per_intensity <= 0.0f) {
+         m_pcLightEntityIndex->ForAllEntities(cCollector);
+      }
+      else {
+         /* Only the cells within reach of the most intense light can contain
+            a light in range */
+         Real fRange = f_range_per_intensity * m_pcLightEntityGridUpdateOperation->GetMaxIntensity() + f_margin;
+         if(fRange > 0.0f) {
+            m_pcLightEntityIndex->ForEntitiesInBoxRange(c_point,
+                                                        CVector3(fRange, fRange, fRange),
+                                                        cCollector);
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_MEDIUM(CLightMedium,
+                   "light",
+                   "agent [agent@local]",
+                   "1.0",
+                   "Manages the lights.",
+                   "This medium indexes the light entities by position. The light sensors that\n"
+                   "support it use the index to consider only the lights that can affect their\n"
+                   "readings, instead of checking every light in the arena. Lights are added to\n"
+                   "this medium with the 'light_medium' attribute of the light entity.\n\n"
+                   "REQUIRED XML CONFIGURATION\n\n"
+                   "<light id=\"lights\" />\n\n"
+                   "OPTIONAL XML CONFIGURATION\n\n"
+                   "The 'grid_size' attribute sets the number of cells of the positional index\n"
+                   "along X, Y and Z. By default, the cells are one meter wide:\n\n"
+                   "<light id=\"lights\" grid_size=\"20,20,1\" />\n",
+                   "Usable"
+      );
+
+   /****************************************/
+   /****************************************/
+
+}
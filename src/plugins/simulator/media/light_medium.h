@@ -0,0 +1,115 @@
+/**
+ * @file <argos3/plugins/simulator/media/light_medium.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef LIGHT_MEDIUM_H
+#define LIGHT_MEDIUM_H
+
+namespace argos {
+   class CLightMedium;
+   class CLightEntity;
+}
+
+#include <argos3/core/simulator/medium/medium.h>
+#include <argos3/core/utility/configuration/memento.h>
+#include <argos3/core/simulator/space/positional_indices/positional_index.h>
+#include <argos3/plugins/simulator/entities/light_entity.h>
+#include <vector>
+
+namespace argos {
+
+   /**
+    * A medium that indexes the light entities by position.
+    *
+    * Light sensors use this medium to consider only the lights whose
+    * contribution to a reading can be above a cutoff, instead of going
+    * through every light in the arena.
+    */
+   class CLightMedium : public CMedium,
+                        public CMemento {
+
+   public:
+
+      /**
+       * Class constructor.
+       */
+      CLightMedium();
+
+      /**
+       * Class destructor.
+       */
+      virtual ~CLightMedium();
+
+      virtual void Init(TConfigurationNode& t_tree);
+      virtual void PostSpaceInit();
+      virtual void Reset();
+      virtual void Destroy();
+      virtual void Update();
+
+      /**
+       * Saves nothing: the light index is rebuilt in Update() from the
+       * light entities.
+       * @param c_buffer The target buffer.
+       */
+      virtual void SaveState(CByteArray& c_buffer) {}
+
+      /**
+       * Restores nothing.
+       * @param c_buffer The source buffer.
+       * @see SaveState()
+       */
+      virtual void LoadState(CByteArray& c_buffer) {}
+
+     /**
+      * Adds the specified entity to the list of managed entities.
+      * @param c_entity The entity to add.
+      */
+      void AddEntity(CLightEntity& c_entity);
+
+     /**
+      * Removes the specified entity from the list of managed entities.
+      * @param c_entity The entity to remove.
+      */
+      void RemoveEntity(CLightEntity& c_entity);
+
+      /**
+       * Collects the lights that can be perceived from around the given point.
+       * A light of intensity <em>I</em> is collected if its intensity is
+       * positive and its distance from the point is at most
+       * <em>I</em> * <tt>f_range_per_intensity</tt> + <tt>f_margin</tt>.
+       * When <tt>f_range_per_intensity</tt> is not positive, all the lights
+       * with positive intensity are collected.
+       * The grid cells are those of the last call to Update().
+       * @param vec_lights The buffer to fill; it is cleared first.
+       * @param c_point The point.
+       * @param f_range_per_intensity The perception range of a light of unit intensity.
+       * @param f_margin A distance added to the range, e.g., the radius of a robot.
+       */
+      void GetLightsInRange(std::vector<CLightEntity*>& vec_lights,
+                            const CVector3& c_point,
+                            Real f_range_per_intensity,
+                            Real f_margin = 0.0f) const;
+
+      /**
+       * Returns the light positional index.
+       * @return The light positional index.
+       */
+      CPositionalIndex<CLightEntity>& GetIndex() {
+         return *m_pcLightEntityIndex;
+      }
+
+   private:
+
+      /** A positional index for the light entities */
+      CPositionalIndex<CLightEntity>* m_pcLightEntityIndex;
+
+      /** The update operation for the grid positional index */
+      CLightEntityGridUpdater* m_pcLightEntityGridUpdateOperation;
+
+   };
+
+}
+
+#endif
@@ -137,7 +137,7 @@ namespace argos {
           it != m_tRoutingTable.end();
           ++it) {
          /* Get a reference to the current RAB entity */
-         CRABEquippedEntity& cRAB = *reinterpret_cast<CRABEquippedEntity*>(GetSpace().GetEntityVector()[it->first]);
+         CRABEquippedEntity& cRAB = *reinterpret_cast<CRABEquippedEntity*>(&GetSpace().GetEntityAtIndex(it->first));
          /* Initialize the occlusion check ray start to the position of the robot */
          cOcclusionCheckRay.SetStart(cRAB.GetPosition());
          /* For each RAB entity, get the list of RAB entities in range */
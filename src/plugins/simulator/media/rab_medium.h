@@ -7,13 +7,15 @@ namespace argos {
 }
 
 #include <argos3/core/simulator/medium/medium.h>
+#include <argos3/core/utility/configuration/memento.h>
 #include <argos3/core/simulator/space/positional_indices/positional_index.h>
 #include <argos3/plugins/robots/generic/control_interface/ci_range_and_bearing_sensor.h>
 #include <argos3/plugins/simulator/entities/rab_equipped_entity.h>
 
 namespace argos {
 
-   class CRABMedium : public CMedium {
+   class CRABMedium : public CMedium,
+                      public CMemento {
 
    public:
 
@@ -33,6 +35,20 @@ namespace argos {
       virtual void Destroy();
       virtual void Update();
 
+      /**
+       * Saves nothing: the routing table is rebuilt in Update(), before
+       * the robots sense.
+       * @param c_buffer The target buffer.
+       */
+      virtual void SaveState(CByteArray& c_buffer) {}
+
+      /**
+       * Restores nothing.
+       * @param c_buffer The source buffer.
+       * @see SaveState()
+       */
+      virtual void LoadState(CByteArray& c_buffer) {}
+
       /**
        * Adds the specified entity to the list of managed entities.
        * @param c_entity The entity to add.
@@ -13,12 +13,14 @@ namespace argos {
 }
 
 #include <argos3/core/simulator/medium/medium.h>
+#include <argos3/core/utility/configuration/memento.h>
 #include <argos3/core/simulator/space/positional_indices/positional_index.h>
 #include <argos3/plugins/simulator/entities/tag_entity.h>
 
 namespace argos {
 
-   class CTagMedium : public CMedium {
+   class CTagMedium : public CMedium,
+                      public CMemento {
 
    public:
 
@@ -40,6 +42,20 @@ namespace argos {
       virtual void Destroy();
       virtual void Update();
 
+      /**
+       * Saves nothing: the positional index of the tags is rebuilt in
+       * Update() from the entities.
+       * @param c_buffer The target buffer.
+       */
+      virtual void SaveState(CByteArray& c_buffer) {}
+
+      /**
+       * Restores nothing.
+       * @param c_buffer The source buffer.
+       * @see SaveState()
+       */
+      virtual void LoadState(CByteArray& c_buffer) {}
+
      /**
       * Adds the specified entity to the list of managed entities.
       * @param c_entity The entity to add.
@@ -12,6 +12,8 @@
 #include <argos3/core/simulator/entity/embodied_entity.h>
 
 #include <cmath>
+#include <algorithm>
+#include <time.h>
 
 namespace argos {
 
@@ -25,7 +27,23 @@ namespace argos {
       m_fCylinderAngularFriction(1.49),
       m_ptSpace(NULL),
       m_ptGroundBody(NULL),
-      m_fElevation(0.0f) {
+      m_fElevation(0.0f),
+      m_eSpatialIndex(SPATIAL_INDEX_BBTREE),
+      m_fSpatialHashCellSize(0.0f),
+      m_unSpatialHashCellNum(0),
+      m_bAdaptiveSpatialIndex(false),
+      m_unAdaptiveIndexPeriod(1000),
+      m_unAdaptiveIndexSteps(10),
+      m_fAdaptiveIndexMinGain(0.1),
+      m_eAdaptiveIndexPhase(ADAPTIVE_INDEX_IDLE),
+      m_eAdaptiveIndexPrevious(SPATIAL_INDEX_BBTREE),
+      m_unAdaptiveIndexCounter(0),
+      m_unAdaptiveIndexTimeCurrent(0),
+      m_unAdaptiveIndexTimeAlternate(0),
+      m_bAdaptiveIndexReported(false),
+      m_bAdaptiveIndexEvaluated(false),
+      m_fAdaptiveIndexEvaluatedCellSize(0.0f),
+      m_unAdaptiveIndexEvaluatedCellNum(0) {
    }
 
    /****************************************/
@@ -63,11 +81,22 @@ namespace argos {
          /* Spatial hash */
          if(NodeExists(t_tree, "spatial_hash")) {
             TConfigurationNode& tNode = GetNode(t_tree, "spatial_hash");
-            cpFloat fSize;
-            UInt32 unNum;
-            GetNodeAttribute(tNode, "cell_size", fSize);
-            GetNodeAttribute(tNode, "cell_num",  unNum);
-            cpSpaceUseSpatialHash(m_ptSpace, fSize, unNum);
+            GetNodeAttribute(tNode, "cell_size", m_fSpatialHashCellSize);
+            GetNodeAttribute(tNode, "cell_num",  m_unSpatialHashCellNum);
+            SetSpatialIndex(SPATIAL_INDEX_HASH);
+         }
+         /* Adaptive spatial index */
+         if(NodeExists(t_tree, "adaptive_spatial_index")) {
+            TConfigurationNode& tNode = GetNode(t_tree, "adaptive_spatial_index");
+            m_bAdaptiveSpatialIndex = true;
+            GetNodeAttributeOrDefault(tNode, "period",   m_unAdaptiveIndexPeriod, m_unAdaptiveIndexPeriod);
+            GetNodeAttributeOrDefault(tNode, "steps",    m_unAdaptiveIndexSteps,  m_unAdaptiveIndexSteps);
+            GetNodeAttributeOrDefault(tNode, "min_gain", m_fAdaptiveIndexMinGain, m_fAdaptiveIndexMinGain);
+            if(m_unAdaptiveIndexSteps < 2) {
+               THROW_ARGOSEXCEPTION("The 'steps' attribute of <adaptive_spatial_index> must be at least 2");
+            }
+            /* The first evaluation is performed as soon as the simulation starts */
+            m_eAdaptiveIndexPhase = ADAPTIVE_INDEX_MEASURE_CURRENT;
          }
          /* Gripper-Gripped callback functions */
          cpSpaceAddCollisionHandler(
@@ -94,6 +123,33 @@ namespace argos {
          it->second->Reset();
       }
       cpSpaceReindexStatic(m_ptSpace);
+      /* Restart the adaptive spatial index evaluation */
+      if(m_bAdaptiveSpatialIndex) {
+         if(m_eAdaptiveIndexPhase == ADAPTIVE_INDEX_MEASURE_ALTERNATE) {
+            SetSpatialIndex(m_eAdaptiveIndexPrevious);
+         }
+         m_eAdaptiveIndexPhase = ADAPTIVE_INDEX_MEASURE_CURRENT;
+         m_unAdaptiveIndexCounter = 0;
+         m_unAdaptiveIndexTimeCurrent = 0;
+         m_unAdaptiveIndexTimeAlternate = 0;
+         m_bAdaptiveIndexEvaluated = false;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics2DEngine::SaveState(CByteArray& c_buffer) {
+      SaveMementoMap(m_tPhysicsModels, c_buffer);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics2DEngine::LoadState(CByteArray& c_buffer) {
+      CMementoBlockReader cReader(c_buffer);
+      LoadMementoMap(m_tPhysicsModels, cReader);
+      c_buffer.Clear();
    }
 
    /****************************************/
@@ -106,6 +162,10 @@ namespace argos {
          it->second->UpdateFromEntityStatus();
       }
       /* Perform the step */
+      ::timespec tStepStart, tStepEnd;
+      if(m_bAdaptiveSpatialIndex) {
+         ::clock_gettime(CLOCK_MONOTONIC, &tStepStart);
+      }
       for(size_t i = 0; i < GetIterations(); ++i) {
          for(CDynamics2DModel::TMap::iterator it = m_tPhysicsModels.begin();
              it != m_tPhysicsModels.end(); ++it) {
@@ -113,6 +173,12 @@ namespace argos {
          }
          cpSpaceStep(m_ptSpace, GetPhysicsClockTick());
       }
+      if(m_bAdaptiveSpatialIndex) {
+         ::clock_gettime(CLOCK_MONOTONIC, &tStepEnd);
+         UpdateAdaptiveSpatialIndex(
+            (tStepEnd.tv_sec - tStepStart.tv_sec) * 1000000000ull +
+            tStepEnd.tv_nsec - tStepStart.tv_nsec);
+      }
       /* Update the simulated space */
       for(CDynamics2DModel::TMap::iterator it = m_tPhysicsModels.begin();
           it != m_tPhysicsModels.end(); ++it) {
@@ -210,6 +276,175 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CDynamics2DEngine::SetSpatialIndex(ESpatialIndex e_index) {
+      /* Rebuilding the index is expensive, do it only for a different type */
+      if(e_index == m_eSpatialIndex && e_index == SPATIAL_INDEX_BBTREE) {
+         return;
+      }
+      if(e_index == SPATIAL_INDEX_HASH) {
+         cpSpaceUseSpatialHash(m_ptSpace, m_fSpatialHashCellSize, m_unSpatialHashCellNum);
+      }
+      else {
+         cpSpaceUseBBTree(m_ptSpace);
+      }
+      m_eSpatialIndex = e_index;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   struct SDynamics2DShapeStats {
+      std::vector<cpFloat> Sizes;
+      cpBB Bounds;
+   };
+
+   static void Dynamics2DShapeStatsFunc(cpShape* pt_shape, void* pt_data) {
+      SDynamics2DShapeStats& sStats = *reinterpret_cast<SDynamics2DShapeStats*>(pt_data);
+      cpBB tBB = cpShapeGetBB(pt_shape);
+      sStats.Sizes.push_back(Max(tBB.r - tBB.l, tBB.t - tBB.b));
+      sStats.Bounds = sStats.Sizes.size() == 1 ? tBB : cpBBMerge(sStats.Bounds, tBB);
+   }
+
+   bool CDynamics2DEngine::CalculateSpatialHashParameters(cpFloat& f_cell_size,
+                                                          UInt32& un_cell_num) const {
+      /* Collect the size of the bounding box of each shape */
+      SDynamics2DShapeStats sStats;
+      cpSpaceEachShape(const_cast<cpSpace*>(m_ptSpace),
+                       Dynamics2DShapeStatsFunc,
+                       &sStats);
+      if(sStats.Sizes.empty()) return false;
+      /* The cell size is the size of the typical shape, i.e., the median */
+      std::vector<cpFloat>::iterator itMedian = sStats.Sizes.begin() + sStats.Sizes.size() / 2;
+      std::nth_element(sStats.Sizes.begin(), itMedian, sStats.Sizes.end());
+      f_cell_size = Max<cpFloat>(*itMedian, 1e-3);
+      /* The number of cells should be at least 10x the number of shapes,
+         but also enough to cover the populated area without collisions
+         in the hash table, which matters for sparse populations */
+      UInt32 unMinCells = 10 * sStats.Sizes.size();
+      cpFloat fCoveringCells =
+         (sStats.Bounds.r - sStats.Bounds.l) *
+         (sStats.Bounds.t - sStats.Bounds.b) /
+         (f_cell_size * f_cell_size);
+      un_cell_num = Min<UInt32>(
+         Max<UInt32>(unMinCells, static_cast<UInt32>(Ceil(fCoveringCells))),
+         10 * unMinCells);
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   static const char* SpatialIndexName(CDynamics2DEngine::ESpatialIndex e_index) {
+      return (e_index == CDynamics2DEngine::SPATIAL_INDEX_HASH) ? "spatial hash" : "bounding-box tree";
+   }
+
+   /* The relative change of the hash parameters that triggers a new trial of the alternative index */
+   static const Real ADAPTIVE_INDEX_CHANGE_THRESHOLD = 0.1;
+
+   static bool HasChangedSignificantly(Real f_value,
+                                       Real f_reference) {
+      return Abs(f_value - f_reference) > ADAPTIVE_INDEX_CHANGE_THRESHOLD * f_reference;
+   }
+
+   void CDynamics2DEngine::UpdateAdaptiveSpatialIndex(UInt64 un_step_time) {
+      ++m_unAdaptiveIndexCounter;
+      switch(m_eAdaptiveIndexPhase) {
+         case ADAPTIVE_INDEX_IDLE: {
+            if(m_unAdaptiveIndexCounter >= m_unAdaptiveIndexPeriod) {
+               m_eAdaptiveIndexPhase = ADAPTIVE_INDEX_MEASURE_CURRENT;
+               m_unAdaptiveIndexCounter = 0;
+               m_unAdaptiveIndexTimeCurrent = 0;
+               m_unAdaptiveIndexTimeAlternate = 0;
+            }
+            break;
+         }
+         case ADAPTIVE_INDEX_MEASURE_CURRENT: {
+            /* The first step is a warm-up, it is not measured */
+            if(m_unAdaptiveIndexCounter > 1) {
+               m_unAdaptiveIndexTimeCurrent += un_step_time;
+            }
+            if(m_unAdaptiveIndexCounter >= m_unAdaptiveIndexSteps) {
+               /* Derive the hash parameters from the current population */
+               cpFloat fCellSize;
+               UInt32 unCellNum;
+               if(!CalculateSpatialHashParameters(fCellSize, unCellNum)) {
+                  /* Nothing to index, try again later */
+                  m_eAdaptiveIndexPhase = ADAPTIVE_INDEX_IDLE;
+                  m_unAdaptiveIndexCounter = 0;
+                  break;
+               }
+               if(m_bAdaptiveIndexEvaluated &&
+                  !HasChangedSignificantly(fCellSize, m_fAdaptiveIndexEvaluatedCellSize) &&
+                  !HasChangedSignificantly(unCellNum, m_unAdaptiveIndexEvaluatedCellNum)) {
+                  /* The population is like at the last evaluation, so the
+                     last choice still holds; avoid rebuilding the index */
+                  m_eAdaptiveIndexPhase = ADAPTIVE_INDEX_IDLE;
+                  m_unAdaptiveIndexCounter = 0;
+                  break;
+               }
+               m_bAdaptiveIndexEvaluated = true;
+               m_fAdaptiveIndexEvaluatedCellSize = fCellSize;
+               m_unAdaptiveIndexEvaluatedCellNum = unCellNum;
+               m_fSpatialHashCellSize = fCellSize;
+               m_unSpatialHashCellNum = unCellNum;
+               /* Try the other index */
+               m_eAdaptiveIndexPrevious = m_eSpatialIndex;
+               SetSpatialIndex(m_eSpatialIndex == SPATIAL_INDEX_HASH ?
+                               SPATIAL_INDEX_BBTREE :
+                               SPATIAL_INDEX_HASH);
+               m_eAdaptiveIndexPhase = ADAPTIVE_INDEX_MEASURE_ALTERNATE;
+               m_unAdaptiveIndexCounter = 0;
+            }
+            break;
+         }
+         case ADAPTIVE_INDEX_MEASURE_ALTERNATE: {
+            if(m_unAdaptiveIndexCounter > 1) {
+               m_unAdaptiveIndexTimeAlternate += un_step_time;
+            }
+            if(m_unAdaptiveIndexCounter >= m_unAdaptiveIndexSteps) {
+               /* Both windows have the same length, so the totals can be compared directly */
+               bool bSwitch =
+                  m_unAdaptiveIndexTimeAlternate <
+                  (1.0 - m_fAdaptiveIndexMinGain) * m_unAdaptiveIndexTimeCurrent;
+               if(!bSwitch) {
+                  /* Go back to the previous index, with up-to-date parameters */
+                  SetSpatialIndex(m_eAdaptiveIndexPrevious);
+               }
+               if(bSwitch || !m_bAdaptiveIndexReported) {
+                  /* Average step time in microseconds, warm-up excluded */
+                  Real fScale = 1000.0 * (m_unAdaptiveIndexSteps - 1);
+                  Real fTimeCurrent   = m_unAdaptiveIndexTimeCurrent   / fScale;
+                  Real fTimeAlternate = m_unAdaptiveIndexTimeAlternate / fScale;
+                  LOG << "[INFO] Dynamics 2D engine \""
+                      << GetId()
+                      << "\": using the "
+                      << SpatialIndexName(m_eSpatialIndex);
+                  if(m_eSpatialIndex == SPATIAL_INDEX_HASH) {
+                     LOG << " (cell_size = "
+                         << m_fSpatialHashCellSize
+                         << ", cell_num = "
+                         << m_unSpatialHashCellNum
+                         << ")";
+                  }
+                  LOG << " for collision shape indexing; average step time "
+                      << (bSwitch ? fTimeAlternate : fTimeCurrent)
+                      << "us vs. "
+                      << (bSwitch ? fTimeCurrent : fTimeAlternate)
+                      << "us"
+                      << std::endl;
+                  m_bAdaptiveIndexReported = true;
+               }
+               m_eAdaptiveIndexPhase = ADAPTIVE_INDEX_IDLE;
+               m_unAdaptiveIndexCounter = 0;
+            }
+            break;
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CDynamics2DEngine::PositionPhysicsToSpace(CVector3& c_new_pos,
                                                   const CVector3& c_original_pos,
                                                   const cpBody* pt_body) {
@@ -403,7 +638,32 @@ namespace argos {
                            "       </spatial_hash>\n"
                            "     </dynamics2d>\n"
                            "     ...\n"
-                           "   </physics_engines>\n"
+                           "   </physics_engines>\n\n"
+                           "6. If you don't want to tune the collision shape indexing by hand, the engine\n"
+                           "   can choose it for you. With adaptive indexing, the engine periodically\n"
+                           "   derives the spatial hash cell size and number from the size distribution\n"
+                           "   and the density of the shapes it manages, times a few steps with the\n"
+                           "   current index and a few steps with the alternative one, and keeps the\n"
+                           "   faster. The alternative index is tried only when the size distribution or\n"
+                           "   the density of the shapes changed by more than 10% since the last trial,\n"
+                           "   since switching index means rebuilding it. Every time the index changes,\n"
+                           "   the choice is reported in the log.\n"
+                           "   To use adaptive indexing, use this syntax (all attributes are optional):\n\n"
+                           "   <physics_engines>\n"
+                           "     ...\n"
+                           "     <dynamics2d id=\"dyn2d\">\n"
+                           "       <adaptive_spatial_index period=\"1000\"\n"
+                           "                               steps=\"10\"\n"
+                           "                               min_gain=\"0.1\" />\n"
+                           "     </dynamics2d>\n"
+                           "     ...\n"
+                           "   </physics_engines>\n\n"
+                           "   The 'period' attribute is the number of simulation steps between two\n"
+                           "   evaluations (default: 1000). The 'steps' attribute is the number of steps\n"
+                           "   timed for each index during an evaluation (default: 10). The 'min_gain'\n"
+                           "   attribute is the relative speedup the alternative index must provide for\n"
+                           "   the engine to switch to it (default: 0.1, i.e., 10%). If <spatial_hash> is\n"
+                           "   also specified, the engine starts with the given parameters.\n"
                            ,
                            "Usable"
       );
@@ -16,6 +16,7 @@ namespace argos {
 
 #include <argos3/core/simulator/entity/controllable_entity.h>
 #include <argos3/core/simulator/physics_engine/physics_engine.h>
+#include <argos3/core/utility/configuration/memento.h>
 #include <argos3/plugins/simulator/physics_engines/dynamics2d/chipmunk-physics/include/chipmunk.h>
 
 namespace argos {
@@ -39,7 +40,8 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   class CDynamics2DEngine : public CPhysicsEngine {
+   class CDynamics2DEngine : public CPhysicsEngine,
+                             public CMemento {
 
    public:
 
@@ -54,6 +56,11 @@ namespace argos {
          LAYER_NORMAL = CP_ALL_LAYERS
       };
 
+      enum ESpatialIndex {
+         SPATIAL_INDEX_BBTREE = 0,
+         SPATIAL_INDEX_HASH
+      };
+
       CDynamics2DEngine();
 
       virtual ~CDynamics2DEngine() {}
@@ -63,6 +70,24 @@ namespace argos {
       virtual void Update();
       virtual void Destroy();
 
+      /**
+       * Saves the state of the models: the pose and velocities of the
+       * bodies, and the state of the velocity controls.
+       * The contacts cached by the solver to warm-start the next step
+       * are not saved, so a checkpoint taken while bodies touch can
+       * diverge from the original run within the solver tolerance.
+       * @param c_buffer The target buffer.
+       * @see CSimulator::SaveState()
+       */
+      virtual void SaveState(CByteArray& c_buffer);
+
+      /**
+       * Restores the state of the models.
+       * @param c_buffer The source buffer.
+       * @see SaveState()
+       */
+      virtual void LoadState(CByteArray& c_buffer);
+
       virtual size_t GetNumPhysicsModels();
       virtual bool AddEntity(CEntity& c_entity);
       virtual bool RemoveEntity(CEntity& c_entity);
@@ -118,6 +143,30 @@ namespace argos {
          m_ptSpace->gravity = cpv(c_gravity.GetX(), c_gravity.GetY());
       }
 
+      inline ESpatialIndex GetSpatialIndex() const {
+         return m_eSpatialIndex;
+      }
+
+      /**
+       * Switches the collision shape index of the physics space.
+       * When the spatial hash is selected, the current cell size and
+       * cell number are used.
+       * @param e_index The wanted spatial index.
+       */
+      void SetSpatialIndex(ESpatialIndex e_index);
+
+      /**
+       * Calculates the spatial hash parameters from the shapes currently in the space.
+       * The cell size is the median of the largest side of the shape bounding boxes;
+       * the cell number is at least ten times the number of shapes, and large enough to
+       * cover the area occupied by the shapes.
+       * @param f_cell_size The calculated cell size.
+       * @param un_cell_num The calculated cell number.
+       * @return <tt>false</tt> if the space contains no shapes.
+       */
+      bool CalculateSpatialHashParameters(cpFloat& f_cell_size,
+                                          UInt32& un_cell_num) const;
+
       void PositionPhysicsToSpace(CVector3& c_new_pos,
                                   const CVector3& c_original_pos,
                                   const cpBody* pt_body);
@@ -129,6 +178,18 @@ namespace argos {
                             CDynamics2DModel& c_model);
       void RemovePhysicsModel(const std::string& str_id);
 
+   private:
+
+      void UpdateAdaptiveSpatialIndex(UInt64 un_step_time);
+
+   private:
+
+      enum EAdaptiveIndexPhase {
+         ADAPTIVE_INDEX_IDLE = 0,
+         ADAPTIVE_INDEX_MEASURE_CURRENT,
+         ADAPTIVE_INDEX_MEASURE_ALTERNATE
+      };
+
    private:
 
       cpFloat m_fBoxLinearFriction;
@@ -139,6 +200,28 @@ namespace argos {
       cpBody* m_ptGroundBody;
       Real m_fElevation;
 
+      /* Spatial index currently used by the space */
+      ESpatialIndex m_eSpatialIndex;
+      cpFloat m_fSpatialHashCellSize;
+      UInt32 m_unSpatialHashCellNum;
+
+      /* Adaptive spatial index selection */
+      bool m_bAdaptiveSpatialIndex;
+      UInt32 m_unAdaptiveIndexPeriod;
+      UInt32 m_unAdaptiveIndexSteps;
+      Real m_fAdaptiveIndexMinGain;
+      EAdaptiveIndexPhase m_eAdaptiveIndexPhase;
+      ESpatialIndex m_eAdaptiveIndexPrevious;
+      UInt32 m_unAdaptiveIndexCounter;
+      UInt64 m_unAdaptiveIndexTimeCurrent;
+      UInt64 m_unAdaptiveIndexTimeAlternate;
+      bool m_bAdaptiveIndexReported;
+      /* Hash parameters of the population at the last evaluation;
+         the alternative index is tried only when they change */
+      bool m_bAdaptiveIndexEvaluated;
+      cpFloat m_fAdaptiveIndexEvaluatedCellSize;
+      UInt32 m_unAdaptiveIndexEvaluatedCellNum;
+
       CControllableEntity::TMap m_tControllableEntities;
       std::map<std::string, CDynamics2DModel*> m_tPhysicsModels;
 
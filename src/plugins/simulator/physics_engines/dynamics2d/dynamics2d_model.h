@@ -12,6 +12,7 @@ namespace argos {
 }
 
 #include <argos3/core/simulator/physics_engine/physics_model.h>
+#include <argos3/core/utility/configuration/memento.h>
 #include <argos3/plugins/simulator/physics_engines/dynamics2d/dynamics2d_engine.h>
 
 namespace argos {
@@ -21,10 +22,17 @@ namespace argos {
     * All the models in the dynamics 2D engine inherit from this class, which
     * provides the additional method GetDynamics2DEngine() over the CPhysicsModel
     * interface.
+    * <p>
+    * The models also implement CMemento, so that CDynamics2DEngine can save
+    * the state of the bodies (e.g., their velocities) in a checkpoint. The
+    * pose of the bodies is restored exactly, rather than recalculated from
+    * the pose of the entity.
+    * </p>
     * @see CPhysicsModel
     * @see CDynamics2DEngine
     */
-   class CDynamics2DModel : public CPhysicsModel {
+   class CDynamics2DModel : public CPhysicsModel,
+                            public CMemento {
 
    public:
 
@@ -57,6 +65,40 @@ namespace argos {
          return m_cDyn2DEngine;
       }
 
+   protected:
+
+      /**
+       * Saves the position, orientation and velocities of a body.
+       * @param pt_body The body.
+       * @param c_buffer The target buffer.
+       */
+      static void SaveBodyState(const cpBody* pt_body,
+                                CByteArray& c_buffer) {
+         c_buffer << static_cast<double>(pt_body->p.x)
+                  << static_cast<double>(pt_body->p.y)
+                  << static_cast<double>(pt_body->a)
+                  << static_cast<double>(pt_body->v.x)
+                  << static_cast<double>(pt_body->v.y)
+                  << static_cast<double>(pt_body->w);
+      }
+
+      /**
+       * Restores the position, orientation and velocities of a body.
+       * The caller must reindex the shapes of the body.
+       * @param pt_body The body.
+       * @param c_buffer The source buffer.
+       */
+      static void LoadBodyState(cpBody* pt_body,
+                                CByteArray& c_buffer) {
+         double fPX, fPY, fA, fVX, fVY, fW;
+         c_buffer >> fPX >> fPY >> fA >> fVX >> fVY >> fW;
+         pt_body->p = cpv(fPX, fPY);
+         cpBodySetAngle(pt_body, fA);
+         pt_body->v = cpv(fVX, fVY);
+         pt_body->w = fW;
+         cpBodyResetForces(pt_body);
+      }
+
    private:
 
       CDynamics2DEngine& m_cDyn2DEngine;
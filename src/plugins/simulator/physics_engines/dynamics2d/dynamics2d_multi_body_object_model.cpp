@@ -85,6 +85,27 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CDynamics2DMultiBodyObjectModel::SaveState(CByteArray& c_buffer) {
+      for(size_t i = 0; i < m_vecBodies.size(); ++i) {
+         SaveBodyState(m_vecBodies[i].Body, c_buffer);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics2DMultiBodyObjectModel::LoadState(CByteArray& c_buffer) {
+      for(size_t i = 0; i < m_vecBodies.size(); ++i) {
+         LoadBodyState(m_vecBodies[i].Body, c_buffer);
+         cpSpaceReindexShapesForBody(GetDynamics2DEngine().GetPhysicsSpace(),
+                                     m_vecBodies[i].Body);
+      }
+      CalculateBoundingBox();
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CDynamics2DMultiBodyObjectModel::CalculateBoundingBox() {
       if(m_vecBodies.empty()) return;
       cpBB tBoundingBox;
@@ -116,6 +116,18 @@ namespace argos {
 
       virtual bool IsCollidingWithSomething() const;
 
+      /**
+       * Saves the position, orientation and velocities of the bodies.
+       * @param c_buffer The target buffer.
+       */
+      virtual void SaveState(CByteArray& c_buffer);
+
+      /**
+       * Restores the position, orientation and velocities of the bodies.
+       * @param c_buffer The source buffer.
+       */
+      virtual void LoadState(CByteArray& c_buffer);
+
       /**
        * Adds a body.
        * <p>
@@ -82,6 +82,28 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CDynamics2DSingleBodyObjectModel::SaveState(CByteArray& c_buffer) {
+      SaveBodyState(m_ptBody, c_buffer);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics2DSingleBodyObjectModel::LoadState(CByteArray& c_buffer) {
+      LoadBodyState(m_ptBody, c_buffer);
+      /* Update shape index */
+      if(cpBodyIsStatic(m_ptBody)) {
+         cpSpaceReindexStatic(GetDynamics2DEngine().GetPhysicsSpace());
+      }
+      else {
+         cpSpaceReindexShapesForBody(GetDynamics2DEngine().GetPhysicsSpace(), m_ptBody);
+      }
+      CalculateBoundingBox();
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CDynamics2DSingleBodyObjectModel::CalculateBoundingBox() {
       cpBB tBoundingBox = cpShapeGetBB(m_ptBody->shapeList);
       for(cpShape* pt_shape = m_ptBody->shapeList->next;
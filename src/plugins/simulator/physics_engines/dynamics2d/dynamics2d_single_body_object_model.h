@@ -108,6 +108,18 @@ namespace argos {
 
       virtual bool IsCollidingWithSomething() const;
 
+      /**
+       * Saves the position, orientation and velocities of the body.
+       * @param c_buffer The target buffer.
+       */
+      virtual void SaveState(CByteArray& c_buffer);
+
+      /**
+       * Restores the position, orientation and velocities of the body.
+       * @param c_buffer The source buffer.
+       */
+      virtual void LoadState(CByteArray& c_buffer);
+
       /**
        * Sets the body and registers the default origin anchor method.
        * <p>
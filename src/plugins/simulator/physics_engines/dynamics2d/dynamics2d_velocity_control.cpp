@@ -100,6 +100,37 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CDynamics2DVelocityControl::SaveState(CByteArray& c_buffer) {
+      c_buffer << static_cast<double>(m_ptControlBody->v.x)
+               << static_cast<double>(m_ptControlBody->v.y)
+               << static_cast<double>(m_ptControlBody->w);
+      if(m_ptControlledBody != NULL) {
+         cpVect tLinearImpulse = reinterpret_cast<cpPivotJoint*>(m_ptLinearConstraint)->jAcc;
+         c_buffer << static_cast<double>(tLinearImpulse.x)
+                  << static_cast<double>(tLinearImpulse.y)
+                  << static_cast<double>(reinterpret_cast<cpGearJoint*>(m_ptAngularConstraint)->jAcc);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CDynamics2DVelocityControl::LoadState(CByteArray& c_buffer) {
+      double fVX, fVY, fW;
+      c_buffer >> fVX >> fVY >> fW;
+      m_ptControlBody->v = cpv(fVX, fVY);
+      m_ptControlBody->w = fW;
+      if(m_ptControlledBody != NULL) {
+         double fJX, fJY, fJ;
+         c_buffer >> fJX >> fJY >> fJ;
+         reinterpret_cast<cpPivotJoint*>(m_ptLinearConstraint)->jAcc = cpv(fJX, fJY);
+         reinterpret_cast<cpGearJoint*>(m_ptAngularConstraint)->jAcc = fJ;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    CVector2 CDynamics2DVelocityControl::GetLinearVelocity() const {
       return CVector2(m_ptControlledBody->v.x,
                       m_ptControlledBody->v.y);
@@ -14,6 +14,7 @@ namespace argos {
 #include <argos3/plugins/simulator/physics_engines/dynamics2d/chipmunk-physics/include/chipmunk.h>
 #include <argos3/core/utility/configuration/argos_configuration.h>
 #include <argos3/core/utility/math/vector2.h>
+#include <argos3/core/utility/datatypes/byte_array.h>
 
 namespace argos {
 
@@ -34,6 +35,19 @@ namespace argos {
 
       void Reset();
 
+      /**
+       * Saves the velocity of the control body and the impulses
+       * accumulated by the constraints, which warm-start the solver.
+       * @param c_buffer The target buffer.
+       */
+      void SaveState(CByteArray& c_buffer);
+
+      /**
+       * Restores the state saved by SaveState().
+       * @param c_buffer The source buffer.
+       */
+      void LoadState(CByteArray& c_buffer);
+
       CVector2 GetLinearVelocity() const;
 
       void SetLinearVelocity(const CVector2& c_velocity);
@@ -59,6 +59,22 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CPointMass3DEngine::SaveState(CByteArray& c_buffer) {
+      SaveMementoMap(m_tPhysicsModels, c_buffer);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CPointMass3DEngine::LoadState(CByteArray& c_buffer) {
+      CMementoBlockReader cReader(c_buffer);
+      LoadMementoMap(m_tPhysicsModels, cReader);
+      c_buffer.Clear();
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CPointMass3DEngine::Update() {
       /* Update the physics state from the entities */
       for(CPointMass3DModel::TMap::iterator it = m_tPhysicsModels.begin();
@@ -151,6 +167,27 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CPointMass3DEngine::CheckIntersectionWithRays(std::vector<TEmbodiedEntityIntersectionData>& vec_data,
+                                                      const std::vector<CRay3>& vec_rays) const {
+      /* Walk the models once, checking all the rays against each of them */
+      Real fTOnRay;
+      for(CPointMass3DModel::TMap::const_iterator it = m_tPhysicsModels.begin();
+          it != m_tPhysicsModels.end();
+          ++it) {
+         for(size_t i = 0; i < vec_rays.size(); ++i) {
+            if(it->second->CheckIntersectionWithRay(fTOnRay, vec_rays[i])) {
+               vec_data[i].push_back(
+                  SEmbodiedEntityIntersectionItem(
+                     &it->second->GetEmbodiedEntity(),
+                     fTOnRay));
+            }
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CPointMass3DEngine::AddPhysicsModel(const std::string& str_id,
                                             CPointMass3DModel& c_model) {
       m_tPhysicsModels[str_id] = &c_model;
@@ -16,10 +16,12 @@ namespace argos {
 #include <argos3/core/utility/math/ray2.h>
 #include <argos3/core/simulator/entity/controllable_entity.h>
 #include <argos3/core/simulator/physics_engine/physics_engine.h>
+#include <argos3/core/utility/configuration/memento.h>
 
 namespace argos {
 
-   class CPointMass3DEngine : public CPhysicsEngine {
+   class CPointMass3DEngine : public CPhysicsEngine,
+                              public CMemento {
 
    public:
 
@@ -30,6 +32,20 @@ namespace argos {
       virtual void Reset();
       virtual void Destroy();
 
+      /**
+       * Saves the state of the models.
+       * @param c_buffer The target buffer.
+       * @see CSimulator::SaveState()
+       */
+      virtual void SaveState(CByteArray& c_buffer);
+
+      /**
+       * Restores the state of the models.
+       * @param c_buffer The source buffer.
+       * @see SaveState()
+       */
+      virtual void LoadState(CByteArray& c_buffer);
+
       virtual void Update();
 
       virtual size_t GetNumPhysicsModels();
@@ -45,6 +61,9 @@ namespace argos {
       virtual void CheckIntersectionWithRay(TEmbodiedEntityIntersectionData& t_data,
                                             const CRay3& c_ray) const;
 
+      virtual void CheckIntersectionWithRays(std::vector<TEmbodiedEntityIntersectionData>& vec_data,
+                                             const std::vector<CRay3>& vec_rays) const;
+
       void AddPhysicsModel(const std::string& str_id,
                            CPointMass3DModel& c_model);
       void RemovePhysicsModel(const std::string& str_id);
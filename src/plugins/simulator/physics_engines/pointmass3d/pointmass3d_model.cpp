@@ -53,6 +53,25 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CPointMass3DModel::SaveState(CByteArray& c_buffer) {
+      SaveVector(c_buffer, m_cPosition);
+      SaveVector(c_buffer, m_cVelocity);
+      SaveVector(c_buffer, m_cAcceleration);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CPointMass3DModel::LoadState(CByteArray& c_buffer) {
+      LoadVector(c_buffer, m_cPosition);
+      LoadVector(c_buffer, m_cVelocity);
+      LoadVector(c_buffer, m_cAcceleration);
+      CalculateBoundingBox();
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CPointMass3DModel::UpdateOriginAnchor(SAnchor& s_anchor) {
       s_anchor.Position = m_cPosition;
    }
@@ -12,13 +12,25 @@ namespace argos {
 }
 
 #include <argos3/core/simulator/physics_engine/physics_model.h>
+#include <argos3/core/utility/configuration/memento.h>
 #include <argos3/plugins/simulator/physics_engines/pointmass3d/pointmass3d_engine.h>
 #include <argos3/core/utility/math/vector3.h>
 #include <argos3/core/utility/math/quaternion.h>
 
 namespace argos {
 
-   class CPointMass3DModel : public CPhysicsModel {
+   /**
+    * The base class for models in the point-mass 3D engine.
+    * <p>
+    * The models implement CMemento, so that CPointMass3DEngine can save
+    * their position, velocity and acceleration in a checkpoint. Models
+    * with additional state (e.g., a yaw) must extend SaveState() and
+    * LoadState().
+    * </p>
+    * @see CPointMass3DEngine
+    */
+   class CPointMass3DModel : public CPhysicsModel,
+                             public CMemento {
 
    public:
 
@@ -41,6 +53,18 @@ namespace argos {
 
       virtual bool IsCollidingWithSomething() const;
 
+      /**
+       * Saves the position, velocity and acceleration of the model.
+       * @param c_buffer The target buffer.
+       */
+      virtual void SaveState(CByteArray& c_buffer);
+
+      /**
+       * Restores the position, velocity and acceleration of the model.
+       * @param c_buffer The source buffer.
+       */
+      virtual void LoadState(CByteArray& c_buffer);
+
       virtual bool CheckIntersectionWithRay(Real& f_t_on_ray,
                                             const CRay3& c_ray) const = 0;
 
@@ -65,6 +89,32 @@ namespace argos {
          return m_cPM3DEngine;
       }
 
+   protected:
+
+      /**
+       * Appends a vector to a buffer.
+       * @param c_buffer The target buffer.
+       * @param c_vector The vector.
+       */
+      static void SaveVector(CByteArray& c_buffer,
+                             const CVector3& c_vector) {
+         c_buffer << static_cast<double>(c_vector.GetX())
+                  << static_cast<double>(c_vector.GetY())
+                  << static_cast<double>(c_vector.GetZ());
+      }
+
+      /**
+       * Moves a vector from the beginning of a buffer.
+       * @param c_buffer The source buffer.
+       * @param c_vector The vector.
+       */
+      static void LoadVector(CByteArray& c_buffer,
+                             CVector3& c_vector) {
+         double fX, fY, fZ;
+         c_buffer >> fX >> fY >> fZ;
+         c_vector.Set(fX, fY, fZ);
+      }
+
    protected:
 
       /** Reference to the physics engine */
@@ -134,6 +134,38 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CPointMass3DQuadRotorModel::SaveState(CByteArray& c_buffer) {
+      CPointMass3DModel::SaveState(c_buffer);
+      c_buffer << static_cast<double>(m_cYaw.GetValue())
+               << static_cast<double>(m_cRotSpeed.GetValue())
+               << static_cast<double>(m_cTorque.GetValue())
+               << static_cast<double>(m_pfLinearError[0])
+               << static_cast<double>(m_pfLinearError[1])
+               << static_cast<double>(m_pfLinearError[2])
+               << static_cast<double>(m_fRotError);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CPointMass3DQuadRotorModel::LoadState(CByteArray& c_buffer) {
+      CPointMass3DModel::LoadState(c_buffer);
+      double fYaw, fRotSpeed, fTorque, fLinErrX, fLinErrY, fLinErrZ, fRotError;
+      c_buffer >> fYaw >> fRotSpeed >> fTorque
+               >> fLinErrX >> fLinErrY >> fLinErrZ
+               >> fRotError;
+      m_cYaw.SetValue(fYaw);
+      m_cRotSpeed.SetValue(fRotSpeed);
+      m_cTorque.SetValue(fTorque);
+      m_pfLinearError[0] = fLinErrX;
+      m_pfLinearError[1] = fLinErrY;
+      m_pfLinearError[2] = fLinErrZ;
+      m_fRotError = fRotError;
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CPointMass3DQuadRotorModel::CalculateBoundingBox() {
       GetBoundingBox().MinCorner.Set(
          GetEmbodiedEntity().GetOriginAnchor().Position.GetX() - m_fArmLength,
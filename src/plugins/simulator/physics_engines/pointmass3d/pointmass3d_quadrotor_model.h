@@ -48,6 +48,20 @@ namespace argos {
       virtual void UpdateFromEntityStatus();
       virtual void Step();
 
+      /**
+       * Saves the state of the model, including the yaw and the
+       * errors of the controllers.
+       * @param c_buffer The target buffer.
+       */
+      virtual void SaveState(CByteArray& c_buffer);
+
+      /**
+       * Restores the state of the model, including the yaw and the
+       * errors of the controllers.
+       * @param c_buffer The source buffer.
+       */
+      virtual void LoadState(CByteArray& c_buffer);
+
       virtual void CalculateBoundingBox();
 
       virtual bool CheckIntersectionWithRay(Real& f_t_on_ray,
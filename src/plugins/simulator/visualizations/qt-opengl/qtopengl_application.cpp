@@ -5,9 +5,12 @@
  * @author Carlo Pinciroli <ilpincy@gmail.com>
  */
 #include "qtopengl_application.h"
+#include "qtopengl_widget.h"
 
 #include <argos3/core/utility/logging/argos_log.h>
 
+#include <QThread>
+
 #include <typeinfo>
 
 namespace argos {
@@ -17,9 +20,16 @@ namespace argos {
 
    bool CQTOpenGLApplication::notify(QObject* pc_receiver,
                                      QEvent* pc_event) {
+      /* The GUI thread accesses the simulated state only with the lock held */
+      CQTOpenGLWidget* pcLockingWidget =
+         (QThread::currentThread() == thread()) ? m_pcOpenGLWidget : NULL;
+      if(pcLockingWidget != NULL) pcLockingWidget->LockSimulation();
       try {
-         return QApplication::notify(pc_receiver, pc_event);
+         bool bResult = QApplication::notify(pc_receiver, pc_event);
+         if(pcLockingWidget != NULL) pcLockingWidget->UnlockSimulation();
+         return bResult;
       } catch (std::exception& ex) {
+         if(pcLockingWidget != NULL) pcLockingWidget->UnlockSimulation();
          fprintf(stderr, "%s\n", ex.what());
          QApplication::exit(1);
       } catch (...) {
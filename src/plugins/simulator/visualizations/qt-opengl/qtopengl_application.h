@@ -9,6 +9,7 @@
 
 namespace argos {
    class CQTOpenGLApplication;
+   class CQTOpenGLWidget;
 }
 
 #include <QtWidgets/QApplication>
@@ -24,13 +25,34 @@ namespace argos {
       CQTOpenGLApplication(int& n_option_num,
                            char** ppc_options) :
          QApplication(n_option_num,
-                      ppc_options) {}
+                      ppc_options),
+         m_pcOpenGLWidget(NULL) {}
 
       virtual ~CQTOpenGLApplication() {}
 
+      /**
+       * Processes an event.
+       * The events processed by the GUI thread are processed while holding
+       * the simulation lock of the OpenGL widget, so every GUI path (the
+       * main window, the Lua editor, the user functions) can access the
+       * simulated state while the simulation thread is stepping.
+       * @see CQTOpenGLWidget::LockSimulation
+       */
       virtual bool notify(QObject* pc_receiver,
                           QEvent* pc_event);
 
+      /**
+       * Sets the widget whose simulation lock protects the event processing.
+       * @param pc_widget The widget, or <tt>NULL</tt> to stop locking.
+       */
+      inline void SetOpenGLWidget(CQTOpenGLWidget* pc_widget) {
+         m_pcOpenGLWidget = pc_widget;
+      }
+
+   private:
+
+      CQTOpenGLWidget* m_pcOpenGLWidget;
+
    };
 
 }
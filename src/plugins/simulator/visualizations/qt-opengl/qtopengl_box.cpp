@@ -9,6 +9,7 @@
 #include <argos3/plugins/simulator/entities/led_equipped_entity.h>
 #include <argos3/plugins/simulator/entities/box_entity.h>
 #include <argos3/plugins/simulator/visualizations/qt-opengl/qtopengl_widget.h>
+#include <argos3/plugins/simulator/visualizations/qt-opengl/qtopengl_instanced_model.h>
 
 namespace argos {
 
@@ -102,6 +103,47 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CQTOpenGLBox::AddInstances(CQTOpenGLWidget& c_visualization,
+                                   CBoxEntity& c_entity) {
+      /* Create the body model on first use */
+      CQTOpenGLInstancedModel* pcBody = c_visualization.GetInstancedModel("box");
+      if(pcBody == NULL) {
+         /* Unit box with its base centered in the origin, same as MakeBody() */
+         CQTOpenGLInstancedModel::TVertices vecTriangles;
+         CQTOpenGLInstancedModel::MakeQuad(vecTriangles, -CVector3::Z,
+                                           CVector3( 0.5f,  0.5f, 0.0f), CVector3( 0.5f, -0.5f, 0.0f),
+                                           CVector3(-0.5f, -0.5f, 0.0f), CVector3(-0.5f,  0.5f, 0.0f));
+         CQTOpenGLInstancedModel::MakeQuad(vecTriangles, CVector3::Z,
+                                           CVector3(-0.5f, -0.5f, 1.0f), CVector3( 0.5f, -0.5f, 1.0f),
+                                           CVector3( 0.5f,  0.5f, 1.0f), CVector3(-0.5f,  0.5f, 1.0f));
+         CQTOpenGLInstancedModel::MakeQuad(vecTriangles, -CVector3::Y,
+                                           CVector3(-0.5f, -0.5f, 1.0f), CVector3(-0.5f, -0.5f, 0.0f),
+                                           CVector3( 0.5f, -0.5f, 0.0f), CVector3( 0.5f, -0.5f, 1.0f));
+         CQTOpenGLInstancedModel::MakeQuad(vecTriangles, CVector3::X,
+                                           CVector3( 0.5f, -0.5f, 1.0f), CVector3( 0.5f, -0.5f, 0.0f),
+                                           CVector3( 0.5f,  0.5f, 0.0f), CVector3( 0.5f,  0.5f, 1.0f));
+         CQTOpenGLInstancedModel::MakeQuad(vecTriangles, CVector3::Y,
+                                           CVector3( 0.5f,  0.5f, 1.0f), CVector3( 0.5f,  0.5f, 0.0f),
+                                           CVector3(-0.5f,  0.5f, 0.0f), CVector3(-0.5f,  0.5f, 1.0f));
+         CQTOpenGLInstancedModel::MakeQuad(vecTriangles, -CVector3::X,
+                                           CVector3(-0.5f,  0.5f, 1.0f), CVector3(-0.5f,  0.5f, 0.0f),
+                                           CVector3(-0.5f, -0.5f, 0.0f), CVector3(-0.5f, -0.5f, 1.0f));
+         pcBody = &c_visualization.AddInstancedModel("box", new CQTOpenGLInstancedModel(vecTriangles));
+      }
+      /* Queue the body */
+      const SAnchor& sOrigin = c_entity.GetEmbodiedEntity().GetOriginAnchor();
+      pcBody->AddInstance(sOrigin.Position,
+                          sOrigin.Orientation,
+                          c_entity.GetSize(),
+                          c_entity.GetEmbodiedEntity().IsMovable() ?
+                          CColor(255, 0, 0) : CColor(178, 178, 178));
+      /* Queue the LEDs */
+      c_visualization.AddLEDInstances(sOrigin, c_entity.GetLEDEquippedEntity());
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CQTOpenGLBox::MakeBody() {
 	     /* Since this shape can be stretched,
 	         make sure the normal vectors are unit-long */
@@ -205,10 +247,15 @@ namespace argos {
    public:
       void ApplyTo(CQTOpenGLWidget& c_visualization,
                    CBoxEntity& c_entity) {
-         static CQTOpenGLBox m_cModel;
          c_visualization.DrawEntity(c_entity.GetEmbodiedEntity());
-         m_cModel.Draw(c_entity);
-         m_cModel.DrawLEDs(c_entity);
+         if(c_visualization.IsInstancingEnabled()) {
+            CQTOpenGLBox::AddInstances(c_visualization, c_entity);
+         }
+         else {
+            static CQTOpenGLBox m_cModel;
+            m_cModel.Draw(c_entity);
+            m_cModel.DrawLEDs(c_entity);
+         }
       }
    };
 
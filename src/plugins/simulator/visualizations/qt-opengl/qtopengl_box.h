@@ -9,6 +9,7 @@
 
 namespace argos {
    class CQTOpenGLBox;
+   class CQTOpenGLWidget;
    class CBoxEntity;
 }
 
@@ -31,6 +32,13 @@ namespace argos {
       virtual void DrawLEDs(CBoxEntity& c_entity);
       virtual void Draw(const CBoxEntity& c_entity);
 
+      /**
+       * Queues the body and the LEDs of the given box for instanced drawing.
+       * @see CQTOpenGLWidget::IsInstancingEnabled
+       */
+      static void AddInstances(CQTOpenGLWidget& c_visualization,
+                               CBoxEntity& c_entity);
+
    private:
 
       void MakeBody();
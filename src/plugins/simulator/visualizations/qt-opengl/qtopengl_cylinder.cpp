@@ -101,6 +101,23 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CQTOpenGLCylinder::AddInstances(CQTOpenGLWidget& c_visualization,
+                                        CCylinderEntity& c_entity) {
+      /* Queue the body */
+      const SAnchor& sOrigin = c_entity.GetEmbodiedEntity().GetOriginAnchor();
+      c_visualization.AddCylinderInstance(sOrigin.Position,
+                                          sOrigin.Orientation,
+                                          c_entity.GetRadius(),
+                                          c_entity.GetHeight(),
+                                          c_entity.GetEmbodiedEntity().IsMovable() ?
+                                          CColor(0, 255, 0) : CColor(178, 178, 178));
+      /* Queue the LEDs */
+      c_visualization.AddLEDInstances(sOrigin, c_entity.GetLEDEquippedEntity());
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CQTOpenGLCylinder::MakeBody() {
       /* Since this shape can be stretched,
          make sure the normal vectors are unit-long */
@@ -192,10 +209,15 @@ namespace argos {
    public:
       void ApplyTo(CQTOpenGLWidget& c_visualization,
                    CCylinderEntity& c_entity) {
-         static CQTOpenGLCylinder m_cModel;
          c_visualization.DrawEntity(c_entity.GetEmbodiedEntity());
-         m_cModel.Draw(c_entity);
-         m_cModel.DrawLEDs(c_entity);
+         if(c_visualization.IsInstancingEnabled()) {
+            CQTOpenGLCylinder::AddInstances(c_visualization, c_entity);
+         }
+         else {
+            static CQTOpenGLCylinder m_cModel;
+            m_cModel.Draw(c_entity);
+            m_cModel.DrawLEDs(c_entity);
+         }
       }
    };
 
@@ -9,6 +9,7 @@
 
 namespace argos {
    class CQTOpenGLCylinder;
+   class CQTOpenGLWidget;
    class CCylinderEntity;
 }
 
@@ -32,6 +33,13 @@ namespace argos {
       void DrawLEDs(CCylinderEntity& c_entity);
       virtual void Draw(CCylinderEntity& c_entity);
 
+      /**
+       * Queues the body and the LEDs of the given cylinder for instanced drawing.
+       * @see CQTOpenGLWidget::IsInstancingEnabled
+       */
+      static void AddInstances(CQTOpenGLWidget& c_visualization,
+                               CCylinderEntity& c_entity);
+
    private:
 
       void MakeBody();
@@ -0,0 +1,331 @@
+/**
+ * @file <argos3/plugins/simulator/visualizations/qt-opengl/qtopengl_frame_grabber.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "qtopengl_frame_grabber.h"
+#include <argos3/core/utility/logging/argos_log.h>
+#include <QOpenGLContext>
+#include <cerrno>
+#include <cstring>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLFrameEncoder::CQTOpenGLFrameEncoder(CQTOpenGLFrameGrabber& c_grabber) :
+      m_cGrabber(c_grabber) {}
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLFrameEncoder::run() {
+#ifdef ARGOS_THREADSAFE_LOG
+      LOG.AddThreadSafeBuffer();
+      LOGERR.AddThreadSafeBuffer();
+#endif
+      CQTOpenGLFrameGrabber::SFrame sFrame;
+      while(m_cGrabber.Dequeue(sFrame)) {
+         m_cGrabber.Encode(sFrame);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLFrameGrabber::CQTOpenGLFrameGrabber(const CQTOpenGLWidget::SFrameGrabData& s_data) :
+      m_nQuality(s_data.Quality),
+      m_bAsyncReadBack(false),
+      m_unNextSlot(0),
+      m_pcResolveFBO(NULL),
+      m_unQueueSize(s_data.QueueSize),
+      m_bDropFrames(s_data.DropFrames),
+      m_unDroppedFrames(0),
+      m_bStopping(false),
+      m_strStreamFormat(s_data.StreamFormat),
+      m_pcStream(NULL),
+      m_bStreamIsPipe(false),
+      m_unStreamFrameRate(s_data.StreamFrameRate) {
+      initializeOpenGLFunctions();
+      /* Asynchronous read back needs pixel buffer objects and framebuffer blitting */
+      QPair<int,int> cVersion = QOpenGLContext::currentContext()->format().version();
+      m_bAsyncReadBack = (cVersion >= qMakePair(3, 0));
+      if(m_bAsyncReadBack) {
+         m_vecReadBackSlots.resize(READ_BACK_SLOTS);
+         for(UInt32 i = 0; i < READ_BACK_SLOTS; ++i) {
+            glGenBuffers(1, &m_vecReadBackSlots[i].Buffer);
+         }
+      }
+      else {
+         LOG << "[INFO] OpenGL "
+             << cVersion.first << "." << cVersion.second
+             << " does not support asynchronous read back, frames will be grabbed synchronously."
+             << std::endl;
+      }
+      /* Open the stream, if necessary */
+      if(!m_strStreamFormat.isEmpty()) {
+         QString strOutput;
+         if(!s_data.StreamCommand.isEmpty()) {
+            strOutput = s_data.StreamCommand;
+            m_pcStream = ::popen(strOutput.toLocal8Bit().constData(), "w");
+            m_bStreamIsPipe = true;
+         }
+         else {
+            strOutput = s_data.StreamFile.isEmpty() ?
+               QString("%1/%2.%3").arg(s_data.Directory).arg(s_data.BaseName).arg(m_strStreamFormat) :
+               s_data.StreamFile;
+            m_pcStream = ::fopen(strOutput.toLocal8Bit().constData(), "wb");
+         }
+         if(m_pcStream == NULL) {
+            LOGERR << "[WARNING] Can't open the frame stream \""
+                   << strOutput.toStdString()
+                   << "\": "
+                   << ::strerror(errno)
+                   << ". Storing one file per frame instead."
+                   << std::endl;
+            m_strStreamFormat.clear();
+         }
+      }
+      /* Start the encoders; a stream must be written in order by a single thread */
+      UInt32 unEncoders = s_data.EncoderThreads;
+      if(m_pcStream != NULL && unEncoders > 1) {
+         unEncoders = 1;
+      }
+      for(UInt32 i = 0; i < unEncoders; ++i) {
+         m_vecEncoders.push_back(new CQTOpenGLFrameEncoder(*this));
+         m_vecEncoders.back()->start();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLFrameGrabber::~CQTOpenGLFrameGrabber() {
+      /* Queue the frames still being read back */
+      Flush();
+      /* Let the encoders finish the queue, then stop them */
+      m_cQueueMutex.lock();
+      m_bStopping = true;
+      m_cQueueNotEmpty.wakeAll();
+      m_cQueueMutex.unlock();
+      for(size_t i = 0; i < m_vecEncoders.size(); ++i) {
+         m_vecEncoders[i]->wait();
+         delete m_vecEncoders[i];
+      }
+      /* Close the stream */
+      if(m_pcStream != NULL) {
+         if(m_bStreamIsPipe) ::pclose(m_pcStream);
+         else ::fclose(m_pcStream);
+      }
+      /* Release the OpenGL resources */
+      for(size_t i = 0; i < m_vecReadBackSlots.size(); ++i) {
+         glDeleteBuffers(1, &m_vecReadBackSlots[i].Buffer);
+      }
+      delete m_pcResolveFBO;
+      if(m_unDroppedFrames > 0) {
+         LOGERR << "[WARNING] Frame grabbing dropped "
+                << m_unDroppedFrames
+                << " frames because the encoders could not keep up."
+                << std::endl;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLFrameGrabber::Grab(CQTOpenGLWidget& c_widget,
+                                    const QString& str_file_name) {
+      if(!m_bAsyncReadBack) {
+         Enqueue(SFrame(c_widget.grabFramebuffer(), str_file_name, false));
+         return;
+      }
+      /* Free the slot to use, completing the read back issued READ_BACK_SLOTS frames ago */
+      SReadBackSlot& sSlot = m_vecReadBackSlots[m_unNextSlot];
+      if(sSlot.Pending) {
+         ReadBack(sSlot);
+      }
+      m_unNextSlot = (m_unNextSlot + 1) % READ_BACK_SLOTS;
+      /* Resolve the multisampled widget framebuffer into a single-sampled one */
+      QSize cSize = c_widget.size() * c_widget.devicePixelRatio();
+      if(m_pcResolveFBO == NULL || m_pcResolveFBO->size() != cSize) {
+         delete m_pcResolveFBO;
+         m_pcResolveFBO = new QOpenGLFramebufferObject(cSize);
+      }
+      glBindFramebuffer(GL_READ_FRAMEBUFFER, c_widget.defaultFramebufferObject());
+      glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_pcResolveFBO->handle());
+      glBlitFramebuffer(0, 0, cSize.width(), cSize.height(),
+                        0, 0, cSize.width(), cSize.height(),
+                        GL_COLOR_BUFFER_BIT, GL_NEAREST);
+      /* Start the read back; it completes while the next frames are drawn */
+      glBindFramebuffer(GL_READ_FRAMEBUFFER, m_pcResolveFBO->handle());
+      glBindBuffer(GL_PIXEL_PACK_BUFFER, sSlot.Buffer);
+      if(sSlot.Size != cSize) {
+         glBufferData(GL_PIXEL_PACK_BUFFER, cSize.width() * cSize.height() * 4, NULL, GL_STREAM_READ);
+         sSlot.Size = cSize;
+      }
+      glPixelStorei(GL_PACK_ALIGNMENT, 4);
+      glReadPixels(0, 0, cSize.width(), cSize.height(), GL_RGBA, GL_UNSIGNED_BYTE, 0);
+      glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+      glBindFramebuffer(GL_FRAMEBUFFER, c_widget.defaultFramebufferObject());
+      sSlot.FileName = str_file_name;
+      sSlot.Pending = true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLFrameGrabber::Flush() {
+      /* Oldest first, to keep the frames in order */
+      for(UInt32 i = 0; i < m_vecReadBackSlots.size(); ++i) {
+         SReadBackSlot& sSlot = m_vecReadBackSlots[(m_unNextSlot + i) % READ_BACK_SLOTS];
+         if(sSlot.Pending) {
+            ReadBack(sSlot);
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CQTOpenGLFrameGrabber::Dequeue(SFrame& s_frame) {
+      QMutexLocker cLocker(&m_cQueueMutex);
+      while(m_deqFrames.empty() && !m_bStopping) {
+         m_cQueueNotEmpty.wait(&m_cQueueMutex);
+      }
+      if(m_deqFrames.empty()) {
+         return false;
+      }
+      s_frame = m_deqFrames.front();
+      m_deqFrames.pop_front();
+      m_cQueueNotFull.wakeOne();
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLFrameGrabber::Encode(SFrame& s_frame) {
+      if(s_frame.BottomUp) {
+         s_frame.Image = s_frame.Image.mirrored();
+      }
+      if(!m_strStreamFormat.isEmpty()) {
+         if(m_pcStream != NULL) WriteStream(s_frame.Image);
+      }
+      else if(!s_frame.Image.save(s_frame.FileName, 0, m_nQuality)) {
+         LOGERR << "[WARNING] Can't store frame to \""
+                << s_frame.FileName.toStdString()
+                << "\""
+                << std::endl;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLFrameGrabber::ReadBack(SReadBackSlot& s_slot) {
+      glBindBuffer(GL_PIXEL_PACK_BUFFER, s_slot.Buffer);
+      GLsizeiptr nBytes = s_slot.Size.width() * s_slot.Size.height() * 4;
+      const uchar* puchData =
+         static_cast<const uchar*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, nBytes, GL_MAP_READ_BIT));
+      QImage cImage;
+      if(puchData != NULL) {
+         /* Copy the pixels out of the buffer, so it can be unmapped right away */
+         cImage = QImage(puchData,
+                         s_slot.Size.width(),
+                         s_slot.Size.height(),
+                         QImage::Format_RGBX8888).copy();
+         glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+      }
+      glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+      s_slot.Pending = false;
+      if(cImage.isNull()) {
+         LOGERR << "[WARNING] Can't read back frame \""
+                << s_slot.FileName.toStdString()
+                << "\""
+                << std::endl;
+         return;
+      }
+      Enqueue(SFrame(cImage, s_slot.FileName, true));
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLFrameGrabber::Enqueue(const SFrame& s_frame) {
+      /* No encoders: encode right away */
+      if(m_vecEncoders.empty()) {
+         SFrame sFrame(s_frame);
+         Encode(sFrame);
+         return;
+      }
+      QMutexLocker cLocker(&m_cQueueMutex);
+      while(m_deqFrames.size() >= m_unQueueSize) {
+         if(m_bDropFrames) {
+            ++m_unDroppedFrames;
+            return;
+         }
+         m_cQueueNotFull.wait(&m_cQueueMutex);
+      }
+      m_deqFrames.push_back(s_frame);
+      m_cQueueNotEmpty.wakeOne();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLFrameGrabber::WriteStream(const QImage& c_image) {
+      /* The first frame sets the stream size */
+      if(m_cStreamSize.isEmpty()) {
+         m_cStreamSize = c_image.size();
+         if(m_strStreamFormat == "y4m") {
+            ::fprintf(m_pcStream, "YUV4MPEG2 W%d H%d F%u:1 Ip A1:1 C444\n",
+                      m_cStreamSize.width(),
+                      m_cStreamSize.height(),
+                      m_unStreamFrameRate);
+         }
+      }
+      /* Frames must all have the same size */
+      QImage cImage = (c_image.size() == m_cStreamSize) ?
+         c_image.convertToFormat(QImage::Format_RGB888) :
+         c_image.scaled(m_cStreamSize).convertToFormat(QImage::Format_RGB888);
+      SInt32 nWidth = cImage.width();
+      SInt32 nHeight = cImage.height();
+      if(m_strStreamFormat == "raw") {
+         /* Packed RGB24, top to bottom */
+         for(SInt32 y = 0; y < nHeight; ++y) {
+            ::fwrite(cImage.constScanLine(y), 3, nWidth, m_pcStream);
+         }
+      }
+      else {
+         /* Planar YUV 4:4:4, BT.601 limited range */
+         std::vector<uchar> vecPlanes(3 * nWidth * nHeight);
+         uchar* puchY = &vecPlanes[0];
+         uchar* puchU = puchY + nWidth * nHeight;
+         uchar* puchV = puchU + nWidth * nHeight;
+         for(SInt32 y = 0; y < nHeight; ++y) {
+            const uchar* puchRGB = cImage.constScanLine(y);
+            for(SInt32 x = 0; x < nWidth; ++x, puchRGB += 3) {
+               SInt32 nR = puchRGB[0], nG = puchRGB[1], nB = puchRGB[2];
+               *(puchY++) = ((  66 * nR + 129 * nG +  25 * nB + 128) >> 8) +  16;
+               *(puchU++) = (( -38 * nR -  74 * nG + 112 * nB + 128) >> 8) + 128;
+               *(puchV++) = (( 112 * nR -  94 * nG -  18 * nB + 128) >> 8) + 128;
+            }
+         }
+         ::fputs("FRAME\n", m_pcStream);
+         ::fwrite(&vecPlanes[0], 1, vecPlanes.size(), m_pcStream);
+      }
+      if(::ferror(m_pcStream)) {
+         LOGERR << "[WARNING] Error writing to the frame stream, no more frames will be written."
+                << std::endl;
+         if(m_bStreamIsPipe) ::pclose(m_pcStream);
+         else ::fclose(m_pcStream);
+         m_pcStream = NULL;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
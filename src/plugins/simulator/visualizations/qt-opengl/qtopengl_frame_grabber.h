@@ -0,0 +1,218 @@
+/**
+ * @file <argos3/plugins/simulator/visualizations/qt-opengl/qtopengl_frame_grabber.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef QTOPENGL_FRAME_GRABBER_H
+#define QTOPENGL_FRAME_GRABBER_H
+
+namespace argos {
+   class CQTOpenGLFrameGrabber;
+   class CQTOpenGLFrameEncoder;
+}
+
+#include <argos3/plugins/simulator/visualizations/qt-opengl/qtopengl_widget.h>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLFramebufferObject>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QImage>
+#include <cstdio>
+#include <deque>
+#include <vector>
+
+namespace argos {
+
+   /**
+    * A thread that encodes the frames queued in a CQTOpenGLFrameGrabber.
+    */
+   class CQTOpenGLFrameEncoder : public QThread {
+
+   public:
+
+      CQTOpenGLFrameEncoder(CQTOpenGLFrameGrabber& c_grabber);
+
+      virtual ~CQTOpenGLFrameEncoder() {}
+
+   protected:
+
+      virtual void run();
+
+   private:
+
+      CQTOpenGLFrameGrabber& m_cGrabber;
+
+   };
+
+   /****************************************/
+   /****************************************/
+
+   /**
+    * Grabs the frames drawn by the OpenGL widget and stores them without
+    * stalling the GUI thread.
+    *
+    * The framebuffer is read back asynchronously into a ring of pixel
+    * buffer objects; a frame is mapped when its slot comes around again,
+    * that is, a few frames after the read was issued. The mapped frames
+    * are put in a bounded queue and encoded by a pool of threads, either
+    * into one image file per frame or into a raw RGB or YUV4MPEG2 stream
+    * written to a file or piped to an external command.
+    *
+    * When the queue is full, the grabber either blocks until an encoder
+    * frees a slot or drops the frame, depending on the configuration.
+    *
+    * All the methods must be called from the GUI thread with the OpenGL
+    * context current.
+    */
+   class CQTOpenGLFrameGrabber : protected QOpenGLExtraFunctions {
+
+   public:
+
+      /**
+       * A frame waiting to be encoded.
+       */
+      struct SFrame {
+         /** The frame pixels */
+         QImage Image;
+         /** The file name to save the frame to */
+         QString FileName;
+         /** True when the first row of the image is the bottom of the frame */
+         bool BottomUp;
+
+         SFrame() :
+            BottomUp(false) {}
+
+         SFrame(const QImage& c_image,
+                const QString& str_file_name,
+                bool b_bottom_up) :
+            Image(c_image),
+            FileName(str_file_name),
+            BottomUp(b_bottom_up) {}
+      };
+
+   public:
+
+      /**
+       * Class constructor.
+       * Must be called with the OpenGL context current.
+       * @param s_data The frame grabbing configuration.
+       */
+      CQTOpenGLFrameGrabber(const CQTOpenGLWidget::SFrameGrabData& s_data);
+
+      /**
+       * Class destructor.
+       * Completes the pending read backs, waits for all the queued frames
+       * to be encoded and closes the stream.
+       * Must be called with the OpenGL context current.
+       */
+      ~CQTOpenGLFrameGrabber();
+
+      /**
+       * Grabs the frame just drawn by the given widget.
+       * @param c_widget The widget.
+       * @param str_file_name The file name to save the frame to.
+       */
+      void Grab(CQTOpenGLWidget& c_widget,
+                const QString& str_file_name);
+
+      /**
+       * Completes the pending read backs and queues their frames.
+       */
+      void Flush();
+
+      /**
+       * Takes the next frame to encode out of the queue.
+       * Blocks until a frame is available.
+       * @param s_frame The frame.
+       * @return <tt>false</tt> when the grabber is being destroyed and the queue is empty.
+       */
+      bool Dequeue(SFrame& s_frame);
+
+      /**
+       * Encodes the given frame.
+       * @param s_frame The frame.
+       */
+      void Encode(SFrame& s_frame);
+
+      /**
+       * Returns the number of frames dropped because the queue was full.
+       */
+      inline UInt64 GetDroppedFrames() const {
+         return m_unDroppedFrames;
+      }
+
+   private:
+
+      /**
+       * A pixel buffer object the framebuffer is read back into.
+       */
+      struct SReadBackSlot {
+         GLuint Buffer;
+         QSize Size;
+         QString FileName;
+         bool Pending;
+
+         SReadBackSlot() :
+            Buffer(0),
+            Pending(false) {}
+      };
+
+   private:
+
+      void ReadBack(SReadBackSlot& s_slot);
+
+      void Enqueue(const SFrame& s_frame);
+
+      void WriteStream(const QImage& c_image);
+
+   private:
+
+      /** Number of read back slots */
+      static const UInt32 READ_BACK_SLOTS = 3;
+
+      /** Output image quality, as in QImage::save() */
+      SInt32 m_nQuality;
+
+      /** True when the framebuffer can be read back asynchronously */
+      bool m_bAsyncReadBack;
+      /** The read back ring */
+      std::vector<SReadBackSlot> m_vecReadBackSlots;
+      /** The next slot to use */
+      UInt32 m_unNextSlot;
+      /** Single-sampled copy of the widget framebuffer */
+      QOpenGLFramebufferObject* m_pcResolveFBO;
+
+      /** The frames waiting to be encoded */
+      std::deque<SFrame> m_deqFrames;
+      /** The maximum number of queued frames */
+      UInt32 m_unQueueSize;
+      /** True to drop frames when the queue is full, false to block */
+      bool m_bDropFrames;
+      /** Number of dropped frames */
+      UInt64 m_unDroppedFrames;
+      /** True when the encoders must quit once the queue is empty */
+      bool m_bStopping;
+      QMutex m_cQueueMutex;
+      QWaitCondition m_cQueueNotEmpty;
+      QWaitCondition m_cQueueNotFull;
+      /** The encoder threads; when empty, frames are encoded in the GUI thread */
+      std::vector<CQTOpenGLFrameEncoder*> m_vecEncoders;
+
+      /** Stream format: empty for one file per frame, "raw" or "y4m" */
+      QString m_strStreamFormat;
+      /** The stream, or NULL */
+      FILE* m_pcStream;
+      /** True when the stream is a pipe to an external command */
+      bool m_bStreamIsPipe;
+      /** The stream frame rate, written in the YUV4MPEG2 header */
+      UInt32 m_unStreamFrameRate;
+      /** The stream frame size, taken from the first frame */
+      QSize m_cStreamSize;
+
+   };
+
+}
+
+#endif
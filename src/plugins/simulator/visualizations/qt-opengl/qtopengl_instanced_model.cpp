@@ -0,0 +1,218 @@
+/**
+ * @file <argos3/plugins/simulator/visualizations/qt-opengl/qtopengl_instanced_model.cpp>
+ *
+ * @author agent - <agent@local>
+ */
+
+#include "qtopengl_instanced_model.h"
+#include <cstddef>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   const char* CQTOpenGLInstancedModel::POSITION_ATTRIBUTE = "position";
+   const char* CQTOpenGLInstancedModel::NORMAL_ATTRIBUTE   = "normal";
+   const char* CQTOpenGLInstancedModel::MODEL_ATTRIBUTE    = "instance_model";
+   const char* CQTOpenGLInstancedModel::COLOR_ATTRIBUTE    = "instance_color";
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLInstancedModel::SVertex::SVertex(const CVector3& c_position,
+                                             const CVector3& c_normal) {
+      Position[0] = c_position.GetX();
+      Position[1] = c_position.GetY();
+      Position[2] = c_position.GetZ();
+      Normal[0] = c_normal.GetX();
+      Normal[1] = c_normal.GetY();
+      Normal[2] = c_normal.GetZ();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLInstancedModel::CQTOpenGLInstancedModel(const TVertices& vec_triangles) :
+      m_cVertexBuffer(QOpenGLBuffer::VertexBuffer),
+      m_cInstanceBuffer(QOpenGLBuffer::VertexBuffer),
+      m_nVertices(vec_triangles.size()) {
+      initializeOpenGLFunctions();
+      /* Upload the mesh once */
+      m_cVertexBuffer.create();
+      m_cVertexBuffer.setUsagePattern(QOpenGLBuffer::StaticDraw);
+      m_cVertexBuffer.bind();
+      m_cVertexBuffer.allocate(&vec_triangles[0], vec_triangles.size() * sizeof(SVertex));
+      m_cVertexBuffer.release();
+      /* The instance buffer is refilled every frame */
+      m_cInstanceBuffer.create();
+      m_cInstanceBuffer.setUsagePattern(QOpenGLBuffer::StreamDraw);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLInstancedModel::~CQTOpenGLInstancedModel() {
+      m_cVertexBuffer.destroy();
+      m_cInstanceBuffer.destroy();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLInstancedModel::AddInstance(const CVector3& c_position,
+                                             const CQuaternion& c_orientation,
+                                             const CVector3& c_scale,
+                                             const CColor& c_color) {
+      /* The columns of the rotation matrix are the rotated axes */
+      CVector3 cAxisX(CVector3::X), cAxisY(CVector3::Y), cAxisZ(CVector3::Z);
+      cAxisX.Rotate(c_orientation);
+      cAxisY.Rotate(c_orientation);
+      cAxisZ.Rotate(c_orientation);
+      cAxisX *= c_scale.GetX();
+      cAxisY *= c_scale.GetY();
+      cAxisZ *= c_scale.GetZ();
+      /* Column-major model matrix */
+      m_vecInstanceData.push_back(cAxisX.GetX());
+      m_vecInstanceData.push_back(cAxisX.GetY());
+      m_vecInstanceData.push_back(cAxisX.GetZ());
+      m_vecInstanceData.push_back(0.0f);
+      m_vecInstanceData.push_back(cAxisY.GetX());
+      m_vecInstanceData.push_back(cAxisY.GetY());
+      m_vecInstanceData.push_back(cAxisY.GetZ());
+      m_vecInstanceData.push_back(0.0f);
+      m_vecInstanceData.push_back(cAxisZ.GetX());
+      m_vecInstanceData.push_back(cAxisZ.GetY());
+      m_vecInstanceData.push_back(cAxisZ.GetZ());
+      m_vecInstanceData.push_back(0.0f);
+      m_vecInstanceData.push_back(c_position.GetX());
+      m_vecInstanceData.push_back(c_position.GetY());
+      m_vecInstanceData.push_back(c_position.GetZ());
+      m_vecInstanceData.push_back(1.0f);
+      /* Color */
+      m_vecInstanceData.push_back(c_color.GetRed()   / 255.0f);
+      m_vecInstanceData.push_back(c_color.GetGreen() / 255.0f);
+      m_vecInstanceData.push_back(c_color.GetBlue()  / 255.0f);
+      m_vecInstanceData.push_back(c_color.GetAlpha() / 255.0f);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLInstancedModel::Draw(QOpenGLShaderProgram& c_program) {
+      if(m_vecInstanceData.empty()) return;
+      GLint nPosition = c_program.attributeLocation(POSITION_ATTRIBUTE);
+      GLint nNormal   = c_program.attributeLocation(NORMAL_ATTRIBUTE);
+      GLint nModel    = c_program.attributeLocation(MODEL_ATTRIBUTE);
+      GLint nColor    = c_program.attributeLocation(COLOR_ATTRIBUTE);
+      /* Per-vertex attributes */
+      m_cVertexBuffer.bind();
+      c_program.enableAttributeArray(nPosition);
+      c_program.setAttributeBuffer(nPosition, GL_FLOAT, offsetof(SVertex, Position), 3, sizeof(SVertex));
+      c_program.enableAttributeArray(nNormal);
+      c_program.setAttributeBuffer(nNormal, GL_FLOAT, offsetof(SVertex, Normal), 3, sizeof(SVertex));
+      m_cVertexBuffer.release();
+      /* Per-instance attributes: the matrix takes four consecutive locations */
+      m_cInstanceBuffer.bind();
+      m_cInstanceBuffer.allocate(&m_vecInstanceData[0], m_vecInstanceData.size() * sizeof(GLfloat));
+      for(GLint i = 0; i < 4; ++i) {
+         c_program.enableAttributeArray(nModel + i);
+         c_program.setAttributeBuffer(nModel + i, GL_FLOAT, 4 * i * sizeof(GLfloat), 4, INSTANCE_SIZE * sizeof(GLfloat));
+         glVertexAttribDivisor(nModel + i, 1);
+      }
+      c_program.enableAttributeArray(nColor);
+      c_program.setAttributeBuffer(nColor, GL_FLOAT, 16 * sizeof(GLfloat), 4, INSTANCE_SIZE * sizeof(GLfloat));
+      glVertexAttribDivisor(nColor, 1);
+      m_cInstanceBuffer.release();
+      /* Draw all the instances at once */
+      glDrawArraysInstanced(GL_TRIANGLES, 0, m_nVertices, GetNumInstances());
+      /* Restore the attribute state */
+      for(GLint i = 0; i < 4; ++i) {
+         glVertexAttribDivisor(nModel + i, 0);
+         c_program.disableAttributeArray(nModel + i);
+      }
+      glVertexAttribDivisor(nColor, 0);
+      c_program.disableAttributeArray(nColor);
+      c_program.disableAttributeArray(nNormal);
+      c_program.disableAttributeArray(nPosition);
+      /* Ready for the next frame */
+      m_vecInstanceData.clear();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLInstancedModel::MakeSphere(TVertices& vec_triangles,
+                                            Real f_radius,
+                                            UInt32 un_slices) {
+      CRadians cInclinationSlice(CRadians::PI / un_slices);
+      CRadians cAzimuthSlice(CRadians::TWO_PI / un_slices);
+      CVector3 cN00, cN01, cN10, cN11;
+      for(UInt32 i = 0; i < un_slices; ++i) {
+         CRadians cInclination = cInclinationSlice * i;
+         for(UInt32 j = 0; j < un_slices; ++j) {
+            CRadians cAzimuth = cAzimuthSlice * j;
+            cN00.FromSphericalCoords(1.0f, cInclination,                     cAzimuth);
+            cN01.FromSphericalCoords(1.0f, cInclination,                     cAzimuth + cAzimuthSlice);
+            cN10.FromSphericalCoords(1.0f, cInclination + cInclinationSlice, cAzimuth);
+            cN11.FromSphericalCoords(1.0f, cInclination + cInclinationSlice, cAzimuth + cAzimuthSlice);
+            vec_triangles.push_back(SVertex(f_radius * cN00, cN00));
+            vec_triangles.push_back(SVertex(f_radius * cN10, cN10));
+            vec_triangles.push_back(SVertex(f_radius * cN11, cN11));
+            vec_triangles.push_back(SVertex(f_radius * cN00, cN00));
+            vec_triangles.push_back(SVertex(f_radius * cN11, cN11));
+            vec_triangles.push_back(SVertex(f_radius * cN01, cN01));
+         }
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLInstancedModel::MakeCylinder(TVertices& vec_triangles,
+                                              UInt32 un_slices) {
+      CRadians cAngle(CRadians::TWO_PI / un_slices);
+      CVector3 cCurrent(1.0f, 0.0f, 0.0f), cNext;
+      for(UInt32 i = 0; i < un_slices; ++i) {
+         cNext = cCurrent;
+         cNext.RotateZ(cAngle);
+         /* Side surface */
+         vec_triangles.push_back(SVertex(cCurrent + CVector3::Z, cCurrent));
+         vec_triangles.push_back(SVertex(cCurrent,               cCurrent));
+         vec_triangles.push_back(SVertex(cNext,                  cNext));
+         vec_triangles.push_back(SVertex(cCurrent + CVector3::Z, cCurrent));
+         vec_triangles.push_back(SVertex(cNext,                  cNext));
+         vec_triangles.push_back(SVertex(cNext + CVector3::Z,    cNext));
+         /* Top disk */
+         vec_triangles.push_back(SVertex(CVector3::Z,            CVector3::Z));
+         vec_triangles.push_back(SVertex(cCurrent + CVector3::Z, CVector3::Z));
+         vec_triangles.push_back(SVertex(cNext + CVector3::Z,    CVector3::Z));
+         /* Bottom disk */
+         vec_triangles.push_back(SVertex(CVector3::ZERO,         -CVector3::Z));
+         vec_triangles.push_back(SVertex(cNext,                  -CVector3::Z));
+         vec_triangles.push_back(SVertex(cCurrent,               -CVector3::Z));
+         cCurrent = cNext;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLInstancedModel::MakeQuad(TVertices& vec_triangles,
+                                          const CVector3& c_normal,
+                                          const CVector3& c_v0,
+                                          const CVector3& c_v1,
+                                          const CVector3& c_v2,
+                                          const CVector3& c_v3) {
+      vec_triangles.push_back(SVertex(c_v0, c_normal));
+      vec_triangles.push_back(SVertex(c_v1, c_normal));
+      vec_triangles.push_back(SVertex(c_v2, c_normal));
+      vec_triangles.push_back(SVertex(c_v0, c_normal));
+      vec_triangles.push_back(SVertex(c_v2, c_normal));
+      vec_triangles.push_back(SVertex(c_v3, c_normal));
+   }
+
+   /****************************************/
+   /****************************************/
+
+}
@@ -0,0 +1,142 @@
+/**
+ * @file <argos3/plugins/simulator/visualizations/qt-opengl/qtopengl_instanced_model.h>
+ *
+ * @author agent - <agent@local>
+ */
+
+#ifndef QTOPENGL_INSTANCED_MODEL_H
+#define QTOPENGL_INSTANCED_MODEL_H
+
+namespace argos {
+   class CQTOpenGLInstancedModel;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <argos3/core/utility/datatypes/color.h>
+#include <argos3/core/utility/math/vector3.h>
+#include <argos3/core/utility/math/quaternion.h>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLBuffer>
+#include <vector>
+
+namespace argos {
+
+   /**
+    * A triangle mesh uploaded once to the GPU and drawn many times per frame.
+    * During a frame, the instances to draw are accumulated with AddInstance().
+    * Draw() then uploads their transforms and colors to a per-frame buffer and
+    * draws all of them with a single instanced call.
+    * @see CQTOpenGLWidget::GetInstancedModel
+    */
+   class CQTOpenGLInstancedModel : protected QOpenGLExtraFunctions {
+
+   public:
+
+      /**
+       * A mesh vertex.
+       */
+      struct SVertex {
+         GLfloat Position[3];
+         GLfloat Normal[3];
+
+         SVertex(const CVector3& c_position,
+                 const CVector3& c_normal);
+      };
+
+      typedef std::vector<SVertex> TVertices;
+
+   public:
+
+      /**
+       * Class constructor.
+       * Must be called with the OpenGL context current.
+       * @param vec_triangles The mesh, three vertices per triangle.
+       */
+      CQTOpenGLInstancedModel(const TVertices& vec_triangles);
+
+      virtual ~CQTOpenGLInstancedModel();
+
+      /**
+       * Adds an instance to draw in the current frame.
+       * @param c_position The position of the instance.
+       * @param c_orientation The orientation of the instance.
+       * @param c_scale The scale of the instance along its local axes.
+       * @param c_color The color of the instance.
+       */
+      void AddInstance(const CVector3& c_position,
+                       const CQuaternion& c_orientation,
+                       const CVector3& c_scale,
+                       const CColor& c_color);
+
+      /**
+       * Draws the instances added in the current frame and clears them.
+       * @param c_program The instancing shader program, already bound.
+       */
+      void Draw(QOpenGLShaderProgram& c_program);
+
+      /**
+       * Returns the number of instances added in the current frame.
+       */
+      inline size_t GetNumInstances() const {
+         return m_vecInstanceData.size() / INSTANCE_SIZE;
+      }
+
+      /**
+       * Appends the triangles of a sphere centered in the origin to the given mesh.
+       * @param vec_triangles The mesh.
+       * @param f_radius The radius of the sphere.
+       * @param un_slices The number of slices along inclination and azimuth.
+       */
+      static void MakeSphere(TVertices& vec_triangles,
+                             Real f_radius,
+                             UInt32 un_slices);
+
+      /**
+       * Appends the triangles of a cylinder to the given mesh.
+       * The cylinder has unit radius and height, its axis is Z and its
+       * base is centered in the origin, so that the scale of an instance
+       * sets its radius and height.
+       * @param vec_triangles The mesh.
+       * @param un_slices The number of slices of the side surface.
+       */
+      static void MakeCylinder(TVertices& vec_triangles,
+                               UInt32 un_slices);
+
+      /**
+       * Appends the two triangles of a quad to the given mesh.
+       * The vertices must be given counter-clockwise.
+       */
+      static void MakeQuad(TVertices& vec_triangles,
+                           const CVector3& c_normal,
+                           const CVector3& c_v0,
+                           const CVector3& c_v1,
+                           const CVector3& c_v2,
+                           const CVector3& c_v3);
+
+   public:
+
+      /** Name of the per-vertex position attribute in the instancing shader */
+      static const char* POSITION_ATTRIBUTE;
+      /** Name of the per-vertex normal attribute in the instancing shader */
+      static const char* NORMAL_ATTRIBUTE;
+      /** Name of the per-instance model matrix attribute in the instancing shader */
+      static const char* MODEL_ATTRIBUTE;
+      /** Name of the per-instance color attribute in the instancing shader */
+      static const char* COLOR_ATTRIBUTE;
+
+   private:
+
+      /** Per-instance data: 4x4 column-major model matrix followed by RGBA color */
+      static const UInt32 INSTANCE_SIZE = 20;
+
+      QOpenGLBuffer m_cVertexBuffer;
+      QOpenGLBuffer m_cInstanceBuffer;
+      GLsizei m_nVertices;
+      std::vector<GLfloat> m_vecInstanceData;
+
+   };
+
+}
+
+#endif
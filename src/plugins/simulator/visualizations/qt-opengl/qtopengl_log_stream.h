@@ -12,6 +12,7 @@ namespace argos {
 }
 
 #include <QTextEdit>
+#include <QMutex>
 #include <argos3/core/simulator/simulator.h>
 #include <argos3/core/simulator/space/space.h>
 #include <argos3/core/utility/string_utilities.h>
@@ -39,12 +40,13 @@ namespace argos {
       }
 
       virtual int_type overflow(int_type t_value) {
+         QMutexLocker cLocker(&m_cMutex);
          if (t_value == '\n') {
             std::string strTmp(m_strBuffer);
             Replace(strTmp, "<", "&lt;");
             Replace(strTmp, ">", "&gt;");
             strTmp = "<b>[t=" + ToString(m_cSpace.GetSimulationClock()) + "]</b> " + strTmp;
-            m_pcTextEdit->append(strTmp.c_str());
+            Append(strTmp);
             m_strBuffer.erase(m_strBuffer.begin(), m_strBuffer.end());
          }
          else {
@@ -55,6 +57,7 @@ namespace argos {
 
       virtual std::streamsize xsputn(const char* pc_message,
                                      std::streamsize un_size) {
+         QMutexLocker cLocker(&m_cMutex);
          /* Add the message to text stream */
          m_strBuffer.append(pc_message, pc_message + un_size);
          size_t nPos = 0;
@@ -70,7 +73,7 @@ namespace argos {
                Replace(strTmp, ">", "&gt;");
                strTmp = "<b>[t=" + ToString(m_cSpace.GetSimulationClock()) + "]</b> " + strTmp;
                /* Append it to the text windoe */
-               m_pcTextEdit->append(strTmp.c_str());
+               Append(strTmp);
                /* Erase the displayed portion from the text stream */
                m_strBuffer.erase(m_strBuffer.begin(), m_strBuffer.begin() + nPos + 1);
             }
@@ -81,6 +84,20 @@ namespace argos {
 
    private:
 
+      /*
+       * The log can be written by the simulation thread while fast-forwarding:
+       * the text is appended in the thread owning the text widget.
+       */
+      void Append(const std::string& str_text) {
+         QMetaObject::invokeMethod(m_pcTextEdit,
+                                   "append",
+                                   Qt::AutoConnection,
+                                   Q_ARG(QString, QString(str_text.c_str())));
+      }
+
+   private:
+
+      QMutex m_cMutex;
       std::ostream& m_cStream;
       std::streambuf* m_pcOldStream;
       std::string m_strBuffer;
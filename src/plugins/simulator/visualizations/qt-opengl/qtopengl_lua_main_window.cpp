@@ -33,12 +33,16 @@
 #include <QToolBar>
 #include <QTableWidget>
 #include <QTreeView>
+#include <QTimer>
 
 namespace argos {
 
    /****************************************/
    /****************************************/
 
+   /** Minimum time between two refreshes of the variable and function trees, in ms */
+   static const int STATE_TREE_REFRESH_PERIOD = 40;
+
    static QString SCRIPT_TEMPLATE =
       "-- Use Shift + Click to select a robot\n"
       "-- When a robot is selected, its variables appear in this editor\n\n"
@@ -403,6 +407,23 @@ namespace argos {
       m_pcLuaFunctionDock->setWidget(m_pcLuaFunctionTree);
       addDockWidget(Qt::LeftDockWidgetArea, m_pcLuaFunctionDock);
       m_pcLuaFunctionDock->hide();
+      /* The trees are refreshed at most once per period, not at every step */
+      m_pcStateTreeRefreshTimer = new QTimer(this);
+      m_pcStateTreeRefreshTimer->setSingleShot(true);
+      m_pcStateTreeRefreshTimer->setInterval(STATE_TREE_REFRESH_PERIOD);
+      connect(m_pcStateTreeRefreshTimer, SIGNAL(timeout()),
+              this, SLOT(RefreshStateTrees()));
+      connect(&(m_pcMainWindow->GetOpenGLWidget()), SIGNAL(StepDone(int)),
+              this, SLOT(ScheduleStateTreeRefresh(int)));
+      /* Only the expanded tables are refreshed */
+      connect(m_pcLuaVariableTree, SIGNAL(expanded(const QModelIndex&)),
+              this, SLOT(StateTreeExpanded(const QModelIndex&)));
+      connect(m_pcLuaVariableTree, SIGNAL(collapsed(const QModelIndex&)),
+              this, SLOT(StateTreeCollapsed(const QModelIndex&)));
+      connect(m_pcLuaFunctionTree, SIGNAL(expanded(const QModelIndex&)),
+              this, SLOT(StateTreeExpanded(const QModelIndex&)));
+      connect(m_pcLuaFunctionTree, SIGNAL(collapsed(const QModelIndex&)),
+              this, SLOT(StateTreeCollapsed(const QModelIndex&)));
       /* Connect stuff */
       connect(&(m_pcMainWindow->GetOpenGLWidget()), SIGNAL(EntitySelected(CEntity*)),
               this, SLOT(HandleEntitySelection(CEntity*)));
@@ -711,8 +732,6 @@ namespace argos {
                                                       false,
                                                       m_pcLuaVariableTree);
             pcVarModel->Refresh();
-            connect(&(m_pcMainWindow->GetOpenGLWidget()), SIGNAL(StepDone(int)),
-                    pcVarModel, SLOT(Refresh(int)));
             connect(m_pcMainWindow, SIGNAL(ExperimentReset()),
                     pcVarModel, SLOT(Refresh()));
             connect(pcVarModel, SIGNAL(modelReset()),
@@ -720,15 +739,13 @@ namespace argos {
                     Qt::QueuedConnection);
             m_pcLuaVariableTree->setModel(pcVarModel);
             m_pcLuaVariableTree->setRootIndex(pcVarModel->index(0, 0));
-            m_pcLuaVariableTree->expandAll();
+            m_pcLuaVariableTree->expandToDepth(0);
             m_pcLuaVariableDock->show();
             CQTOpenGLLuaStateTreeFunctionModel* pcFunModel =
                new CQTOpenGLLuaStateTreeFunctionModel(m_vecControllers[m_unSelectedRobot]->GetLuaState(),
                                                       true,
                                                       m_pcLuaFunctionTree);
             pcFunModel->Refresh();
-            connect(&(m_pcMainWindow->GetOpenGLWidget()), SIGNAL(StepDone(int)),
-                    pcFunModel, SLOT(Refresh(int)));
             connect(m_pcMainWindow, SIGNAL(ExperimentReset()),
                     pcFunModel, SLOT(Refresh()));
             connect(pcFunModel, SIGNAL(modelReset()),
@@ -736,7 +753,7 @@ namespace argos {
                     Qt::QueuedConnection);
             m_pcLuaFunctionTree->setModel(pcFunModel);
             m_pcLuaFunctionTree->setRootIndex(pcFunModel->index(0, 0));
-            m_pcLuaFunctionTree->expandAll();
+            m_pcLuaFunctionTree->expandToDepth(0);
             m_pcLuaFunctionDock->show();
          }
       }
@@ -746,8 +763,7 @@ namespace argos {
    /****************************************/
 
    void CQTOpenGLLuaMainWindow::HandleEntityDeselection(CEntity* pc_entity) {
-      disconnect(&(m_pcMainWindow->GetOpenGLWidget()), SIGNAL(StepDone(int)),
-                 m_pcLuaVariableTree->model(), SLOT(Refresh(int)));
+      m_pcStateTreeRefreshTimer->stop();
       disconnect(m_pcMainWindow, SIGNAL(ExperimentReset()),
                  m_pcLuaVariableTree->model(), SLOT(Refresh()));
       disconnect(m_pcLuaVariableTree->model(), SIGNAL(modelReset()),
@@ -755,8 +771,6 @@ namespace argos {
       m_pcLuaVariableDock->hide();
       delete m_pcLuaVariableTree->model();
       m_pcLuaVariableTree->setModel(NULL);
-      disconnect(&(m_pcMainWindow->GetOpenGLWidget()), SIGNAL(StepDone(int)),
-                 m_pcLuaFunctionTree->model(), SLOT(Refresh(int)));
       disconnect(m_pcMainWindow, SIGNAL(ExperimentReset()),
                  m_pcLuaFunctionTree->model(), SLOT(Refresh()));
       disconnect(m_pcLuaFunctionTree->model(), SIGNAL(modelReset()),
@@ -771,7 +785,7 @@ namespace argos {
 
    void CQTOpenGLLuaMainWindow::VariableTreeChanged() {
       m_pcLuaVariableTree->setRootIndex(m_pcLuaVariableTree->model()->index(0, 0));
-      m_pcLuaVariableTree->expandAll();
+      m_pcLuaVariableTree->expandToDepth(0);
    }
 
    /****************************************/
@@ -779,7 +793,49 @@ namespace argos {
 
    void CQTOpenGLLuaMainWindow::FunctionTreeChanged() {
       m_pcLuaFunctionTree->setRootIndex(m_pcLuaFunctionTree->model()->index(0, 0));
-      m_pcLuaFunctionTree->expandAll();
+      m_pcLuaFunctionTree->expandToDepth(0);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLLuaMainWindow::ScheduleStateTreeRefresh(int) {
+      if(m_pcLuaVariableTree->model() != NULL &&
+         !m_pcStateTreeRefreshTimer->isActive()) {
+         m_pcStateTreeRefreshTimer->start();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLLuaMainWindow::RefreshStateTrees() {
+      if(m_pcLuaVariableTree->model() == NULL) return;
+      /* The simulation may be running in another thread */
+      m_pcMainWindow->GetOpenGLWidget().LockSimulation();
+      static_cast<CQTOpenGLLuaStateTreeModel*>(m_pcLuaVariableTree->model())->Refresh();
+      static_cast<CQTOpenGLLuaStateTreeModel*>(m_pcLuaFunctionTree->model())->Refresh();
+      m_pcMainWindow->GetOpenGLWidget().UnlockSimulation();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLLuaMainWindow::StateTreeExpanded(const QModelIndex& c_index) {
+      CQTOpenGLLuaStateTreeModel* pcModel =
+         static_cast<CQTOpenGLLuaStateTreeModel*>(const_cast<QAbstractItemModel*>(c_index.model()));
+      pcModel->SetExpanded(c_index, true);
+      /* The content of the table may be out of date */
+      m_pcMainWindow->GetOpenGLWidget().LockSimulation();
+      pcModel->Refresh();
+      m_pcMainWindow->GetOpenGLWidget().UnlockSimulation();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLLuaMainWindow::StateTreeCollapsed(const QModelIndex& c_index) {
+      static_cast<CQTOpenGLLuaStateTreeModel*>(const_cast<QAbstractItemModel*>(c_index.model()))->SetExpanded(c_index, false);
    }
 
    /****************************************/
@@ -21,6 +21,8 @@ class QAction;
 class QStatusBar;
 class QTableWidget;
 class QTreeView;
+class QTimer;
+class QModelIndex;
 
 #include <QMainWindow>
 
@@ -51,6 +53,10 @@ namespace argos {
       void HandleEntityDeselection(CEntity* pc_entity);
       void VariableTreeChanged();
       void FunctionTreeChanged();
+      void ScheduleStateTreeRefresh(int n_step);
+      void RefreshStateTrees();
+      void StateTreeExpanded(const QModelIndex& c_index);
+      void StateTreeCollapsed(const QModelIndex& c_index);
 
    private:
 
@@ -90,6 +96,7 @@ namespace argos {
       QDockWidget* m_pcLuaFunctionDock;
       QTreeView* m_pcLuaVariableTree;
       QTreeView* m_pcLuaFunctionTree;
+      QTimer* m_pcStateTreeRefreshTimer;
 
       std::vector<CLuaController*> m_vecControllers;
       std::vector<CComposableEntity*> m_vecRobots;
@@ -13,7 +13,9 @@ namespace argos {
    /****************************************/
 
    CQTOpenGLLuaStateTreeItem::CQTOpenGLLuaStateTreeItem(CQTOpenGLLuaStateTreeItem* pc_parent) :
-      m_pcParent(pc_parent) {}
+      m_pcParent(pc_parent),
+      m_bExpanded(false),
+      m_bVisited(true) {}
 
    /****************************************/
    /****************************************/
@@ -21,7 +23,9 @@ namespace argos {
    CQTOpenGLLuaStateTreeItem::CQTOpenGLLuaStateTreeItem(QList<QVariant>& list_data,
                                                         CQTOpenGLLuaStateTreeItem* pc_parent) :
       m_listData(list_data),
-      m_pcParent(pc_parent) {}
+      m_pcParent(pc_parent),
+      m_bExpanded(false),
+      m_bVisited(true) {}
 
    /****************************************/
    /****************************************/
@@ -68,17 +72,28 @@ namespace argos {
    /****************************************/
    /****************************************/
 
-   bool ItemLessThan(const CQTOpenGLLuaStateTreeItem* pc_i1,
-                     const CQTOpenGLLuaStateTreeItem* pc_i2) {
-      if(pc_i1->GetData(0).type() == QVariant::Double &&
-         pc_i2->GetData(0).type() == QVariant::Double) {
-         return pc_i1->GetData(0).toDouble() < pc_i2->GetData(0).toDouble();
+   bool CQTOpenGLLuaStateTreeItem::KeyLessThan(const QVariant& c_key1,
+                                               const QVariant& c_key2) {
+      if(c_key1.type() == QVariant::Double &&
+         c_key2.type() == QVariant::Double) {
+         return c_key1.toDouble() < c_key2.toDouble();
       }
       else {
-         return pc_i1->GetData(0).toString().toLower() < pc_i2->GetData(0).toString().toLower();
+         QString strKey1 = c_key1.toString();
+         QString strKey2 = c_key2.toString();
+         int nCmp = strKey1.compare(strKey2, Qt::CaseInsensitive);
+         if(nCmp != 0) return nCmp < 0;
+         /* Break ties between keys differing only in case or type, so that keys are unique */
+         if(strKey1 != strKey2) return strKey1 < strKey2;
+         return c_key1.type() < c_key2.type();
       }
    }
 
+   bool ItemLessThan(const CQTOpenGLLuaStateTreeItem* pc_i1,
+                     const CQTOpenGLLuaStateTreeItem* pc_i2) {
+      return CQTOpenGLLuaStateTreeItem::KeyLessThan(pc_i1->GetData(0), pc_i2->GetData(0));
+   }
+
    void CQTOpenGLLuaStateTreeItem::SortChildren() {
       qSort(m_listChildren.begin(), m_listChildren.end(), ItemLessThan);
       foreach(CQTOpenGLLuaStateTreeItem* pcItem, m_listChildren) {
@@ -96,6 +111,61 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   const QList<QVariant>& CQTOpenGLLuaStateTreeItem::GetData() const {
+      return m_listData;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLLuaStateTreeItem::SetData(const QList<QVariant>& list_data) {
+      m_listData = list_data;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLLuaStateTreeItem* CQTOpenGLLuaStateTreeItem::FindChild(const QVariant& c_key) {
+      /* Binary search on the sorted children */
+      int nLow = 0;
+      int nHigh = m_listChildren.count();
+      while(nLow < nHigh) {
+         int nMid = (nLow + nHigh) / 2;
+         if(KeyLessThan(m_listChildren[nMid]->GetData(0), c_key)) {
+            nLow = nMid + 1;
+         }
+         else {
+            nHigh = nMid;
+         }
+      }
+      if(nLow < m_listChildren.count() &&
+         !KeyLessThan(c_key, m_listChildren[nLow]->GetData(0))) {
+         return m_listChildren[nLow];
+      }
+      return NULL;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLLuaStateTreeItem::InsertChild(size_t un_idx,
+                                               CQTOpenGLLuaStateTreeItem* pc_child) {
+      pc_child->m_pcParent = this;
+      m_listChildren.insert(un_idx, pc_child);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLLuaStateTreeItem* CQTOpenGLLuaStateTreeItem::TakeChild(size_t un_idx) {
+      CQTOpenGLLuaStateTreeItem* pcChild = m_listChildren.takeAt(un_idx);
+      pcChild->m_pcParent = NULL;
+      return pcChild;
+   }
+
+   /****************************************/
+   /****************************************/
+
    int CQTOpenGLLuaStateTreeItem::GetRow() {
       if(m_pcParent != NULL) {
          return m_pcParent->m_listChildren.indexOf(const_cast<CQTOpenGLLuaStateTreeItem*>(this));
@@ -38,13 +38,67 @@ namespace argos {
 
       QVariant GetData(int n_col) const;
 
+      const QList<QVariant>& GetData() const;
+
+      void SetData(const QList<QVariant>& list_data);
+
       int GetRow();
 
+      /**
+       * Returns the child with the given key, or <tt>NULL</tt>.
+       * The children must be sorted.
+       */
+      CQTOpenGLLuaStateTreeItem* FindChild(const QVariant& c_key);
+
+      /**
+       * Inserts a child at the given position, taking ownership of it.
+       */
+      void InsertChild(size_t un_idx,
+                       CQTOpenGLLuaStateTreeItem* pc_child);
+
+      /**
+       * Removes the child at the given position and returns it.
+       * The caller takes ownership of the child.
+       */
+      CQTOpenGLLuaStateTreeItem* TakeChild(size_t un_idx);
+
+      /**
+       * Returns <tt>true</tt> if the item is expanded in the view.
+       * The children of collapsed tables are not refreshed.
+       */
+      inline bool IsExpanded() const {
+         return m_bExpanded;
+      }
+
+      inline void SetExpanded(bool b_expanded) {
+         m_bExpanded = b_expanded;
+      }
+
+      /**
+       * Returns <tt>false</tt> if the item is a table whose content was not read.
+       */
+      inline bool IsVisited() const {
+         return m_bVisited;
+      }
+
+      inline void SetVisited(bool b_visited) {
+         m_bVisited = b_visited;
+      }
+
+      /**
+       * Returns <tt>true</tt> if the first item comes before the second.
+       * Numbers are sorted by value, the rest by case-insensitive string.
+       */
+      static bool KeyLessThan(const QVariant& c_key1,
+                              const QVariant& c_key2);
+
    private:
 
       QList<QVariant> m_listData;
       CQTOpenGLLuaStateTreeItem* m_pcParent;
       QList<CQTOpenGLLuaStateTreeItem*> m_listChildren;
+      bool m_bExpanded;
+      bool m_bVisited;
 
    };
 
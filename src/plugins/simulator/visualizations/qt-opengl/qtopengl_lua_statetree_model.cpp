@@ -127,22 +127,54 @@ namespace argos {
 
    void CQTOpenGLLuaStateTreeModel::SetLuaState(lua_State* pt_state) {
       m_ptState = pt_state;
+      /* Nothing in the current tree applies to the new state */
+      beginResetModel();
+      delete m_pcDataRoot;
+      m_pcDataRoot = new CQTOpenGLLuaStateTreeItem();
+      endResetModel();
       Refresh();
    }
 
    /****************************************/
    /****************************************/
 
+   void CQTOpenGLLuaStateTreeModel::SetExpanded(const QModelIndex& c_index,
+                                                bool b_expanded) {
+      if(c_index.isValid()) {
+         static_cast<CQTOpenGLLuaStateTreeItem*>(c_index.internalPointer())->SetExpanded(b_expanded);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CQTOpenGLLuaStateTreeModel::Refresh() {
-      beginResetModel();
-      delete m_pcDataRoot;
-      m_pcDataRoot = new CQTOpenGLLuaStateTreeItem();
+      /* Read the state, skipping the collapsed tables already known */
+      CQTOpenGLLuaStateTreeItem* pcNewRoot = new CQTOpenGLLuaStateTreeItem();
       lua_pushnil(m_ptState);
       lua_getglobal(m_ptState, "_G");
-      ProcessLuaState(m_ptState, m_pcDataRoot);
-      m_pcDataRoot->SortChildren();
+      ProcessLuaState(m_ptState, pcNewRoot, m_pcDataRoot);
+      pcNewRoot->SortChildren();
       lua_pop(m_ptState, 2);
-      endResetModel();
+      if(m_pcDataRoot->GetNumChildren() == 0) {
+         /* First read: the globals and their children start expanded */
+         beginResetModel();
+         delete m_pcDataRoot;
+         m_pcDataRoot = pcNewRoot;
+         if(m_pcDataRoot->GetNumChildren() > 0) {
+            CQTOpenGLLuaStateTreeItem* pcGlobals = m_pcDataRoot->GetChild(0);
+            pcGlobals->SetExpanded(true);
+            for(size_t i = 0; i < pcGlobals->GetNumChildren(); ++i) {
+               pcGlobals->GetChild(i)->SetExpanded(true);
+            }
+         }
+         endResetModel();
+      }
+      else {
+         /* Update only what changed, so the view keeps its state */
+         Merge(m_pcDataRoot, pcNewRoot, QModelIndex());
+         delete pcNewRoot;
+      }
    }
 
    /****************************************/
@@ -155,8 +187,53 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CQTOpenGLLuaStateTreeModel::Merge(CQTOpenGLLuaStateTreeItem* pc_old_item,
+                                          CQTOpenGLLuaStateTreeItem* pc_new_item,
+                                          const QModelIndex& c_index) {
+      /* Remove the children that disappeared */
+      for(int i = pc_old_item->GetNumChildren() - 1; i >= 0; --i) {
+         if(pc_new_item->FindChild(pc_old_item->GetChild(i)->GetData(0)) == NULL) {
+            beginRemoveRows(c_index, i, i);
+            delete pc_old_item->TakeChild(i);
+            endRemoveRows();
+         }
+      }
+      /*
+       * Both child lists are now sorted and every remaining old child has a
+       * new counterpart: walk them together, updating the common children
+       * and inserting the new ones
+       */
+      int nRow = 0;
+      while(pc_new_item->GetNumChildren() > 0) {
+         CQTOpenGLLuaStateTreeItem* pcNewChild = pc_new_item->GetChild(0);
+         CQTOpenGLLuaStateTreeItem* pcOldChild = pc_old_item->GetChild(nRow);
+         if(pcOldChild != NULL &&
+            !CQTOpenGLLuaStateTreeItem::KeyLessThan(pcNewChild->GetData(0), pcOldChild->GetData(0))) {
+            if(pcOldChild->GetData() != pcNewChild->GetData()) {
+               pcOldChild->SetData(pcNewChild->GetData());
+               emit dataChanged(createIndex(nRow, 0, pcOldChild),
+                                createIndex(nRow, columnCount() - 1, pcOldChild));
+            }
+            if(pcNewChild->IsVisited()) {
+               Merge(pcOldChild, pcNewChild, createIndex(nRow, 0, pcOldChild));
+            }
+            delete pc_new_item->TakeChild(0);
+         }
+         else {
+            beginInsertRows(c_index, nRow, nRow);
+            pc_old_item->InsertChild(nRow, pc_new_item->TakeChild(0));
+            endInsertRows();
+         }
+         ++nRow;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CQTOpenGLLuaStateTreeModel::ProcessLuaState(lua_State* pt_state,
-                                                    CQTOpenGLLuaStateTreeItem* pc_item) {
+                                                    CQTOpenGLLuaStateTreeItem* pc_item,
+                                                    CQTOpenGLLuaStateTreeItem* pc_old_item) {
       QList<QVariant> cData;
       switch(lua_type(pt_state, -2)) {
          case LUA_TBOOLEAN:
@@ -173,16 +250,31 @@ namespace argos {
       if(lua_istable(pt_state, -1)) {
          CQTOpenGLLuaStateTreeItem* pcChild = new CQTOpenGLLuaStateTreeItem(cData, pc_item);
          pc_item->AddChild(pcChild);
+         /* Collapsed tables are not visible: keep their current content */
+         CQTOpenGLLuaStateTreeItem* pcOldChild =
+            (pc_old_item != NULL) ? pc_old_item->FindChild(cData.value(0)) : NULL;
+         if(pcOldChild != NULL &&
+            !pcOldChild->IsExpanded() &&
+            pcOldChild->GetNumChildren() > 0) {
+            pcChild->SetVisited(false);
+            return;
+         }
+         /* Lazy sensor tables are empty proxies, show the actual readings instead */
+         if(luaL_getmetafield(pt_state, -1, "__readings") == LUA_TNIL) {
+            lua_pushvalue(pt_state, -1);
+         }
          lua_pushnil(pt_state);
          while(lua_next(pt_state, -2)) {
             if(IsTypeVisitable(pt_state)) {
-               ProcessLuaState(pt_state, pcChild);
+               ProcessLuaState(pt_state, pcChild, pcOldChild);
             }
             lua_pop(pt_state, 1);
          }
+         lua_pop(pt_state, 1);
          if(m_bRemoveEmptyTables) {
             if(pcChild->GetNumChildren() == 0) {
                pc_item->RemoveChild(pcChild);
+               delete pcChild;
             }
          }
       }
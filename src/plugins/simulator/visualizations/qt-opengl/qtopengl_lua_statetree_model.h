@@ -54,15 +54,43 @@ namespace argos {
 
       void SetLuaState(lua_State* pt_state);
 
+      /**
+       * Records whether an item is expanded in the view.
+       * The content of collapsed tables is not read again when refreshing.
+       */
+      void SetExpanded(const QModelIndex& c_index,
+                       bool b_expanded);
+
    public slots:
 
+      /**
+       * Reads the Lua state again and updates the items that changed.
+       */
       void Refresh();
       void Refresh(int);
 
    protected:
 
+      /**
+       * Reads the key-value pair on top of the stack into a new child of the given item.
+       * @param pt_state The Lua state.
+       * @param pc_item The item to add the child to.
+       * @param pc_old_item The item corresponding to pc_item in the current tree, or <tt>NULL</tt>.
+       */
       void ProcessLuaState(lua_State* pt_state,
-                           CQTOpenGLLuaStateTreeItem* pc_item);
+                           CQTOpenGLLuaStateTreeItem* pc_item,
+                           CQTOpenGLLuaStateTreeItem* pc_old_item);
+
+      /**
+       * Brings the children of an item of the current tree up to date with a freshly read item.
+       * The new children are moved into the current tree.
+       * @param pc_old_item The item in the current tree.
+       * @param pc_new_item The freshly read item.
+       * @param c_index The index of pc_old_item.
+       */
+      void Merge(CQTOpenGLLuaStateTreeItem* pc_old_item,
+                 CQTOpenGLLuaStateTreeItem* pc_new_item,
+                 const QModelIndex& c_index);
 
       virtual bool IsTypeVisitable(lua_State* pt_state) = 0;
 
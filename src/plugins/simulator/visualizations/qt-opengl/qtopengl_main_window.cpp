@@ -469,6 +469,22 @@ namespace argos {
       bool bShowBoundary;
       GetNodeAttributeOrDefault(t_tree, "show_boundary", bShowBoundary, true);
       m_pcOpenGLWidget->SetShowBoundary(bShowBoundary);
+      /* Use instanced rendering, when supported? */
+      bool bInstancing;
+      GetNodeAttributeOrDefault(t_tree, "instancing", bInstancing, true);
+      m_pcOpenGLWidget->SetInstancing(bInstancing);
+      /* Skip the entities out of view? */
+      bool bCulling;
+      GetNodeAttributeOrDefault(t_tree, "culling", bCulling, true);
+      m_pcOpenGLWidget->SetCulling(bCulling);
+      /* Distance beyond which entities are drawn with low detail */
+      Real fLODDistance = 10.0f;
+      GetNodeAttributeOrDefault(t_tree, "lod_distance", fLODDistance, fLODDistance);
+      m_pcOpenGLWidget->SetLODDistance(fLODDistance);
+      /* Maximum number of rays drawn per frame */
+      UInt32 unMaxRays = 10000;
+      GetNodeAttributeOrDefault(t_tree, "max_rays_per_frame", unMaxRays, unMaxRays);
+      m_pcOpenGLWidget->SetMaxRaysPerFrame(unMaxRays);
       /* Set the window as the central widget */
       CQTOpenGLLayout* pcQTOpenGLLayout = new CQTOpenGLLayout();
       pcQTOpenGLLayout->addWidget(m_pcOpenGLWidget);
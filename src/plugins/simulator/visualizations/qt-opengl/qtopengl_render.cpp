@@ -272,7 +272,30 @@ namespace argos {
                           "The 'headless_frame_size' attribute is the size of the main QTWidget in ARGoS,\n"
                           "*not* the size of the converted frames (actual images will be somewhat smaller).\n"
                           "The 'headless_frame_rate' attribute specifes the frame skip rate (i.e. grab\n"
-                          "every n-th frame). The default value is '1'.\n",
+                          "every n-th frame). The default value is '1'.\n\n"
+                          "Grabbed frames are read back from the GPU asynchronously and encoded by a pool\n"
+                          "of threads, so storing them does not slow down the visualization. You can tune\n"
+                          "the encoding with these optional attributes of 'frame_grabbing':\n\n"
+                          "  <frame_grabbing ...\n"
+                          "                  encoder_threads=\"2\"\n"
+                          "                  queue_size=\"16\"\n"
+                          "                  backpressure=\"block\"\n"
+                          "                  stream=\"y4m\"\n"
+                          "                  stream_command=\"ffmpeg -y -i - video.mp4\"\n"
+                          "                  stream_frame_rate=\"25\"/>\n\n"
+                          "The 'encoder_threads' attribute sets the number of encoder threads. With '0', the\n"
+                          "frames are encoded in the GUI thread. The default value is '2'.\n"
+                          "The 'queue_size' attribute sets the maximum number of frames waiting to be\n"
+                          "encoded. The default value is '16'.\n"
+                          "The 'backpressure' attribute sets what happens when the queue is full: 'block'\n"
+                          "waits for the encoders, 'drop' discards the frame. The default value is 'block'.\n"
+                          "The 'stream' attribute writes all the frames into a single stream instead of one\n"
+                          "file per frame. It can be 'none', 'raw' (packed RGB24, as expected by\n"
+                          "'ffmpeg -f rawvideo -pix_fmt rgb24 -s WxH') or 'y4m' (YUV4MPEG2). The default\n"
+                          "value is 'none'. The stream is piped to the command in 'stream_command' if set,\n"
+                          "otherwise it is written to the file in 'stream_file', which defaults to\n"
+                          "'<directory>/<base_name>.<stream>'. The 'stream_frame_rate' attribute is the\n"
+                          "frame rate written in the YUV4MPEG2 header. The default value is '25'.\n",
                           "Usable"
       );
 
@@ -7,6 +7,9 @@
 #include "qtopengl_widget.h"
 #include "qtopengl_main_window.h"
 #include "qtopengl_user_functions.h"
+#include "qtopengl_instanced_model.h"
+#include "qtopengl_frame_grabber.h"
+#include "qtopengl_application.h"
 
 #include <argos3/core/utility/logging/argos_log.h>
 #include <argos3/core/utility/math/plane.h>
@@ -16,6 +19,7 @@
 #include <argos3/core/simulator/entity/floor_entity.h>
 #include <argos3/core/simulator/entity/composable_entity.h>
 #include <argos3/core/simulator/entity/positional_entity.h>
+#include <argos3/plugins/simulator/entities/led_equipped_entity.h>
 
 #include <QDir>
 #include <QToolTip>
@@ -33,6 +37,154 @@ namespace argos {
 
    static const Real ASPECT_RATIO         = 4.0f / 3.0f;
 
+   /** Tessellation of the instanced models, and radius of the LED model */
+   static const Real LED_RADIUS           = 0.01f;
+   static const UInt32 LED_SLICES         = 10;
+   static const UInt32 CYLINDER_SLICES    = 20;
+
+   /*
+    * Instancing shaders. They use the fixed-function matrices and the
+    * first light, so they render like the immediate-mode drawing code.
+    */
+   static const char* INSTANCING_VERTEX_SHADER =
+      "#version 120\n"
+      "attribute vec3 position;\n"
+      "attribute vec3 normal;\n"
+      "attribute mat4 instance_model;\n"
+      "attribute vec4 instance_color;\n"
+      "varying vec4 color;\n"
+      "void main() {\n"
+      "   vec4 eye_position = gl_ModelViewMatrix * (instance_model * vec4(position, 1.0));\n"
+      "   mat3 rotation = mat3(instance_model[0].xyz, instance_model[1].xyz, instance_model[2].xyz);\n"
+      "   vec3 eye_normal = normalize(gl_NormalMatrix * (rotation * normal));\n"
+      "   vec3 light = normalize(gl_LightSource[0].position.xyz - eye_position.xyz * gl_LightSource[0].position.w);\n"
+      "   float diffuse = max(dot(eye_normal, light), 0.0);\n"
+      "   color = vec4(instance_color.rgb * (gl_LightModel.ambient.rgb +\n"
+      "                                      gl_LightSource[0].ambient.rgb +\n"
+      "                                      gl_LightSource[0].diffuse.rgb * diffuse),\n"
+      "                instance_color.a);\n"
+      "   gl_Position = gl_ProjectionMatrix * eye_position;\n"
+      "}\n";
+
+   static const char* INSTANCING_FRAGMENT_SHADER =
+      "#version 120\n"
+      "varying vec4 color;\n"
+      "void main() {\n"
+      "   gl_FragColor = color;\n"
+      "}\n";
+
+   /** Period of the rendering timer while the simulation thread is stepping, in ms */
+   static const SInt32 RENDER_PERIOD      = 16;
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLSimulationThread::CQTOpenGLSimulationThread(CQTOpenGLWidget& c_widget) :
+      m_cWidget(c_widget),
+      m_bStepping(false),
+      m_bStepInProgress(false),
+      m_bQuit(false),
+      m_bExperimentFinished(false) {}
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLSimulationThread::~CQTOpenGLSimulationThread() {
+      m_cStateMutex.lock();
+      m_bQuit = true;
+      m_cStateCondition.wakeAll();
+      m_cStateMutex.unlock();
+      wait();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLSimulationThread::Resume() {
+      QMutexLocker cLocker(&m_cStateMutex);
+      m_bStepping = true;
+      m_bExperimentFinished = false;
+      m_strError.clear();
+      m_cStateCondition.wakeAll();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLSimulationThread::Suspend() {
+      QMutexLocker cLocker(&m_cStateMutex);
+      m_bStepping = false;
+      while(m_bStepInProgress) {
+         m_cStateCondition.wait(&m_cStateMutex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CQTOpenGLSimulationThread::IsExperimentFinished() {
+      QMutexLocker cLocker(&m_cStateMutex);
+      return m_bExperimentFinished;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   std::string CQTOpenGLSimulationThread::GetError() {
+      QMutexLocker cLocker(&m_cStateMutex);
+      return m_strError;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLSimulationThread::run() {
+#ifdef ARGOS_THREADSAFE_LOG
+      LOG.AddThreadSafeBuffer();
+      LOGERR.AddThreadSafeBuffer();
+#endif
+      CSimulator& cSimulator = CSimulator::GetInstance();
+      m_cStateMutex.lock();
+      while(1) {
+         /* Wait until stepping is requested */
+         while(!m_bStepping && !m_bQuit) {
+            m_cStateCondition.wait(&m_cStateMutex);
+         }
+         if(m_bQuit) break;
+         m_bStepInProgress = true;
+         m_cStateMutex.unlock();
+         /* Execute a step with the simulation lock held */
+         bool bFinished = false;
+         std::string strError;
+         m_cWidget.m_cSimulationMutex.lock();
+         try {
+            if(cSimulator.IsExperimentFinished()) {
+               bFinished = true;
+            }
+            else {
+               cSimulator.UpdateSpace();
+            }
+         }
+         catch(CARGoSException& ex) {
+            strError = ex.what();
+         }
+         m_cWidget.m_cSimulationMutex.unlock();
+         /* Let the GUI thread in, if it is waiting for the lock */
+         while(m_cWidget.m_nSimulationLockRequests.loadAcquire() > 0) {
+            QThread::yieldCurrentThread();
+         }
+         m_cStateMutex.lock();
+         m_bStepInProgress = false;
+         if(bFinished || !strError.empty()) {
+            m_bExperimentFinished = bFinished;
+            m_strError = strError;
+            m_bStepping = false;
+         }
+         m_cStateCondition.wakeAll();
+      }
+      m_cStateMutex.unlock();
+   }
+
    /****************************************/
    /****************************************/
 
@@ -46,6 +198,11 @@ namespace argos {
       m_bFastForwarding(false),
       m_nDrawFrameEvery(1),
       m_nFrameCounter(0),
+      m_pcSimulationThread(NULL),
+      m_bSimulationThreadActive(false),
+      m_unLastRefreshClock(0),
+      m_unSimulationLockDepth(0),
+      m_nSimulationLockRequests(0),
       m_bMouseGrabbed(false),
       m_bShiftPressed(false),
       m_bInvertMouse(false),
@@ -54,7 +211,15 @@ namespace argos {
       m_bShowBoundary(true),
       m_bUsingFloorTexture(false),
       m_pcFloorTexture(NULL),
-      m_pcGroundTexture(NULL) {
+      m_pcGroundTexture(NULL),
+      m_bCulling(true),
+      m_fLODDistance(0.0f),
+      m_eLevelOfDetail(LOD_FULL),
+      m_unMaxRaysPerFrame(0),
+      m_unRaysDrawn(0),
+      m_bInstancing(true),
+      m_pcInstancingProgram(NULL),
+      m_pcFrameGrabber(NULL) {
       /* Set the widget's size policy */
       QSizePolicy cSizePolicy(QSizePolicy::Minimum, QSizePolicy::Minimum);
       cSizePolicy.setHeightForWidth(true);
@@ -70,17 +235,39 @@ namespace argos {
       m_mapPressedKeys[DIRECTION_RIGHT]     = false;
       m_mapPressedKeys[DIRECTION_FORWARDS]  = false;
       m_mapPressedKeys[DIRECTION_BACKWARDS] = false;
+      /* Start the simulation thread, idle until fast-forwarding */
+      m_pcSimulationThread = new CQTOpenGLSimulationThread(*this);
+      m_pcSimulationThread->start();
+      /* Process all the GUI events with the simulated state locked */
+      CQTOpenGLApplication* pcApplication =
+         qobject_cast<CQTOpenGLApplication*>(QCoreApplication::instance());
+      if(pcApplication != NULL) {
+         pcApplication->SetOpenGLWidget(this);
+      }
    }
 
    /****************************************/
    /****************************************/
 
    CQTOpenGLWidget::~CQTOpenGLWidget() {
+      CQTOpenGLApplication* pcApplication =
+         qobject_cast<CQTOpenGLApplication*>(QCoreApplication::instance());
+      if(pcApplication != NULL) {
+         pcApplication->SetOpenGLWidget(NULL);
+      }
+      StopSimulationThread();
+      delete m_pcSimulationThread;
       makeCurrent();
+      delete m_pcFrameGrabber;
       delete m_pcGroundTexture;
       if(m_bUsingFloorTexture) {
          delete m_pcFloorTexture;
       }
+      for(std::map<std::string, CQTOpenGLInstancedModel*>::iterator it = m_mapInstancedModels.begin();
+          it != m_mapInstancedModels.end(); ++it) {
+         delete it->second;
+      }
+      delete m_pcInstancingProgram;
       doneCurrent();
    }
 
@@ -122,6 +309,137 @@ namespace argos {
       glLightfv(GL_LIGHT0, GL_DIFFUSE,  pfLightDiffuse);
       glLightfv(GL_LIGHT0, GL_POSITION, pfLightPosition);
       glEnable(GL_LIGHT0);
+      /* Setup instanced rendering */
+      if(m_bInstancing && m_pcInstancingProgram == NULL) {
+         InitInstancing();
+      }
+      /* Setup frame grabbing */
+      if(m_pcFrameGrabber == NULL) {
+         m_pcFrameGrabber = new CQTOpenGLFrameGrabber(m_sFrameGrabData);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLWidget::InitInstancing() {
+      /* Instanced arrays are core since OpenGL 3.3 */
+      QPair<int,int> cVersion = context()->format().version();
+      if(cVersion < qMakePair(3, 3)) {
+         LOG << "[INFO] OpenGL "
+             << cVersion.first << "." << cVersion.second
+             << " does not support instanced rendering, using immediate mode."
+             << std::endl;
+         m_bInstancing = false;
+         return;
+      }
+      m_pcInstancingProgram = new QOpenGLShaderProgram();
+      /* Position must be attribute 0 in compatibility contexts */
+      m_pcInstancingProgram->bindAttributeLocation(CQTOpenGLInstancedModel::POSITION_ATTRIBUTE, 0);
+      if(!m_pcInstancingProgram->addShaderFromSourceCode(QOpenGLShader::Vertex, INSTANCING_VERTEX_SHADER) ||
+         !m_pcInstancingProgram->addShaderFromSourceCode(QOpenGLShader::Fragment, INSTANCING_FRAGMENT_SHADER) ||
+         !m_pcInstancingProgram->link()) {
+         LOGERR << "[WARNING] Can't build the instancing shaders, using immediate mode: "
+                << m_pcInstancingProgram->log().toStdString()
+                << std::endl;
+         delete m_pcInstancingProgram;
+         m_pcInstancingProgram = NULL;
+         m_bInstancing = false;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLInstancedModel* CQTOpenGLWidget::GetInstancedModel(const std::string& str_name) {
+      std::map<std::string, CQTOpenGLInstancedModel*>::iterator it = m_mapInstancedModels.find(str_name);
+      return (it != m_mapInstancedModels.end()) ? it->second : NULL;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLInstancedModel& CQTOpenGLWidget::AddInstancedModel(const std::string& str_name,
+                                                               CQTOpenGLInstancedModel* pc_model) {
+      std::map<std::string, CQTOpenGLInstancedModel*>::iterator it = m_mapInstancedModels.find(str_name);
+      if(it != m_mapInstancedModels.end()) {
+         delete it->second;
+         it->second = pc_model;
+      }
+      else {
+         m_mapInstancedModels[str_name] = pc_model;
+      }
+      return *pc_model;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLWidget::AddCylinderInstance(const CVector3& c_position,
+                                             const CQuaternion& c_orientation,
+                                             Real f_radius,
+                                             Real f_height,
+                                             const CColor& c_color) {
+      /* Create the cylinder model on first use */
+      CQTOpenGLInstancedModel* pcCylinder = GetInstancedModel("cylinder");
+      if(pcCylinder == NULL) {
+         CQTOpenGLInstancedModel::TVertices vecTriangles;
+         CQTOpenGLInstancedModel::MakeCylinder(vecTriangles, CYLINDER_SLICES);
+         pcCylinder = &AddInstancedModel("cylinder", new CQTOpenGLInstancedModel(vecTriangles));
+      }
+      pcCylinder->AddInstance(c_position,
+                              c_orientation,
+                              CVector3(f_radius, f_radius, f_height),
+                              c_color);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLWidget::AddLEDInstances(const SAnchor& s_anchor,
+                                         CLEDEquippedEntity& c_leds) {
+      AddLEDInstances(s_anchor.Position, s_anchor.Orientation, c_leds);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLWidget::AddLEDInstances(const CVector3& c_position,
+                                         const CQuaternion& c_orientation,
+                                         CLEDEquippedEntity& c_leds) {
+      if(c_leds.GetLEDs().empty()) return;
+      /* Create the LED model on first use */
+      CQTOpenGLInstancedModel* pcLED = GetInstancedModel("led");
+      if(pcLED == NULL) {
+         CQTOpenGLInstancedModel::TVertices vecTriangles;
+         CQTOpenGLInstancedModel::MakeSphere(vecTriangles, LED_RADIUS, LED_SLICES);
+         pcLED = &AddInstancedModel("led", new CQTOpenGLInstancedModel(vecTriangles));
+      }
+      /* Queue the LEDs */
+      static const CVector3 cUnitScale(1.0f, 1.0f, 1.0f);
+      CVector3 cPosition;
+      for(UInt32 i = 0; i < c_leds.GetLEDs().size(); ++i) {
+         cPosition = c_leds.GetLEDOffset(i);
+         cPosition.Rotate(c_orientation);
+         cPosition += c_position;
+         pcLED->AddInstance(cPosition,
+                            CQuaternion(),
+                            cUnitScale,
+                            c_leds.GetLED(i).GetColor());
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLWidget::DrawInstancedModels() {
+      if(!m_bInstancing) return;
+      m_pcInstancingProgram->bind();
+      for(std::map<std::string, CQTOpenGLInstancedModel*>::iterator it = m_mapInstancedModels.begin();
+          it != m_mapInstancedModels.end(); ++it) {
+         it->second->Draw(*m_pcInstancingProgram);
+      }
+      m_pcInstancingProgram->release();
    }
 
    /****************************************/
@@ -154,15 +472,43 @@ namespace argos {
       /* Draw the arena */
       DrawArena();
       /* Draw the objects */
+      UpdateFrustum();
+      m_unRaysDrawn = 0;
+      const CVector3& cCameraPosition = m_cCamera.GetActivePlacement().Position;
+      Real fLODDistanceSquare = m_fLODDistance * m_fLODDistance;
       CEntity::TVector& vecEntities = m_cSpace.GetRootEntityVector();
       for(CEntity::TVector::iterator itEntities = vecEntities.begin();
           itEntities != vecEntities.end();
           ++itEntities) {
+         m_eLevelOfDetail = LOD_FULL;
+         /* Skip the entities out of view, and draw the distant ones with low detail */
+         CComposableEntity* pcComposable = dynamic_cast<CComposableEntity*>(*itEntities);
+         if(pcComposable != NULL &&
+            pcComposable->HasComponent("body") &&
+            pcComposable->GetComponent<CEmbodiedEntity>("body").GetPhysicsModelsNum() > 0) {
+            CEmbodiedEntity& cBody = pcComposable->GetComponent<CEmbodiedEntity>("body");
+            const SBoundingBox& sBBox = cBody.GetBoundingBox();
+            if(m_bCulling && !IsInFrustum(sBBox)) {
+               /* User functions may draw outside the bounding box */
+               glPushMatrix();
+               DrawEntity(cBody);
+               m_cUserFunctions.Call(**itEntities);
+               glPopMatrix();
+               continue;
+            }
+            if(m_fLODDistance > 0.0f &&
+               ((sBBox.MinCorner + sBBox.MaxCorner) * 0.5f - cCameraPosition).SquareLength() > fLODDistanceSquare) {
+               m_eLevelOfDetail = LOD_LOW;
+            }
+         }
          glPushMatrix();
          CallEntityOperation<CQTOpenGLOperationDrawNormal, CQTOpenGLWidget, void>(*this, **itEntities);
          m_cUserFunctions.Call(**itEntities);
          glPopMatrix();
       }
+      m_eLevelOfDetail = LOD_FULL;
+      /* Draw the geometry queued for instanced rendering */
+      DrawInstancedModels();
       /* Draw the selected object, if necessary */
       if(m_sSelectionInfo.IsSelected) {
          glPushMatrix();
@@ -195,17 +541,65 @@ namespace argos {
             .arg(m_cSpace.GetSimulationClock(), 5, 10, QChar('0'))
             .arg(m_sFrameGrabData.Format);
          QToolTip::showText(pos() + geometry().center(), "Stored frame to \"" + strFileName);
-         grabFramebuffer()
-            .save(
-               strFileName,
-               0,
-               m_sFrameGrabData.Quality);
+         m_pcFrameGrabber->Grab(*this, strFileName);
+      }
+      else {
+         /* Grabbing was just switched off: store the frames still being read back */
+         m_pcFrameGrabber->Flush();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLWidget::UpdateFrustum() {
+      /* Combine projection and modelview, both column-major */
+      GLfloat pfProjection[16], pfModelView[16], pfClip[16];
+      glGetFloatv(GL_PROJECTION_MATRIX, pfProjection);
+      glGetFloatv(GL_MODELVIEW_MATRIX, pfModelView);
+      for(UInt32 c = 0; c < 4; ++c) {
+         for(UInt32 r = 0; r < 4; ++r) {
+            pfClip[c * 4 + r] =
+               pfProjection[0 * 4 + r] * pfModelView[c * 4 + 0] +
+               pfProjection[1 * 4 + r] * pfModelView[c * 4 + 1] +
+               pfProjection[2 * 4 + r] * pfModelView[c * 4 + 2] +
+               pfProjection[3 * 4 + r] * pfModelView[c * 4 + 3];
+         }
+      }
+      /*
+       * Each plane is the fourth row of the clip matrix plus or minus one of
+       * the others: left/right use the first row, bottom/top the second,
+       * near/far the third
+       */
+      for(UInt32 p = 0; p < 6; ++p) {
+         UInt32 unRow = p / 2;
+         GLfloat fSign = (p % 2 == 0) ? 1.0f : -1.0f;
+         for(UInt32 c = 0; c < 4; ++c) {
+            m_pfFrustumPlanes[p][c] = pfClip[c * 4 + 3] + fSign * pfClip[c * 4 + unRow];
+         }
       }
    }
 
    /****************************************/
    /****************************************/
 
+   bool CQTOpenGLWidget::IsInFrustum(const SBoundingBox& s_bounding_box) const {
+      for(UInt32 p = 0; p < 6; ++p) {
+         const GLfloat* pfPlane = m_pfFrustumPlanes[p];
+         /* The box is out if its corner furthest along the plane normal is out */
+         GLfloat fDistance =
+            pfPlane[0] * (pfPlane[0] >= 0.0f ? s_bounding_box.MaxCorner.GetX() : s_bounding_box.MinCorner.GetX()) +
+            pfPlane[1] * (pfPlane[1] >= 0.0f ? s_bounding_box.MaxCorner.GetY() : s_bounding_box.MinCorner.GetY()) +
+            pfPlane[2] * (pfPlane[2] >= 0.0f ? s_bounding_box.MaxCorner.GetZ() : s_bounding_box.MinCorner.GetZ()) +
+            pfPlane[3];
+         if(fDistance < 0.0f) return false;
+      }
+      return true;
+   }
+
+   /****************************************/
+   /****************************************/
+
    CRay3 CQTOpenGLWidget::RayFromWindowCoord(int n_x,
                                              int n_y) {
       /* Make sure OpenGL context is correct */
@@ -393,10 +787,17 @@ namespace argos {
 
    void CQTOpenGLWidget::DrawRays(CControllableEntity& c_entity) {
       if(! c_entity.GetCheckedRays().empty()) {
+         /* Respect the per-frame ray budget */
+         UInt32 unRays = c_entity.GetCheckedRays().size();
+         if(m_unMaxRaysPerFrame > 0) {
+            if(m_unRaysDrawn >= m_unMaxRaysPerFrame) return;
+            unRays = Min(unRays, m_unMaxRaysPerFrame - m_unRaysDrawn);
+         }
+         m_unRaysDrawn += unRays;
          glDisable(GL_LIGHTING);
          glLineWidth(1.0f);
          glBegin(GL_LINES);
-         for(UInt32 i = 0; i < c_entity.GetCheckedRays().size(); ++i) {
+         for(UInt32 i = 0; i < unRays; ++i) {
             if(c_entity.GetCheckedRays()[i].first) {
                glColor3f(1.0, 0.0, 1.0);
             }
@@ -409,15 +810,18 @@ namespace argos {
             glVertex3f(cEnd.GetX(), cEnd.GetY(), cEnd.GetZ());
          }
          glEnd();
-         glPointSize(5.0);
-         glColor3f(0.0, 0.0, 0.0);
-         glBegin(GL_POINTS);
-         for(UInt32 i = 0; i < c_entity.GetIntersectionPoints().size(); ++i) {
-            const CVector3& cPoint = c_entity.GetIntersectionPoints()[i];
-            glVertex3f(cPoint.GetX(), cPoint.GetY(), cPoint.GetZ());
+         /* Intersection points are too small to be seen from far away */
+         if(m_eLevelOfDetail == LOD_FULL) {
+            glPointSize(5.0);
+            glColor3f(0.0, 0.0, 0.0);
+            glBegin(GL_POINTS);
+            for(UInt32 i = 0; i < c_entity.GetIntersectionPoints().size(); ++i) {
+               const CVector3& cPoint = c_entity.GetIntersectionPoints()[i];
+               glVertex3f(cPoint.GetX(), cPoint.GetY(), cPoint.GetZ());
+            }
+            glEnd();
+            glPointSize(1.0);
          }
-         glEnd();
-         glPointSize(1.0);
          glEnable(GL_LIGHTING);
       }
    }
@@ -483,6 +887,7 @@ namespace argos {
 
    void CQTOpenGLWidget::PlayExperiment() {
       m_bFastForwarding = false;
+      StopSimulationThread();
       if(nTimerId != -1) killTimer(nTimerId);
       nTimerId = startTimer(CPhysicsEngine::GetSimulationClockTick() * 1000.0f);
    }
@@ -494,7 +899,16 @@ namespace argos {
       m_nFrameCounter = 0;
       m_bFastForwarding = true;
       if(nTimerId != -1) killTimer(nTimerId);
-      nTimerId = startTimer(1);
+      if(m_sFrameGrabData.GUIGrabbing || m_sFrameGrabData.HeadlessGrabbing) {
+         /* Every drawn frame must be grabbed: step in the GUI thread */
+         StopSimulationThread();
+         nTimerId = startTimer(1);
+      }
+      else {
+         /* Step in the simulation thread and render at display rate */
+         StartSimulationThread();
+         nTimerId = startTimer(RENDER_PERIOD);
+      }
    }
 
    /****************************************/
@@ -502,6 +916,7 @@ namespace argos {
 
    void CQTOpenGLWidget::PauseExperiment() {
       m_bFastForwarding = false;
+      StopSimulationThread();
       if(nTimerId != -1) killTimer(nTimerId);
       nTimerId = -1;
    }
@@ -535,7 +950,9 @@ namespace argos {
    /****************************************/
 
    void CQTOpenGLWidget::ResetExperiment() {
+      StopSimulationThread();
       m_cSimulator.Reset();
+      m_unLastRefreshClock = 0;
       m_cCamera.Reset();
       delete m_pcGroundTexture;
       if(m_bUsingFloorTexture) delete m_pcFloorTexture;
@@ -546,6 +963,89 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   void CQTOpenGLWidget::LockSimulation() {
+      if(m_unSimulationLockDepth == 0) {
+         m_nSimulationLockRequests.ref();
+         m_cSimulationMutex.lock();
+         m_nSimulationLockRequests.deref();
+      }
+      ++m_unSimulationLockDepth;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLWidget::UnlockSimulation() {
+      --m_unSimulationLockDepth;
+      if(m_unSimulationLockDepth == 0) {
+         m_cSimulationMutex.unlock();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLWidget::StartSimulationThread() {
+      if(m_bSimulationThreadActive) return;
+      m_bSimulationThreadActive = true;
+      m_unLastRefreshClock = m_cSpace.GetSimulationClock();
+      m_pcSimulationThread->Resume();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLWidget::StopSimulationThread() {
+      if(!m_bSimulationThreadActive) return;
+      m_bSimulationThreadActive = false;
+      /*
+       * If the GUI thread holds the simulation lock, the step in progress
+       * cannot complete: release the lock while waiting
+       */
+      if(m_unSimulationLockDepth > 0) {
+         m_cSimulationMutex.unlock();
+      }
+      m_pcSimulationThread->Suspend();
+      if(m_unSimulationLockDepth > 0) {
+         m_cSimulationMutex.lock();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLWidget::RefreshFromSimulationThread() {
+      /* Show the state reached by the simulation thread, if at least
+         m_nDrawFrameEvery steps were executed since the last frame */
+      if(m_cSpace.GetSimulationClock() - m_unLastRefreshClock >=
+         static_cast<UInt32>(Max<SInt32>(m_nDrawFrameEvery, 1))) {
+         m_unLastRefreshClock = m_cSpace.GetSimulationClock();
+         update();
+         m_cCamera.UpdateTimeline();
+         emit StepDone(m_cSpace.GetSimulationClock());
+      }
+      /* Check whether the simulation thread stopped by itself */
+      std::string strError = m_pcSimulationThread->GetError();
+      if(!strError.empty()) {
+         PauseExperiment();
+         THROW_ARGOSEXCEPTION("Error while executing the simulation step: " << strError);
+      }
+      if(m_pcSimulationThread->IsExperimentFinished()) {
+         PauseExperiment();
+         /* Show the final state, which might have been skipped */
+         if(m_cSpace.GetSimulationClock() != m_unLastRefreshClock) {
+            m_unLastRefreshClock = m_cSpace.GetSimulationClock();
+            update();
+            m_cCamera.UpdateTimeline();
+            emit StepDone(m_cSpace.GetSimulationClock());
+         }
+         emit ExperimentDone();
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
    void CQTOpenGLWidget::SetDrawFrameEvery(SInt32 n_every) {
       m_nDrawFrameEvery = n_every;
    }
@@ -781,7 +1281,12 @@ namespace argos {
    /****************************************/
 
    void CQTOpenGLWidget::timerEvent(QTimerEvent* pc_event) {
-      StepExperiment();
+      if(m_bSimulationThreadActive) {
+         RefreshFromSimulationThread();
+      }
+      else {
+         StepExperiment();
+      }
    }
 
    /****************************************/
@@ -1035,6 +1540,41 @@ namespace argos {
                                    "headless_frame_rate",
                                    HeadlessFrameRate,
                                    HeadlessFrameRate);
+
+         /* Parse encoder settings */
+         GetNodeAttributeOrDefault(tNode, "encoder_threads", EncoderThreads, EncoderThreads);
+         GetNodeAttributeOrDefault(tNode, "queue_size", QueueSize, QueueSize);
+         if(QueueSize == 0) {
+            THROW_ARGOSEXCEPTION("QTOpenGL: frame grabbing queue_size must be greater than zero");
+         }
+         strBuffer = "block";
+         GetNodeAttributeOrDefault(tNode, "backpressure", strBuffer, strBuffer);
+         if(strBuffer == "block") {
+            DropFrames = false;
+         }
+         else if(strBuffer == "drop") {
+            DropFrames = true;
+         }
+         else {
+            THROW_ARGOSEXCEPTION("QTOpenGL: unknown frame grabbing backpressure \"" << strBuffer << "\", use \"block\" or \"drop\"");
+         }
+
+         /* Parse stream settings */
+         strBuffer = "none";
+         GetNodeAttributeOrDefault(tNode, "stream", strBuffer, strBuffer);
+         if(strBuffer == "raw" || strBuffer == "y4m") {
+            StreamFormat = strBuffer.c_str();
+         }
+         else if(strBuffer != "none") {
+            THROW_ARGOSEXCEPTION("QTOpenGL: unknown frame grabbing stream \"" << strBuffer << "\", use \"none\", \"raw\" or \"y4m\"");
+         }
+         strBuffer = "";
+         GetNodeAttributeOrDefault(tNode, "stream_file", strBuffer, strBuffer);
+         StreamFile = strBuffer.c_str();
+         strBuffer = "";
+         GetNodeAttributeOrDefault(tNode, "stream_command", strBuffer, strBuffer);
+         StreamCommand = strBuffer.c_str();
+         GetNodeAttributeOrDefault(tNode, "stream_frame_rate", StreamFrameRate, StreamFrameRate);
       }
    }
 
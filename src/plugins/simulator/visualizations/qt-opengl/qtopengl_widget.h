@@ -9,6 +9,9 @@
 
 namespace argos {
    class CQTOpenGLWidget;
+   class CQTOpenGLSimulationThread;
+   class CQTOpenGLInstancedModel;
+   class CQTOpenGLFrameGrabber;
    class CQTOpenGLMainWindow;
    class CSpace;
    class CSimulator;
@@ -17,6 +20,11 @@ namespace argos {
    class CPositionalEntity;
    class CControllableEntity;
    class CEmbodiedEntity;
+   class CLEDEquippedEntity;
+   class CQuaternion;
+   class CColor;
+   struct SAnchor;
+   struct SBoundingBox;
 }
 
 #include <argos3/plugins/simulator/visualizations/qt-opengl/qtopengl_camera.h>
@@ -25,6 +33,12 @@ namespace argos {
 #include <QOpenGLWidget>
 #include <QOpenGLFunctions>
 #include <QOpenGLTexture>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInt>
+#include <QOpenGLShaderProgram>
+#include <map>
 
 #ifdef __APPLE__
 #include <glu.h>
@@ -53,6 +67,61 @@ namespace argos {
    /****************************************/
    /****************************************/
 
+   /**
+    * Executes the simulation steps outside the GUI thread when fast-forwarding.
+    * Each step is executed while holding the simulation lock of the widget,
+    * so the GUI thread can safely access the simulated state by taking the
+    * same lock.
+    * @see CQTOpenGLWidget::LockSimulation
+    */
+   class CQTOpenGLSimulationThread : public QThread {
+
+   public:
+
+      CQTOpenGLSimulationThread(CQTOpenGLWidget& c_widget);
+
+      virtual ~CQTOpenGLSimulationThread();
+
+      /**
+       * Starts executing simulation steps.
+       */
+      void Resume();
+
+      /**
+       * Stops executing simulation steps.
+       * When this method returns, no step is in progress.
+       */
+      void Suspend();
+
+      /**
+       * Returns <tt>true</tt> if the experiment finished while stepping.
+       */
+      bool IsExperimentFinished();
+
+      /**
+       * Returns the message of the error raised while stepping, if any.
+       */
+      std::string GetError();
+
+   protected:
+
+      virtual void run();
+
+   private:
+
+      CQTOpenGLWidget& m_cWidget;
+      QMutex m_cStateMutex;
+      QWaitCondition m_cStateCondition;
+      bool m_bStepping;
+      bool m_bStepInProgress;
+      bool m_bQuit;
+      bool m_bExperimentFinished;
+      std::string m_strError;
+   };
+
+   /****************************************/
+   /****************************************/
+
    class CQTOpenGLWidget : public QOpenGLWidget, protected QOpenGLFunctions {
 
     Q_OBJECT
@@ -71,6 +140,13 @@ namespace argos {
          QString Format;            // output file format
          SInt32 Quality;            // output quality [0-100]
          QSize  Size;               // Frame size
+         UInt32 EncoderThreads;     // number of encoder threads, 0 to encode in the GUI thread
+         UInt32 QueueSize;          // maximum number of frames waiting to be encoded
+         bool DropFrames;           // true to drop frames when the queue is full, false to block
+         QString StreamFormat;      // "raw" or "y4m" to write a video stream, empty for one file per frame
+         QString StreamFile;        // stream output file
+         QString StreamCommand;     // command the stream is piped to
+         UInt32 StreamFrameRate;    // stream frame rate
 
          SFrameGrabData() :
             GUIGrabbing(false),
@@ -80,11 +156,24 @@ namespace argos {
             BaseName("frame_"),
             Format("png"),
             Quality(-1),
-            Size(1600, 1200) {}
+            Size(1600, 1200),
+            EncoderThreads(2),
+            QueueSize(16),
+            DropFrames(false),
+            StreamFrameRate(25) {}
 
          void Init(TConfigurationNode& t_tree);
       };
 
+      /**
+       * The level of detail an entity is drawn with.
+       * @see GetLevelOfDetail
+       */
+      enum ELevelOfDetail {
+         LOD_FULL = 0, // close to the camera: draw everything
+         LOD_LOW       // far from the camera: draw only what is visible from afar
+      };
+
       /**
        * Data arelated to robot selection
        */
@@ -240,6 +329,127 @@ namespace argos {
          m_bShowBoundary = b_show_boundary;
       }
 
+      /**
+       * Sets whether entities outside the view frustum should be skipped.
+       */
+      inline void SetCulling(bool b_culling) {
+         m_bCulling = b_culling;
+      }
+
+      /**
+       * Sets the distance from the camera beyond which entities are drawn
+       * with a low level of detail. Zero draws everything in full detail.
+       */
+      inline void SetLODDistance(Real f_distance) {
+         m_fLODDistance = f_distance;
+      }
+
+      /**
+       * Sets the maximum number of rays drawn by DrawRays() in a frame.
+       * Zero means no limit.
+       */
+      inline void SetMaxRaysPerFrame(UInt32 un_max_rays) {
+         m_unMaxRaysPerFrame = un_max_rays;
+      }
+
+      /**
+       * Returns the level of detail of the entity being drawn.
+       * Draw operations can use it to skip the parts that can't be seen
+       * from far away.
+       */
+      inline ELevelOfDetail GetLevelOfDetail() const {
+         return m_eLevelOfDetail;
+      }
+
+      /**
+       * Sets whether instanced rendering should be used, when supported.
+       * Must be called before the widget is shown.
+       */
+      inline void SetInstancing(bool b_instancing) {
+         m_bInstancing = b_instancing;
+      }
+
+      /**
+       * Returns <tt>true</tt> if instanced rendering is active.
+       * When it is, the draw operations can queue their geometry in
+       * instanced models, which are drawn with one call per model after
+       * all the entities have been visited. Robots drawn at LOD_FULL keep
+       * their display lists, as their articulated parts depend on the
+       * state of each robot.
+       * @see GetInstancedModel
+       */
+      inline bool IsInstancingEnabled() const {
+         return m_bInstancing;
+      }
+
+      /**
+       * Returns the instanced model with the given name, or <tt>NULL</tt>.
+       * @param str_name The name of the model.
+       * @see AddInstancedModel
+       */
+      CQTOpenGLInstancedModel* GetInstancedModel(const std::string& str_name);
+
+      /**
+       * Adds an instanced model with the given name.
+       * The widget takes ownership of the model.
+       * @param str_name The name of the model.
+       * @param pc_model The model.
+       * @return The added model.
+       */
+      CQTOpenGLInstancedModel& AddInstancedModel(const std::string& str_name,
+                                                 CQTOpenGLInstancedModel* pc_model);
+
+      /**
+       * Queues a cylinder for instanced drawing.
+       * @param c_position The position of the center of the base of the cylinder.
+       * @param c_orientation The orientation of the cylinder.
+       * @param f_radius The radius of the cylinder.
+       * @param f_height The height of the cylinder.
+       * @param c_color The color of the cylinder.
+       */
+      void AddCylinderInstance(const CVector3& c_position,
+                               const CQuaternion& c_orientation,
+                               Real f_radius,
+                               Real f_height,
+                               const CColor& c_color);
+
+      /**
+       * Queues the LEDs of an entity for instanced drawing.
+       * The LED offsets are expressed in the frame of the given anchor.
+       * @param s_anchor The anchor the LEDs are attached to.
+       * @param c_leds The LEDs.
+       */
+      void AddLEDInstances(const SAnchor& s_anchor,
+                           CLEDEquippedEntity& c_leds);
+
+      /**
+       * Queues the LEDs of an entity for instanced drawing.
+       * The LED offsets are expressed in the frame with the given pose.
+       * @param c_position The position of the frame of the LEDs.
+       * @param c_orientation The orientation of the frame of the LEDs.
+       * @param c_leds The LEDs.
+       */
+      void AddLEDInstances(const CVector3& c_position,
+                           const CQuaternion& c_orientation,
+                           CLEDEquippedEntity& c_leds);
+
+      /**
+       * Acquires the lock on the simulated state.
+       * While fast-forwarding, the simulation steps are executed in a
+       * separate thread; code executed in the GUI thread must hold this
+       * lock to access the simulated state. CQTOpenGLApplication already
+       * processes all the events of the GUI thread, including painting,
+       * with the lock held. The lock can be acquired multiple times by the
+       * GUI thread.
+       */
+      void LockSimulation();
+
+      /**
+       * Releases the lock on the simulated state.
+       * @see LockSimulation
+       */
+      void UnlockSimulation();
+
    signals:
 
       /**
@@ -278,7 +488,12 @@ namespace argos {
 
       /**
        * Fast forwards the experiment.
-       * Internally sets a timer whose period is 1ms.
+       * The simulation steps are executed as fast as possible in a separate
+       * thread, while the widget renders the latest state at display rate,
+       * provided that at least as many steps as set by SetDrawFrameEvery()
+       * were executed since the last rendered frame.
+       * When frames are being grabbed, the steps are executed in the GUI
+       * thread by a timer whose period is 1ms, so no frame is skipped.
        */
       void FastForwardExperiment();
 
@@ -338,6 +553,16 @@ namespace argos {
       void DrawArena();
       void DrawAxes();
 
+      void UpdateFrustum();
+      bool IsInFrustum(const SBoundingBox& s_bounding_box) const;
+
+      void InitInstancing();
+      void DrawInstancedModels();
+
+      void StartSimulationThread();
+      void StopSimulationThread();
+      void RefreshFromSimulationThread();
+
       virtual void timerEvent(QTimerEvent* pc_event);
       virtual void mousePressEvent(QMouseEvent* pc_event);
       virtual void mouseReleaseEvent(QMouseEvent* pc_event);
@@ -350,6 +575,8 @@ namespace argos {
 
    private:
 
+      friend class CQTOpenGLSimulationThread;
+
       /** Reference to the main window */
       CQTOpenGLMainWindow& m_cMainWindow;
       /** Reference to the user functions */
@@ -364,6 +591,19 @@ namespace argos {
       /** Counter for the current frame */
       SInt32 m_nFrameCounter;
 
+      /** Thread executing the simulation steps when fast-forwarding */
+      CQTOpenGLSimulationThread* m_pcSimulationThread;
+      /** True when the simulation thread is stepping */
+      bool m_bSimulationThreadActive;
+      /** Simulation clock at the last refresh from the simulation thread */
+      UInt32 m_unLastRefreshClock;
+      /** Lock on the simulated state */
+      QMutex m_cSimulationMutex;
+      /** Number of times the GUI thread acquired the simulation lock */
+      UInt32 m_unSimulationLockDepth;
+      /** Number of GUI thread requests waiting for the simulation lock */
+      QAtomicInt m_nSimulationLockRequests;
+
       /** True when the mouse is grabbed by this widget */
       bool m_bMouseGrabbed;
       /** True when shift is pressed */
@@ -408,6 +648,28 @@ namespace argos {
       CQTOpenGLCamera m_cCamera;
       /** Data on frame grabbing */
       SFrameGrabData m_sFrameGrabData;
+      /** Reads back and stores the grabbed frames */
+      CQTOpenGLFrameGrabber* m_pcFrameGrabber;
+
+      /** True when entities outside the view frustum are skipped */
+      bool m_bCulling;
+      /** The planes of the view frustum, as (a,b,c,d) with the inside where ax+by+cz+d >= 0 */
+      GLfloat m_pfFrustumPlanes[6][4];
+      /** Distance beyond which entities are drawn with low detail */
+      Real m_fLODDistance;
+      /** Level of detail of the entity being drawn */
+      ELevelOfDetail m_eLevelOfDetail;
+      /** Maximum number of rays drawn per frame */
+      UInt32 m_unMaxRaysPerFrame;
+      /** Number of rays drawn in the current frame */
+      UInt32 m_unRaysDrawn;
+
+      /** True when instanced rendering is active */
+      bool m_bInstancing;
+      /** The shader program used for instanced rendering */
+      QOpenGLShaderProgram* m_pcInstancingProgram;
+      /** The instanced models, indexed by name */
+      std::map<std::string, CQTOpenGLInstancedModel*> m_mapInstancedModels;
 
       /** Current direction of motion */
       enum EDirection {
@@ -8,10 +8,10 @@ _argos3() {
     # previous token
     prev="${COMP_WORDS[COMP_CWORD-1]}"
     # option list
-    opts="-h --help -v --version -c --config-file -q --query -n --no-color -l --log-file -e --logerr-file"
+    opts="-h --help -v --version -c --config-file -q --query -m --plugin-manifest -b --batch -o --batch-output -j --batch-workers -n --no-color -l --log-file -e --logerr-file"
     # Complete option arguments
     case "${prev}" in
-        -h|--help|-v|--version|-n|--no-color)
+        -h|--help|-v|--version|-n|--no-color|-j|--batch-workers)
             return 0
             ;;
         -c|--config-file)
@@ -24,7 +24,7 @@ _argos3() {
             COMPREPLY=( $(compgen -W "${plugintypes} ${plugins}" -- ${cur}) )
             return 0
             ;;
-        -l|--log-file|-e|--logerr-file)
+        -m|--plugin-manifest|-b|--batch|-o|--batch-output|-l|--log-file|-e|--logerr-file)
             COMPREPLY=( $(compgen -f ${cur}) )
             return 0
             ;;
@@ -0,0 +1,31 @@
+-- Random walk used by test-checkpoint.
+-- The script keeps no state of its own, so a restored checkpoint
+-- drives the robots exactly as the original run.
+
+function init()
+end
+
+function step()
+   -- Turn away from the closest obstacle, if any
+   local closest = 0
+   for i = 1,#robot.proximity do
+      if robot.proximity[i].value > closest then
+         closest = robot.proximity[i].value
+      end
+   end
+   if closest > 0.5 then
+      robot.wheels.set_velocity(-5, 5)
+   else
+      robot.wheels.set_velocity(robot.random.uniform(0, 10),
+                                robot.random.uniform(0, 10))
+   end
+   robot.leds.set_all_colors(math.floor(robot.random.uniform(0, 255)),
+                             math.floor(robot.random.uniform(0, 255)),
+                             math.floor(robot.random.uniform(0, 255)))
+end
+
+function reset()
+end
+
+function destroy()
+end
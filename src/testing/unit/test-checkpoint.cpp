@@ -0,0 +1,99 @@
+/**
+ * @file <argos3/testing/unit/test-checkpoint.cpp>
+ *
+ * Checks that restoring a checkpoint reproduces the original run.
+ * The experiment runs for a while and is saved; then it runs for N steps
+ * and is saved again as reference. The first checkpoint is restored, from
+ * memory and from a file, and after N more steps the state must be the
+ * same as the reference, byte by byte.
+ *
+ * Example: test-checkpoint 100 ../../src/testing/argos/checkpoint.argos
+ *
+ * @author agent <agent@local>
+ */
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/utility/plugins/dynamic_loading.h>
+#include <argos3/core/utility/string_utilities.h>
+#include <cstdio>
+
+using namespace argos;
+
+static void Step(CSimulator& c_simulator,
+                 UInt32 un_steps) {
+   for(UInt32 i = 0; i < un_steps; ++i) {
+      c_simulator.UpdateSpace();
+   }
+}
+
+static bool Compare(const std::string& str_what,
+                    const CByteArray& c_reference,
+                    const CByteArray& c_restored) {
+   if(c_reference == c_restored) {
+      LOG << "[INFO] " << str_what << ": OK" << std::endl;
+      return true;
+   }
+   LOGERR << "[FAILED] " << str_what
+          << ": the restored run differs from the original one"
+          << " (" << c_restored.Size() << " bytes vs. "
+          << c_reference.Size() << " bytes)"
+          << std::endl;
+   return false;
+}
+
+int main(int n_argc, char** ppch_argv) {
+   if(n_argc != 3) {
+      LOGERR << "Usage:" << std::endl;
+      LOGERR << ppch_argv[0] << " <steps> <xml>" << std::endl << std::endl;
+      LOGERR.Flush();
+      return 1;
+   }
+   /* Create a new instance of the simulator */
+   CSimulator& cSimulator = CSimulator::GetInstance();
+   std::string strFileName = "test-checkpoint.dat";
+   bool bOK = true;
+   try {
+      UInt32 unSteps = FromString<UInt32>(ppch_argv[1]);
+      CDynamicLoading::LoadAllLibraries();
+      cSimulator.SetExperimentFileName(ppch_argv[2]);
+      cSimulator.LoadExperiment();
+      /* Run, so that the robots are moving when the checkpoint is saved */
+      Step(cSimulator, unSteps);
+      CByteArray cCheckpoint;
+      cSimulator.SaveState(cCheckpoint);
+      cSimulator.SaveStateToFile(strFileName);
+      /* Reference run */
+      Step(cSimulator, unSteps);
+      CByteArray cReference;
+      cSimulator.SaveState(cReference);
+      /* Restore from memory; LoadState() empties the buffer */
+      CByteArray cCopy(cCheckpoint);
+      cSimulator.LoadState(cCopy);
+      Step(cSimulator, unSteps);
+      CByteArray cRestored;
+      cSimulator.SaveState(cRestored);
+      bOK = Compare("restore from memory", cReference, cRestored) && bOK;
+      /* Restore from file */
+      cSimulator.LoadStateFromFile(strFileName);
+      Step(cSimulator, unSteps);
+      cRestored.Clear();
+      cSimulator.SaveState(cRestored);
+      bOK = Compare("restore from file", cReference, cRestored) && bOK;
+      ::remove(strFileName.c_str());
+      cSimulator.Destroy();
+   }
+   catch(std::exception& ex) {
+      /* A fatal error occurred: dispose of data, print error and exit */
+      LOGERR << ex.what() << std::endl;
+      LOG.Flush();
+      LOGERR.Flush();
+      ::remove(strFileName.c_str());
+      cSimulator.Destroy();
+      LOG.Flush();
+      LOGERR.Flush();
+      return 1;
+   }
+   LOG.Flush();
+   LOGERR.Flush();
+   return bOK ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file <argos3/testing/unit/test-lazy-loading.cpp>
+ *
+ * Checks the loading of the plugins on demand.
+ * First, a factory miss handler is installed by hand, to check that the
+ * factories retry the lookups it satisfies and give up on the others.
+ * Then, a plugin manifest that lists only the box entity is written to a
+ * temporary directory and lazy loading is enabled: asking for a box must
+ * load the entities library, and nothing else.
+ *
+ * Run it from the build directory, after sourcing setup_env.sh, so that
+ * ARGOS_PLUGIN_PATH lists the plugin libraries.
+ *
+ * @author agent <agent@local>
+ */
+#include <argos3/core/config.h>
+#include <argos3/core/utility/plugins/factory.h>
+#include <argos3/core/utility/plugins/dynamic_loading.h>
+#include <argos3/core/simulator/entity/entity.h>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+using namespace argos;
+
+/****************************************/
+/****************************************/
+
+class CLazyObject {
+public:
+   virtual ~CLazyObject() {}
+};
+
+static CLazyObject* CreateLazyObject() {
+   return new CLazyObject;
+}
+
+static UInt32 unMisses = 0;
+
+/*
+ * Registers "lazy" when it is asked for, and nothing else.
+ */
+static bool RegisterLazyObject(const std::string& str_label) {
+   ++unMisses;
+   if(str_label != "lazy") return false;
+   CFactory<CLazyObject>::Register("lazy", "", "", "", "", "", &CreateLazyObject);
+   return true;
+}
+
+/****************************************/
+/****************************************/
+
+static bool Check(const std::string& str_what,
+                  bool b_condition) {
+   if(!b_condition) {
+      std::cerr << "[FAILED] " << str_what << std::endl;
+   }
+   return b_condition;
+}
+
+template<typename TYPE>
+static bool IsRegistered(const std::string& str_label) {
+   /* Look the label up without triggering the miss handler */
+   return CFactory<TYPE>::GetTypeMap().find(str_label) != CFactory<TYPE>::GetTypeMap().end();
+}
+
+/****************************************/
+/****************************************/
+
+static bool TestMissHandler() {
+   bool bOK = true;
+   CFactoryMissHandler::Get() = &RegisterLazyObject;
+   /* A miss the handler satisfies is retried */
+   CLazyObject* pcObject = CFactory<CLazyObject>::New("lazy");
+   bOK = Check("label registered by the handler", pcObject != NULL) && bOK;
+   delete pcObject;
+   bOK = Check("one miss for a label registered by the handler", unMisses == 1) && bOK;
+   /* Once registered, the handler is not called */
+   bOK = Check("registered label", CFactory<CLazyObject>::Exists("lazy")) && bOK;
+   bOK = Check("no miss for a registered label", unMisses == 1) && bOK;
+   /* A miss the handler cannot satisfy is not retried */
+   bOK = Check("unknown label", !CFactory<CLazyObject>::Exists("unknown")) && bOK;
+   bOK = Check("one miss for an unknown label", unMisses == 2) && bOK;
+   CFactoryMissHandler::Get() = NULL;
+   CFactory<CLazyObject>::Destroy();
+   return bOK;
+}
+
+/****************************************/
+/****************************************/
+
+#ifdef ARGOS_DYNAMIC_LIBRARY_LOADING
+
+static bool TestManifest() {
+   bool bOK = true;
+   /* Write a manifest with just the box entity in a temporary directory */
+   char pchDir[] = "/tmp/argos3-lazy-XXXXXX";
+   if(::mkdtemp(pchDir) == NULL) {
+      std::cerr << "[FAILED] cannot create a temporary directory" << std::endl;
+      return false;
+   }
+   std::string strManifest = std::string(pchDir) + "/" + CDynamicLoading::MANIFEST_FILE_NAME;
+   std::ofstream cOFS(strManifest.c_str());
+   cOFS << "box\tlibargos3plugin_" ARGOS_BUILD_FOR "_entities" << std::endl;
+   cOFS.close();
+   std::string strPluginPath = pchDir;
+   if(::getenv("ARGOS_PLUGIN_PATH") != NULL) {
+      strPluginPath += std::string(":") + ::getenv("ARGOS_PLUGIN_PATH");
+   }
+   ::setenv("ARGOS_PLUGIN_PATH", strPluginPath.c_str(), 1);
+   try {
+      bOK = Check("box not registered before lazy loading", !IsRegistered<CEntity>("box")) && bOK;
+      CDynamicLoading::EnableLazyLoading();
+      bOK = Check("box not registered before it is needed", !IsRegistered<CEntity>("box")) && bOK;
+      bOK = Check("box found through the manifest", CFactory<CEntity>::Exists("box")) && bOK;
+      bOK = Check("foot-bot not loaded with the box", !IsRegistered<CEntity>("foot-bot")) && bOK;
+   }
+   catch(CARGoSException& ex) {
+      std::cerr << "[FAILED] " << ex.what() << std::endl;
+      bOK = false;
+   }
+   CFactoryMissHandler::Get() = NULL;
+   ::remove(strManifest.c_str());
+   ::rmdir(pchDir);
+   return bOK;
+}
+
+#endif
+
+/****************************************/
+/****************************************/
+
+int main(int n_argc, char** ppch_argv) {
+   bool bOK = TestMissHandler();
+#ifdef ARGOS_DYNAMIC_LIBRARY_LOADING
+   bOK = TestManifest() && bOK;
+#endif
+   if(bOK) {
+      std::cout << "OK" << std::endl;
+   }
+   LOG.Flush();
+   LOGERR.Flush();
+   return bOK ? 0 : 1;
+}
@@ -50,6 +50,50 @@ void GenerateG(Real f_std_dev, Real f_mean) {
    cFile.close();
 }
 
+void CheckPhilox() {
+   CRandom::CreateCategory("testing_philox", 12345, CRandom::CRNG::TYPE_PHILOX);
+   CRandom::CCategory& cCategory = CRandom::GetCategory("testing_philox");
+   CRandom::CRNG* pcRNG1 = CRandom::CreateRNG("testing_philox");
+   CRandom::CRNG* pcRNG2 = CRandom::CreateRNG("testing_philox");
+   /* Batched draws are the same as single draws */
+   Real pfBatch[100];
+   cCategory.SetTick(1);
+   pcRNG1->Gaussian(pfBatch, 100, 1.0);
+   bool bSame = true;
+   pcRNG1->Reset();
+   for(UInt32 i = 0; i < 100; ++i) {
+      bSame = bSame && (pfBatch[i] == pcRNG1->Gaussian(1.0));
+   }
+   std::cout << "Philox batched Gaussian == single Gaussian: " << (bSame ? "OK" : "FAILED") << std::endl;
+   /* Draws in a tick do not depend on the draws in the previous ticks */
+   cCategory.SetTick(10);
+   pcRNG2->Uniform(pfBatch, 100, FRANGE);
+   cCategory.SetTick(5);
+   for(UInt32 i = 0; i < 1000; ++i) pcRNG2->Uniform(FRANGE);
+   cCategory.SetTick(10);
+   bSame = true;
+   for(UInt32 i = 0; i < 100; ++i) {
+      bSame = bSame && (pfBatch[i] == pcRNG2->Uniform(FRANGE));
+   }
+   std::cout << "Philox draws keyed by tick: " << (bSame ? "OK" : "FAILED") << std::endl;
+   /* Different streams give different sequences */
+   CRandom::CRNG cRNG3(pcRNG2->GetSeed(), CRandom::CRNG::TYPE_PHILOX);
+   CRandom::CRNG cRNG4(pcRNG2->GetSeed(), CRandom::CRNG::TYPE_PHILOX);
+   cRNG4.SetStream(1);
+   cRNG4.Reset();
+   std::cout << "Philox streams: " << (cRNG3.Uniform(URANGE) != cRNG4.Uniform(URANGE) || cRNG3.Uniform(URANGE) != cRNG4.Uniform(URANGE) ? "OK" : "FAILED") << std::endl;
+   /* With a creation stream, the sequence does not depend on the creation order */
+   CRandom::SetCreationStream(42);
+   CRandom::CRNG* pcRNG5 = CRandom::CreateRNG("testing_philox");
+   CRandom::SetCreationStream(0);
+   CRandom::CreateRNG("testing_philox");
+   CRandom::SetCreationStream(42);
+   CRandom::CRNG* pcRNG6 = CRandom::CreateRNG("testing_philox");
+   CRandom::SetCreationStream(0);
+   std::cout << "Philox creation streams: " << (pcRNG5->GetStream() == 42 && pcRNG5->Uniform(URANGE) == pcRNG6->Uniform(URANGE) ? "OK" : "FAILED") << std::endl;
+   CRandom::RemoveCategory("testing_philox");
+}
+
 int main() {
    CRandom::CreateCategory("testing", 12345);
    GenerateU("ufile.dat", URANGE);
@@ -64,4 +108,5 @@ int main() {
       }
    }
    CRandom::RemoveCategory("testing");
+   CheckPhilox();
 }
@@ -0,0 +1,161 @@
+/**
+ * @file <argos3/testing/unit/test-space.cpp>
+ *
+ * Checks the entity index of the space: handles, reuse of the index
+ * slots, order of the entity vectors after removals, and queued
+ * additions and removals.
+ *
+ * Example: test-space ../../src/testing/argos/space.argos
+ *
+ * @author agent <agent@local>
+ */
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/simulator/loop_functions.h>
+#include <argos3/core/utility/plugins/dynamic_loading.h>
+#include <argos3/core/utility/string_utilities.h>
+
+using namespace argos;
+
+static CEntity* NewBox(const std::string& str_id,
+                       Real f_x) {
+   TConfigurationNode tBox("box");
+   SetNodeAttribute(tBox, "id", str_id);
+   SetNodeAttribute(tBox, "size", CVector3(0.1, 0.1, 0.1));
+   SetNodeAttribute(tBox, "movable", false);
+   TConfigurationNode tBody("body");
+   SetNodeAttribute(tBody, "position", CVector3(f_x, 0.0, 0.0));
+   SetNodeAttribute(tBody, "orientation", CVector3());
+   AddChildNode(tBox, tBody);
+   CEntity* pcEntity = CFactory<CEntity>::New("box");
+   pcEntity->Init(tBox);
+   return pcEntity;
+}
+
+static bool Check(const std::string& str_what,
+                  bool b_condition) {
+   if(!b_condition) {
+      LOGERR << "[FAILED] " << str_what << std::endl;
+   }
+   return b_condition;
+}
+
+/*
+ * Checks that the vectors have no holes and that each entity is found
+ * through its handle.
+ */
+static bool CheckIndex(CSpace& c_space) {
+   bool bOK = true;
+   CEntity::TVector& vecEntities = c_space.GetEntityVector();
+   for(size_t i = 0; i < vecEntities.size(); ++i) {
+      if(vecEntities[i] == NULL ||
+         c_space.GetEntity(c_space.GetEntityHandle(*vecEntities[i])) != vecEntities[i]) {
+         bOK = false;
+      }
+   }
+   CEntity::TVector& vecRootEntities = c_space.GetRootEntityVector();
+   for(size_t i = 0; i < vecRootEntities.size(); ++i) {
+      if(vecRootEntities[i] == NULL ||
+         vecRootEntities[i]->HasParent()) {
+         bOK = false;
+      }
+   }
+   return Check("index consistency", bOK);
+}
+
+/*
+ * Checks the ids of the root entities, in order.
+ */
+static bool CheckRootOrder(CSpace& c_space,
+                           const std::string& str_what,
+                           const std::string& str_ids) {
+   std::string strIds;
+   CEntity::TVector& vecRootEntities = c_space.GetRootEntityVector();
+   for(size_t i = 0; i < vecRootEntities.size(); ++i) {
+      if(i > 0) strIds += ",";
+      strIds += vecRootEntities[i]->GetId();
+   }
+   if(strIds != str_ids) {
+      LOGERR << "[FAILED] " << str_what
+             << ": expected \"" << str_ids << "\""
+             << ", got \"" << strIds << "\""
+             << std::endl;
+      return false;
+   }
+   return true;
+}
+
+int main(int n_argc, char** ppch_argv) {
+   if(n_argc != 2) {
+      LOGERR << "Usage:" << std::endl;
+      LOGERR << ppch_argv[0] << " <xml>" << std::endl << std::endl;
+      LOGERR.Flush();
+      return 1;
+   }
+   /* Create a new instance of the simulator */
+   CSimulator& cSimulator = CSimulator::GetInstance();
+   bool bOK = true;
+   try {
+      CDynamicLoading::LoadAllLibraries();
+      cSimulator.SetExperimentFileName(ppch_argv[1]);
+      cSimulator.LoadExperiment();
+      CSpace& cSpace = cSimulator.GetSpace();
+      CLoopFunctions& cLoopFunctions = cSimulator.GetLoopFunctions();
+      /* Add the boxes right away */
+      std::vector<CEntity*> vecBoxes;
+      for(size_t i = 0; i < 5; ++i) {
+         vecBoxes.push_back(NewBox("b" + ToString(i), 2.0 * i - 4.0));
+         cLoopFunctions.AddEntity(*vecBoxes.back());
+      }
+      bOK = CheckRootOrder(cSpace, "addition", "b0,b1,b2,b3,b4") && bOK;
+      bOK = CheckIndex(cSpace) && bOK;
+      /* Removing an entity keeps the order of the others */
+      CSpace::SEntityHandle sHandle = cSpace.GetEntityHandle(*vecBoxes[1]);
+      bOK = Check("handle of an entity in the space",
+                  cSpace.GetEntity(sHandle) == vecBoxes[1]) && bOK;
+      cLoopFunctions.RemoveEntity(*vecBoxes[1]);
+      bOK = Check("handle of a removed entity",
+                  cSpace.GetEntity(sHandle) == NULL) && bOK;
+      bOK = CheckRootOrder(cSpace, "immediate removal", "b0,b2,b3,b4") && bOK;
+      bOK = CheckIndex(cSpace) && bOK;
+      /* A new entity reuses the slot with a new generation */
+      CEntity* pcReused = NewBox("b5", 6.0);
+      cLoopFunctions.AddEntity(*pcReused);
+      CSpace::SEntityHandle sReused = cSpace.GetEntityHandle(*pcReused);
+      bOK = Check("slot reuse",
+                  sReused.Index == sHandle.Index &&
+                  sReused.Generation != sHandle.Generation) && bOK;
+      bOK = Check("stale handle of a reused slot",
+                  cSpace.GetEntity(sHandle) == NULL) && bOK;
+      bOK = CheckRootOrder(cSpace, "addition to a reused slot", "b0,b2,b3,b4,b5") && bOK;
+      /* Queued changes take effect at the end of the step */
+      cLoopFunctions.QueueRemoveEntity(*vecBoxes[0]);
+      cLoopFunctions.QueueRemoveEntity(*vecBoxes[3]);
+      cLoopFunctions.QueueRemoveEntity(*vecBoxes[3]);
+      cLoopFunctions.QueueAddEntity(*NewBox("b6", 8.0));
+      bOK = CheckRootOrder(cSpace, "queued changes before the step", "b0,b2,b3,b4,b5") && bOK;
+      cSimulator.UpdateSpace();
+      bOK = CheckRootOrder(cSpace, "queued changes after the step", "b2,b4,b5,b6") && bOK;
+      bOK = CheckIndex(cSpace) && bOK;
+      bOK = Check("entities per type",
+                  cSpace.GetEntitiesByType("box").size() == 4 &&
+                  cSpace.GetEntityVectorByType("box").size() == 4) && bOK;
+      cSimulator.Destroy();
+   }
+   catch(std::exception& ex) {
+      /* A fatal error occurred: dispose of data, print error and exit */
+      LOGERR << ex.what() << std::endl;
+      LOG.Flush();
+      LOGERR.Flush();
+      cSimulator.Destroy();
+      LOG.Flush();
+      LOGERR.Flush();
+      return 1;
+   }
+   if(bOK) {
+      LOG << "[INFO] OK" << std::endl;
+   }
+   LOG.Flush();
+   LOGERR.Flush();
+   return bOK ? 0 : 1;
+}
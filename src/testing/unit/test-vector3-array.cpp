@@ -0,0 +1,110 @@
+/**
+ * @file <argos3/testing/unit/test-vector3-array.cpp>
+ *
+ * @author agent <agent@local>
+ */
+#include <argos3/core/utility/math/vector3_array.h>
+#include <argos3/core/utility/math/quaternion.h>
+#include <argos3/core/utility/math/rng.h>
+
+#include <iostream>
+
+using namespace argos;
+
+static const Real TOLERANCE = 1e-5;
+
+static bool Check(const std::string& str_what,
+                  const CVector3& c_batch,
+                  const CVector3& c_scalar) {
+   if(Distance(c_batch, c_scalar) > TOLERANCE * (1.0 + c_scalar.Length())) {
+      std::cerr << "ERROR: " << str_what
+                << ", batch = [" << c_batch << "]"
+                << ", scalar = [" << c_scalar << "]"
+                << std::endl;
+      return false;
+   }
+   return true;
+}
+
+int main(int argc, char* argv[]) {
+   CRandom::CreateCategory("argos", 1);
+   CRandom::CRNG* pcRNG = CRandom::CreateRNG("argos");
+   CRange<Real> cCoordRange(-10.0, 10.0);
+   /* Test sizes that are not multiples of the vector width */
+   for(size_t unSize = 0; unSize < 20; ++unSize) {
+      CVector3Array cVecs(unSize), cOthers(unSize);
+      for(size_t i = 0; i < unSize; ++i) {
+         cVecs.Set(i, CVector3(pcRNG->Uniform(cCoordRange),
+                               pcRNG->Uniform(cCoordRange),
+                               pcRNG->Uniform(cCoordRange)));
+         cOthers.Set(i, CVector3(pcRNG->Uniform(cCoordRange),
+                                 pcRNG->Uniform(cCoordRange),
+                                 pcRNG->Uniform(cCoordRange)));
+      }
+      /* Both unit and non-unit quaternions */
+      CQuaternion cRotation(CRadians(pcRNG->Uniform(CRadians::SIGNED_RANGE)),
+                            CVector3(pcRNG->Uniform(cCoordRange),
+                                     pcRNG->Uniform(cCoordRange),
+                                     pcRNG->Uniform(cCoordRange)).Normalize());
+      CQuaternion cScaled(2.0 * cRotation.GetW(),
+                          2.0 * cRotation.GetX(),
+                          2.0 * cRotation.GetY(),
+                          2.0 * cRotation.GetZ());
+      CVector3 cTranslation(pcRNG->Uniform(cCoordRange),
+                            pcRNG->Uniform(cCoordRange),
+                            pcRNG->Uniform(cCoordRange));
+      /* Transform */
+      CVector3Array cTransformed;
+      cVecs.Transform(cTransformed, cRotation, cTranslation);
+      /* Rotate and translate */
+      CVector3Array cRotated(cVecs);
+      cRotated.Rotate(cScaled);
+      CVector3Array cTranslated(cVecs);
+      cTranslated.Translate(cTranslation);
+      /* Transform of a range, in place */
+      CVector3Array cRange(cVecs);
+      size_t unFirst = unSize / 3;
+      size_t unCount = unSize / 2;
+      cRange.Transform(cRange, cRotation, cTranslation, unFirst, unCount);
+      /* Dot and cross products */
+      std::vector<Real> vecDots;
+      cVecs.DotProduct(vecDots, cOthers);
+      CVector3Array cCrosses;
+      cVecs.CrossProduct(cCrosses, cOthers);
+      if(cTransformed.GetSize() != unSize ||
+         vecDots.size() != unSize ||
+         cCrosses.GetSize() != unSize) {
+         std::cerr << "ERROR: wrong result size for " << unSize << " vectors" << std::endl;
+         return 1;
+      }
+      for(size_t i = 0; i < unSize; ++i) {
+         CVector3 cVec = cVecs.Get(i);
+         CVector3 cScalar = cVec;
+         cScalar.Rotate(cRotation);
+         cScalar += cTranslation;
+         if(!Check("transform", cTransformed.Get(i), cScalar)) return 1;
+         if(i >= unFirst && i < unFirst + unCount) {
+            if(!Check("range transform", cRange.Get(i), cScalar)) return 1;
+         }
+         else {
+            if(!Check("outside of range", cRange.Get(i), cVec)) return 1;
+         }
+         cScalar = cVec;
+         cScalar.Rotate(cScaled);
+         if(!Check("rotate", cRotated.Get(i), cScalar)) return 1;
+         if(!Check("translate", cTranslated.Get(i), cVec + cTranslation)) return 1;
+         cScalar = cVec;
+         cScalar.CrossProduct(cOthers.Get(i));
+         if(!Check("cross product", cCrosses.Get(i), cScalar)) return 1;
+         if(Abs(vecDots[i] - cVec.DotProduct(cOthers.Get(i))) > TOLERANCE) {
+            std::cerr << "ERROR: dot product"
+                      << ", batch = " << vecDots[i]
+                      << ", scalar = " << cVec.DotProduct(cOthers.Get(i))
+                      << std::endl;
+            return 1;
+         }
+      }
+      std::cout << "size = " << unSize << ", OK" << std::endl;
+   }
+   return 0;
+}